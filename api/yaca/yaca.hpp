@@ -0,0 +1,548 @@
+/*
+ *  Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file   yaca.hpp
+ * @brief  Header-only C++17 API over the C API.
+ *
+ * Contexts and keys are move-only RAII objects. Algorithms and block cipher
+ * modes are template parameters, so unsupported combinations don't compile
+ * and output lengths are constant expressions. The data is passed as spans
+ * of caller owned memory, nothing is copied or allocated by this layer.
+ * Errors are reported with yaca::error exceptions.
+ *
+ * The C API still has to be initialized with yaca_initialize().
+ */
+
+#ifndef YACA_HPP
+#define YACA_HPP
+
+#include <cstddef>
+#include <array>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if __cplusplus > 201703L && __has_include(<span>)
+#include <span>
+#endif
+
+#include <yaca_crypto.h>
+#include <yaca_digest.h>
+#include <yaca_encrypt.h>
+#include <yaca_sign.h>
+#include <yaca_key.h>
+#include <yaca_error.h>
+
+namespace yaca {
+
+#if defined(__cpp_lib_span)
+
+template <typename T>
+using span = std::span<T>;
+
+#else /* __cpp_lib_span */
+
+/**
+ * @brief  The subset of C++20 std::span used by this API, std::span itself
+ *         is used when available.
+ */
+template <typename T>
+class span {
+public:
+	constexpr span() noexcept : m_data(nullptr), m_size(0) {}
+	constexpr span(T *data, std::size_t size) noexcept : m_data(data), m_size(size) {}
+
+	template <std::size_t N>
+	constexpr span(T (&array)[N]) noexcept : m_data(array), m_size(N) {}
+
+	/* Contiguous containers: std::array, std::vector, std::string etc. */
+	template <typename C, typename = std::enable_if_t<
+	          !std::is_array_v<C> &&
+	          std::is_convertible_v<
+	              std::remove_pointer_t<decltype(std::data(std::declval<C &>()))> (*)[],
+	              T (*)[]>>>
+	constexpr span(C &container) noexcept :
+		m_data(std::data(container)), m_size(std::size(container)) {}
+
+	template <typename U, typename = std::enable_if_t<std::is_convertible_v<U (*)[], T (*)[]>>>
+	constexpr span(const span<U> &other) noexcept : m_data(other.data()), m_size(other.size()) {}
+
+	constexpr T *data() const noexcept { return m_data; }
+	constexpr std::size_t size() const noexcept { return m_size; }
+	constexpr bool empty() const noexcept { return m_size == 0; }
+	constexpr T *begin() const noexcept { return m_data; }
+	constexpr T *end() const noexcept { return m_data + m_size; }
+
+	constexpr span first(std::size_t count) const noexcept { return {m_data, count}; }
+	constexpr span subspan(std::size_t offset) const noexcept
+	{
+		return {m_data + offset, m_size - offset};
+	}
+	constexpr span subspan(std::size_t offset, std::size_t count) const noexcept
+	{
+		return {m_data + offset, count};
+	}
+
+private:
+	T *m_data;
+	std::size_t m_size;
+};
+
+#endif /* __cpp_lib_span */
+
+/**
+ * @brief  Thrown when a function of the C API fails, code() is the
+ *         #yaca_error_e it returned.
+ */
+class error : public std::runtime_error {
+public:
+	explicit error(int code) : std::runtime_error(describe(code)), m_code(code) {}
+
+	int code() const noexcept { return m_code; }
+
+private:
+	static const char *describe(int code) noexcept
+	{
+		switch (code) {
+		case YACA_ERROR_INVALID_PARAMETER:
+			return "YACA_ERROR_INVALID_PARAMETER";
+		case YACA_ERROR_OUT_OF_MEMORY:
+			return "YACA_ERROR_OUT_OF_MEMORY";
+		case YACA_ERROR_INTERNAL:
+			return "YACA_ERROR_INTERNAL";
+		case YACA_ERROR_DATA_MISMATCH:
+			return "YACA_ERROR_DATA_MISMATCH";
+		case YACA_ERROR_INVALID_PASSWORD:
+			return "YACA_ERROR_INVALID_PASSWORD";
+		default:
+			return "Unknown YACA error";
+		}
+	}
+
+	int m_code;
+};
+
+namespace detail {
+
+/* Out of line so that the error path doesn't bloat the inlined callers */
+[[noreturn]] inline void raise(int ret)
+{
+	throw error(ret);
+}
+
+inline void check(int ret)
+{
+	if (ret != YACA_ERROR_NONE)
+		raise(ret);
+}
+
+/* The ENCRYPTION_CIPHERS table of encrypt.c */
+constexpr bool cipher_supported(yaca_encrypt_algorithm_e algo, yaca_block_cipher_mode_e bcm)
+{
+	switch (algo) {
+	case YACA_ENCRYPT_AES:
+		return bcm == YACA_BCM_CBC || bcm == YACA_BCM_CCM || bcm == YACA_BCM_CFB ||
+		       bcm == YACA_BCM_CFB1 || bcm == YACA_BCM_CFB8 || bcm == YACA_BCM_CTR ||
+		       bcm == YACA_BCM_ECB || bcm == YACA_BCM_GCM || bcm == YACA_BCM_OFB ||
+		       bcm == YACA_BCM_WRAP || bcm == YACA_BCM_CBC_HMAC_SHA1 ||
+		       bcm == YACA_BCM_CBC_HMAC_SHA256 || bcm == YACA_BCM_SIV;
+	case YACA_ENCRYPT_UNSAFE_DES:
+		return bcm == YACA_BCM_CBC || bcm == YACA_BCM_CFB || bcm == YACA_BCM_CFB1 ||
+		       bcm == YACA_BCM_CFB8 || bcm == YACA_BCM_ECB || bcm == YACA_BCM_OFB;
+	case YACA_ENCRYPT_3DES_3TDEA:
+		return bcm == YACA_BCM_CBC || bcm == YACA_BCM_CFB || bcm == YACA_BCM_CFB1 ||
+		       bcm == YACA_BCM_CFB8 || bcm == YACA_BCM_ECB || bcm == YACA_BCM_OFB ||
+		       bcm == YACA_BCM_WRAP;
+	case YACA_ENCRYPT_UNSAFE_3DES_2TDEA:
+	case YACA_ENCRYPT_UNSAFE_RC2:
+	case YACA_ENCRYPT_CAST5:
+		return bcm == YACA_BCM_CBC || bcm == YACA_BCM_CFB || bcm == YACA_BCM_ECB ||
+		       bcm == YACA_BCM_OFB;
+	case YACA_ENCRYPT_UNSAFE_RC4:
+		return bcm == YACA_BCM_NONE;
+	default:
+		return false;
+	}
+}
+
+/* EVP_CIPHER_block_size(), only ECB and CBC work on whole blocks */
+constexpr std::size_t cipher_block_size(yaca_encrypt_algorithm_e algo,
+                                        yaca_block_cipher_mode_e bcm)
+{
+	if (bcm != YACA_BCM_ECB && bcm != YACA_BCM_CBC &&
+	    bcm != YACA_BCM_CBC_HMAC_SHA1 && bcm != YACA_BCM_CBC_HMAC_SHA256)
+		return 1;
+	return algo == YACA_ENCRYPT_AES ? 16 : 8;
+}
+
+/* What the key wrap adds to the wrapped key */
+constexpr std::size_t wrap_overhead(yaca_encrypt_algorithm_e algo)
+{
+	return algo == YACA_ENCRYPT_AES ? 8 : 16;
+}
+
+constexpr std::size_t digest_length(yaca_digest_algorithm_e algo)
+{
+	switch (algo) {
+	case YACA_DIGEST_MD5:
+		return 16;
+	case YACA_DIGEST_SHA1:
+		return 20;
+	case YACA_DIGEST_SHA224:
+		return 28;
+	case YACA_DIGEST_SHA256:
+		return 32;
+	case YACA_DIGEST_SHA384:
+		return 48;
+	case YACA_DIGEST_SHA512:
+		return 64;
+	default:
+		return 0;
+	}
+}
+
+} /* namespace detail */
+
+/**
+ * @brief  Owns a #yaca_key_h, destroys it with yaca_key_destroy().
+ */
+class key {
+public:
+	key() noexcept = default;
+	/* Takes the ownership of the handle */
+	explicit key(yaca_key_h handle) noexcept : m_handle(handle) {}
+	key(key &&other) noexcept : m_handle(std::exchange(other.m_handle, YACA_KEY_NULL)) {}
+	key &operator=(key &&other) noexcept
+	{
+		if (this != &other) {
+			yaca_key_destroy(m_handle);
+			m_handle = std::exchange(other.m_handle, YACA_KEY_NULL);
+		}
+		return *this;
+	}
+	key(const key &) = delete;
+	key &operator=(const key &) = delete;
+	~key() { yaca_key_destroy(m_handle); }
+
+	/** @see yaca_key_generate() */
+	static key generate(yaca_key_type_e type, std::size_t bit_len)
+	{
+		yaca_key_h handle = YACA_KEY_NULL;
+		detail::check(yaca_key_generate(type, bit_len, &handle));
+		return key(handle);
+	}
+
+	/** @see yaca_key_import() */
+	static key import(yaca_key_type_e type, span<const char> data,
+	                  const char *password = nullptr)
+	{
+		yaca_key_h handle = YACA_KEY_NULL;
+		detail::check(yaca_key_import(type, password, data.data(), data.size(), &handle));
+		return key(handle);
+	}
+
+	/** @see yaca_key_derive_pbkdf2() */
+	static key derive_pbkdf2(const char *password, span<const char> salt,
+	                         std::size_t iterations, yaca_digest_algorithm_e algo,
+	                         std::size_t bit_len)
+	{
+		yaca_key_h handle = YACA_KEY_NULL;
+		detail::check(yaca_key_derive_pbkdf2(password, salt.empty() ? nullptr : salt.data(),
+		                                     salt.size(), iterations, algo, bit_len,
+		                                     &handle));
+		return key(handle);
+	}
+
+	/** @see yaca_key_get_type() */
+	yaca_key_type_e type() const
+	{
+		yaca_key_type_e type;
+		detail::check(yaca_key_get_type(m_handle, &type));
+		return type;
+	}
+
+	/** @see yaca_key_get_bit_length() */
+	std::size_t bit_length() const
+	{
+		std::size_t bit_len;
+		detail::check(yaca_key_get_bit_length(m_handle, &bit_len));
+		return bit_len;
+	}
+
+	yaca_key_h get() const noexcept { return m_handle; }
+
+	/* Gives up the ownership of the handle */
+	yaca_key_h release() noexcept { return std::exchange(m_handle, YACA_KEY_NULL); }
+
+	explicit operator bool() const noexcept { return m_handle != YACA_KEY_NULL; }
+
+private:
+	yaca_key_h m_handle = YACA_KEY_NULL;
+};
+
+/**
+ * @brief  Owns a #yaca_context_h, destroys it with yaca_context_destroy().
+ */
+class context {
+public:
+	context(context &&other) noexcept :
+		m_handle(std::exchange(other.m_handle, YACA_CONTEXT_NULL)) {}
+	context &operator=(context &&other) noexcept
+	{
+		if (this != &other) {
+			yaca_context_destroy(m_handle);
+			m_handle = std::exchange(other.m_handle, YACA_CONTEXT_NULL);
+		}
+		return *this;
+	}
+	context(const context &) = delete;
+	context &operator=(const context &) = delete;
+	~context() { yaca_context_destroy(m_handle); }
+
+	/** @see yaca_context_set_property() */
+	void set_property(yaca_property_e property, span<const char> value)
+	{
+		detail::check(yaca_context_set_property(m_handle, property,
+		                                        value.data(), value.size()));
+	}
+
+	/** @see yaca_context_set_property() */
+	template <typename T, typename = std::enable_if_t<std::is_arithmetic_v<T> ||
+	                                                  std::is_enum_v<T>>>
+	void set_property(yaca_property_e property, T value)
+	{
+		detail::check(yaca_context_set_property(m_handle, property, &value, sizeof(value)));
+	}
+
+	/**
+	 * @brief  Writes the property into the caller buffer, returns its length.
+	 * @see yaca_context_get_property_into()
+	 */
+	std::size_t get_property(yaca_property_e property, span<char> value) const
+	{
+		std::size_t value_len;
+		detail::check(yaca_context_get_property_into(m_handle, property, value.data(),
+		                                             value.size(), &value_len));
+		return value_len;
+	}
+
+	yaca_context_h get() const noexcept { return m_handle; }
+
+protected:
+	context() noexcept = default;
+
+	yaca_context_h m_handle = YACA_CONTEXT_NULL;
+};
+
+/**
+ * @brief  Message digest of the Algo algorithm.
+ * @see yaca_digest_initialize()
+ */
+template <yaca_digest_algorithm_e Algo>
+class digest : public context {
+	static_assert(detail::digest_length(Algo) != 0, "Unsupported digest algorithm");
+
+public:
+	static constexpr std::size_t length = detail::digest_length(Algo);
+
+	digest()
+	{
+		detail::check(yaca_digest_initialize(&m_handle, Algo));
+	}
+
+	/** @see yaca_digest_update() */
+	void update(span<const char> data)
+	{
+		detail::check(yaca_digest_update(m_handle, data.data(), data.size()));
+	}
+
+	/** @see yaca_digest_finalize() */
+	void finalize(span<char> output)
+	{
+		std::size_t output_len;
+
+		if (output.size() < length)
+			detail::raise(YACA_ERROR_INVALID_PARAMETER);
+		detail::check(yaca_digest_finalize(m_handle, output.data(), &output_len));
+	}
+
+	std::array<char, length> finalize()
+	{
+		std::array<char, length> output;
+		finalize(output);
+		return output;
+	}
+};
+
+/**
+ * @brief  Symmetric encryption (Encrypt true) or decryption (false) with the
+ *         Algo algorithm in the Bcm mode.
+ *
+ * @remarks  The output buffers are checked against output_length(), the same
+ *           value yaca_context_get_output_length() returns, computed inline.
+ *
+ * @see encryptor
+ * @see decryptor
+ */
+template <yaca_encrypt_algorithm_e Algo, yaca_block_cipher_mode_e Bcm, bool Encrypt>
+class cipher : public context {
+	static_assert(detail::cipher_supported(Algo, Bcm),
+	              "Block cipher mode not supported by the algorithm");
+
+public:
+	static constexpr std::size_t block_size = detail::cipher_block_size(Algo, Bcm);
+
+	/** Output buffer length required by update() of input_len bytes */
+	static constexpr std::size_t output_length(std::size_t input_len) noexcept
+	{
+		if constexpr (Bcm == YACA_BCM_WRAP) {
+			constexpr std::size_t overhead = detail::wrap_overhead(Algo);
+
+			if (input_len == 0)
+				return 0;
+			if constexpr (Encrypt)
+				return input_len + overhead;
+			else
+				return input_len > overhead ? input_len - overhead : 0;
+		} else {
+			return input_len > 0 ? input_len + block_size - 1 : block_size;
+		}
+	}
+
+	/** Output buffer length required by finalize() */
+	static constexpr std::size_t finalize_length = output_length(0);
+
+	/** @see yaca_encrypt_initialize() */
+	explicit cipher(const key &sym_key, const key &iv = key())
+	{
+		if constexpr (Encrypt)
+			detail::check(yaca_encrypt_initialize(&m_handle, Algo, Bcm,
+			                                      sym_key.get(), iv.get()));
+		else
+			detail::check(yaca_decrypt_initialize(&m_handle, Algo, Bcm,
+			                                      sym_key.get(), iv.get()));
+	}
+
+	/**
+	 * @brief  Processes the input into the output, returns the number of
+	 *         bytes written. The output may be the same memory as the input.
+	 * @see yaca_encrypt_update()
+	 */
+	std::size_t update(span<const char> input, span<char> output)
+	{
+		std::size_t output_len;
+
+		if (output.size() < output_length(input.size()))
+			detail::raise(YACA_ERROR_INVALID_PARAMETER);
+
+		if constexpr (Encrypt)
+			detail::check(yaca_encrypt_update(m_handle, input.data(), input.size(),
+			                                  output.data(), &output_len));
+		else
+			detail::check(yaca_decrypt_update(m_handle, input.data(), input.size(),
+			                                  output.data(), &output_len));
+		return output_len;
+	}
+
+	/**
+	 * @brief  Passes the total length of the input, CCM only.
+	 * @see yaca_encrypt_update()
+	 */
+	void update_total_length(std::size_t input_len)
+	{
+		static_assert(Bcm == YACA_BCM_CCM, "The total input length is only used by CCM");
+		std::size_t output_len;
+
+		if constexpr (Encrypt)
+			detail::check(yaca_encrypt_update(m_handle, nullptr, input_len, nullptr,
+			                                  &output_len));
+		else
+			detail::check(yaca_decrypt_update(m_handle, nullptr, input_len, nullptr,
+			                                  &output_len));
+	}
+
+	/**
+	 * @brief  Writes the final chunk, returns the number of bytes written.
+	 * @see yaca_encrypt_finalize()
+	 */
+	std::size_t finalize(span<char> output)
+	{
+		std::size_t output_len;
+
+		if (output.size() < finalize_length)
+			detail::raise(YACA_ERROR_INVALID_PARAMETER);
+
+		if constexpr (Encrypt)
+			detail::check(yaca_encrypt_finalize(m_handle, output.data(), &output_len));
+		else
+			detail::check(yaca_decrypt_finalize(m_handle, output.data(), &output_len));
+		return output_len;
+	}
+};
+
+template <yaca_encrypt_algorithm_e Algo, yaca_block_cipher_mode_e Bcm>
+using encryptor = cipher<Algo, Bcm, true>;
+
+template <yaca_encrypt_algorithm_e Algo, yaca_block_cipher_mode_e Bcm>
+using decryptor = cipher<Algo, Bcm, false>;
+
+/**
+ * @brief  HMAC with the Algo digest.
+ * @see yaca_sign_initialize_hmac()
+ */
+template <yaca_digest_algorithm_e Algo>
+class hmac : public context {
+	static_assert(detail::digest_length(Algo) != 0, "Unsupported digest algorithm");
+
+public:
+	static constexpr std::size_t length = detail::digest_length(Algo);
+
+	explicit hmac(const key &sym_key)
+	{
+		detail::check(yaca_sign_initialize_hmac(&m_handle, Algo, sym_key.get()));
+	}
+
+	/** @see yaca_sign_update() */
+	void update(span<const char> data)
+	{
+		detail::check(yaca_sign_update(m_handle, data.data(), data.size()));
+	}
+
+	/** @see yaca_sign_finalize() */
+	void finalize(span<char> output)
+	{
+		std::size_t output_len;
+
+		if (output.size() < length)
+			detail::raise(YACA_ERROR_INVALID_PARAMETER);
+		detail::check(yaca_sign_finalize(m_handle, output.data(), &output_len));
+	}
+
+	std::array<char, length> finalize()
+	{
+		std::array<char, length> output;
+		finalize(output);
+		return output;
+	}
+};
+
+} /* namespace yaca */
+
+#endif /* YACA_HPP */
@@ -245,6 +245,43 @@ int yaca_context_get_property(const yaca_context_h ctx,
                               void **value,
                               size_t *value_len);
 
+/**
+ * @brief  Returns the non-standard context properties into a buffer provided by the caller.
+ *         Can only be called on an initialized context.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  This is the allocation free variant of yaca_context_get_property(), meant for
+ *           reading e.g. a tag after every message. It supports the same properties.
+ *
+ * @remarks  The @a value has to be of type appropriate for given property. See #yaca_property_e
+ *           for details on corresponding types.
+ *
+ * @remarks  If the @a value_capacity is too small #YACA_ERROR_INVALID_PARAMETER is returned
+ *           and the required length is written to @a value_len.
+ *
+ * @param[in]  ctx             Previously initialized crypto context
+ * @param[in]  property        Property to be read
+ * @param[out] value           Buffer the property value will be written to
+ * @param[in]  value_capacity  Size of the @a value buffer
+ * @param[out] value_len       Length of the property value will be returned here
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a ctx or @a property, too small
+ *                                       @a value_capacity)
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_property_e
+ * @see yaca_context_get_property()
+ */
+int yaca_context_get_property_into(const yaca_context_h ctx,
+                                   yaca_property_e property,
+                                   void *value,
+                                   size_t value_capacity,
+                                   size_t *value_len);
+
 /**
  * @brief  Returns the minimum required size of the output buffer for a single crypto function call.
  *
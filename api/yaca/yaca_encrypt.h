@@ -69,6 +69,9 @@ int yaca_encrypt_get_iv_bit_length(yaca_encrypt_algorithm_e algo,
  *
  * @remarks  The @a ctx should be released using yaca_context_destroy().
  *
+ * @remarks  The plaintext can be hashed in the same pass, see
+ *           #YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO.
+ *
  * @param[out] ctx      Newly created context
  * @param[in]  algo     Encryption algorithm that will be used
  * @param[in]  bcm      Chaining mode that will be used
@@ -97,6 +100,11 @@ int yaca_encrypt_initialize(yaca_context_h *ctx,
 /**
  * @brief  Encrypts chunk of the data.
  *
+ * @remarks  The @a ciphertext may point to the same buffer as the @a plaintext to process the data
+ *           in place, for every algorithm and mode. Such buffer must still be as large as
+ *           yaca_context_get_output_length() requires. Buffers that overlap only partially
+ *           are not allowed.
+ *
  * @since_tizen 3.0
  *
  * @param[in,out] ctx             Context created by yaca_encrypt_initialize()
@@ -110,7 +118,8 @@ int yaca_encrypt_initialize(yaca_context_h *ctx,
  * @return #YACA_ERROR_NONE on success, negative on error
  * @retval #YACA_ERROR_NONE Successful
  * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
- *                                       invalid @a ctx)
+ *                                       invalid @a ctx, partially overlapping @a plaintext
+ *                                       and @a ciphertext)
  * @retval #YACA_ERROR_INTERNAL Internal error
  *
  * @see yaca_encrypt_initialize()
@@ -158,6 +167,9 @@ int yaca_encrypt_finalize(yaca_context_h ctx,
  *
  * @remarks  The @a ctx should be released using yaca_context_destroy().
  *
+ * @remarks  The decrypted plaintext can be hashed in the same pass, see
+ *           #YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO.
+ *
  * @param[out] ctx      Newly created context
  * @param[in]  algo     Encryption algorithm that was used to encrypt the data
  * @param[in]  bcm      Chaining mode that was used to encrypt the data
@@ -186,6 +198,11 @@ int yaca_decrypt_initialize(yaca_context_h *ctx,
 /**
  * @brief  Decrypts chunk of the data.
  *
+ * @remarks  The @a plaintext may point to the same buffer as the @a ciphertext to process the data
+ *           in place, for every algorithm and mode. Such buffer must still be as large as
+ *           yaca_context_get_output_length() requires. Buffers that overlap only partially
+ *           are not allowed.
+ *
  * @since_tizen 3.0
  *
  * @param[in,out] ctx             Context created by yaca_decrypt_initialize()
@@ -199,8 +216,10 @@ int yaca_decrypt_initialize(yaca_context_h *ctx,
  * @return #YACA_ERROR_NONE on success, negative on error
  * @retval #YACA_ERROR_NONE Successful
  * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
- *                                       invalid @a ctx), wrong #YACA_PROPERTY_CCM_AAD or
- *                                       wrong #YACA_PROPERTY_CCM_TAG was used
+ *                                       invalid @a ctx), partially overlapping @a ciphertext
+ *                                       and @a plaintext, wrong #YACA_PROPERTY_CCM_AAD,
+ *                                       #YACA_PROPERTY_CCM_TAG, #YACA_PROPERTY_SIV_AAD or
+ *                                       #YACA_PROPERTY_SIV_TAG was used
  * @retval #YACA_ERROR_INTERNAL Internal error
  *
  * @see yaca_decrypt_initialize()
@@ -242,6 +261,319 @@ int yaca_decrypt_finalize(yaca_context_h ctx,
                           char *plaintext,
                           size_t *plaintext_len);
 
+/**
+ * @brief  Wraps a batch of keys given as raw buffers with a single key encryption key.
+ *
+ * @remarks  The @a kek is set up once for the whole batch, instead of once per key as with
+ *           yaca_encrypt_initialize() and #YACA_BCM_WRAP.
+ *
+ * @remarks  Each @a wrapped buffer must be allocated by the client and hold at least the length
+ *           of the key plus 8 bytes for #YACA_ENCRYPT_AES or plus 16 bytes for
+ *           #YACA_ENCRYPT_3DES_3TDEA. It must not overlap the key.
+ *
+ * @remarks  The batch is split evenly between @a threads threads, including the calling one.
+ *
+ * @remarks  On error the contents of the @a wrapped buffers are undefined.
+ *
+ * @since_tizen 6.0
+ *
+ * @param[in]  algo          #YACA_ENCRYPT_AES or #YACA_ENCRYPT_3DES_3TDEA
+ * @param[in]  kek           Key encryption key, the same as for #YACA_BCM_WRAP
+ * @param[in]  iv            Initialization vector, the same as for #YACA_BCM_WRAP
+ * @param[in]  keys          Array of @a count keys to be wrapped
+ * @param[in]  key_lens      Lengths of the @a keys
+ * @param[in]  count         Number of keys, greater than 0
+ * @param[out] wrapped       Array of @a count buffers for the wrapped keys
+ * @param[out] wrapped_lens  Lengths of the wrapped keys will be returned here
+ * @param[in]  threads       Number of threads to use, 0 or 1 for the calling thread only,
+ *                           at most 64
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a algo, @a kek, @a iv or key length,
+ *                                       too many @a threads)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_encrypt_algorithm_e
+ * @see #YACA_BCM_WRAP
+ * @see yaca_decrypt_unwrap_batch()
+ * @see yaca_encrypt_wrap_keys()
+ */
+int yaca_encrypt_wrap_batch(yaca_encrypt_algorithm_e algo,
+                            const yaca_key_h kek,
+                            const yaca_key_h iv,
+                            const char *const *keys,
+                            const size_t *key_lens,
+                            size_t count,
+                            char *const *wrapped,
+                            size_t *wrapped_lens,
+                            size_t threads);
+
+/**
+ * @brief  Unwraps a batch of keys into raw buffers with a single key encryption key.
+ *
+ * @remarks  Each @a keys buffer must be allocated by the client, the length of the wrapped key
+ *           is always enough. It must not overlap the wrapped key.
+ *
+ * @remarks  The batch is split evenly between @a threads threads, including the calling one.
+ *
+ * @remarks  On error the contents of the @a keys buffers are undefined.
+ *
+ * @since_tizen 6.0
+ *
+ * @param[in]  algo          #YACA_ENCRYPT_AES or #YACA_ENCRYPT_3DES_3TDEA
+ * @param[in]  kek           Key encryption key, the same as for #YACA_BCM_WRAP
+ * @param[in]  iv            Initialization vector, the same as for #YACA_BCM_WRAP
+ * @param[in]  wrapped       Array of @a count wrapped keys
+ * @param[in]  wrapped_lens  Lengths of the @a wrapped keys
+ * @param[in]  count         Number of keys, greater than 0
+ * @param[out] keys          Array of @a count buffers for the unwrapped keys
+ * @param[out] key_lens      Lengths of the unwrapped keys will be returned here
+ * @param[in]  threads       Number of threads to use, 0 or 1 for the calling thread only,
+ *                           at most 64
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a algo, @a kek, @a iv or wrapped key length,
+ *                                       too many @a threads)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error, also a key that failed the integrity check
+ *
+ * @see #yaca_encrypt_algorithm_e
+ * @see #YACA_BCM_WRAP
+ * @see yaca_encrypt_wrap_batch()
+ * @see yaca_decrypt_unwrap_keys()
+ */
+int yaca_decrypt_unwrap_batch(yaca_encrypt_algorithm_e algo,
+                              const yaca_key_h kek,
+                              const yaca_key_h iv,
+                              const char *const *wrapped,
+                              const size_t *wrapped_lens,
+                              size_t count,
+                              char *const *keys,
+                              size_t *key_lens,
+                              size_t threads);
+
+/**
+ * @brief  Wraps a batch of symmetric or DES keys with a single key encryption key.
+ *
+ * @remarks  The @a wrapped keys should be freed using yaca_free(). On error none of them are
+ *           returned.
+ *
+ * @remarks  The batch is split evenly between @a threads threads, including the calling one.
+ *
+ * @since_tizen 6.0
+ *
+ * @param[in]  algo          #YACA_ENCRYPT_AES or #YACA_ENCRYPT_3DES_3TDEA
+ * @param[in]  kek           Key encryption key, the same as for #YACA_BCM_WRAP
+ * @param[in]  iv            Initialization vector, the same as for #YACA_BCM_WRAP
+ * @param[in]  keys          Array of @a count keys to be wrapped
+ * @param[in]  count         Number of keys, greater than 0
+ * @param[out] wrapped       Array of @a count pointers, the newly allocated wrapped keys will
+ *                           be returned here
+ * @param[out] wrapped_lens  Lengths of the wrapped keys will be returned here
+ * @param[in]  threads       Number of threads to use, 0 or 1 for the calling thread only,
+ *                           at most 64
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a algo, @a kek or @a iv, @a keys of a wrong
+ *                                       type or length, too many @a threads)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_encrypt_algorithm_e
+ * @see #YACA_BCM_WRAP
+ * @see yaca_decrypt_unwrap_keys()
+ * @see yaca_free()
+ */
+int yaca_encrypt_wrap_keys(yaca_encrypt_algorithm_e algo,
+                           const yaca_key_h kek,
+                           const yaca_key_h iv,
+                           const yaca_key_h *keys,
+                           size_t count,
+                           char **wrapped,
+                           size_t *wrapped_lens,
+                           size_t threads);
+
+/**
+ * @brief  Unwraps a batch of keys with a single key encryption key.
+ *
+ * @remarks  The @a keys should be released using yaca_key_destroy(). On error none of them are
+ *           returned.
+ *
+ * @remarks  The batch is split evenly between @a threads threads, including the calling one.
+ *
+ * @since_tizen 6.0
+ *
+ * @param[in]  algo          #YACA_ENCRYPT_AES or #YACA_ENCRYPT_3DES_3TDEA
+ * @param[in]  kek           Key encryption key, the same as for #YACA_BCM_WRAP
+ * @param[in]  iv            Initialization vector, the same as for #YACA_BCM_WRAP
+ * @param[in]  key_type      Type of the unwrapped keys, #YACA_KEY_TYPE_SYMMETRIC or
+ *                           #YACA_KEY_TYPE_DES
+ * @param[in]  wrapped       Array of @a count wrapped keys
+ * @param[in]  wrapped_lens  Lengths of the @a wrapped keys
+ * @param[in]  count         Number of keys, greater than 0
+ * @param[out] keys          Array of @a count handles, the unwrapped keys will be returned here
+ * @param[in]  threads       Number of threads to use, 0 or 1 for the calling thread only,
+ *                           at most 64
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a algo, @a kek, @a iv or @a key_type,
+ *                                       wrong wrapped key length, too many @a threads)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error, also a key that failed the integrity check
+ *
+ * @see #yaca_encrypt_algorithm_e
+ * @see #yaca_key_type_e
+ * @see yaca_encrypt_wrap_keys()
+ * @see yaca_key_destroy()
+ */
+int yaca_decrypt_unwrap_keys(yaca_encrypt_algorithm_e algo,
+                             const yaca_key_h kek,
+                             const yaca_key_h iv,
+                             yaca_key_type_e key_type,
+                             const char *const *wrapped,
+                             const size_t *wrapped_lens,
+                             size_t count,
+                             yaca_key_h *keys,
+                             size_t threads);
+
+/**
+ * @brief  Structure describing a single record of an AEAD batch.
+ *
+ * @since_tizen 6.0
+ *
+ * @see yaca_encrypt_aead_batch()
+ * @see yaca_decrypt_aead_batch()
+ */
+typedef struct {
+	/** Initialization vector of the record, of the length given for the whole batch,
+	 *  ignored for #YACA_BCM_SIV */
+	const char *iv;
+	/** Additional authentication data, NULL if @a aad_len is 0. A single component for
+	 *  #YACA_BCM_SIV */
+	const char *aad;
+	/** Length of the @a aad */
+	size_t aad_len;
+	/** Plaintext to seal or ciphertext to open */
+	const char *input;
+	/** Length of the @a input, greater than 0 */
+	size_t input_len;
+	/** Buffer for @a input_len bytes of the output, the same as @a input or not overlapping it */
+	char *output;
+	/** Buffer for the tag when sealing, the tag to check when opening */
+	char *tag;
+	/** #YACA_ERROR_NONE, or #YACA_ERROR_INVALID_PARAMETER for a record that failed to open */
+	int result;
+} yaca_aead_record_s;
+
+/**
+ * @brief  Encrypts and authenticates a batch of records with a single key.
+ *
+ * @remarks  The key is set up once for the whole batch. Each record costs one pass of the
+ *           cipher over its AAD and input, without any context or property calls. The result
+ *           is the same as with yaca_encrypt_initialize(), #YACA_PROPERTY_GCM_AAD or
+ *           #YACA_PROPERTY_CCM_AAD, yaca_encrypt_update(), yaca_encrypt_finalize() and the
+ *           #YACA_PROPERTY_GCM_TAG or #YACA_PROPERTY_CCM_TAG of every record (the SIV
+ *           properties for #YACA_BCM_SIV).
+ *
+ * @remarks  Every record must have its own IV, the batch doesn't check that. #YACA_BCM_SIV
+ *           has no IV, equal records give equal outputs.
+ *
+ * @remarks  The batch is split evenly between @a threads threads, including the calling one.
+ *
+ * @remarks  On error the contents of the output and tag buffers are undefined.
+ *
+ * @since_tizen 6.0
+ *
+ * @param[in]     algo     #YACA_ENCRYPT_AES
+ * @param[in]     bcm      #YACA_BCM_GCM, #YACA_BCM_CCM or #YACA_BCM_SIV
+ * @param[in]     sym_key  Symmetric encryption key
+ * @param[in]     iv_len   Length of the IVs in bytes, from 7 to 13 for #YACA_BCM_CCM,
+ *                         0 for #YACA_BCM_SIV
+ * @param[in]     tag_len  Length of the tags in bytes, one of the lengths allowed for
+ *                         #YACA_PROPERTY_GCM_TAG_LEN or #YACA_PROPERTY_CCM_TAG_LEN,
+ *                         16 for #YACA_BCM_SIV
+ * @param[in,out] records  Array of @a count records
+ * @param[in]     count    Number of records, greater than 0
+ * @param[in]     threads  Number of threads to use, 0 or 1 for the calling thread only,
+ *                         at most 64
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a algo, @a bcm, @a sym_key, @a iv_len or
+ *                                       @a tag_len, overlapping buffers, too many @a threads)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_aead_record_s
+ * @see yaca_decrypt_aead_batch()
+ */
+int yaca_encrypt_aead_batch(yaca_encrypt_algorithm_e algo,
+                            yaca_block_cipher_mode_e bcm,
+                            const yaca_key_h sym_key,
+                            size_t iv_len,
+                            size_t tag_len,
+                            yaca_aead_record_s *records,
+                            size_t count,
+                            size_t threads);
+
+/**
+ * @brief  Decrypts and verifies a batch of records with a single key.
+ *
+ * @remarks  The key is set up once for the whole batch, as in yaca_encrypt_aead_batch().
+ *
+ * @remarks  A record that fails the authentication doesn't stop the batch. Its @a result is
+ *           set to #YACA_ERROR_INVALID_PARAMETER and its output is cleared, the @a result of
+ *           the other records is set to #YACA_ERROR_NONE.
+ *
+ * @remarks  The batch is split evenly between @a threads threads, including the calling one.
+ *
+ * @remarks  On an error other than a failed authentication the contents of the output buffers
+ *           and the @a result of the records are undefined.
+ *
+ * @since_tizen 6.0
+ *
+ * @param[in]     algo     #YACA_ENCRYPT_AES
+ * @param[in]     bcm      #YACA_BCM_GCM, #YACA_BCM_CCM or #YACA_BCM_SIV
+ * @param[in]     sym_key  Symmetric encryption key
+ * @param[in]     iv_len   Length of the IVs in bytes, from 7 to 13 for #YACA_BCM_CCM,
+ *                         0 for #YACA_BCM_SIV
+ * @param[in]     tag_len  Length of the tags in bytes
+ * @param[in,out] records  Array of @a count records
+ * @param[in]     count    Number of records, greater than 0
+ * @param[in]     threads  Number of threads to use, 0 or 1 for the calling thread only,
+ *                         at most 64
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful, all the records were authenticated
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a algo, @a bcm, @a sym_key, @a iv_len or
+ *                                       @a tag_len, overlapping buffers, too many @a threads),
+ *                                       at least one record failed the authentication
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_aead_record_s
+ * @see yaca_encrypt_aead_batch()
+ */
+int yaca_decrypt_aead_batch(yaca_encrypt_algorithm_e algo,
+                            yaca_block_cipher_mode_e bcm,
+                            const yaca_key_h sym_key,
+                            size_t iv_len,
+                            size_t tag_len,
+                            yaca_aead_record_s *records,
+                            size_t count,
+                            size_t threads);
+
 /**
  * @}
  */
@@ -25,6 +25,7 @@
 #define YACA_ERROR_H
 
 #include <errno.h>
+#include <stddef.h>
 
 #ifdef __cplusplus
 extern "C" {
@@ -62,6 +63,99 @@ typedef enum {
 	YACA_ERROR_INVALID_PASSWORD   = BASE_ERROR_YACA | 0x03
 } yaca_error_e;
 
+/**
+ * @brief Number of the latest error records kept for every thread.
+ *
+ * @since_tizen 6.0
+ */
+#define YACA_ERROR_RECORDS_MAX 16
+
+/**
+ * @brief Number of OpenSSL errors kept in an error record.
+ *
+ * @since_tizen 6.0
+ */
+#define YACA_ERROR_RECORD_OPENSSL_MAX 8
+
+/**
+ * @brief Structure describing an internal error of a YACA function.
+ *
+ * @since_tizen 6.0
+ *
+ * @see yaca_error_get_records()
+ * @see yaca_error_format_record()
+ */
+typedef struct {
+	/** The error returned by the function, #yaca_error_e */
+	int code;
+	/** Source file of YACA where the error was detected */
+	const char *file;
+	/** Line in the @a file */
+	int line;
+	/** Function of YACA where the error was detected */
+	const char *function;
+	/** Number of the OpenSSL errors that were queued, may exceed #YACA_ERROR_RECORD_OPENSSL_MAX */
+	size_t openssl_errors_count;
+	/** The first of the queued OpenSSL errors, as returned by ERR_get_error() */
+	unsigned long openssl_errors[YACA_ERROR_RECORD_OPENSSL_MAX];
+} yaca_error_record_s;
+
+/**
+ * @brief  Gets the records of the latest internal errors of the calling thread.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  A record is made whenever a function returns #YACA_ERROR_INTERNAL, or another
+ *           error that YACA couldn't explain, without any formatting. Only the last
+ *           #YACA_ERROR_RECORDS_MAX records of each thread are kept.
+ *
+ * @remarks  The batch functions move the last records of the threads they start to the
+ *           calling thread, they are passed to its error callback as well.
+ *
+ * @param[out] records  Array for the records, the newest one first
+ * @param[in]  max      Number of the elements of the @a records
+ * @param[out] count    Number of the records written
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0)
+ *
+ * @see yaca_error_record_s
+ * @see yaca_error_format_record()
+ * @see yaca_error_clear_records()
+ */
+int yaca_error_get_records(yaca_error_record_s *records, size_t max, size_t *count);
+
+/**
+ * @brief  Removes the error records of the calling thread.
+ *
+ * @since_tizen 6.0
+ *
+ * @see yaca_error_get_records()
+ */
+void yaca_error_clear_records(void);
+
+/**
+ * @brief  Formats an error record as text.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  The first line describes the error, every next one an OpenSSL error. If the
+ *           text doesn't fit in the @a buf it is truncated and ends with "...".
+ *
+ * @param[in]  record   Record from yaca_error_get_records()
+ * @param[out] buf      Buffer for the NULL-terminated text
+ * @param[in]  buf_len  Length of the @a buf, at least 5 bytes
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL,
+ *                                       too short @a buf_len)
+ *
+ * @see yaca_error_get_records()
+ */
+int yaca_error_format_record(const yaca_error_record_s *record, char *buf, size_t buf_len);
+
 /**
  * @}
  */
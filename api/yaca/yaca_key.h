@@ -143,6 +143,51 @@ int yaca_key_import(yaca_key_type_e key_type,
                     size_t data_len,
                     yaca_key_h *key);
 
+/**
+ * @brief  Imports an EC key from its raw encoding, without the ASN1 structure.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  The raw encodings don't identify the curve, it has to be given in
+ *           @a key_bit_len, the same as for yaca_key_generate().
+ *
+ * @remarks  For #YACA_KEY_TYPE_EC_PUB the @a data is a SEC1 point, either uncompressed
+ *           (0x04 || X || Y) or compressed (0x02 or 0x03 || X). The point must lie on the curve.
+ *
+ * @remarks  For #YACA_KEY_TYPE_EC_PRIV the @a data is the big-endian private scalar, padded to
+ *           the length of the curve order. The public key is computed from it.
+ *
+ * @remarks  Such keys are exported with yaca_key_export() and #YACA_KEY_FILE_FORMAT_RAW,
+ *           #YACA_KEY_FORMAT_DEFAULT gives an uncompressed point or the private scalar,
+ *           #YACA_KEY_FORMAT_EC_COMPRESSED a compressed point.
+ *
+ * @remarks  The @a key should be released using yaca_key_destroy().
+ *
+ * @param[in]  key_type     #YACA_KEY_TYPE_EC_PUB or #YACA_KEY_TYPE_EC_PRIV
+ * @param[in]  key_bit_len  Curve of the key, one of #yaca_key_bit_length_ec_e
+ * @param[in]  data         Raw key
+ * @param[in]  data_len     Size of the raw key
+ * @param[out] key          Returned key
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a key_type or @a key_bit_len, @a data not
+ *                                       a valid key on the curve)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_key_bit_length_ec_e
+ * @see yaca_key_import()
+ * @see yaca_key_export()
+ * @see yaca_key_destroy()
+ */
+int yaca_key_import_raw(yaca_key_type_e key_type,
+                        size_t key_bit_len,
+                        const char *data,
+                        size_t data_len,
+                        yaca_key_h *key);
+
 /**
  * @brief  Exports a key or key generation parameters to arbitrary format.
  *
@@ -159,9 +204,12 @@ int yaca_key_import(yaca_key_type_e key_type,
  *                                       export to their default ASN1 structure format
  *                                       (e.g. PKCS#1, SSLeay, PKCS#3).
  *           - #YACA_KEY_FORMAT_PKCS8: this will only work for private asymmetric keys.
+ *           - #YACA_KEY_FORMAT_EC_COMPRESSED: this will only work for EC public keys with
+ *                                             #YACA_KEY_FILE_FORMAT_RAW.
  *
  * @remarks  The following file formats are supported:
- *           - #YACA_KEY_FILE_FORMAT_RAW:    used only for symmetric, raw binary format
+ *           - #YACA_KEY_FILE_FORMAT_RAW:    used for symmetric, raw binary format, and for EC
+ *                                           keys, see yaca_key_import_raw()
  *           - #YACA_KEY_FILE_FORMAT_BASE64: used only for symmetric, BASE64 encoded binary form
  *           - #YACA_KEY_FILE_FORMAT_PEM:    used only for asymmetric, PEM file format
  *           - #YACA_KEY_FILE_FORMAT_DER:    used only for asymmetric, DER file format
@@ -359,6 +407,83 @@ int yaca_key_derive_dh(const yaca_key_h prv_key,
                        char **secret,
                        size_t *secret_len);
 
+/**
+ * @brief  Prepares a private key for deriving shared secrets with many peers.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  The derivation is set up once for the @a prv_key, instead of once per peer as with
+ *           yaca_key_derive_dh(). The context keeps its own reference to the @a prv_key, which
+ *           may be released afterwards.
+ *
+ * @remarks  The length of the secrets, the size of the buffers to be passed to
+ *           yaca_key_derive_dh_batch(), can be obtained with yaca_context_get_output_length()
+ *           and @a input_len equal to 0.
+ *
+ * @remarks  The @a ctx should be released using yaca_context_destroy().
+ *
+ * @param[out] ctx      Newly created context
+ * @param[in]  prv_key  Our private key, of DH or EC type
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values
+ *                                       (NULL, invalid @a prv_key)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see yaca_key_derive_dh_batch()
+ * @see yaca_key_derive_dh()
+ * @see yaca_context_get_output_length()
+ * @see yaca_context_destroy()
+ */
+int yaca_key_derive_dh_initialize(yaca_context_h *ctx, const yaca_key_h prv_key);
+
+/**
+ * @brief  Derives shared secrets between the prepared private key and a batch of peers.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  Each secret is the same as the one returned by yaca_key_derive_dh() for the
+ *           private key passed to yaca_key_derive_dh_initialize() and the peer key.
+ *
+ * @remarks  Each @a secrets buffer must be allocated by the client and hold at least the
+ *           length returned by yaca_context_get_output_length() for the @a ctx. The DH secrets
+ *           may be shorter, their lengths are returned in @a secret_lens.
+ *
+ * @remarks  The batch is split evenly between @a threads threads, including the calling one.
+ *           The copies of the derivation context made for them are kept in the @a ctx for the
+ *           next batches. The @a ctx must not be used by other threads meanwhile.
+ *
+ * @remarks  On error the contents of the @a secrets buffers are undefined.
+ *
+ * @param[in]  ctx          Context created by yaca_key_derive_dh_initialize()
+ * @param[in]  pub_keys     Array of @a count peer public keys, of the type matching the
+ *                          private key
+ * @param[in]  count        Number of peers, greater than 0
+ * @param[out] secrets      Array of @a count buffers for the shared secrets
+ * @param[out] secret_lens  Lengths of the shared secrets will be returned here
+ * @param[in]  threads      Number of threads to use, 0 or 1 for the calling thread only,
+ *                          at most 64
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a ctx or @a pub_keys, too many @a threads)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see yaca_key_derive_dh_initialize()
+ * @see yaca_key_derive_dh()
+ * @see yaca_context_get_output_length()
+ */
+int yaca_key_derive_dh_batch(const yaca_context_h ctx,
+                             const yaca_key_h *pub_keys,
+                             size_t count,
+                             char *const *secrets,
+                             size_t *secret_lens,
+                             size_t threads);
+
 /**
  * @brief  Derives a key material from shared secret.
  *
@@ -436,6 +561,96 @@ int yaca_key_derive_pbkdf2(const char *password,
                            size_t key_bit_len,
                            yaca_key_h *key);
 
+/**
+ * @brief  Derives a key from user password (PKCS #5 a.k.a. pbkdf2 algorithm) on many threads.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  The key is the same as the one of yaca_key_derive_pbkdf2(). Its output blocks,
+ *           each as long as the @a algo digest, are independent and are split evenly between
+ *           @a threads threads, including the calling one. A key no longer than the digest
+ *           is derived on the calling thread.
+ *
+ * @remarks  The @a key should be released using yaca_key_destroy().
+ *
+ * @param[in]  password     User password as a null-terminated string
+ * @param[in]  salt         Salt, should be a non-empty string
+ * @param[in]  salt_len     Length of the salt
+ * @param[in]  iterations   Number of iterations
+ * @param[in]  algo         Digest algorithm that should be used in key generation
+ * @param[in]  key_bit_len  Length of a key (in bits) to be generated
+ * @param[out] key          Newly generated key
+ * @param[in]  threads      Number of threads to use, 0 or 1 for the calling thread only,
+ *                          at most 64
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a algo or @a key_bit_len not divisible by 8,
+ *                                       too many @a threads)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_digest_algorithm_e
+ * @see yaca_key_derive_pbkdf2()
+ * @see yaca_key_destroy()
+ */
+int yaca_key_derive_pbkdf2_parallel(const char *password,
+                                    const char *salt,
+                                    size_t salt_len,
+                                    size_t iterations,
+                                    yaca_digest_algorithm_e algo,
+                                    size_t key_bit_len,
+                                    yaca_key_h *key,
+                                    size_t threads);
+
+/**
+ * @brief  Derives keys from a batch of user passwords (PKCS #5 a.k.a. pbkdf2 algorithm).
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  Every key is derived the same way as with yaca_key_derive_pbkdf2(), with the
+ *           same @a iterations, @a algo and @a key_bit_len, e.g. to check many passwords
+ *           against stored hashes at once.
+ *
+ * @remarks  The batch is split evenly between @a threads threads, including the calling one.
+ *
+ * @remarks  The @a keys should be released using yaca_key_destroy(). On error none of them are
+ *           returned.
+ *
+ * @param[in]  passwords    Array of @a count null-terminated passwords
+ * @param[in]  salts        Array of @a count salts, each should be a non-empty string
+ * @param[in]  salt_lens    Lengths of the @a salts
+ * @param[in]  count        Number of passwords, greater than 0
+ * @param[in]  iterations   Number of iterations
+ * @param[in]  algo         Digest algorithm that should be used in key generation
+ * @param[in]  key_bit_len  Length of the keys (in bits) to be generated
+ * @param[out] keys         Array of @a count handles, the derived keys will be returned here
+ * @param[in]  threads      Number of threads to use, 0 or 1 for the calling thread only,
+ *                          at most 64
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a algo or @a key_bit_len not divisible by 8,
+ *                                       too many @a threads)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_digest_algorithm_e
+ * @see yaca_key_derive_pbkdf2()
+ * @see yaca_key_destroy()
+ */
+int yaca_key_derive_pbkdf2_batch(const char *const *passwords,
+                                 const char *const *salts,
+                                 const size_t *salt_lens,
+                                 size_t count,
+                                 size_t iterations,
+                                 yaca_digest_algorithm_e algo,
+                                 size_t key_bit_len,
+                                 yaca_key_h *keys,
+                                 size_t threads);
+
 /**
  * @brief  Release the key created by the library. Passing YACA_KEY_NULL is allowed.
  *
@@ -97,6 +97,11 @@ int yaca_seal_initialize(yaca_context_h *ctx,
 /**
  * @brief  Encrypts piece of the data.
  *
+ * @remarks  The @a ciphertext may point to the same buffer as the @a plaintext to process the data
+ *           in place, for every algorithm and mode. Such buffer must still be as large as
+ *           yaca_context_get_output_length() requires. Buffers that overlap only partially
+ *           are not allowed.
+ *
  * @since_tizen 3.0
  *
  * @param[in,out] ctx             Context created by yaca_seal_initialize()
@@ -110,7 +115,8 @@ int yaca_seal_initialize(yaca_context_h *ctx,
  * @return #YACA_ERROR_NONE on success, negative on error
  * @retval #YACA_ERROR_NONE Successful
  * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
- *                                       invalid @a ctx)
+ *                                       invalid @a ctx, partially overlapping @a plaintext
+ *                                       and @a ciphertext)
  * @retval #YACA_ERROR_INTERNAL Internal error
  *
  * @see yaca_seal_initialize()
@@ -195,6 +201,11 @@ int yaca_open_initialize(yaca_context_h *ctx,
 /**
  * @brief  Decrypts piece of the data.
  *
+ * @remarks  The @a plaintext may point to the same buffer as the @a ciphertext to process the data
+ *           in place, for every algorithm and mode. Such buffer must still be as large as
+ *           yaca_context_get_output_length() requires. Buffers that overlap only partially
+ *           are not allowed.
+ *
  * @since_tizen 3.0
  *
  * @param[in,out] ctx             Context created by yaca_open_initialize()
@@ -208,7 +219,8 @@ int yaca_open_initialize(yaca_context_h *ctx,
  * @return #YACA_ERROR_NONE on success, negative on error
  * @retval #YACA_ERROR_NONE Successful
  * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
- *                                       invalid @a ctx), wrong #YACA_PROPERTY_CCM_AAD or
+ *                                       invalid @a ctx), partially overlapping @a ciphertext
+ *                                       and @a plaintext, wrong #YACA_PROPERTY_CCM_AAD or
  *                                       wrong #YACA_PROPERTY_CCM_TAG was used
  * @retval #YACA_ERROR_INTERNAL Internal error
  *
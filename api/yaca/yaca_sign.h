@@ -154,13 +154,54 @@ int yaca_sign_initialize_cmac(yaca_context_h *ctx,
                               yaca_encrypt_algorithm_e algo,
                               const yaca_key_h sym_key);
 
+/**
+ * @brief  Initializes a signature context for GMAC.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  GMAC is AES-GCM authenticating the message as additional data, with no
+ *           plaintext. The MAC is 16 bytes long and can be truncated by the caller.
+ *
+ * @remarks  An IV must never be used twice with the same key, a repeated IV reveals the
+ *           authentication key and allows forgeries.
+ *
+ * @remarks  For verification, calculate message GMAC and compare with received MAC using
+ *           yaca_memcmp().
+ *
+ * @remarks  The @a ctx should be released using yaca_context_destroy().
+ *
+ * @param[out] ctx      Newly created context
+ * @param[in]  sym_key  AES key that will be used, supported key type:
+ *                      - #YACA_KEY_TYPE_SYMMETRIC
+ * @param[in]  iv       Initialization Vector, 96 bits long is recommended,
+ *                      supported key type:
+ *                      - #YACA_KEY_TYPE_IV
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL,
+ *                                       invalid @a sym_key or @a iv)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_key_type_e
+ * @see yaca_sign_update()
+ * @see yaca_sign_finalize()
+ * @see yaca_memcmp()
+ * @see yaca_context_destroy()
+ */
+int yaca_sign_initialize_gmac(yaca_context_h *ctx,
+                              const yaca_key_h sym_key,
+                              const yaca_key_h iv);
+
 /**
  * @brief  Feeds the message into the digital signature or MAC algorithm.
  *
  * @since_tizen 3.0
  *
  * @param[in,out] ctx          Context created by yaca_sign_initialize(),
- *                             yaca_sign_initialize_hmac() or yaca_sign_initialize_cmac()
+ *                             yaca_sign_initialize_hmac(), yaca_sign_initialize_cmac()
+ *                             or yaca_sign_initialize_gmac()
  * @param[in]     message      Message to be signed
  * @param[in]     message_len  Length of the message
  *
@@ -174,6 +215,7 @@ int yaca_sign_initialize_cmac(yaca_context_h *ctx,
  * @see yaca_sign_finalize()
  * @see yaca_sign_initialize_hmac()
  * @see yaca_sign_initialize_cmac()
+ * @see yaca_sign_initialize_gmac()
  */
 int yaca_sign_update(yaca_context_h ctx,
                      const char *message,
@@ -203,6 +245,7 @@ int yaca_sign_update(yaca_context_h ctx,
  * @see yaca_sign_update()
  * @see yaca_sign_initialize_hmac()
  * @see yaca_sign_initialize_cmac()
+ * @see yaca_sign_initialize_gmac()
  * @see yaca_context_get_output_length()
  */
 int yaca_sign_finalize(yaca_context_h ctx,
@@ -296,6 +339,79 @@ int yaca_verify_finalize(yaca_context_h ctx,
                          const char *signature,
                          size_t signature_len);
 
+/**
+ * @brief  Prepares an RSA private key for repeated use by concurrent threads.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  The first private operation with a key sets up the Montgomery values of its
+ *           modulus and primes and its blinding, this call does it in advance.
+ *
+ * @remarks  OpenSSL shares the blinding of a key between the threads under a lock. For
+ *           @a threads greater than 1 that many private copies of the key are made (up to
+ *           64), each of them prepared the same way. yaca_sign_initialize() and
+ *           yaca_rsa_private_encrypt() / yaca_rsa_private_decrypt() take a copy that
+ *           no other operation uses at the time, or the @a prv_key itself when all of them
+ *           are taken. A sign context keeps its copy until it is destroyed.
+ *
+ * @remarks  The copies are kept until the key is destroyed. Only the first call for a
+ *           key makes them, the next ones do nothing.
+ *
+ * @param[in] prv_key  Private key to be prepared, #YACA_KEY_TYPE_RSA_PRIV
+ * @param[in] threads  Number of threads that are going to use the key at the same time
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0,
+ *                                       invalid @a prv_key)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_key_type_e
+ * @see yaca_sign_initialize()
+ * @see yaca_rsa_private_encrypt()
+ * @see yaca_rsa_private_decrypt()
+ */
+int yaca_sign_prepare_key(const yaca_key_h prv_key, size_t threads);
+
+/**
+ * @brief  Prepares a public key for repeated signature verification.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  Every verify context created with the @a pub_key afterwards, in any thread,
+ *           uses what has been computed here. It is kept until the key is destroyed.
+ *
+ * @remarks  For #YACA_KEY_TYPE_EC_PUB on curves with precomputed generator tables
+ *           (prime256v1) the multiples of the public point are precomputed too, about
+ *           150 kB per key. Verify contexts of such a key accept the DER ECDSA signatures
+ *           only and reject #YACA_DIGEST_MD5 and yaca_context_set_property(). On other
+ *           curves the call does nothing.
+ *
+ * @remarks  For #YACA_KEY_TYPE_RSA_PUB and #YACA_KEY_TYPE_DSA_PUB the Montgomery
+ *           values of the modulus are computed in advance instead of by the first
+ *           verification.
+ *
+ * @remarks  Calling it again for the same key does nothing. It may be called concurrently
+ *           with verifications that use the @a pub_key.
+ *
+ * @param[in] pub_key  Public key to be prepared, supported key types:
+ *                     - #YACA_KEY_TYPE_RSA_PUB,
+ *                     - #YACA_KEY_TYPE_DSA_PUB,
+ *                     - #YACA_KEY_TYPE_EC_PUB
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL,
+ *                                       invalid @a pub_key)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_key_type_e
+ * @see yaca_verify_initialize()
+ */
+int yaca_verify_prepare_key(const yaca_key_h pub_key);
+
 /**
  * @}
  */
@@ -52,7 +52,8 @@ extern "C" {
  *
  * @since_tizen 3.0
  *
- * @remarks  yaca_simple_encrypt() doesn't support #YACA_BCM_GCM and #YACA_BCM_CCM.
+ * @remarks  yaca_simple_encrypt() doesn't support #YACA_BCM_GCM, #YACA_BCM_CCM and
+ *           #YACA_BCM_SIV, see yaca_simple_encrypt_siv() for the latter.
  *
  * @remarks  The @a ciphertext should be freed using yaca_free().
  *
@@ -93,7 +94,8 @@ int yaca_simple_encrypt(yaca_encrypt_algorithm_e algo,
  *
  * @since_tizen 3.0
  *
- * @remarks  yaca_simple_decrypt() doesn't support #YACA_BCM_GCM and #YACA_BCM_CCM.
+ * @remarks  yaca_simple_decrypt() doesn't support #YACA_BCM_GCM, #YACA_BCM_CCM and
+ *           #YACA_BCM_SIV, see yaca_simple_decrypt_siv() for the latter.
  *
  * @remarks  The @a plaintext should be freed using yaca_free().
  *
@@ -321,6 +323,133 @@ int yaca_simple_calculate_cmac(yaca_encrypt_algorithm_e algo,
                                char **mac,
                                size_t *mac_len);
 
+/**
+ * @brief  Calculates a GMAC of given message using AES key and IV.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  An IV must never be used twice with the same key, see
+ *           yaca_sign_initialize_gmac().
+ *
+ * @remarks  For verification, calculate message GMAC and compare with received MAC using
+ *           yaca_memcmp().
+ *
+ * @remarks  The @a mac should be freed using yaca_free().
+ *
+ * @remarks  The @a message can be NULL but then @a message_len must be 0.
+ *
+ * @param[in]  sym_key      AES key that will be used, supported key type:
+ *                          - #YACA_KEY_TYPE_SYMMETRIC
+ * @param[in]  iv           Initialization Vector, supported key type:
+ *                          - #YACA_KEY_TYPE_IV
+ * @param[in]  message      Message to calculate GMAC from
+ * @param[in]  message_len  Length of the message
+ * @param[out] mac          MAC, will be allocated by the library
+ * @param[out] mac_len      Length of the MAC
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0
+ *                                       invalid @a sym_key or @a iv)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #yaca_key_type_e
+ * @see yaca_sign_initialize_gmac()
+ * @see yaca_memcmp()
+ * @see yaca_free()
+ */
+int yaca_simple_calculate_gmac(const yaca_key_h sym_key,
+                               const yaca_key_h iv,
+                               const char *message,
+                               size_t message_len,
+                               char **mac,
+                               size_t *mac_len);
+
+/**
+ * @brief  Encrypts and authenticates data with AES-SIV (#YACA_BCM_SIV).
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  The encryption is deterministic, the same key, AAD and plaintext always give
+ *           the same ciphertext. No Initialization Vector is needed.
+ *
+ * @remarks  The @a ciphertext is the 16 bytes tag followed by the encrypted data, it is
+ *           16 bytes longer than the plaintext.
+ *
+ * @remarks  The @a ciphertext should be freed using yaca_free().
+ *
+ * @remarks  The @a aad can be NULL but then @a aad_len must be 0.
+ *
+ * @remarks  The @a plaintext can be NULL but then @a plaintext_len must be 0.
+ *
+ * @param[in]  sym_key         AES key of 256, 384 or 512 bits, supported key type:
+ *                             - #YACA_KEY_TYPE_SYMMETRIC
+ * @param[in]  aad             Additional authentication data
+ * @param[in]  aad_len         Length of the additional authentication data
+ * @param[in]  plaintext       Plaintext to be encrypted
+ * @param[in]  plaintext_len   Length of the plaintext
+ * @param[out] ciphertext      Tag and encrypted data, will be allocated by the library
+ * @param[out] ciphertext_len  Length of the tag and encrypted data
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0
+ *                                       invalid @a sym_key)
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #YACA_BCM_SIV
+ * @see yaca_simple_decrypt_siv()
+ * @see yaca_free()
+ */
+int yaca_simple_encrypt_siv(const yaca_key_h sym_key,
+                            const char *aad,
+                            size_t aad_len,
+                            const char *plaintext,
+                            size_t plaintext_len,
+                            char **ciphertext,
+                            size_t *ciphertext_len);
+
+/**
+ * @brief  Authenticates and decrypts data encrypted with yaca_simple_encrypt_siv().
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  Nothing is returned for a forged @a ciphertext or @a aad.
+ *
+ * @remarks  The @a plaintext should be freed using yaca_free(). It is NULL when the
+ *           @a ciphertext has only the tag.
+ *
+ * @remarks  The @a aad can be NULL but then @a aad_len must be 0.
+ *
+ * @param[in]  sym_key         AES key that was used to encrypt the data
+ * @param[in]  aad             Additional authentication data that was used to encrypt the data
+ * @param[in]  aad_len         Length of the additional authentication data
+ * @param[in]  ciphertext      Tag and encrypted data, at least 16 bytes
+ * @param[in]  ciphertext_len  Length of the tag and encrypted data
+ * @param[out] plaintext       Decrypted data, will be allocated by the library
+ * @param[out] plaintext_len   Length of the decrypted data
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER Required parameters have incorrect values (NULL, 0
+ *                                       invalid @a sym_key), the authentication failed
+ * @retval #YACA_ERROR_OUT_OF_MEMORY Out of memory error
+ * @retval #YACA_ERROR_INTERNAL Internal error
+ *
+ * @see #YACA_BCM_SIV
+ * @see yaca_simple_encrypt_siv()
+ * @see yaca_free()
+ */
+int yaca_simple_decrypt_siv(const yaca_key_h sym_key,
+                            const char *aad,
+                            size_t aad_len,
+                            const char *ciphertext,
+                            size_t ciphertext_len,
+                            char **plaintext,
+                            size_t *plaintext_len);
+
 /**
  * @}
  */
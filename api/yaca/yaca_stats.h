@@ -0,0 +1,187 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file   yaca_stats.h
+ * @brief  Runtime statistics and counters.
+ */
+
+#ifndef YACA_STATS_H
+#define YACA_STATS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <yaca_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @addtogroup CAPI_YACA_ENCRYPTION_MODULE
+ * @{
+ */
+
+/**
+ * @brief  Enumeration of context types tracked by the statistics.
+ *
+ * @since_tizen 6.0
+ */
+typedef enum {
+	/** Digest contexts */
+	YACA_STATS_CONTEXT_DIGEST = 0,
+	/** Sign, verify, HMAC and CMAC contexts */
+	YACA_STATS_CONTEXT_SIGN,
+	/** Encrypt, decrypt, seal and open contexts */
+	YACA_STATS_CONTEXT_ENCRYPT,
+
+	/** Number of tracked context types */
+	YACA_STATS_CONTEXT_COUNT
+} yaca_stats_context_e;
+
+/**
+ * @brief  Enumeration of failures tracked by the statistics.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  Only the failures of the data and the errors reported by OpenSSL are
+ *           counted. The arguments that a function rejects before doing anything,
+ *           NULL pointers, wrong lengths or calls in a wrong order, are not.
+ */
+typedef enum {
+	/** Ciphertexts, AADs or tags that failed the authentication,
+	 *  reported as #YACA_ERROR_INVALID_PARAMETER */
+	YACA_STATS_FAILURE_AUTHENTICATION = 0,
+	/** Signatures that didn't verify, reported as #YACA_ERROR_DATA_MISMATCH */
+	YACA_STATS_FAILURE_VERIFICATION,
+	/** OpenSSL errors reported as #YACA_ERROR_INVALID_PARAMETER */
+	YACA_STATS_FAILURE_OPENSSL_INVALID_PARAMETER,
+	/** OpenSSL errors reported as #YACA_ERROR_INVALID_PASSWORD */
+	YACA_STATS_FAILURE_INVALID_PASSWORD,
+	/** Failed allocations, reported as #YACA_ERROR_OUT_OF_MEMORY */
+	YACA_STATS_FAILURE_OUT_OF_MEMORY,
+	/** Errors reported as #YACA_ERROR_INTERNAL */
+	YACA_STATS_FAILURE_INTERNAL,
+
+	/** Number of tracked failures */
+	YACA_STATS_FAILURE_COUNT
+} yaca_stats_failure_e;
+
+/**
+ * @brief  Number of entries in the per digest algorithm counters,
+ *         indexed by #yaca_digest_algorithm_e.
+ *
+ * @since_tizen 6.0
+ */
+#define YACA_STATS_DIGEST_COUNT (YACA_DIGEST_SHA512 + 1)
+
+/**
+ * @brief  Number of entries in the per encryption algorithm counters,
+ *         indexed by #yaca_encrypt_algorithm_e.
+ *
+ * @since_tizen 6.0
+ */
+#define YACA_STATS_ENCRYPT_COUNT (YACA_ENCRYPT_CAST5 + 1)
+
+/**
+ * @brief  Snapshot of the library counters.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  All the counters are totals since the library was loaded or
+ *           since the last call to yaca_stats_reset(), aggregated over all
+ *           the threads, including the ones that have already exited.
+ *
+ * @see yaca_stats_snapshot()
+ */
+typedef struct {
+	/** Successful context initializations, indexed by #yaca_stats_context_e */
+	uint64_t initialized[YACA_STATS_CONTEXT_COUNT];
+	/** Successful context updates, indexed by #yaca_stats_context_e */
+	uint64_t updated[YACA_STATS_CONTEXT_COUNT];
+	/** Successful context finalizations, indexed by #yaca_stats_context_e */
+	uint64_t finalized[YACA_STATS_CONTEXT_COUNT];
+	/** Bytes hashed, signed or verified, indexed by #yaca_digest_algorithm_e */
+	uint64_t digest_bytes[YACA_STATS_DIGEST_COUNT];
+	/** Bytes en/decrypted or CMAC'ed, indexed by #yaca_encrypt_algorithm_e */
+	uint64_t cipher_bytes[YACA_STATS_ENCRYPT_COUNT];
+	/** Bytes produced by the random number generator */
+	uint64_t rng_bytes;
+	/** System calls made by the random number generator */
+	uint64_t rng_syscalls;
+	/** Memory allocations made with yaca_malloc() and friends */
+	uint64_t allocations;
+	/** Failures reported by the library, indexed by #yaca_stats_failure_e */
+	uint64_t failures[YACA_STATS_FAILURE_COUNT];
+} yaca_stats_s;
+
+/**
+ * @brief  Enables or disables gathering of the statistics.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  The statistics are disabled by default. When disabled the
+ *           counters cost a single relaxed load per tracked event.
+ *
+ * @remarks  The counters are not cleared when the statistics are disabled.
+ *
+ * @param[in] enabled  Whether the statistics should be gathered
+ *
+ * @see yaca_stats_snapshot()
+ * @see yaca_stats_reset()
+ */
+void yaca_stats_set_enabled(bool enabled);
+
+/**
+ * @brief  Aggregates the counters of all the threads.
+ *
+ * @since_tizen 6.0
+ *
+ * @remarks  The snapshot is not atomic with respect to the threads that are
+ *           updating their counters at the same time, each counter on its own
+ *           is consistent though.
+ *
+ * @param[out] stats  The aggregated counters
+ *
+ * @return #YACA_ERROR_NONE on success, negative on error
+ * @retval #YACA_ERROR_NONE Successful
+ * @retval #YACA_ERROR_INVALID_PARAMETER @a stats is NULL
+ *
+ * @see #yaca_stats_s
+ * @see yaca_stats_reset()
+ */
+int yaca_stats_snapshot(yaca_stats_s *stats);
+
+/**
+ * @brief  Resets all the counters to zero.
+ *
+ * @since_tizen 6.0
+ *
+ * @see yaca_stats_snapshot()
+ */
+void yaca_stats_reset(void);
+
+/**
+ * @}
+ */
+
+#ifdef __cplusplus
+} /* extern */
+#endif
+
+#endif /* YACA_STATS_H */
@@ -166,7 +166,9 @@ typedef enum {
 	/** Key is either PKCS#1 for RSA or SSLeay for DSA, also use this option for symmetric */
 	YACA_KEY_FORMAT_DEFAULT,
 	/** Key is in PKCS#8, can only be used for asymmetric private keys */
-	YACA_KEY_FORMAT_PKCS8
+	YACA_KEY_FORMAT_PKCS8,
+	/** EC public key as a compressed SEC1 point, only with #YACA_KEY_FILE_FORMAT_RAW */
+	YACA_KEY_FORMAT_EC_COMPRESSED
 } yaca_key_format_e;
 
 /**
@@ -175,7 +177,7 @@ typedef enum {
  * @since_tizen 3.0
  */
 typedef enum {
-	/** Key file is in raw binary format, used for symmetric keys */
+	/** Key file is in raw binary format, used for symmetric keys and raw EC keys */
 	YACA_KEY_FILE_FORMAT_RAW,
 	/** Key file is encoded in ASCII-base64, used for symmetric keys */
 	YACA_KEY_FILE_FORMAT_BASE64,
@@ -488,7 +490,10 @@ typedef enum {
 	 * #YACA_BCM_GCM,\n
 	 * #YACA_BCM_CCM,\n
 	 * #YACA_BCM_CTR,\n
-	 * #YACA_BCM_WRAP
+	 * #YACA_BCM_WRAP,\n
+	 * #YACA_BCM_CBC_HMAC_SHA1,\n
+	 * #YACA_BCM_CBC_HMAC_SHA256,\n
+	 * #YACA_BCM_SIV (with a @c 256, @c 384 or @c 512 bits key)
 	 * - see #yaca_block_cipher_mode_e for details on additional properties (mandatory).
 	 */
 	YACA_ENCRYPT_AES = 0,
@@ -747,7 +752,94 @@ typedef enum {
 	 * #YACA_ENCRYPT_3DES_3TDEA allows wrapping only one key.
 	 *
 	 */
-	YACA_BCM_WRAP
+	YACA_BCM_WRAP,
+
+	/**
+	 * CBC encryption followed by HMAC-SHA1 of the ciphertext (encrypt-then-MAC), AES only.
+	 * The ciphertext is authenticated while it is produced / consumed, in a single
+	 * pass over the data.\n
+	 * 128-bit Initialization Vector is mandatory. Padding works as in #YACA_BCM_CBC.\n
+	 * The tag is HMAC(IV || AAD || ciphertext || AL), AL being the AAD length in bits
+	 * as a 64-bit big endian number, as in RFC 7518 but with the IV first. The IV
+	 * can't be modified and no bytes can be moved between the AAD and the ciphertext
+	 * without the tag check failing.\n\n
+	 *
+	 * Supported properties:
+	 * - #YACA_PROPERTY_CBC_HMAC_KEY = HMAC key (mandatory)\n
+	 *   Any positive length, independent of the encryption key.\n
+	 *   Set after yaca_encrypt_initialize() / yaca_seal_initialize() /
+	 *   yaca_decrypt_initialize() / yaca_open_initialize() and before any other
+	 *   property or update.\n\n
+	 *
+	 * - #YACA_PROPERTY_CBC_HMAC_AAD = additional authentication data (optional)\n
+	 *   AAD length can have any positive value, it can be set more than once.\n
+	 *   Set after #YACA_PROPERTY_CBC_HMAC_KEY and before yaca_encrypt_update() /
+	 *   yaca_seal_update() / yaca_decrypt_update() / yaca_open_update().\n\n
+	 *
+	 * - #YACA_PROPERTY_CBC_HMAC_TAG = HMAC tag\n
+	 *   Get after yaca_encrypt_finalize() / yaca_seal_finalize() in encryption / seal
+	 *   operation, it has the full length of the digest (20 bytes).\n
+	 *   Set after yaca_decrypt_update() / yaca_open_update() and before
+	 *   yaca_decrypt_finalize() / yaca_open_finalize() in decryption / open operation.
+	 *   A tag truncated to at least half of the digest length is accepted.\n\n
+	 *
+	 * .
+	 * yaca_decrypt_finalize() / yaca_open_finalize() compares the tag before it checks
+	 * the padding. Like with #YACA_BCM_GCM the decrypted data must not be used before
+	 * it succeeds.
+	 *
+	 * @since_tizen 6.0
+	 *
+	 * @see yaca_context_set_property()
+	 * @see yaca_context_get_property()
+	 */
+	YACA_BCM_CBC_HMAC_SHA1,
+
+	/**
+	 * The same as #YACA_BCM_CBC_HMAC_SHA1 with HMAC-SHA256, the tag is 32 bytes long.
+	 *
+	 * @since_tizen 6.0
+	 */
+	YACA_BCM_CBC_HMAC_SHA256,
+
+	/**
+	 * Synthetic Initialization Vector mode (RFC 5297), AES only. A deterministic
+	 * authenticated encryption: the same key, AAD and plaintext always give the same
+	 * ciphertext and tag, which only reveals that two messages are equal.\n
+	 * The key is twice as long as the AES key (256, 384 or 512 bits), its first half
+	 * is the S2V (CMAC) key and the second half the CTR key.\n
+	 * Initialization Vector is not used, pass #YACA_KEY_NULL. The tag is the synthetic
+	 * IV of the CTR, it is always 16 bytes long. The ciphertext is as long as the
+	 * plaintext.\n\n
+	 *
+	 * Supported properties:
+	 * - #YACA_PROPERTY_SIV_AAD = additional authentication data (optional)\n
+	 *   Every value is a separate AAD component of RFC 5297, it can be set more than once
+	 *   and the order matters.\n
+	 *   Set after yaca_encrypt_initialize() and before yaca_encrypt_update() in
+	 *   encryption operation.\n
+	 *   Set after #YACA_PROPERTY_SIV_TAG and before yaca_decrypt_update() in decryption
+	 *   operation.\n\n
+	 *
+	 * - #YACA_PROPERTY_SIV_TAG = SIV tag\n
+	 *   Get after yaca_encrypt_finalize() in encryption operation.\n
+	 *   Set after yaca_decrypt_initialize() and before any AAD or yaca_decrypt_update()
+	 *   in decryption operation.\n\n
+	 *
+	 * .
+	 * Only a single yaca_encrypt_update() / yaca_decrypt_update() is allowed, it can be
+	 * omitted for an empty message. yaca_decrypt_update() authenticates the message and
+	 * returns #YACA_ERROR_INVALID_PARAMETER with a cleared output if it is forged.
+	 *
+	 * Usage in yaca_seal_initialize() / yaca_open_initialize() and in the simple
+	 * encryption functions is forbidden.
+	 *
+	 * @since_tizen 6.0
+	 *
+	 * @see yaca_context_set_property()
+	 * @see yaca_context_get_property()
+	 */
+	YACA_BCM_SIV
 
 } yaca_block_cipher_mode_e;
 
@@ -783,6 +875,60 @@ typedef enum {
 
 	/** RC2 effective key bits, 1-1024, 1 bit resolution. Property type is size_t. */
 	YACA_PROPERTY_RC2_EFFECTIVE_KEY_BITS,
+
+	/**
+	 * CBC-HMAC HMAC key. Property type is a buffer (e.g. char*)
+	 *
+	 * @since_tizen 6.0
+	 */
+	YACA_PROPERTY_CBC_HMAC_KEY,
+	/**
+	 * CBC-HMAC Additional Authentication Data. Property type is a buffer (e.g. char*)
+	 *
+	 * @since_tizen 6.0
+	 */
+	YACA_PROPERTY_CBC_HMAC_AAD,
+	/**
+	 * CBC-HMAC Tag. Property type is a buffer (e.g. char*)
+	 *
+	 * @since_tizen 6.0
+	 */
+	YACA_PROPERTY_CBC_HMAC_TAG,
+
+	/**
+	 * SIV Additional Authentication Data, one component per value. Property type is
+	 * a buffer (e.g. char*)
+	 *
+	 * @since_tizen 6.0
+	 */
+	YACA_PROPERTY_SIV_AAD,
+	/**
+	 * SIV Tag. Property type is a buffer (e.g. char*)
+	 *
+	 * @since_tizen 6.0
+	 */
+	YACA_PROPERTY_SIV_TAG,
+
+	/**
+	 * Digest algorithm for the plaintext of the encrypt/decrypt operation. Property type is
+	 * #yaca_digest_algorithm_e.
+	 *
+	 * The plaintext is hashed as it passes through the *_update() calls, each chunk
+	 * while it is still in the cache. Set after *_initialize() and before any other
+	 * property or *_update() call.
+	 *
+	 * @since_tizen 6.0
+	 */
+	YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO,
+	/**
+	 * Digest of the plaintext of the encrypt/decrypt operation. Property type is a buffer
+	 * (e.g. char*)
+	 *
+	 * Get after *_finalize() if #YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO was set.
+	 *
+	 * @since_tizen 6.0
+	 */
+	YACA_PROPERTY_PLAINTEXT_DIGEST,
 } yaca_property_e;
 
 /**
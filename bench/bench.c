@@ -0,0 +1,495 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench.c
+ * @brief YACA benchmark driver
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <time.h>
+
+#include <openssl/crypto.h>
+
+#include <yaca_crypto.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+#define MAX_SAMPLES ((size_t)1 << 16)
+#define DEFAULT_MAX_SIZE ((size_t)1 << 20)
+
+const size_t BENCH_SIZES[] = {
+	16, 64, 256, 1024, 4096, 16384, 65536, 262144,
+	1048576, 4194304, 16777216, 67108864
+};
+const size_t BENCH_SIZES_COUNT = sizeof(BENCH_SIZES) / sizeof(BENCH_SIZES[0]);
+
+char *bench_input = NULL;
+char *bench_output = NULL;
+
+static const struct bench_suite SUITES[] = {
+	{"digest",  "message digests, simple and streaming",              bench_digest},
+	{"encrypt", "every supported cipher, encrypt and decrypt",        bench_encrypt},
+	{"record",  "small record updates on a long lived context",        bench_record},
+	{"seal",    "RSA envelope seal and open",                          bench_seal},
+	{"sign",    "RSA, DSA and EC signatures, sign and verify",         bench_sign},
+	{"mac",     "HMAC, CMAC and GMAC",                                 bench_mac},
+	{"rsa",     "raw RSA public/private encrypt and decrypt",          bench_rsa},
+	{"key",     "key generation and derivation",                       bench_key},
+	{"pbkdf2",  "PBKDF2 at 100k iterations, single and batched",       bench_pbkdf2},
+	{"ecdh",    "ECDH with one key against 64 peers, single and batched", bench_ecdh},
+	{"init",    "context initialization latency",                      bench_init},
+	{"threads", "context initialization scaling over threads",         bench_threads},
+	{"rotation", "KEK rotation of a keystore, per key and batched",     bench_rotation},
+	{"forgery", "rejected AEAD tags and signatures against valid ones", bench_forgery},
+	{"aead",    "short AEAD records, per context and batched",          bench_aead},
+	{"etm",     "AES-CBC encrypt-then-HMAC, composite and two contexts", bench_etm},
+	{"hashed",  "AES encrypt-and-hash, attached digest and two contexts", bench_hashed},
+	{"cpp",     "C++ API overhead against the C API",                   bench_cpp},
+};
+
+static const size_t SUITES_COUNT = sizeof(SUITES) / sizeof(SUITES[0]);
+
+static struct {
+	size_t max_size;
+	double min_time;
+	size_t min_iters;
+	bool json;
+	bool allocs_counted;
+	size_t rows;
+} config = {
+	.max_size = DEFAULT_MAX_SIZE,
+	.min_time = 0.1,
+	.min_iters = 3,
+};
+
+static uint64_t *samples = NULL;
+
+static atomic_size_t alloc_count;
+
+static void *count_malloc(size_t num, const char *file, int line)
+{
+	(void)file;
+	(void)line;
+
+	atomic_fetch_add_explicit(&alloc_count, 1, memory_order_relaxed);
+	return malloc(num);
+}
+
+static void *count_realloc(void *addr, size_t num, const char *file, int line)
+{
+	(void)file;
+	(void)line;
+
+	atomic_fetch_add_explicit(&alloc_count, 1, memory_order_relaxed);
+	return realloc(addr, num);
+}
+
+static void count_free(void *addr, const char *file, int line)
+{
+	(void)file;
+	(void)line;
+
+	free(addr);
+}
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int cmp_u64(const void *a, const void *b)
+{
+	uint64_t x = *(const uint64_t *)a;
+	uint64_t y = *(const uint64_t *)b;
+
+	return (x > y) - (x < y);
+}
+
+size_t bench_max_size(void)
+{
+	return config.max_size;
+}
+
+double bench_min_time(void)
+{
+	return config.min_time;
+}
+
+static void print_header(void)
+{
+	if (config.json)
+		printf("[");
+	else
+		printf("%-8s %-24s %-10s %-6s %10s %10s %12s %10s %12s %12s %10s\n",
+		       "suite", "name", "op", "api", "size", "iters",
+		       "ops/s", "MB/s", "p50 ns", "p99 ns", "allocs/op");
+}
+
+static void print_footer(void)
+{
+	if (config.json)
+		printf("%s]\n", config.rows > 0 ? "\n" : "");
+}
+
+static void print_row_prefix(const char *suite, const char *name, const char *op,
+                             const char *api, size_t size)
+{
+	if (config.json)
+		printf("%s\n  {\"suite\": \"%s\", \"name\": \"%s\", \"op\": \"%s\", \"api\": \"%s\", "
+		       "\"size\": %zu",
+		       config.rows > 0 ? "," : "", suite, name, op, api, size);
+	else
+		printf("%-8s %-24s %-10s %-6s %10zu", suite, name, op, api, size);
+
+	config.rows++;
+}
+
+void bench_fail(const char *suite, const char *name, const char *op, const char *api,
+                size_t size, int error)
+{
+	print_row_prefix(suite, name, op, api, size);
+
+	if (config.json)
+		printf(", \"error\": %d}", error);
+	else
+		printf(" failed with %d\n", error);
+	fflush(stdout);
+}
+
+static void print_result(const char *suite, const char *name, const char *op,
+                         const char *api, size_t size, size_t n, uint64_t elapsed,
+                         bool latency, uint64_t p50, uint64_t p99, size_t allocs)
+{
+	double seconds = (double)elapsed / 1e9;
+	double ops = (double)n / seconds;
+	double mbs = ops * (double)size / 1e6;
+	double allocs_per_op = (double)allocs / (double)n;
+	bool allocs_counted = config.allocs_counted && latency;
+
+	print_row_prefix(suite, name, op, api, size);
+	if (config.json) {
+		printf(", \"iterations\": %zu, \"ops_per_sec\": %.2f, ", n, ops);
+		if (size > 0)
+			printf("\"mb_per_sec\": %.2f, ", mbs);
+		else
+			printf("\"mb_per_sec\": null, ");
+		if (latency)
+			printf("\"p50_ns\": %llu, \"p99_ns\": %llu, ",
+			       (unsigned long long)p50, (unsigned long long)p99);
+		else
+			printf("\"p50_ns\": null, \"p99_ns\": null, ");
+		if (allocs_counted)
+			printf("\"allocs_per_op\": %.2f}", allocs_per_op);
+		else
+			printf("\"allocs_per_op\": null}");
+	} else {
+		printf(" %10zu %12.1f ", n, ops);
+		if (size > 0)
+			printf("%10.2f", mbs);
+		else
+			printf("%10s", "-");
+		if (latency)
+			printf(" %12llu %12llu ", (unsigned long long)p50, (unsigned long long)p99);
+		else
+			printf(" %12s %12s ", "-", "-");
+		if (allocs_counted)
+			printf("%10.2f\n", allocs_per_op);
+		else
+			printf("%10s\n", "-");
+	}
+	fflush(stdout);
+}
+
+void bench_run(const char *suite, const char *name, const char *op, const char *api,
+               size_t size, bench_op_fn fn, void *arg)
+{
+	int ret;
+	size_t n = 0;
+	size_t allocs;
+	uint64_t start, elapsed = 0;
+	uint64_t p50, p99;
+
+	/* warm up, also catches setups that don't work at all */
+	ret = fn(arg);
+	if (ret != YACA_ERROR_NONE) {
+		bench_fail(suite, name, op, api, size, ret);
+		return;
+	}
+
+	allocs = atomic_load(&alloc_count);
+	start = now_ns();
+	while (n < MAX_SAMPLES &&
+	       (n < config.min_iters || elapsed < (uint64_t)(config.min_time * 1e9))) {
+		uint64_t t0 = now_ns();
+		ret = fn(arg);
+		uint64_t t1 = now_ns();
+
+		if (ret != YACA_ERROR_NONE) {
+			bench_fail(suite, name, op, api, size, ret);
+			return;
+		}
+
+		samples[n++] = t1 - t0;
+		elapsed = t1 - start;
+	}
+	allocs = atomic_load(&alloc_count) - allocs;
+
+	qsort(samples, n, sizeof(samples[0]), cmp_u64);
+	p50 = samples[n / 2];
+	p99 = samples[(n * 99) / 100 < n ? (n * 99) / 100 : n - 1];
+
+	print_result(suite, name, op, api, size, n, elapsed, true, p50, p99, allocs);
+}
+
+void bench_report(const char *suite, const char *name, const char *op, const char *api,
+                  size_t size, size_t iterations, uint64_t elapsed_ns)
+{
+	print_result(suite, name, op, api, size, iterations, elapsed_ns, false, 0, 0, 0);
+}
+
+const char *bench_digest_name(yaca_digest_algorithm_e algo)
+{
+	switch (algo) {
+	case YACA_DIGEST_MD5:
+		return "MD5";
+	case YACA_DIGEST_SHA1:
+		return "SHA1";
+	case YACA_DIGEST_SHA224:
+		return "SHA224";
+	case YACA_DIGEST_SHA256:
+		return "SHA256";
+	case YACA_DIGEST_SHA384:
+		return "SHA384";
+	case YACA_DIGEST_SHA512:
+		return "SHA512";
+	default:
+		return "?";
+	}
+}
+
+const char *bench_cipher_name(yaca_encrypt_algorithm_e algo, yaca_block_cipher_mode_e bcm,
+                              size_t key_bit_len, char *buf, size_t buf_len)
+{
+	static const char *ALGO_NAMES[] = {
+		[YACA_ENCRYPT_AES] = "AES",
+		[YACA_ENCRYPT_UNSAFE_DES] = "DES",
+		[YACA_ENCRYPT_UNSAFE_3DES_2TDEA] = "3DES-2TDEA",
+		[YACA_ENCRYPT_3DES_3TDEA] = "3DES-3TDEA",
+		[YACA_ENCRYPT_UNSAFE_RC2] = "RC2",
+		[YACA_ENCRYPT_UNSAFE_RC4] = "RC4",
+		[YACA_ENCRYPT_CAST5] = "CAST5",
+	};
+	static const char *BCM_NAMES[] = {
+		[YACA_BCM_NONE] = "",
+		[YACA_BCM_ECB] = "-ECB",
+		[YACA_BCM_CTR] = "-CTR",
+		[YACA_BCM_CBC] = "-CBC",
+		[YACA_BCM_GCM] = "-GCM",
+		[YACA_BCM_CFB] = "-CFB",
+		[YACA_BCM_CFB1] = "-CFB1",
+		[YACA_BCM_CFB8] = "-CFB8",
+		[YACA_BCM_OFB] = "-OFB",
+		[YACA_BCM_CCM] = "-CCM",
+		[YACA_BCM_WRAP] = "-WRAP",
+		[YACA_BCM_CBC_HMAC_SHA1] = "-CBC-HMAC-SHA1",
+		[YACA_BCM_CBC_HMAC_SHA256] = "-CBC-HMAC-SHA256",
+		[YACA_BCM_SIV] = "-SIV",
+	};
+
+	if (algo == YACA_ENCRYPT_AES)
+		snprintf(buf, buf_len, "%s-%zu%s", ALGO_NAMES[algo], key_bit_len, BCM_NAMES[bcm]);
+	else
+		snprintf(buf, buf_len, "%s%s", ALGO_NAMES[algo], BCM_NAMES[bcm]);
+
+	return buf;
+}
+
+int bench_feed(yaca_context_h ctx, int (*update)(yaca_context_h, const char *, size_t),
+               const char *input, size_t input_len)
+{
+	int ret;
+
+	while (input_len > 0) {
+		size_t len = input_len < BENCH_CHUNK ? input_len : BENCH_CHUNK;
+
+		ret = update(ctx, input, len);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+
+		input += len;
+		input_len -= len;
+	}
+
+	return YACA_ERROR_NONE;
+}
+
+int bench_feed_out(yaca_context_h ctx,
+                   int (*update)(yaca_context_h, const char *, size_t, char *, size_t *),
+                   const char *input, size_t input_len, size_t chunk,
+                   char *output, size_t *output_len)
+{
+	int ret;
+	size_t written = 0;
+
+	while (input_len > 0) {
+		size_t len = input_len < chunk ? input_len : chunk;
+		size_t out_len;
+
+		ret = update(ctx, input, len, output + written, &out_len);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+
+		written += out_len;
+		input += len;
+		input_len -= len;
+	}
+
+	*output_len = written;
+	return YACA_ERROR_NONE;
+}
+
+static int parse_size(const char *str, size_t *size)
+{
+	char *end;
+	unsigned long long val = strtoull(str, &end, 10);
+
+	if (end == str)
+		return -1;
+
+	switch (*end) {
+	case 'k':
+	case 'K':
+		val <<= 10;
+		end++;
+		break;
+	case 'm':
+	case 'M':
+		val <<= 20;
+		end++;
+		break;
+	default:
+		break;
+	}
+
+	if (*end != '\0' || val == 0)
+		return -1;
+
+	*size = val;
+	return 0;
+}
+
+static void usage(const char *name)
+{
+	printf("Usage: %s [options] [suite...]\n\n", name);
+	printf("Options:\n");
+	printf("  --json            print the results as a JSON array\n");
+	printf("  --max-size SIZE   largest input size swept, K and M suffixes allowed\n");
+	printf("                    (default 1M, at most 64M)\n");
+	printf("  --min-time SEC    minimal measurement time per row (default 0.1)\n");
+	printf("  --min-iters N     minimal number of iterations per row (default 3)\n");
+	printf("  --help            print this message\n\n");
+	printf("Suites (all by default):\n");
+	for (size_t i = 0; i < SUITES_COUNT; ++i)
+		printf("  %-10s %s\n", SUITES[i].name, SUITES[i].description);
+}
+
+int main(int argc, char *argv[])
+{
+	int ret = EXIT_FAILURE;
+	bool selected[sizeof(SUITES) / sizeof(SUITES[0])] = {false};
+	bool any_selected = false;
+
+	/* has to happen before OpenSSL allocates anything */
+	config.allocs_counted = CRYPTO_set_mem_functions(count_malloc, count_realloc, count_free) == 1;
+
+	for (int i = 1; i < argc; ++i) {
+		if (strcmp(argv[i], "--json") == 0) {
+			config.json = true;
+		} else if (strcmp(argv[i], "--max-size") == 0 && i + 1 < argc) {
+			if (parse_size(argv[++i], &config.max_size) != 0 ||
+			    config.max_size > BENCH_SIZES[BENCH_SIZES_COUNT - 1]) {
+				fprintf(stderr, "Invalid size: %s\n", argv[i]);
+				return EXIT_FAILURE;
+			}
+		} else if (strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+			config.min_time = atof(argv[++i]);
+		} else if (strcmp(argv[i], "--min-iters") == 0 && i + 1 < argc) {
+			config.min_iters = strtoul(argv[++i], NULL, 10);
+		} else if (strcmp(argv[i], "--help") == 0) {
+			usage(argv[0]);
+			return EXIT_SUCCESS;
+		} else {
+			size_t s;
+			for (s = 0; s < SUITES_COUNT; ++s) {
+				if (strcmp(argv[i], SUITES[s].name) == 0) {
+					selected[s] = true;
+					any_selected = true;
+					break;
+				}
+			}
+			if (s == SUITES_COUNT) {
+				fprintf(stderr, "Unknown argument: %s\n\n", argv[i]);
+				usage(argv[0]);
+				return EXIT_FAILURE;
+			}
+		}
+	}
+
+	if (config.min_iters == 0)
+		config.min_iters = 1;
+
+	if (yaca_initialize() != YACA_ERROR_NONE)
+		return EXIT_FAILURE;
+
+	samples = malloc(MAX_SAMPLES * sizeof(samples[0]));
+	bench_input = malloc(config.max_size);
+	bench_output = malloc(config.max_size + BENCH_OUTPUT_SLACK);
+	if (samples == NULL || bench_input == NULL || bench_output == NULL)
+		goto exit;
+
+	if (yaca_randomize_bytes(bench_input, config.max_size) != YACA_ERROR_NONE)
+		goto exit;
+
+	print_header();
+	for (size_t s = 0; s < SUITES_COUNT; ++s)
+		if (!any_selected || selected[s])
+			SUITES[s].run();
+	print_footer();
+
+	ret = EXIT_SUCCESS;
+
+exit:
+	free(samples);
+	free(bench_input);
+	free(bench_output);
+
+	yaca_cleanup();
+	return ret;
+}
@@ -0,0 +1,116 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench.h
+ * @brief Common definitions for the YACA benchmarks
+ */
+
+#ifndef BENCH_H
+#define BENCH_H
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <yaca_types.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Streaming rows feed the input in chunks of this size */
+#define BENCH_CHUNK ((size_t)16384)
+
+/* Extra room in the output buffer for padding, tags etc. */
+#define BENCH_OUTPUT_SLACK ((size_t)1024)
+
+/* A single benchmarked operation, returns YACA_ERROR_NONE on success */
+typedef int (*bench_op_fn)(void *arg);
+
+struct bench_suite {
+	const char *name;
+	const char *description;
+	void (*run)(void);
+};
+
+/* Data sizes swept by the size dependent suites (16 B - 64 MB) */
+extern const size_t BENCH_SIZES[];
+extern const size_t BENCH_SIZES_COUNT;
+
+/* Random input of bench_max_size() bytes and an output buffer of
+ * bench_max_size() + BENCH_OUTPUT_SLACK bytes, shared by all suites.
+ */
+extern char *bench_input;
+extern char *bench_output;
+
+size_t bench_max_size(void);
+double bench_min_time(void);
+
+/* Runs fn(arg) repeatedly and reports a single result row. The size is
+ * the number of bytes processed by one call, 0 if not applicable.
+ */
+void bench_run(const char *suite, const char *name, const char *op, const char *api,
+               size_t size, bench_op_fn fn, void *arg);
+
+/* Reports a row measured by the suite itself, without latency percentiles
+ * and allocation counts. Used by the multi-threaded suites.
+ */
+void bench_report(const char *suite, const char *name, const char *op, const char *api,
+                  size_t size, size_t iterations, uint64_t elapsed_ns);
+
+/* Reports a row that couldn't be run because its setup failed */
+void bench_fail(const char *suite, const char *name, const char *op, const char *api,
+                size_t size, int error);
+
+const char *bench_digest_name(yaca_digest_algorithm_e algo);
+const char *bench_cipher_name(yaca_encrypt_algorithm_e algo, yaca_block_cipher_mode_e bcm,
+                              size_t key_bit_len, char *buf, size_t buf_len);
+
+/* Feeds the input in BENCH_CHUNK sized pieces */
+int bench_feed(yaca_context_h ctx, int (*update)(yaca_context_h, const char *, size_t),
+               const char *input, size_t input_len);
+int bench_feed_out(yaca_context_h ctx,
+                   int (*update)(yaca_context_h, const char *, size_t, char *, size_t *),
+                   const char *input, size_t input_len, size_t chunk,
+                   char *output, size_t *output_len);
+
+void bench_digest(void);
+void bench_encrypt(void);
+void bench_record(void);
+void bench_seal(void);
+void bench_sign(void);
+void bench_mac(void);
+void bench_rsa(void);
+void bench_key(void);
+void bench_pbkdf2(void);
+void bench_ecdh(void);
+void bench_init(void);
+void bench_threads(void);
+void bench_rotation(void);
+void bench_forgery(void);
+void bench_aead(void);
+void bench_etm(void);
+void bench_hashed(void);
+void bench_cpp(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* BENCH_H */
@@ -0,0 +1,331 @@
+/*
+ *  Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_aead.c
+ * @brief Batch AEAD benchmarks
+ *
+ * Short records, each with its own IV and AAD, sealed and opened with a
+ * context per record ("context" rows) and with the batch functions. The
+ * rows are reported per record, so ops/s is the number of records per
+ * second. SIV has no IV, its double length key runs the same AES-128 as
+ * the other modes.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <yaca_crypto.h>
+#include <yaca_encrypt.h>
+#include <yaca_key.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+#define AEAD_RECORDS 256
+#define AEAD_MAX_RECORD_LEN 512
+#define AEAD_IV_LEN 12
+#define AEAD_TAG_LEN 16
+#define AEAD_AAD_LEN 16
+
+static const size_t AEAD_RECORD_LENS[] = {64, 256, 512};
+static const size_t AEAD_THREADS[] = {1, 4};
+
+static const struct {
+	yaca_block_cipher_mode_e bcm;
+	size_t key_bit_len;
+} AEAD_MODES[] = {
+	{YACA_BCM_GCM, YACA_KEY_LENGTH_UNSAFE_128BIT},
+	{YACA_BCM_CCM, YACA_KEY_LENGTH_UNSAFE_128BIT},
+	{YACA_BCM_SIV, YACA_KEY_LENGTH_256BIT},
+};
+
+struct aead_arg {
+	yaca_block_cipher_mode_e bcm;
+	size_t key_bit_len;
+	yaca_key_h key;
+	/* 0 for a context per record */
+	size_t threads;
+	bool seal;
+	yaca_aead_record_s records[AEAD_RECORDS];
+	char ivs[AEAD_RECORDS][AEAD_IV_LEN];
+	char tags[AEAD_RECORDS][AEAD_TAG_LEN];
+	char sealed[AEAD_RECORDS][AEAD_MAX_RECORD_LEN];
+	char opened[AEAD_RECORDS][AEAD_MAX_RECORD_LEN];
+};
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static int siv_context_record(const struct aead_arg *a, const yaca_aead_record_s *r)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t written, final_len, tag_len;
+
+	if (a->seal)
+		ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, YACA_KEY_NULL);
+	else
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, YACA_KEY_NULL);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	/* the synthetic IV is needed before the ciphertext */
+	if (!a->seal) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_TAG, r->tag, AEAD_TAG_LEN);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, r->aad, r->aad_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (a->seal)
+		ret = yaca_encrypt_update(ctx, r->input, r->input_len, r->output, &written);
+	else
+		ret = yaca_decrypt_update(ctx, r->input, r->input_len, r->output, &written);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (a->seal) {
+		ret = yaca_encrypt_finalize(ctx, r->output + written, &final_len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_SIV_TAG, r->tag, AEAD_TAG_LEN,
+		                                     &tag_len);
+	} else {
+		ret = yaca_decrypt_finalize(ctx, r->output + written, &final_len);
+	}
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+/* Initialization, AAD, update, finalization and the tag, as without the batch */
+static int aead_context_record(const struct aead_arg *a, const yaca_aead_record_s *r)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_key_h iv = YACA_KEY_NULL;
+	bool ccm = a->bcm == YACA_BCM_CCM;
+	yaca_property_e tag_property = ccm ? YACA_PROPERTY_CCM_TAG : YACA_PROPERTY_GCM_TAG;
+	size_t written, final_len, tag_len;
+
+	ret = yaca_key_import(YACA_KEY_TYPE_IV, NULL, r->iv, AEAD_IV_LEN, &iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (a->seal)
+		ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, iv);
+	else
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (ccm) {
+		if (a->seal)
+			ret = yaca_context_set_property(ctx, YACA_PROPERTY_CCM_TAG_LEN,
+			                                &(size_t){AEAD_TAG_LEN}, sizeof(size_t));
+		else
+			ret = yaca_context_set_property(ctx, YACA_PROPERTY_CCM_TAG, r->tag, AEAD_TAG_LEN);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		/* CCM needs the total length before the AAD */
+		if (a->seal)
+			ret = yaca_encrypt_update(ctx, NULL, r->input_len, NULL, &written);
+		else
+			ret = yaca_decrypt_update(ctx, NULL, r->input_len, NULL, &written);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	ret = yaca_context_set_property(ctx, ccm ? YACA_PROPERTY_CCM_AAD : YACA_PROPERTY_GCM_AAD,
+	                                r->aad, r->aad_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (a->seal) {
+		ret = yaca_encrypt_update(ctx, r->input, r->input_len, r->output, &written);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = yaca_encrypt_finalize(ctx, r->output + written, &final_len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = yaca_context_get_property_into(ctx, tag_property, r->tag, AEAD_TAG_LEN,
+		                                     &tag_len);
+	} else {
+		ret = yaca_decrypt_update(ctx, r->input, r->input_len, r->output, &written);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		if (!ccm) {
+			ret = yaca_context_set_property(ctx, tag_property, r->tag, AEAD_TAG_LEN);
+			if (ret != YACA_ERROR_NONE)
+				goto exit;
+		}
+
+		ret = yaca_decrypt_finalize(ctx, r->output + written, &final_len);
+	}
+
+exit:
+	yaca_context_destroy(ctx);
+	yaca_key_destroy(iv);
+	return ret;
+}
+
+static int aead_op(struct aead_arg *a)
+{
+	int ret = YACA_ERROR_NONE;
+	bool siv = a->bcm == YACA_BCM_SIV;
+	size_t iv_len = siv ? 0 : AEAD_IV_LEN;
+
+	if (a->threads > 0) {
+		if (a->seal)
+			return yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, a->bcm, a->key, iv_len,
+			                               AEAD_TAG_LEN, a->records, AEAD_RECORDS, a->threads);
+		else
+			return yaca_decrypt_aead_batch(YACA_ENCRYPT_AES, a->bcm, a->key, iv_len,
+			                               AEAD_TAG_LEN, a->records, AEAD_RECORDS, a->threads);
+	}
+
+	for (size_t i = 0; i < AEAD_RECORDS; ++i) {
+		if (siv)
+			ret = siv_context_record(a, &a->records[i]);
+		else
+			ret = aead_context_record(a, &a->records[i]);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+	}
+
+	return ret;
+}
+
+static void bench_aead_run(const char *name, const char *api, size_t record_len,
+                           struct aead_arg *a)
+{
+	int ret;
+	const char *op = a->seal ? "seal" : "open";
+	size_t iterations = 0;
+	uint64_t start, elapsed;
+
+	for (size_t i = 0; i < AEAD_RECORDS; ++i) {
+		yaca_aead_record_s *r = &a->records[i];
+
+		r->input = a->seal ? bench_input + i : a->sealed[i];
+		r->input_len = record_len;
+		r->output = a->seal ? a->sealed[i] : a->opened[i];
+	}
+
+	/* warm up, it also seals the records opened next */
+	ret = aead_op(a);
+	if (ret != YACA_ERROR_NONE) {
+		bench_fail("aead", name, op, api, record_len, ret);
+		return;
+	}
+
+	start = now_ns();
+	do {
+		ret = aead_op(a);
+		if (ret != YACA_ERROR_NONE) {
+			bench_fail("aead", name, op, api, record_len, ret);
+			return;
+		}
+		iterations += AEAD_RECORDS;
+		elapsed = now_ns() - start;
+	} while (elapsed < (uint64_t)(bench_min_time() * 1e9));
+
+	bench_report("aead", name, op, api, record_len, iterations, elapsed);
+}
+
+static void bench_aead_mode(struct aead_arg *a)
+{
+	int ret;
+	char name[32];
+	char api[16];
+
+	bench_cipher_name(YACA_ENCRYPT_AES, a->bcm, a->key_bit_len, name, sizeof(name));
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, a->key_bit_len, &a->key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_randomize_bytes(&a->ivs[0][0], sizeof(a->ivs));
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	for (size_t i = 0; i < AEAD_RECORDS; ++i) {
+		a->records[i].iv = a->ivs[i];
+		a->records[i].aad = bench_input + AEAD_RECORDS + i;
+		a->records[i].aad_len = AEAD_AAD_LEN;
+		a->records[i].tag = a->tags[i];
+	}
+
+	for (size_t l = 0; l < sizeof(AEAD_RECORD_LENS) / sizeof(AEAD_RECORD_LENS[0]); ++l) {
+		size_t record_len = AEAD_RECORD_LENS[l];
+
+		/* the records and their AAD start at different offsets of the input */
+		if (record_len + 2 * AEAD_RECORDS > bench_max_size())
+			break;
+
+		/* seal first, open what was sealed */
+		for (int seal = 1; seal >= 0; --seal) {
+			a->seal = seal;
+			a->threads = 0;
+			bench_aead_run(name, "context", record_len, a);
+
+			for (size_t t = 0; t < sizeof(AEAD_THREADS) / sizeof(AEAD_THREADS[0]); ++t) {
+				a->threads = AEAD_THREADS[t];
+				snprintf(api, sizeof(api), "batch-%zut", a->threads);
+				bench_aead_run(name, api, record_len, a);
+			}
+		}
+	}
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("aead", name, "setup", "-", 0, ret);
+
+	yaca_key_destroy(a->key);
+	a->key = YACA_KEY_NULL;
+}
+
+void bench_aead(void)
+{
+	static struct aead_arg a;
+
+	for (size_t m = 0; m < sizeof(AEAD_MODES) / sizeof(AEAD_MODES[0]); ++m) {
+		a.bcm = AEAD_MODES[m].bcm;
+		a.key_bit_len = AEAD_MODES[m].key_bit_len;
+		bench_aead_mode(&a);
+	}
+}
@@ -0,0 +1,137 @@
+/*
+ *  Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_cpp.cpp
+ * @brief C++ API overhead benchmarks
+ *
+ * The same operations through the C API ("c" rows) and through yaca.hpp
+ * ("c++" rows). Short records on a long lived context and a whole digest
+ * of a short message, where any overhead of the wrapper would show.
+ */
+
+#include <yaca.hpp>
+
+#include "bench.h"
+
+
+namespace {
+
+using Encryptor = yaca::encryptor<YACA_ENCRYPT_AES, YACA_BCM_CBC>;
+using Digest = yaca::digest<YACA_DIGEST_SHA256>;
+
+const size_t CPP_RECORD_SIZES[] = {16, 1024, 16384};
+const size_t CPP_DIGEST_SIZE = 64;
+
+struct cpp_arg {
+	yaca_context_h ctx;
+	Encryptor *encryptor;
+	size_t size;
+};
+
+int c_update_op(void *arg)
+{
+	cpp_arg *a = static_cast<cpp_arg *>(arg);
+	size_t written;
+
+	return yaca_encrypt_update(a->ctx, bench_input, a->size, bench_output, &written);
+}
+
+int cpp_update_op(void *arg)
+{
+	cpp_arg *a = static_cast<cpp_arg *>(arg);
+
+	try {
+		a->encryptor->update(yaca::span<const char>(bench_input, a->size),
+		                     yaca::span<char>(bench_output,
+		                                      bench_max_size() + BENCH_OUTPUT_SLACK));
+	} catch (const yaca::error &e) {
+		return e.code();
+	}
+	return YACA_ERROR_NONE;
+}
+
+int c_digest_op(void *)
+{
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	char digest[32];
+	size_t digest_len;
+	int ret;
+
+	ret = yaca_digest_initialize(&ctx, YACA_DIGEST_SHA256);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_digest_update(ctx, bench_input, CPP_DIGEST_SIZE);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_digest_finalize(ctx, digest, &digest_len);
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+int cpp_digest_op(void *)
+{
+	try {
+		Digest ctx;
+		ctx.update(yaca::span<const char>(bench_input, CPP_DIGEST_SIZE));
+		ctx.finalize();
+	} catch (const yaca::error &e) {
+		return e.code();
+	}
+	return YACA_ERROR_NONE;
+}
+
+} /* namespace */
+
+void bench_cpp(void)
+{
+	char name[32];
+	cpp_arg arg = {YACA_CONTEXT_NULL, nullptr, 0};
+
+	bench_cipher_name(YACA_ENCRYPT_AES, YACA_BCM_CBC, YACA_KEY_LENGTH_256BIT,
+	                  name, sizeof(name));
+
+	try {
+		yaca::key key = yaca::key::generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT);
+		yaca::key iv = yaca::key::generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT);
+		Encryptor c_ctx(key, iv);
+		Encryptor cpp_ctx(key, iv);
+
+		/* Separate contexts so that both stay in the same state */
+		arg.ctx = c_ctx.get();
+		arg.encryptor = &cpp_ctx;
+
+		for (size_t size: CPP_RECORD_SIZES) {
+			if (size > bench_max_size())
+				break;
+
+			arg.size = size;
+			bench_run("cpp", name, "update", "c", size, c_update_op, &arg);
+			bench_run("cpp", name, "update", "c++", size, cpp_update_op, &arg);
+		}
+	} catch (const yaca::error &e) {
+		bench_fail("cpp", name, "setup", "-", 0, e.code());
+	}
+
+	bench_run("cpp", "SHA256", "digest", "c", CPP_DIGEST_SIZE, c_digest_op, nullptr);
+	bench_run("cpp", "SHA256", "digest", "c++", CPP_DIGEST_SIZE, cpp_digest_op, nullptr);
+}
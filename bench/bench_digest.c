@@ -0,0 +1,92 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_digest.c
+ * @brief Message digest benchmarks
+ */
+
+#include <yaca_crypto.h>
+#include <yaca_digest.h>
+#include <yaca_simple.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+static const yaca_digest_algorithm_e DIGESTS[] = {
+	YACA_DIGEST_MD5,
+	YACA_DIGEST_SHA1,
+	YACA_DIGEST_SHA224,
+	YACA_DIGEST_SHA256,
+	YACA_DIGEST_SHA384,
+	YACA_DIGEST_SHA512,
+};
+
+struct digest_arg {
+	yaca_digest_algorithm_e algo;
+	size_t size;
+};
+
+static int digest_simple(void *arg)
+{
+	struct digest_arg *a = arg;
+	char *digest = NULL;
+	size_t digest_len;
+	int ret;
+
+	ret = yaca_simple_calculate_digest(a->algo, bench_input, a->size, &digest, &digest_len);
+	yaca_free(digest);
+	return ret;
+}
+
+static int digest_stream(void *arg)
+{
+	struct digest_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t digest_len;
+	int ret;
+
+	ret = yaca_digest_initialize(&ctx, a->algo);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = bench_feed(ctx, yaca_digest_update, bench_input, a->size);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_digest_finalize(ctx, bench_output, &digest_len);
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+void bench_digest(void)
+{
+	for (size_t d = 0; d < sizeof(DIGESTS) / sizeof(DIGESTS[0]); ++d) {
+		const char *name = bench_digest_name(DIGESTS[d]);
+
+		for (size_t s = 0; s < BENCH_SIZES_COUNT && BENCH_SIZES[s] <= bench_max_size(); ++s) {
+			struct digest_arg arg = {DIGESTS[d], BENCH_SIZES[s]};
+
+			bench_run("digest", name, "digest", "simple", arg.size, digest_simple, &arg);
+			bench_run("digest", name, "digest", "stream", arg.size, digest_stream, &arg);
+		}
+	}
+}
@@ -0,0 +1,568 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_encrypt.c
+ * @brief Symmetric encryption and seal benchmarks
+ */
+
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+
+#include <yaca_crypto.h>
+#include <yaca_encrypt.h>
+#include <yaca_seal.h>
+#include <yaca_simple.h>
+#include <yaca_key.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+/* Mirrors ENCRYPTION_CIPHERS from src/encrypt.c */
+static const struct {
+	yaca_encrypt_algorithm_e algo;
+	yaca_block_cipher_mode_e bcm;
+	size_t key_bit_len;
+} CIPHERS[] = {
+	{YACA_ENCRYPT_AES, YACA_BCM_CBC,  128},
+	{YACA_ENCRYPT_AES, YACA_BCM_CCM,  128},
+	{YACA_ENCRYPT_AES, YACA_BCM_CFB,  128},
+	{YACA_ENCRYPT_AES, YACA_BCM_CFB1, 128},
+	{YACA_ENCRYPT_AES, YACA_BCM_CFB8, 128},
+	{YACA_ENCRYPT_AES, YACA_BCM_CTR,  128},
+	{YACA_ENCRYPT_AES, YACA_BCM_ECB,  128},
+	{YACA_ENCRYPT_AES, YACA_BCM_GCM,  128},
+	{YACA_ENCRYPT_AES, YACA_BCM_OFB,  128},
+	{YACA_ENCRYPT_AES, YACA_BCM_WRAP, 128},
+
+	{YACA_ENCRYPT_AES, YACA_BCM_CBC,  192},
+	{YACA_ENCRYPT_AES, YACA_BCM_CCM,  192},
+	{YACA_ENCRYPT_AES, YACA_BCM_CFB,  192},
+	{YACA_ENCRYPT_AES, YACA_BCM_CFB1, 192},
+	{YACA_ENCRYPT_AES, YACA_BCM_CFB8, 192},
+	{YACA_ENCRYPT_AES, YACA_BCM_CTR,  192},
+	{YACA_ENCRYPT_AES, YACA_BCM_ECB,  192},
+	{YACA_ENCRYPT_AES, YACA_BCM_GCM,  192},
+	{YACA_ENCRYPT_AES, YACA_BCM_OFB,  192},
+	{YACA_ENCRYPT_AES, YACA_BCM_WRAP, 192},
+
+	{YACA_ENCRYPT_AES, YACA_BCM_CBC,  256},
+	{YACA_ENCRYPT_AES, YACA_BCM_CCM,  256},
+	{YACA_ENCRYPT_AES, YACA_BCM_CFB,  256},
+	{YACA_ENCRYPT_AES, YACA_BCM_CFB1, 256},
+	{YACA_ENCRYPT_AES, YACA_BCM_CFB8, 256},
+	{YACA_ENCRYPT_AES, YACA_BCM_CTR,  256},
+	{YACA_ENCRYPT_AES, YACA_BCM_ECB,  256},
+	{YACA_ENCRYPT_AES, YACA_BCM_GCM,  256},
+	{YACA_ENCRYPT_AES, YACA_BCM_OFB,  256},
+	{YACA_ENCRYPT_AES, YACA_BCM_WRAP, 256},
+
+	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CBC,  64},
+	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CFB,  64},
+	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CFB1, 64},
+	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CFB8, 64},
+	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_ECB,  64},
+	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_OFB,  64},
+
+	{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_CBC, 128},
+	{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_CFB, 128},
+	{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_ECB, 128},
+	{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_OFB, 128},
+
+	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CBC,  192},
+	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CFB,  192},
+	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CFB1, 192},
+	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CFB8, 192},
+	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_ECB,  192},
+	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_OFB,  192},
+	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_WRAP, 192},
+
+	{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_CBC, 128},
+	{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_CFB, 128},
+	{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_ECB, 128},
+	{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_OFB, 128},
+
+	{YACA_ENCRYPT_UNSAFE_RC4, YACA_BCM_NONE, 128},
+
+	{YACA_ENCRYPT_CAST5, YACA_BCM_CBC, 128},
+	{YACA_ENCRYPT_CAST5, YACA_BCM_CFB, 128},
+	{YACA_ENCRYPT_CAST5, YACA_BCM_ECB, 128},
+	{YACA_ENCRYPT_CAST5, YACA_BCM_OFB, 128},
+};
+
+/* Wrapping is meant for key material, don't sweep it beyond that */
+#define WRAP_MAX_SIZE ((size_t)4096)
+
+/* With the default 96 bit IV CCM can't process more than 2^24 bytes */
+#define CCM_MAX_SIZE (((size_t)1 << 24) - 1)
+
+/* The only input lengths accepted by 3DES key wrap */
+#define DES_WRAP_SIZE ((size_t)(YACA_KEY_LENGTH_192BIT / 8))
+
+struct cipher_arg {
+	yaca_encrypt_algorithm_e algo;
+	yaca_block_cipher_mode_e bcm;
+	yaca_key_h key;
+	yaca_key_h iv;
+	bool encrypt;
+
+	const char *input;
+	size_t input_len;
+	char *output;
+	size_t output_len;
+
+	char tag[16];
+	size_t tag_len;
+};
+
+static bool is_des(yaca_encrypt_algorithm_e algo)
+{
+	return algo == YACA_ENCRYPT_UNSAFE_DES ||
+	       algo == YACA_ENCRYPT_UNSAFE_3DES_2TDEA ||
+	       algo == YACA_ENCRYPT_3DES_3TDEA;
+}
+
+static bool is_aead(yaca_block_cipher_mode_e bcm)
+{
+	return bcm == YACA_BCM_GCM || bcm == YACA_BCM_CCM;
+}
+
+static bool size_supported(yaca_block_cipher_mode_e bcm, size_t size)
+{
+	if (bcm == YACA_BCM_WRAP)
+		return size <= WRAP_MAX_SIZE;
+	if (bcm == YACA_BCM_CCM)
+		return size <= CCM_MAX_SIZE;
+	return true;
+}
+
+static int cipher_simple(void *arg)
+{
+	struct cipher_arg *a = arg;
+	char *output = NULL;
+	size_t output_len;
+	int ret;
+
+	if (a->encrypt)
+		ret = yaca_simple_encrypt(a->algo, a->bcm, a->key, a->iv,
+		                          a->input, a->input_len, &output, &output_len);
+	else
+		ret = yaca_simple_decrypt(a->algo, a->bcm, a->key, a->iv,
+		                          a->input, a->input_len, &output, &output_len);
+
+	yaca_free(output);
+	return ret;
+}
+
+static int cipher_stream(void *arg)
+{
+	struct cipher_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t written, final_len;
+	int ret;
+
+	/* CCM and key wrapping don't support multiple updates */
+	size_t chunk = (a->bcm == YACA_BCM_CCM || a->bcm == YACA_BCM_WRAP) ? a->input_len : BENCH_CHUNK;
+
+	if (a->encrypt)
+		ret = yaca_encrypt_initialize(&ctx, a->algo, a->bcm, a->key, a->iv);
+	else
+		ret = yaca_decrypt_initialize(&ctx, a->algo, a->bcm, a->key, a->iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (!a->encrypt && a->bcm == YACA_BCM_CCM) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CCM_TAG, a->tag, a->tag_len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	ret = bench_feed_out(ctx, a->encrypt ? yaca_encrypt_update : yaca_decrypt_update,
+	                     a->input, a->input_len, chunk, a->output, &written);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (!a->encrypt && a->bcm == YACA_BCM_GCM) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_GCM_TAG, a->tag, a->tag_len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	if (a->encrypt)
+		ret = yaca_encrypt_finalize(ctx, a->output + written, &final_len);
+	else
+		ret = yaca_decrypt_finalize(ctx, a->output + written, &final_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	a->output_len = written + final_len;
+
+	if (a->encrypt && is_aead(a->bcm))
+		ret = yaca_context_get_property_into(ctx, a->bcm == YACA_BCM_GCM ? YACA_PROPERTY_GCM_TAG :
+		                                     YACA_PROPERTY_CCM_TAG, a->tag, sizeof(a->tag),
+		                                     &a->tag_len);
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+static void bench_cipher_size(const char *name, yaca_encrypt_algorithm_e algo,
+                              yaca_block_cipher_mode_e bcm, yaca_key_h key, yaca_key_h iv,
+                              size_t size, char *ciphertext)
+{
+	int ret;
+	struct cipher_arg enc = {
+		.algo = algo, .bcm = bcm, .key = key, .iv = iv, .encrypt = true,
+		.input = bench_input, .input_len = size, .output = ciphertext,
+	};
+
+	/* produces the ciphertext and the tag for the decryption rows */
+	ret = cipher_stream(&enc);
+	if (ret != YACA_ERROR_NONE) {
+		bench_fail("encrypt", name, "encrypt", "stream", size, ret);
+		return;
+	}
+
+	struct cipher_arg dec = {
+		.algo = algo, .bcm = bcm, .key = key, .iv = iv, .encrypt = false,
+		.input = ciphertext, .input_len = enc.output_len, .output = bench_output,
+		.tag_len = enc.tag_len,
+	};
+	memcpy(dec.tag, enc.tag, enc.tag_len);
+	enc.output = bench_output;
+
+	/* The chunks are whole blocks, so every one is encrypted exactly in place.
+	 * Decrypting in place would need the ciphertext restored every time.
+	 */
+	struct cipher_arg enc_in_place = enc;
+	enc_in_place.input = bench_output;
+
+	if (!is_aead(bcm))
+		bench_run("encrypt", name, "encrypt", "simple", size, cipher_simple, &enc);
+	bench_run("encrypt", name, "encrypt", "stream", size, cipher_stream, &enc);
+	bench_run("encrypt", name, "encrypt", "inplace", size, cipher_stream, &enc_in_place);
+	if (!is_aead(bcm))
+		bench_run("encrypt", name, "decrypt", "simple", size, cipher_simple, &dec);
+	bench_run("encrypt", name, "decrypt", "stream", size, cipher_stream, &dec);
+}
+
+static void bench_cipher(size_t c, char *ciphertext)
+{
+	int ret;
+	char name[32];
+	yaca_key_h key = YACA_KEY_NULL;
+	yaca_key_h iv = YACA_KEY_NULL;
+	size_t iv_bit_len;
+	yaca_encrypt_algorithm_e algo = CIPHERS[c].algo;
+	yaca_block_cipher_mode_e bcm = CIPHERS[c].bcm;
+
+	bench_cipher_name(algo, bcm, CIPHERS[c].key_bit_len, name, sizeof(name));
+
+	ret = yaca_key_generate(is_des(algo) ? YACA_KEY_TYPE_DES : YACA_KEY_TYPE_SYMMETRIC,
+	                        CIPHERS[c].key_bit_len, &key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_encrypt_get_iv_bit_length(algo, bcm, CIPHERS[c].key_bit_len, &iv_bit_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (iv_bit_len > 0) {
+		ret = yaca_key_generate(YACA_KEY_TYPE_IV, iv_bit_len, &iv);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	if (bcm == YACA_BCM_WRAP && algo == YACA_ENCRYPT_3DES_3TDEA) {
+		bench_cipher_size(name, algo, bcm, key, iv, DES_WRAP_SIZE, ciphertext);
+		goto exit;
+	}
+
+	for (size_t s = 0; s < BENCH_SIZES_COUNT && BENCH_SIZES[s] <= bench_max_size(); ++s)
+		if (size_supported(bcm, BENCH_SIZES[s]))
+			bench_cipher_size(name, algo, bcm, key, iv, BENCH_SIZES[s], ciphertext);
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("encrypt", name, "setup", "-", 0, ret);
+
+	yaca_key_destroy(iv);
+	yaca_key_destroy(key);
+}
+
+void bench_encrypt(void)
+{
+	char *ciphertext = malloc(bench_max_size() + BENCH_OUTPUT_SLACK);
+
+	if (ciphertext == NULL) {
+		bench_fail("encrypt", "-", "setup", "-", 0, YACA_ERROR_OUT_OF_MEMORY);
+		return;
+	}
+
+	for (size_t c = 0; c < sizeof(CIPHERS) / sizeof(CIPHERS[0]); ++c)
+		bench_cipher(c, ciphertext);
+
+	free(ciphertext);
+}
+
+/* Record sizes typical for TLS-like protocols, one update per record */
+static const size_t RECORD_SIZES[] = {16, 64, 256, 1024};
+
+static const struct {
+	yaca_encrypt_algorithm_e algo;
+	yaca_block_cipher_mode_e bcm;
+	size_t key_bit_len;
+} RECORD_CIPHERS[] = {
+	{YACA_ENCRYPT_AES, YACA_BCM_GCM, 128},
+	{YACA_ENCRYPT_AES, YACA_BCM_CTR, 128},
+	{YACA_ENCRYPT_AES, YACA_BCM_CBC, 128},
+	{YACA_ENCRYPT_UNSAFE_RC4, YACA_BCM_NONE, 128},
+};
+
+struct record_arg {
+	yaca_context_h ctx;
+	bool encrypt;
+	bool in_place;
+	size_t size;
+};
+
+static int record_update(void *arg)
+{
+	struct record_arg *a = arg;
+	const char *input = a->in_place ? bench_output : bench_input;
+	size_t written;
+
+	if (a->encrypt)
+		return yaca_encrypt_update(a->ctx, input, a->size, bench_output, &written);
+	else
+		return yaca_decrypt_update(a->ctx, input, a->size, bench_output, &written);
+}
+
+static void bench_record_cipher(size_t c)
+{
+	int ret;
+	char name[32];
+	yaca_key_h key = YACA_KEY_NULL;
+	yaca_key_h iv = YACA_KEY_NULL;
+	size_t iv_bit_len;
+	yaca_encrypt_algorithm_e algo = RECORD_CIPHERS[c].algo;
+	yaca_block_cipher_mode_e bcm = RECORD_CIPHERS[c].bcm;
+	struct record_arg arg = {YACA_CONTEXT_NULL, true, false, 0};
+
+	bench_cipher_name(algo, bcm, RECORD_CIPHERS[c].key_bit_len, name, sizeof(name));
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, RECORD_CIPHERS[c].key_bit_len, &key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_encrypt_get_iv_bit_length(algo, bcm, RECORD_CIPHERS[c].key_bit_len, &iv_bit_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (iv_bit_len > 0) {
+		ret = yaca_key_generate(YACA_KEY_TYPE_IV, iv_bit_len, &iv);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	/* One long lived context per direction, only the update is measured */
+	for (int encrypt = 1; encrypt >= 0; --encrypt) {
+		arg.encrypt = encrypt;
+
+		if (encrypt)
+			ret = yaca_encrypt_initialize(&arg.ctx, algo, bcm, key, iv);
+		else
+			ret = yaca_decrypt_initialize(&arg.ctx, algo, bcm, key, iv);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		for (size_t s = 0; s < sizeof(RECORD_SIZES) / sizeof(RECORD_SIZES[0]); ++s) {
+			if (RECORD_SIZES[s] > bench_max_size())
+				break;
+
+			arg.size = RECORD_SIZES[s];
+			arg.in_place = false;
+			bench_run("record", name, encrypt ? "encrypt" : "decrypt", "update",
+			          arg.size, record_update, &arg);
+			arg.in_place = true;
+			bench_run("record", name, encrypt ? "encrypt" : "decrypt", "inplace",
+			          arg.size, record_update, &arg);
+		}
+
+		yaca_context_destroy(arg.ctx);
+		arg.ctx = YACA_CONTEXT_NULL;
+	}
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("record", name, "setup", "-", 0, ret);
+
+	yaca_context_destroy(arg.ctx);
+	yaca_key_destroy(iv);
+	yaca_key_destroy(key);
+}
+
+void bench_record(void)
+{
+	for (size_t c = 0; c < sizeof(RECORD_CIPHERS) / sizeof(RECORD_CIPHERS[0]); ++c)
+		bench_record_cipher(c);
+}
+
+struct seal_arg {
+	yaca_key_h asym_key;
+	yaca_key_h sym_key;
+	yaca_key_h iv;
+	bool keep_keys;
+
+	const char *input;
+	size_t input_len;
+	char *output;
+	size_t output_len;
+};
+
+static const yaca_encrypt_algorithm_e SEAL_ALGO = YACA_ENCRYPT_AES;
+static const yaca_block_cipher_mode_e SEAL_BCM = YACA_BCM_CBC;
+static const size_t SEAL_KEY_BIT_LEN = YACA_KEY_LENGTH_256BIT;
+
+static int seal_op(void *arg)
+{
+	struct seal_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_key_h sym_key = YACA_KEY_NULL;
+	yaca_key_h iv = YACA_KEY_NULL;
+	size_t written, final_len;
+	int ret;
+
+	ret = yaca_seal_initialize(&ctx, a->asym_key, SEAL_ALGO, SEAL_BCM, SEAL_KEY_BIT_LEN,
+	                           &sym_key, &iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = bench_feed_out(ctx, yaca_seal_update, a->input, a->input_len, BENCH_CHUNK,
+	                     a->output, &written);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_seal_finalize(ctx, a->output + written, &final_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	a->output_len = written + final_len;
+
+	if (a->keep_keys) {
+		a->sym_key = sym_key;
+		a->iv = iv;
+		sym_key = iv = YACA_KEY_NULL;
+	}
+
+exit:
+	yaca_context_destroy(ctx);
+	yaca_key_destroy(sym_key);
+	yaca_key_destroy(iv);
+	return ret;
+}
+
+static int open_op(void *arg)
+{
+	struct seal_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t written, final_len;
+	int ret;
+
+	ret = yaca_open_initialize(&ctx, a->asym_key, SEAL_ALGO, SEAL_BCM, SEAL_KEY_BIT_LEN,
+	                           a->sym_key, a->iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = bench_feed_out(ctx, yaca_open_update, a->input, a->input_len, BENCH_CHUNK,
+	                     a->output, &written);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_open_finalize(ctx, a->output + written, &final_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	a->output_len = written + final_len;
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+void bench_seal(void)
+{
+	int ret;
+	const char *name = "RSA-2048/AES-256-CBC";
+	yaca_key_h prv = YACA_KEY_NULL;
+	yaca_key_h pub = YACA_KEY_NULL;
+	char *sealed = malloc(bench_max_size() + BENCH_OUTPUT_SLACK);
+
+	if (sealed == NULL) {
+		ret = YACA_ERROR_OUT_OF_MEMORY;
+		goto exit;
+	}
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_2048BIT, &prv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_extract_public(prv, &pub);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	for (size_t s = 0; s < BENCH_SIZES_COUNT && BENCH_SIZES[s] <= bench_max_size(); ++s) {
+		size_t size = BENCH_SIZES[s];
+		struct seal_arg seal = {
+			.asym_key = pub, .keep_keys = true,
+			.input = bench_input, .input_len = size, .output = sealed,
+		};
+
+		ret = seal_op(&seal);
+		if (ret != YACA_ERROR_NONE) {
+			bench_fail("seal", name, "seal", "stream", size, ret);
+			continue;
+		}
+
+		struct seal_arg open = {
+			.asym_key = prv, .sym_key = seal.sym_key, .iv = seal.iv,
+			.input = sealed, .input_len = seal.output_len, .output = bench_output,
+		};
+		seal.keep_keys = false;
+		seal.output = bench_output;
+
+		bench_run("seal", name, "seal", "stream", size, seal_op, &seal);
+		bench_run("seal", name, "open", "stream", size, open_op, &open);
+
+		yaca_key_destroy(open.sym_key);
+		yaca_key_destroy(open.iv);
+	}
+
+	ret = YACA_ERROR_NONE;
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("seal", name, "setup", "-", 0, ret);
+
+	yaca_key_destroy(pub);
+	yaca_key_destroy(prv);
+	free(sealed);
+}
@@ -0,0 +1,340 @@
+/*
+ *  Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_etm.c
+ * @brief AES-CBC encrypt-then-HMAC benchmarks
+ *
+ * The CBC-HMAC block cipher modes ("composite" rows) against an encrypt
+ * context and an HMAC context of the same IV || ciphertext || AL, AL
+ * being the zero AAD length. The "two-pass" rows encrypt the whole
+ * message and then MAC the ciphertext (or MAC and then decrypt), the
+ * "interleaved" rows alternate between the contexts every BENCH_CHUNK.
+ */
+
+#include <string.h>
+#include <stdbool.h>
+
+#include <yaca_crypto.h>
+#include <yaca_encrypt.h>
+#include <yaca_sign.h>
+#include <yaca_key.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+#define ETM_MAC_KEY_LEN ((size_t)32)
+#define ETM_IV_LEN ((size_t)16)
+#define ETM_TAG_MAX_LEN ((size_t)32)
+#define ETM_MIN_SIZE ((size_t)1024)
+
+static const struct {
+	yaca_block_cipher_mode_e bcm;
+	yaca_digest_algorithm_e digest;
+} ETM_MODES[] = {
+	{YACA_BCM_CBC_HMAC_SHA1,   YACA_DIGEST_SHA1},
+	{YACA_BCM_CBC_HMAC_SHA256, YACA_DIGEST_SHA256},
+};
+
+/* The AAD length in bits, there is no AAD */
+static const char ETM_AL[8] = {0};
+
+enum etm_api {
+	ETM_COMPOSITE,
+	ETM_TWO_PASS,
+	ETM_INTERLEAVED,
+};
+
+struct etm_arg {
+	yaca_block_cipher_mode_e bcm;
+	yaca_digest_algorithm_e digest;
+	enum etm_api api;
+	bool seal;
+	yaca_key_h key;
+	yaca_key_h iv;
+	char iv_raw[ETM_IV_LEN];
+	yaca_key_h mac_key;
+	char mac_key_raw[ETM_MAC_KEY_LEN];
+	const char *input;
+	size_t input_len;
+	char *output;
+	size_t output_len;
+	char tag[ETM_TAG_MAX_LEN];
+	size_t tag_len;
+};
+
+static int etm_composite(struct etm_arg *a)
+{
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t written, final_len;
+	int ret;
+
+	if (a->seal)
+		ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, a->iv);
+	else
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, a->iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY,
+	                                a->mac_key_raw, sizeof(a->mac_key_raw));
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = bench_feed_out(ctx, a->seal ? yaca_encrypt_update : yaca_decrypt_update,
+	                     a->input, a->input_len, BENCH_CHUNK, a->output, &written);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (a->seal) {
+		ret = yaca_encrypt_finalize(ctx, a->output + written, &final_len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_CBC_HMAC_TAG,
+		                                     a->tag, sizeof(a->tag), &a->tag_len);
+	} else {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_TAG, a->tag, a->tag_len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = yaca_decrypt_finalize(ctx, a->output + written, &final_len);
+	}
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	a->output_len = written + final_len;
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+/* What an application does without the composite modes */
+static int etm_two_contexts(struct etm_arg *a)
+{
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_context_h mac = YACA_CONTEXT_NULL;
+	int (*update)(yaca_context_h, const char *, size_t, char *, size_t *) =
+		a->seal ? yaca_encrypt_update : yaca_decrypt_update;
+	char tag[ETM_TAG_MAX_LEN];
+	size_t written = 0, tag_len, len;
+	int ret;
+
+	if (a->seal)
+		ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC, a->key, a->iv);
+	else
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC, a->key, a->iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_sign_initialize_hmac(&mac, a->digest, a->mac_key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_sign_update(mac, a->iv_raw, sizeof(a->iv_raw));
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (a->api == ETM_TWO_PASS) {
+		/* the ciphertext is MACed as a whole, before or after the cipher */
+		if (!a->seal) {
+			ret = bench_feed(mac, yaca_sign_update, a->input, a->input_len);
+			if (ret != YACA_ERROR_NONE)
+				goto exit;
+		}
+
+		ret = bench_feed_out(ctx, update, a->input, a->input_len, BENCH_CHUNK,
+		                     a->output, &written);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	} else {
+		for (size_t pos = 0; pos < a->input_len; pos += BENCH_CHUNK) {
+			size_t chunk = a->input_len - pos < BENCH_CHUNK ? a->input_len - pos : BENCH_CHUNK;
+
+			if (!a->seal) {
+				ret = yaca_sign_update(mac, a->input + pos, chunk);
+				if (ret != YACA_ERROR_NONE)
+					goto exit;
+			}
+
+			ret = update(ctx, a->input + pos, chunk, a->output + written, &len);
+			if (ret != YACA_ERROR_NONE)
+				goto exit;
+
+			if (a->seal && len > 0) {
+				ret = yaca_sign_update(mac, a->output + written, len);
+				if (ret != YACA_ERROR_NONE)
+					goto exit;
+			}
+
+			written += len;
+		}
+	}
+
+	if (a->seal) {
+		ret = yaca_encrypt_finalize(ctx, a->output + written, &len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		/* the last block, in the two-pass rows the whole ciphertext */
+		if (a->api == ETM_TWO_PASS)
+			ret = bench_feed(mac, yaca_sign_update, a->output, written + len);
+		else
+			ret = yaca_sign_update(mac, a->output + written, len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		written += len;
+		ret = yaca_sign_update(mac, ETM_AL, sizeof(ETM_AL));
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = yaca_sign_finalize(mac, a->tag, &a->tag_len);
+	} else {
+		ret = yaca_sign_update(mac, ETM_AL, sizeof(ETM_AL));
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = yaca_sign_finalize(mac, tag, &tag_len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		if (tag_len != a->tag_len || yaca_memcmp(tag, a->tag, tag_len) != YACA_ERROR_NONE) {
+			ret = YACA_ERROR_INVALID_PARAMETER;
+			goto exit;
+		}
+
+		ret = yaca_decrypt_finalize(ctx, a->output + written, &len);
+		written += len;
+	}
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	a->output_len = written;
+
+exit:
+	yaca_context_destroy(mac);
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+static int etm_op(void *arg)
+{
+	struct etm_arg *a = arg;
+
+	return a->api == ETM_COMPOSITE ? etm_composite(a) : etm_two_contexts(a);
+}
+
+static void bench_etm_size(const char *name, struct etm_arg *seal, char *ciphertext, size_t size)
+{
+	static const char *API_NAMES[] = {
+		[ETM_COMPOSITE] = "composite",
+		[ETM_TWO_PASS] = "two-pass",
+		[ETM_INTERLEAVED] = "interleaved",
+	};
+	struct etm_arg open;
+	int ret;
+
+	seal->seal = true;
+	seal->api = ETM_COMPOSITE;
+	seal->input = bench_input;
+	seal->input_len = size;
+	seal->output = ciphertext;
+
+	/* produces the ciphertext and the tag for the open rows */
+	ret = etm_op(seal);
+	if (ret != YACA_ERROR_NONE) {
+		bench_fail("etm", name, "seal", "composite", size, ret);
+		return;
+	}
+
+	open = *seal;
+	open.seal = false;
+	open.input = ciphertext;
+	open.input_len = seal->output_len;
+	open.output = bench_output;
+	seal->output = bench_output;
+
+	for (int api = ETM_COMPOSITE; api <= ETM_INTERLEAVED; ++api) {
+		seal->api = api;
+		bench_run("etm", name, "seal", API_NAMES[api], size, etm_op, seal);
+	}
+
+	for (int api = ETM_COMPOSITE; api <= ETM_INTERLEAVED; ++api) {
+		open.api = api;
+		bench_run("etm", name, "open", API_NAMES[api], size, etm_op, &open);
+	}
+}
+
+void bench_etm(void)
+{
+	int ret;
+	char *ciphertext = NULL;
+	struct etm_arg a = {.key = YACA_KEY_NULL, .iv = YACA_KEY_NULL, .mac_key = YACA_KEY_NULL};
+
+	ret = yaca_malloc(bench_max_size() + BENCH_OUTPUT_SLACK, (void**)&ciphertext);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &a.key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_randomize_bytes(a.iv_raw, sizeof(a.iv_raw));
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_import(YACA_KEY_TYPE_IV, NULL, a.iv_raw, sizeof(a.iv_raw), &a.iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_randomize_bytes(a.mac_key_raw, sizeof(a.mac_key_raw));
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_import(YACA_KEY_TYPE_SYMMETRIC, NULL, a.mac_key_raw, sizeof(a.mac_key_raw),
+	                      &a.mac_key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	for (size_t m = 0; m < sizeof(ETM_MODES) / sizeof(ETM_MODES[0]); ++m) {
+		char name[32];
+
+		a.bcm = ETM_MODES[m].bcm;
+		a.digest = ETM_MODES[m].digest;
+		bench_cipher_name(YACA_ENCRYPT_AES, a.bcm, YACA_KEY_LENGTH_256BIT, name, sizeof(name));
+
+		for (size_t s = 0; s < BENCH_SIZES_COUNT && BENCH_SIZES[s] <= bench_max_size(); ++s) {
+			if (BENCH_SIZES[s] < ETM_MIN_SIZE)
+				continue;
+
+			bench_etm_size(name, &a, ciphertext, BENCH_SIZES[s]);
+		}
+	}
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("etm", "-", "setup", "-", 0, ret);
+
+	yaca_key_destroy(a.mac_key);
+	yaca_key_destroy(a.iv);
+	yaca_key_destroy(a.key);
+	yaca_free(ciphertext);
+}
@@ -0,0 +1,266 @@
+/*
+ *  Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_forgery.c
+ * @brief Rejected forgery benchmarks
+ *
+ * Short messages with a valid ("valid" rows) and a forged ("forged" rows)
+ * tag or signature. A rejection should cost no more than an acceptance.
+ */
+
+#include <stdio.h>
+
+#include <yaca_crypto.h>
+#include <yaca_encrypt.h>
+#include <yaca_sign.h>
+#include <yaca_key.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+#define FORGERY_MESSAGE_LEN ((size_t)64)
+#define FORGERY_TAG_LEN ((size_t)16)
+
+/* Large enough for the signatures benchmarked here */
+#define FORGERY_SIGNATURE_MAX_LEN ((size_t)512)
+
+struct open_arg {
+	yaca_block_cipher_mode_e bcm;
+	yaca_key_h key;
+	yaca_key_h iv;
+	char ciphertext[FORGERY_MESSAGE_LEN];
+	char tag[FORGERY_TAG_LEN];
+	/* the result expected by the row */
+	int expected;
+};
+
+struct verify_arg {
+	yaca_key_h key;
+	char signature[FORGERY_SIGNATURE_MAX_LEN];
+	size_t signature_len;
+	int expected;
+};
+
+static int seal_record(struct open_arg *a)
+{
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_property_e tag_property = a->bcm == YACA_BCM_GCM ? YACA_PROPERTY_GCM_TAG :
+	                                                        YACA_PROPERTY_CCM_TAG;
+	size_t written, final_len, tag_len;
+	int ret;
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, a->iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (a->bcm == YACA_BCM_CCM) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CCM_TAG_LEN,
+		                                &(size_t){FORGERY_TAG_LEN}, sizeof(size_t));
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	ret = yaca_encrypt_update(ctx, bench_input, FORGERY_MESSAGE_LEN, a->ciphertext, &written);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_encrypt_finalize(ctx, a->ciphertext + written, &final_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_context_get_property_into(ctx, tag_property, a->tag, sizeof(a->tag), &tag_len);
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+static int open_op(void *arg)
+{
+	struct open_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t written, final_len;
+	int ret;
+
+	ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, a->iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	/* CCM authenticates in the update, GCM in the finalization */
+	if (a->bcm == YACA_BCM_CCM) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CCM_TAG, a->tag, sizeof(a->tag));
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	ret = yaca_decrypt_update(ctx, a->ciphertext, sizeof(a->ciphertext),
+	                          bench_output, &written);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (a->bcm == YACA_BCM_GCM) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_GCM_TAG, a->tag, sizeof(a->tag));
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	ret = yaca_decrypt_finalize(ctx, bench_output + written, &final_len);
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret == a->expected ? YACA_ERROR_NONE : YACA_ERROR_INTERNAL;
+}
+
+static int verify_op(void *arg)
+{
+	struct verify_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	int ret;
+
+	ret = yaca_verify_initialize(&ctx, YACA_DIGEST_SHA256, a->key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_verify_update(ctx, bench_input, FORGERY_MESSAGE_LEN);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_verify_finalize(ctx, a->signature, a->signature_len);
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret == a->expected ? YACA_ERROR_NONE : YACA_ERROR_INTERNAL;
+}
+
+static void bench_forgery_open(yaca_block_cipher_mode_e bcm)
+{
+	int ret;
+	char name[32];
+	struct open_arg valid = {.bcm = bcm, .expected = YACA_ERROR_NONE};
+	struct open_arg forged;
+	size_t iv_bit_len;
+
+	bench_cipher_name(YACA_ENCRYPT_AES, bcm, YACA_KEY_LENGTH_256BIT, name, sizeof(name));
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &valid.key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_encrypt_get_iv_bit_length(YACA_ENCRYPT_AES, bcm, YACA_KEY_LENGTH_256BIT,
+	                                      &iv_bit_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, iv_bit_len, &valid.iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = seal_record(&valid);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	forged = valid;
+	forged.tag[0] ^= 0x01;
+	forged.expected = YACA_ERROR_INVALID_PARAMETER;
+
+	bench_run("forgery", name, "open", "valid", FORGERY_MESSAGE_LEN, open_op, &valid);
+	bench_run("forgery", name, "open", "forged", FORGERY_MESSAGE_LEN, open_op, &forged);
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("forgery", name, "setup", "-", 0, ret);
+
+	yaca_key_destroy(valid.iv);
+	yaca_key_destroy(valid.key);
+}
+
+static void bench_forgery_verify(const char *name, yaca_key_type_e type, size_t key_bit_len)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_key_h prv = YACA_KEY_NULL;
+	struct verify_arg valid = {.expected = YACA_ERROR_NONE};
+	struct verify_arg forged;
+	char prepared_name[32];
+
+	ret = yaca_key_generate(type, key_bit_len, &prv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_extract_public(prv, &valid.key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_sign_initialize(&ctx, YACA_DIGEST_SHA256, prv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_sign_update(ctx, bench_input, FORGERY_MESSAGE_LEN);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_context_get_output_length(ctx, 0, &valid.signature_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (valid.signature_len > sizeof(valid.signature)) {
+		ret = YACA_ERROR_INTERNAL;
+		goto exit;
+	}
+
+	ret = yaca_sign_finalize(ctx, valid.signature, &valid.signature_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	/* the last byte of the RSA signature or of s */
+	forged = valid;
+	forged.signature[forged.signature_len - 1] ^= 0x01;
+	forged.expected = YACA_ERROR_DATA_MISMATCH;
+
+	bench_run("forgery", name, "verify", "valid", FORGERY_MESSAGE_LEN, verify_op, &valid);
+	bench_run("forgery", name, "verify", "forged", FORGERY_MESSAGE_LEN, verify_op, &forged);
+
+	/* The prepared EC path rejects in its own code, not in OpenSSL */
+	ret = yaca_verify_prepare_key(valid.key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	snprintf(prepared_name, sizeof(prepared_name), "%s-prepared", name);
+	bench_run("forgery", prepared_name, "verify", "valid", FORGERY_MESSAGE_LEN,
+	          verify_op, &valid);
+	bench_run("forgery", prepared_name, "verify", "forged", FORGERY_MESSAGE_LEN,
+	          verify_op, &forged);
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("forgery", name, "setup", "-", 0, ret);
+
+	yaca_context_destroy(ctx);
+	yaca_key_destroy(valid.key);
+	yaca_key_destroy(prv);
+}
+
+void bench_forgery(void)
+{
+	bench_forgery_open(YACA_BCM_GCM);
+	bench_forgery_open(YACA_BCM_CCM);
+	bench_forgery_verify("RSA-2048", YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_2048BIT);
+	bench_forgery_verify("EC-P256", YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_PRIME256V1);
+}
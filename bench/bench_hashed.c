@@ -0,0 +1,282 @@
+/*
+ *  Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_hashed.c
+ * @brief Encrypt-and-hash benchmarks
+ *
+ * Encryption and decryption with a SHA256 of the plaintext. The "attached"
+ * rows use YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO, the "two-pass" rows hash the
+ * whole plaintext with a digest context before encrypting it (or after
+ * decrypting it), the "interleaved" rows alternate between the contexts
+ * every BENCH_CHUNK.
+ */
+
+#include <stdbool.h>
+
+#include <yaca_crypto.h>
+#include <yaca_encrypt.h>
+#include <yaca_digest.h>
+#include <yaca_key.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+#define HASHED_DIGEST_LEN ((size_t)32)
+#define HASHED_MIN_SIZE ((size_t)1024)
+
+static const yaca_block_cipher_mode_e HASHED_MODES[] = {
+	YACA_BCM_CBC,
+	YACA_BCM_CTR,
+};
+
+enum hashed_api {
+	HASHED_ATTACHED,
+	HASHED_TWO_PASS,
+	HASHED_INTERLEAVED,
+};
+
+struct hashed_arg {
+	yaca_block_cipher_mode_e bcm;
+	enum hashed_api api;
+	bool encrypt;
+	yaca_key_h key;
+	yaca_key_h iv;
+	const char *input;
+	size_t input_len;
+	char *output;
+	size_t output_len;
+	char digest[HASHED_DIGEST_LEN];
+};
+
+static int hashed_attached(struct hashed_arg *a)
+{
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_digest_algorithm_e algo = YACA_DIGEST_SHA256;
+	size_t written, final_len, digest_len;
+	int ret;
+
+	if (a->encrypt)
+		ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, a->iv);
+	else
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, a->iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO,
+	                                &algo, sizeof(algo));
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = bench_feed_out(ctx, a->encrypt ? yaca_encrypt_update : yaca_decrypt_update,
+	                     a->input, a->input_len, BENCH_CHUNK, a->output, &written);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (a->encrypt)
+		ret = yaca_encrypt_finalize(ctx, a->output + written, &final_len);
+	else
+		ret = yaca_decrypt_finalize(ctx, a->output + written, &final_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	a->output_len = written + final_len;
+
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST,
+	                                     a->digest, sizeof(a->digest), &digest_len);
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+/* What an application does without the attached digest */
+static int hashed_two_contexts(struct hashed_arg *a)
+{
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_context_h md = YACA_CONTEXT_NULL;
+	int (*update)(yaca_context_h, const char *, size_t, char *, size_t *) =
+		a->encrypt ? yaca_encrypt_update : yaca_decrypt_update;
+	size_t written = 0, digest_len, len;
+	int ret;
+
+	if (a->encrypt)
+		ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, a->iv);
+	else
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, a->bcm, a->key, a->iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_digest_initialize(&md, YACA_DIGEST_SHA256);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (a->api == HASHED_TWO_PASS) {
+		/* the plaintext is hashed as a whole, before or after the cipher */
+		if (a->encrypt) {
+			ret = bench_feed(md, yaca_digest_update, a->input, a->input_len);
+			if (ret != YACA_ERROR_NONE)
+				goto exit;
+		}
+
+		ret = bench_feed_out(ctx, update, a->input, a->input_len, BENCH_CHUNK,
+		                     a->output, &written);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	} else {
+		for (size_t pos = 0; pos < a->input_len; pos += BENCH_CHUNK) {
+			size_t chunk = a->input_len - pos < BENCH_CHUNK ? a->input_len - pos : BENCH_CHUNK;
+
+			if (a->encrypt) {
+				ret = yaca_digest_update(md, a->input + pos, chunk);
+				if (ret != YACA_ERROR_NONE)
+					goto exit;
+			}
+
+			ret = update(ctx, a->input + pos, chunk, a->output + written, &len);
+			if (ret != YACA_ERROR_NONE)
+				goto exit;
+
+			if (!a->encrypt && len > 0) {
+				ret = yaca_digest_update(md, a->output + written, len);
+				if (ret != YACA_ERROR_NONE)
+					goto exit;
+			}
+
+			written += len;
+		}
+	}
+
+	if (a->encrypt) {
+		ret = yaca_encrypt_finalize(ctx, a->output + written, &len);
+		written += len;
+	} else {
+		ret = yaca_decrypt_finalize(ctx, a->output + written, &len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		/* the last block, in the two-pass rows the whole plaintext */
+		if (a->api == HASHED_TWO_PASS)
+			ret = bench_feed(md, yaca_digest_update, a->output, written + len);
+		else if (len > 0)
+			ret = yaca_digest_update(md, a->output + written, len);
+		written += len;
+	}
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	a->output_len = written;
+
+	ret = yaca_digest_finalize(md, a->digest, &digest_len);
+
+exit:
+	yaca_context_destroy(md);
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+static int hashed_op(void *arg)
+{
+	struct hashed_arg *a = arg;
+
+	return a->api == HASHED_ATTACHED ? hashed_attached(a) : hashed_two_contexts(a);
+}
+
+static void bench_hashed_size(const char *name, struct hashed_arg *enc, char *ciphertext,
+                              size_t size)
+{
+	static const char *API_NAMES[] = {
+		[HASHED_ATTACHED] = "attached",
+		[HASHED_TWO_PASS] = "two-pass",
+		[HASHED_INTERLEAVED] = "interleaved",
+	};
+	struct hashed_arg dec;
+	int ret;
+
+	enc->encrypt = true;
+	enc->api = HASHED_ATTACHED;
+	enc->input = bench_input;
+	enc->input_len = size;
+	enc->output = ciphertext;
+
+	/* produces the ciphertext for the decrypt rows */
+	ret = hashed_op(enc);
+	if (ret != YACA_ERROR_NONE) {
+		bench_fail("hashed", name, "encrypt", "attached", size, ret);
+		return;
+	}
+
+	dec = *enc;
+	dec.encrypt = false;
+	dec.input = ciphertext;
+	dec.input_len = enc->output_len;
+	dec.output = bench_output;
+	enc->output = bench_output;
+
+	for (int api = HASHED_ATTACHED; api <= HASHED_INTERLEAVED; ++api) {
+		enc->api = api;
+		bench_run("hashed", name, "encrypt", API_NAMES[api], size, hashed_op, enc);
+	}
+
+	for (int api = HASHED_ATTACHED; api <= HASHED_INTERLEAVED; ++api) {
+		dec.api = api;
+		bench_run("hashed", name, "decrypt", API_NAMES[api], size, hashed_op, &dec);
+	}
+}
+
+void bench_hashed(void)
+{
+	int ret;
+	char *ciphertext = NULL;
+	struct hashed_arg a = {.key = YACA_KEY_NULL, .iv = YACA_KEY_NULL};
+
+	ret = yaca_malloc(bench_max_size() + BENCH_OUTPUT_SLACK, (void**)&ciphertext);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &a.key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &a.iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	for (size_t m = 0; m < sizeof(HASHED_MODES) / sizeof(HASHED_MODES[0]); ++m) {
+		char name[32];
+
+		a.bcm = HASHED_MODES[m];
+		bench_cipher_name(YACA_ENCRYPT_AES, a.bcm, YACA_KEY_LENGTH_256BIT, name, sizeof(name));
+
+		for (size_t s = 0; s < BENCH_SIZES_COUNT && BENCH_SIZES[s] <= bench_max_size(); ++s) {
+			if (BENCH_SIZES[s] < HASHED_MIN_SIZE)
+				continue;
+
+			bench_hashed_size(name, &a, ciphertext, BENCH_SIZES[s]);
+		}
+	}
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("hashed", "-", "setup", "-", 0, ret);
+
+	yaca_key_destroy(a.iv);
+	yaca_key_destroy(a.key);
+	yaca_free(ciphertext);
+}
@@ -0,0 +1,159 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_init.c
+ * @brief Context initialization latency benchmarks
+ *
+ * Measures yaca_*_initialize() + yaca_context_destroy() alone, without
+ * processing any data, so the cost of the algorithm lookup is visible.
+ */
+
+#include <yaca_crypto.h>
+#include <yaca_digest.h>
+#include <yaca_encrypt.h>
+#include <yaca_sign.h>
+#include <yaca_key.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+/* Both ends of the cipher table */
+static const struct {
+	yaca_encrypt_algorithm_e algo;
+	yaca_block_cipher_mode_e bcm;
+	size_t key_bit_len;
+	size_t iv_bit_len;
+} INIT_CIPHERS[] = {
+	{YACA_ENCRYPT_AES,        YACA_BCM_CBC, 128, 128},
+	{YACA_ENCRYPT_AES,        YACA_BCM_GCM, 256, 128},
+	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CBC, 192, 64},
+	{YACA_ENCRYPT_CAST5,      YACA_BCM_OFB, 128, 64},
+};
+
+struct init_arg {
+	yaca_encrypt_algorithm_e algo;
+	yaca_block_cipher_mode_e bcm;
+	yaca_digest_algorithm_e digest;
+	yaca_key_h key;
+	yaca_key_h iv;
+	bool decrypt;
+};
+
+static int encrypt_init_op(void *arg)
+{
+	struct init_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	int ret;
+
+	if (a->decrypt)
+		ret = yaca_decrypt_initialize(&ctx, a->algo, a->bcm, a->key, a->iv);
+	else
+		ret = yaca_encrypt_initialize(&ctx, a->algo, a->bcm, a->key, a->iv);
+
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+static int cmac_init_op(void *arg)
+{
+	struct init_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	int ret;
+
+	ret = yaca_sign_initialize_cmac(&ctx, a->algo, a->key);
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+static int hmac_init_op(void *arg)
+{
+	struct init_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	int ret;
+
+	ret = yaca_sign_initialize_hmac(&ctx, a->digest, a->key);
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+static int digest_init_op(void *arg)
+{
+	struct init_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	int ret;
+
+	ret = yaca_digest_initialize(&ctx, a->digest);
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+static void bench_init_cipher(size_t c)
+{
+	int ret;
+	char name[64];
+	yaca_key_type_e key_type = INIT_CIPHERS[c].algo == YACA_ENCRYPT_AES ||
+	                           INIT_CIPHERS[c].algo == YACA_ENCRYPT_CAST5 ?
+	                           YACA_KEY_TYPE_SYMMETRIC : YACA_KEY_TYPE_DES;
+	struct init_arg arg = {INIT_CIPHERS[c].algo, INIT_CIPHERS[c].bcm, YACA_DIGEST_SHA256,
+	                       YACA_KEY_NULL, YACA_KEY_NULL, false};
+
+	bench_cipher_name(arg.algo, arg.bcm, INIT_CIPHERS[c].key_bit_len, name, sizeof(name));
+
+	ret = yaca_key_generate(key_type, INIT_CIPHERS[c].key_bit_len, &arg.key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, INIT_CIPHERS[c].iv_bit_len, &arg.iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	bench_run("init", name, "encrypt", "-", 0, encrypt_init_op, &arg);
+	arg.decrypt = true;
+	bench_run("init", name, "decrypt", "-", 0, encrypt_init_op, &arg);
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("init", name, "setup", "-", 0, ret);
+
+	yaca_key_destroy(arg.iv);
+	yaca_key_destroy(arg.key);
+}
+
+void bench_init(void)
+{
+	int ret;
+	struct init_arg arg = {YACA_ENCRYPT_AES, YACA_BCM_CBC, YACA_DIGEST_SHA512,
+	                       YACA_KEY_NULL, YACA_KEY_NULL, false};
+
+	for (size_t c = 0; c < sizeof(INIT_CIPHERS) / sizeof(INIT_CIPHERS[0]); ++c)
+		bench_init_cipher(c);
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &arg.key);
+	if (ret != YACA_ERROR_NONE) {
+		bench_fail("init", "-", "setup", "-", 0, ret);
+		return;
+	}
+
+	bench_run("init", "CMAC-AES-256", "sign", "-", 0, cmac_init_op, &arg);
+	bench_run("init", "HMAC-SHA512", "sign", "-", 0, hmac_init_op, &arg);
+	bench_run("init", "SHA512", "digest", "-", 0, digest_init_op, &arg);
+
+	yaca_key_destroy(arg.key);
+}
@@ -0,0 +1,526 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_key.c
+ * @brief Key generation, key derivation and RSA benchmarks
+ */
+
+#include <stdio.h>
+
+#include <yaca_crypto.h>
+#include <yaca_key.h>
+#include <yaca_rsa.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+struct keygen_arg {
+	yaca_key_type_e type;
+	size_t key_bit_len;
+	yaca_key_h params;
+};
+
+static int keygen_op(void *arg)
+{
+	struct keygen_arg *a = arg;
+	yaca_key_h key = YACA_KEY_NULL;
+	int ret;
+
+	if (a->params != YACA_KEY_NULL)
+		ret = yaca_key_generate_from_parameters(a->params, &key);
+	else
+		ret = yaca_key_generate(a->type, a->key_bit_len, &key);
+
+	yaca_key_destroy(key);
+	return ret;
+}
+
+struct derive_arg {
+	yaca_key_h prv;
+	yaca_key_h pub;
+	const char *secret;
+	size_t secret_len;
+};
+
+static int derive_dh_op(void *arg)
+{
+	struct derive_arg *a = arg;
+	char *secret = NULL;
+	size_t secret_len;
+	int ret;
+
+	ret = yaca_key_derive_dh(a->prv, a->pub, &secret, &secret_len);
+	yaca_free(secret);
+	return ret;
+}
+
+static int derive_kdf_op(void *arg)
+{
+	struct derive_arg *a = arg;
+	char *key_material = NULL;
+	int ret;
+
+	ret = yaca_key_derive_kdf(YACA_KDF_X962, YACA_DIGEST_SHA256, a->secret, a->secret_len,
+	                          NULL, 0, 32, &key_material);
+	yaca_free(key_material);
+	return ret;
+}
+
+static const size_t PBKDF2_ITERATIONS = 1000;
+
+static int derive_pbkdf2_op(void *arg)
+{
+	yaca_key_h key = YACA_KEY_NULL;
+	int ret;
+	(void)arg;
+
+	ret = yaca_key_derive_pbkdf2("password", "salt", 4, PBKDF2_ITERATIONS, YACA_DIGEST_SHA256,
+	                             YACA_KEY_LENGTH_256BIT, &key);
+	yaca_key_destroy(key);
+	return ret;
+}
+
+/* Typical for stored password hashes */
+#define PBKDF2_SLOW_ITERATIONS 100000
+#define PBKDF2_BATCH 8
+
+static const size_t PBKDF2_THREADS[] = {1, 4, PBKDF2_BATCH};
+
+struct pbkdf2_arg {
+	size_t key_bit_len;
+	size_t threads;
+};
+
+static int derive_pbkdf2_slow_op(void *arg)
+{
+	struct pbkdf2_arg *a = arg;
+	yaca_key_h key = YACA_KEY_NULL;
+	int ret;
+
+	ret = yaca_key_derive_pbkdf2_parallel("password", "salt", 4, PBKDF2_SLOW_ITERATIONS,
+	                                      YACA_DIGEST_SHA256, a->key_bit_len, &key, a->threads);
+	yaca_key_destroy(key);
+	return ret;
+}
+
+static int derive_pbkdf2_batch_op(void *arg)
+{
+	struct pbkdf2_arg *a = arg;
+	static const char *const passwords[PBKDF2_BATCH] = {
+		"password0", "password1", "password2", "password3",
+		"password4", "password5", "password6", "password7"
+	};
+	static const char *const salts[PBKDF2_BATCH] = {
+		"salt0", "salt1", "salt2", "salt3", "salt4", "salt5", "salt6", "salt7"
+	};
+	static const size_t salt_lens[PBKDF2_BATCH] = {5, 5, 5, 5, 5, 5, 5, 5};
+	yaca_key_h keys[PBKDF2_BATCH];
+	int ret;
+
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, PBKDF2_BATCH,
+	                                   PBKDF2_SLOW_ITERATIONS, YACA_DIGEST_SHA256,
+	                                   a->key_bit_len, keys, a->threads);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	for (size_t i = 0; i < PBKDF2_BATCH; ++i)
+		yaca_key_destroy(keys[i]);
+	return ret;
+}
+
+static void bench_keygen(const char *name, yaca_key_type_e type, size_t key_bit_len)
+{
+	struct keygen_arg arg = {type, key_bit_len, YACA_KEY_NULL};
+
+	bench_run("key", name, "generate", "-", 0, keygen_op, &arg);
+}
+
+static void bench_keygen_params(const char *name, yaca_key_type_e type, size_t key_bit_len)
+{
+	int ret;
+	struct keygen_arg arg = {type, key_bit_len, YACA_KEY_NULL};
+
+	ret = yaca_key_generate(type, key_bit_len, &arg.params);
+	if (ret != YACA_ERROR_NONE) {
+		bench_fail("key", name, "generate", "params", 0, ret);
+		return;
+	}
+
+	bench_run("key", name, "generate", "params", 0, keygen_op, &arg);
+	yaca_key_destroy(arg.params);
+}
+
+static void bench_derive_dh(const char *name, yaca_key_type_e type, size_t key_bit_len)
+{
+	int ret;
+	yaca_key_h prv = YACA_KEY_NULL;
+	yaca_key_h peer = YACA_KEY_NULL;
+	yaca_key_h params = YACA_KEY_NULL;
+	yaca_key_h peer_pub = YACA_KEY_NULL;
+	char *secret = NULL;
+	struct derive_arg arg = {.secret = NULL};
+
+	ret = yaca_key_generate(type, key_bit_len, &prv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_extract_parameters(prv, &params);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_generate_from_parameters(params, &peer);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_extract_public(peer, &peer_pub);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	arg.prv = prv;
+	arg.pub = peer_pub;
+	bench_run("key", name, "derive_dh", "-", 0, derive_dh_op, &arg);
+
+	/* the shared secret feeds the KDF row */
+	ret = yaca_key_derive_dh(prv, peer_pub, &secret, &arg.secret_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	arg.secret = secret;
+	bench_run("key", name, "derive_kdf", "X962", arg.secret_len, derive_kdf_op, &arg);
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("key", name, "derive_dh", "-", 0, ret);
+
+	yaca_free(secret);
+	yaca_key_destroy(peer_pub);
+	yaca_key_destroy(peer);
+	yaca_key_destroy(params);
+	yaca_key_destroy(prv);
+}
+
+struct import_arg {
+	yaca_key_type_e type;
+	size_t curve;
+	const char *data;
+	size_t data_len;
+};
+
+static int import_op(void *arg)
+{
+	struct import_arg *a = arg;
+	yaca_key_h key = YACA_KEY_NULL;
+	int ret;
+
+	if (a->curve != 0)
+		ret = yaca_key_import_raw(a->type, a->curve, a->data, a->data_len, &key);
+	else
+		ret = yaca_key_import(a->type, NULL, a->data, a->data_len, &key);
+
+	yaca_key_destroy(key);
+	return ret;
+}
+
+/* A device public key as received by a gateway, as SPKI DER and as SEC1 points */
+static void bench_import_ec(const char *name, size_t curve)
+{
+	static const struct {
+		const char *api;
+		yaca_key_format_e fmt;
+		yaca_key_file_format_e file_fmt;
+	} FORMATS[] = {
+		{"der",        YACA_KEY_FORMAT_DEFAULT,       YACA_KEY_FILE_FORMAT_DER},
+		{"raw",        YACA_KEY_FORMAT_DEFAULT,       YACA_KEY_FILE_FORMAT_RAW},
+		{"compressed", YACA_KEY_FORMAT_EC_COMPRESSED, YACA_KEY_FILE_FORMAT_RAW},
+	};
+	int ret;
+	yaca_key_h prv = YACA_KEY_NULL;
+	yaca_key_h pub = YACA_KEY_NULL;
+	char *data = NULL;
+	struct import_arg arg = {YACA_KEY_TYPE_EC_PUB, 0, NULL, 0};
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_EC_PRIV, curve, &prv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_extract_public(prv, &pub);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	for (size_t i = 0; i < sizeof(FORMATS) / sizeof(FORMATS[0]); ++i) {
+		ret = yaca_key_export(pub, FORMATS[i].fmt, FORMATS[i].file_fmt, NULL,
+		                      &data, &arg.data_len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		arg.curve = FORMATS[i].file_fmt == YACA_KEY_FILE_FORMAT_RAW ? curve : 0;
+		arg.data = data;
+		bench_run("key", name, "import_pub", FORMATS[i].api, arg.data_len, import_op, &arg);
+
+		yaca_free(data);
+		data = NULL;
+	}
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("key", name, "import_pub", "-", 0, ret);
+
+	yaca_free(data);
+	yaca_key_destroy(pub);
+	yaca_key_destroy(prv);
+}
+
+void bench_key(void)
+{
+	bench_keygen("SYMMETRIC-256", YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT);
+	bench_keygen("DES-192", YACA_KEY_TYPE_DES, YACA_KEY_LENGTH_192BIT);
+	bench_keygen("IV-128", YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT);
+	bench_keygen("RSA-2048", YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_2048BIT);
+	bench_keygen("EC-P256", YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_PRIME256V1);
+	bench_keygen_params("DSA-2048", YACA_KEY_TYPE_DSA_PARAMS, YACA_KEY_LENGTH_2048BIT);
+	bench_keygen_params("DH-2048-256", YACA_KEY_TYPE_DH_PARAMS, YACA_KEY_LENGTH_DH_RFC_2048_256);
+	bench_keygen_params("EC-P256", YACA_KEY_TYPE_EC_PARAMS, YACA_KEY_LENGTH_EC_PRIME256V1);
+
+	bench_derive_dh("DH-2048-256", YACA_KEY_TYPE_DH_PRIV, YACA_KEY_LENGTH_DH_RFC_2048_256);
+	bench_derive_dh("EC-P256", YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_PRIME256V1);
+
+	bench_import_ec("EC-P256", YACA_KEY_LENGTH_EC_PRIME256V1);
+
+	bench_run("key", "PBKDF2-SHA256-1000", "derive", "-", 0, derive_pbkdf2_op, NULL);
+}
+
+void bench_pbkdf2(void)
+{
+	struct pbkdf2_arg arg = {YACA_KEY_LENGTH_256BIT, 1};
+	char api[16];
+
+	/* a single output block, then two of them on one and on two threads */
+	bench_run("pbkdf2", "PBKDF2-SHA256-100k", "derive", "256", 0, derive_pbkdf2_slow_op, &arg);
+	arg.key_bit_len = YACA_KEY_LENGTH_512BIT;
+	bench_run("pbkdf2", "PBKDF2-SHA256-100k", "derive", "512", 0, derive_pbkdf2_slow_op, &arg);
+	arg.threads = 2;
+	bench_run("pbkdf2", "PBKDF2-SHA256-100k", "parallel", "512-2t", 0,
+	          derive_pbkdf2_slow_op, &arg);
+
+	/* a batch of passwords to be checked, e.g. by a login service */
+	arg.key_bit_len = YACA_KEY_LENGTH_256BIT;
+	for (size_t t = 0; t < sizeof(PBKDF2_THREADS) / sizeof(PBKDF2_THREADS[0]); ++t) {
+		arg.threads = PBKDF2_THREADS[t];
+		snprintf(api, sizeof(api), "%zut", arg.threads);
+		bench_run("pbkdf2", "PBKDF2-SHA256-100k-x8", "batch", api, 0,
+		          derive_pbkdf2_batch_op, &arg);
+	}
+}
+
+/* Peers of a single server key, e.g. members of a group */
+#define ECDH_PEERS 64
+/* Enough for the secrets of any supported curve */
+#define ECDH_SECRET_MAX 128
+
+static const size_t ECDH_THREADS[] = {1, 4};
+
+struct ecdh_arg {
+	yaca_key_h prv;
+	yaca_context_h ctx;
+	yaca_key_h pubs[ECDH_PEERS];
+	char *secrets[ECDH_PEERS];
+	size_t secret_lens[ECDH_PEERS];
+	size_t threads;
+};
+
+static int ecdh_single_op(void *arg)
+{
+	struct ecdh_arg *a = arg;
+	char *secret;
+	size_t secret_len;
+	int ret;
+
+	for (size_t i = 0; i < ECDH_PEERS; ++i) {
+		ret = yaca_key_derive_dh(a->prv, a->pubs[i], &secret, &secret_len);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+		yaca_free(secret);
+	}
+
+	return YACA_ERROR_NONE;
+}
+
+static int ecdh_batch_op(void *arg)
+{
+	struct ecdh_arg *a = arg;
+
+	return yaca_key_derive_dh_batch(a->ctx, a->pubs, ECDH_PEERS, a->secrets, a->secret_lens,
+	                                a->threads);
+}
+
+static void bench_ecdh_curve(const char *name, size_t key_bit_len)
+{
+	int ret;
+	char api[16];
+	static char store[ECDH_PEERS][ECDH_SECRET_MAX];
+	static struct ecdh_arg a;
+	yaca_key_h peer = YACA_KEY_NULL;
+	size_t secret_len;
+
+	a.prv = YACA_KEY_NULL;
+	a.ctx = YACA_CONTEXT_NULL;
+	for (size_t i = 0; i < ECDH_PEERS; ++i) {
+		a.pubs[i] = YACA_KEY_NULL;
+		a.secrets[i] = store[i];
+	}
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_EC_PRIV, key_bit_len, &a.prv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	for (size_t i = 0; i < ECDH_PEERS; ++i) {
+		ret = yaca_key_generate(YACA_KEY_TYPE_EC_PRIV, key_bit_len, &peer);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = yaca_key_extract_public(peer, &a.pubs[i]);
+		yaca_key_destroy(peer);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	ret = yaca_key_derive_dh_initialize(&a.ctx, a.prv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_context_get_output_length(a.ctx, 0, &secret_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (secret_len > ECDH_SECRET_MAX) {
+		ret = YACA_ERROR_INTERNAL;
+		goto exit;
+	}
+
+	bench_run("ecdh", name, "derive_x64", "single", 0, ecdh_single_op, &a);
+
+	for (size_t t = 0; t < sizeof(ECDH_THREADS) / sizeof(ECDH_THREADS[0]); ++t) {
+		a.threads = ECDH_THREADS[t];
+		snprintf(api, sizeof(api), "batch-%zut", a.threads);
+		bench_run("ecdh", name, "derive_x64", api, 0, ecdh_batch_op, &a);
+	}
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("ecdh", name, "derive_x64", "-", 0, ret);
+
+	yaca_context_destroy(a.ctx);
+	for (size_t i = 0; i < ECDH_PEERS; ++i)
+		yaca_key_destroy(a.pubs[i]);
+	yaca_key_destroy(a.prv);
+}
+
+void bench_ecdh(void)
+{
+	bench_ecdh_curve("EC-P256", YACA_KEY_LENGTH_EC_PRIME256V1);
+	bench_ecdh_curve("EC-P384", YACA_KEY_LENGTH_EC_SECP384R1);
+}
+
+struct rsa_arg {
+	yaca_padding_e padding;
+	yaca_key_h key;
+	const char *input;
+	size_t input_len;
+	bool public_op;
+	bool encrypt;
+};
+
+static int rsa_op(void *arg)
+{
+	struct rsa_arg *a = arg;
+	char *output = NULL;
+	size_t output_len;
+	int ret;
+
+	if (a->public_op && a->encrypt)
+		ret = yaca_rsa_public_encrypt(a->padding, a->key, a->input, a->input_len,
+		                              &output, &output_len);
+	else if (a->public_op)
+		ret = yaca_rsa_public_decrypt(a->padding, a->key, a->input, a->input_len,
+		                              &output, &output_len);
+	else if (a->encrypt)
+		ret = yaca_rsa_private_encrypt(a->padding, a->key, a->input, a->input_len,
+		                               &output, &output_len);
+	else
+		ret = yaca_rsa_private_decrypt(a->padding, a->key, a->input, a->input_len,
+		                               &output, &output_len);
+
+	yaca_free(output);
+	return ret;
+}
+
+/* A typical symmetric key being transported */
+static const size_t RSA_INPUT_LEN = 32;
+
+void bench_rsa(void)
+{
+	int ret;
+	const char *name = "RSA-2048";
+	yaca_key_h prv = YACA_KEY_NULL;
+	yaca_key_h pub = YACA_KEY_NULL;
+	char *pub_enc = NULL;
+	char *prv_enc = NULL;
+	size_t pub_enc_len, prv_enc_len;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_2048BIT, &prv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_extract_public(prv, &pub);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_rsa_public_encrypt(YACA_PADDING_PKCS1_OAEP, pub, bench_input, RSA_INPUT_LEN,
+	                              &pub_enc, &pub_enc_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_rsa_private_encrypt(YACA_PADDING_PKCS1, prv, bench_input, RSA_INPUT_LEN,
+	                               &prv_enc, &prv_enc_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	{
+		struct rsa_arg args[] = {
+			{YACA_PADDING_PKCS1_OAEP, pub, bench_input, RSA_INPUT_LEN, true, true},
+			{YACA_PADDING_PKCS1_OAEP, prv, pub_enc, pub_enc_len, false, false},
+			{YACA_PADDING_PKCS1, prv, bench_input, RSA_INPUT_LEN, false, true},
+			{YACA_PADDING_PKCS1, pub, prv_enc, prv_enc_len, true, false},
+		};
+		const char *ops[] = {"pub_enc", "prv_dec", "prv_enc", "pub_dec"};
+
+		for (size_t i = 0; i < sizeof(args) / sizeof(args[0]); ++i)
+			bench_run("rsa", name, ops[i], "simple", args[i].input_len, rsa_op, &args[i]);
+	}
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("rsa", name, "setup", "-", 0, ret);
+
+	yaca_free(prv_enc);
+	yaca_free(pub_enc);
+	yaca_key_destroy(pub);
+	yaca_key_destroy(prv);
+}
@@ -0,0 +1,213 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_rotation.c
+ * @brief Key encryption key rotation benchmarks
+ *
+ * Every wrapped key of a keystore is unwrapped with the old KEK and wrapped
+ * again with the new one. The rows are reported per key, so ops/s is the
+ * number of keys rotated (or wrapped) per second.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdint.h>
+#include <time.h>
+
+#include <yaca_crypto.h>
+#include <yaca_encrypt.h>
+#include <yaca_simple.h>
+#include <yaca_key.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+#define ROTATION_KEYS 1024
+#define ROTATION_KEY_LEN 32
+/* AES key wrap adds a single 64 bit block */
+#define ROTATION_WRAPPED_LEN (ROTATION_KEY_LEN + 8)
+
+static const size_t ROTATION_THREADS[] = {1, 4, 16};
+
+struct rotation_arg {
+	yaca_key_h old_kek;
+	yaca_key_h new_kek;
+	yaca_key_h iv;
+	size_t threads;
+	bool rotate;
+	const char *wrapped[ROTATION_KEYS];
+	size_t wrapped_lens[ROTATION_KEYS];
+	char *keys[ROTATION_KEYS];
+	size_t key_lens[ROTATION_KEYS];
+	char *rewrapped[ROTATION_KEYS];
+	size_t rewrapped_lens[ROTATION_KEYS];
+	char store[3][ROTATION_KEYS][ROTATION_WRAPPED_LEN];
+};
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+/* A context and two allocations per key and direction */
+static int rotate_simple_op(struct rotation_arg *a)
+{
+	int ret = YACA_ERROR_NONE;
+
+	for (size_t i = 0; i < ROTATION_KEYS; ++i) {
+		char *key = NULL, *wrapped = NULL;
+		size_t key_len, wrapped_len;
+
+		if (a->rotate) {
+			ret = yaca_simple_decrypt(YACA_ENCRYPT_AES, YACA_BCM_WRAP, a->old_kek, a->iv,
+			                          a->wrapped[i], a->wrapped_lens[i], &key, &key_len);
+			if (ret != YACA_ERROR_NONE)
+				return ret;
+		}
+
+		ret = yaca_simple_encrypt(YACA_ENCRYPT_AES, YACA_BCM_WRAP, a->new_kek, a->iv,
+		                          a->rotate ? key : a->store[1][i], ROTATION_KEY_LEN,
+		                          &wrapped, &wrapped_len);
+		yaca_free(wrapped);
+		yaca_free(key);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+	}
+
+	return ret;
+}
+
+/* One KEK schedule per direction for the whole keystore */
+static int rotate_batch_op(struct rotation_arg *a)
+{
+	int ret;
+
+	if (a->rotate) {
+		ret = yaca_decrypt_unwrap_batch(YACA_ENCRYPT_AES, a->old_kek, a->iv,
+		                                a->wrapped, a->wrapped_lens, ROTATION_KEYS,
+		                                a->keys, a->key_lens, a->threads);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+	}
+
+	return yaca_encrypt_wrap_batch(YACA_ENCRYPT_AES, a->new_kek, a->iv,
+	                               (const char *const *)a->keys, a->key_lens, ROTATION_KEYS,
+	                               a->rewrapped, a->rewrapped_lens, a->threads);
+}
+
+static void bench_rotation_run(const char *op, const char *api, struct rotation_arg *a)
+{
+	int ret;
+	size_t iterations = 0;
+	uint64_t start, elapsed;
+
+	/* warm up */
+	ret = a->threads == 0 ? rotate_simple_op(a) : rotate_batch_op(a);
+	if (ret != YACA_ERROR_NONE) {
+		bench_fail("rotation", "KW-AES-256", op, api, ROTATION_KEY_LEN, ret);
+		return;
+	}
+
+	start = now_ns();
+	do {
+		ret = a->threads == 0 ? rotate_simple_op(a) : rotate_batch_op(a);
+		if (ret != YACA_ERROR_NONE) {
+			bench_fail("rotation", "KW-AES-256", op, api, ROTATION_KEY_LEN, ret);
+			return;
+		}
+		iterations += ROTATION_KEYS;
+		elapsed = now_ns() - start;
+	} while (elapsed < (uint64_t)(bench_min_time() * 1e9));
+
+	bench_report("rotation", "KW-AES-256", op, api, ROTATION_KEY_LEN, iterations, elapsed);
+}
+
+void bench_rotation(void)
+{
+	int ret;
+	size_t iv_bit_len;
+	char api[16];
+	static struct rotation_arg a;
+
+	a.old_kek = a.new_kek = a.iv = YACA_KEY_NULL;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &a.old_kek);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &a.new_kek);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_encrypt_get_iv_bit_length(YACA_ENCRYPT_AES, YACA_BCM_WRAP,
+	                                     YACA_KEY_LENGTH_256BIT, &iv_bit_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, iv_bit_len, &a.iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	/* store[0] wrapped under the old KEK, store[1] plain, store[2] rewrapped */
+	ret = yaca_randomize_bytes(&a.store[1][0][0], sizeof(a.store[1]));
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	for (size_t i = 0; i < ROTATION_KEYS; ++i) {
+		a.keys[i] = a.store[1][i];
+		a.key_lens[i] = ROTATION_KEY_LEN;
+		a.rewrapped[i] = a.store[2][i];
+		a.rewrapped_lens[i] = ROTATION_WRAPPED_LEN;
+		a.wrapped[i] = a.store[0][i];
+		a.wrapped_lens[i] = ROTATION_WRAPPED_LEN;
+	}
+
+	ret = yaca_encrypt_wrap_batch(YACA_ENCRYPT_AES, a.old_kek, a.iv,
+	                              (const char *const *)a.keys, a.key_lens, ROTATION_KEYS,
+	                              (char *const *)a.wrapped, a.wrapped_lens, 1);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	for (int rotate = 0; rotate <= 1; ++rotate) {
+		const char *op = rotate ? "rotate" : "wrap";
+
+		a.rotate = rotate;
+		a.threads = 0;
+		bench_rotation_run(op, "simple", &a);
+
+		for (size_t t = 0; t < sizeof(ROTATION_THREADS) / sizeof(ROTATION_THREADS[0]); ++t) {
+			a.threads = ROTATION_THREADS[t];
+			snprintf(api, sizeof(api), "%zut", a.threads);
+			bench_rotation_run(op, api, &a);
+		}
+	}
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("rotation", "-", "setup", "-", 0, ret);
+
+	yaca_key_destroy(a.iv);
+	yaca_key_destroy(a.new_kek);
+	yaca_key_destroy(a.old_kek);
+}
@@ -0,0 +1,321 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_sign.c
+ * @brief Signature and MAC benchmarks
+ */
+
+#include <string.h>
+
+#include <yaca_crypto.h>
+#include <yaca_sign.h>
+#include <yaca_simple.h>
+#include <yaca_key.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+static const yaca_digest_algorithm_e SIGN_DIGEST = YACA_DIGEST_SHA256;
+
+static const struct {
+	const char *name;
+	yaca_key_type_e type;
+	size_t key_bit_len;
+} SIGN_KEYS[] = {
+	{"RSA-2048",   YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_2048BIT},
+	{"DSA-2048",   YACA_KEY_TYPE_DSA_PRIV, YACA_KEY_LENGTH_2048BIT},
+	{"EC-P256",    YACA_KEY_TYPE_EC_PRIV,  YACA_KEY_LENGTH_EC_PRIME256V1},
+};
+
+/* Large enough for any signature or MAC benchmarked here */
+#define SIGNATURE_MAX_LEN ((size_t)512)
+
+struct sign_arg {
+	yaca_key_h key;
+	const char *message;
+	size_t message_len;
+	char signature[SIGNATURE_MAX_LEN];
+	size_t signature_len;
+};
+
+static int sign_simple(void *arg)
+{
+	struct sign_arg *a = arg;
+	char *signature = NULL;
+	size_t signature_len;
+	int ret;
+
+	ret = yaca_simple_calculate_signature(SIGN_DIGEST, a->key, a->message, a->message_len,
+	                                      &signature, &signature_len);
+	yaca_free(signature);
+	return ret;
+}
+
+static int sign_stream(void *arg)
+{
+	struct sign_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t signature_len;
+	int ret;
+
+	ret = yaca_sign_initialize(&ctx, SIGN_DIGEST, a->key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_context_get_output_length(ctx, 0, &signature_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (signature_len > sizeof(a->signature)) {
+		ret = YACA_ERROR_INTERNAL;
+		goto exit;
+	}
+
+	ret = bench_feed(ctx, yaca_sign_update, a->message, a->message_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_sign_finalize(ctx, a->signature, &signature_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	a->signature_len = signature_len;
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+static int verify_simple(void *arg)
+{
+	struct sign_arg *a = arg;
+
+	return yaca_simple_verify_signature(SIGN_DIGEST, a->key, a->message, a->message_len,
+	                                    a->signature, a->signature_len);
+}
+
+static int verify_stream(void *arg)
+{
+	struct sign_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	int ret;
+
+	ret = yaca_verify_initialize(&ctx, SIGN_DIGEST, a->key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = bench_feed(ctx, yaca_verify_update, a->message, a->message_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_verify_finalize(ctx, a->signature, a->signature_len);
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+/* Not DER, the verification fails with an internal error */
+static const char MALFORMED_SIGNATURE[] = {0x30, 0x00, 0x00, 0x00};
+
+static int verify_malformed(void *arg)
+{
+	struct sign_arg *a = arg;
+	int ret;
+
+	ret = yaca_simple_verify_signature(SIGN_DIGEST, a->key, a->message, a->message_len,
+	                                   MALFORMED_SIGNATURE, sizeof(MALFORMED_SIGNATURE));
+	return ret == YACA_ERROR_NONE ? YACA_ERROR_INTERNAL : YACA_ERROR_NONE;
+}
+
+void bench_sign(void)
+{
+	for (size_t k = 0; k < sizeof(SIGN_KEYS) / sizeof(SIGN_KEYS[0]); ++k) {
+		int ret;
+		const char *name = SIGN_KEYS[k].name;
+		yaca_key_h prv = YACA_KEY_NULL;
+		yaca_key_h pub = YACA_KEY_NULL;
+		yaca_key_h pub_prepared = YACA_KEY_NULL;
+
+		ret = yaca_key_generate(SIGN_KEYS[k].type, SIGN_KEYS[k].key_bit_len, &prv);
+		if (ret != YACA_ERROR_NONE)
+			goto next;
+
+		ret = yaca_key_extract_public(prv, &pub);
+		if (ret != YACA_ERROR_NONE)
+			goto next;
+
+		/* A separate key, the preparation is kept in the key */
+		ret = yaca_key_extract_public(prv, &pub_prepared);
+		if (ret != YACA_ERROR_NONE)
+			goto next;
+
+		ret = yaca_verify_prepare_key(pub_prepared);
+		if (ret != YACA_ERROR_NONE)
+			goto next;
+
+		for (size_t s = 0; s < BENCH_SIZES_COUNT && BENCH_SIZES[s] <= bench_max_size(); ++s) {
+			struct sign_arg sign = {.key = prv, .message = bench_input, .message_len = BENCH_SIZES[s]};
+			struct sign_arg verify = {.key = pub, .message = bench_input, .message_len = BENCH_SIZES[s]};
+			struct sign_arg prepared;
+
+			ret = sign_stream(&sign);
+			if (ret != YACA_ERROR_NONE) {
+				bench_fail("sign", name, "sign", "stream", sign.message_len, ret);
+				continue;
+			}
+
+			memcpy(verify.signature, sign.signature, sign.signature_len);
+			verify.signature_len = sign.signature_len;
+			prepared = verify;
+			prepared.key = pub_prepared;
+
+			bench_run("sign", name, "sign", "simple", sign.message_len, sign_simple, &sign);
+			bench_run("sign", name, "sign", "stream", sign.message_len, sign_stream, &sign);
+			bench_run("sign", name, "verify", "simple", verify.message_len, verify_simple, &verify);
+			bench_run("sign", name, "verify", "stream", verify.message_len, verify_stream, &verify);
+			bench_run("sign", name, "verify", "prepared", prepared.message_len, verify_stream, &prepared);
+			bench_run("sign", name, "verify", "bad-der", verify.message_len, verify_malformed, &verify);
+		}
+
+		ret = YACA_ERROR_NONE;
+
+next:
+		if (ret != YACA_ERROR_NONE)
+			bench_fail("sign", name, "setup", "-", 0, ret);
+
+		yaca_key_destroy(pub_prepared);
+		yaca_key_destroy(pub);
+		yaca_key_destroy(prv);
+	}
+}
+
+enum mac_type {
+	MAC_HMAC,
+	MAC_CMAC,
+	MAC_GMAC,
+};
+
+struct mac_arg {
+	enum mac_type type;
+	yaca_key_h key;
+	yaca_key_h iv;
+	size_t message_len;
+};
+
+static const yaca_digest_algorithm_e HMAC_DIGEST = YACA_DIGEST_SHA256;
+static const yaca_encrypt_algorithm_e CMAC_CIPHER = YACA_ENCRYPT_AES;
+
+static int mac_simple(void *arg)
+{
+	struct mac_arg *a = arg;
+	char *mac = NULL;
+	size_t mac_len;
+	int ret;
+
+	switch (a->type) {
+	case MAC_CMAC:
+		ret = yaca_simple_calculate_cmac(CMAC_CIPHER, a->key, bench_input, a->message_len,
+		                                 &mac, &mac_len);
+		break;
+	case MAC_GMAC:
+		ret = yaca_simple_calculate_gmac(a->key, a->iv, bench_input, a->message_len,
+		                                 &mac, &mac_len);
+		break;
+	default:
+		ret = yaca_simple_calculate_hmac(HMAC_DIGEST, a->key, bench_input, a->message_len,
+		                                 &mac, &mac_len);
+		break;
+	}
+
+	yaca_free(mac);
+	return ret;
+}
+
+static int mac_stream(void *arg)
+{
+	struct mac_arg *a = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t mac_len;
+	int ret;
+
+	switch (a->type) {
+	case MAC_CMAC:
+		ret = yaca_sign_initialize_cmac(&ctx, CMAC_CIPHER, a->key);
+		break;
+	case MAC_GMAC:
+		ret = yaca_sign_initialize_gmac(&ctx, a->key, a->iv);
+		break;
+	default:
+		ret = yaca_sign_initialize_hmac(&ctx, HMAC_DIGEST, a->key);
+		break;
+	}
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = bench_feed(ctx, yaca_sign_update, bench_input, a->message_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_sign_finalize(ctx, bench_output, &mac_len);
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+/* The GMAC rows reuse the IV, which is only acceptable in a benchmark */
+void bench_mac(void)
+{
+	static const char *MAC_NAMES[] = {
+		[MAC_HMAC] = "HMAC-SHA256",
+		[MAC_CMAC] = "CMAC-AES-256",
+		[MAC_GMAC] = "GMAC-AES-256",
+	};
+	int ret;
+	yaca_key_h key = YACA_KEY_NULL;
+	yaca_key_h iv = YACA_KEY_NULL;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, 96, &iv);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	for (int type = MAC_HMAC; type <= MAC_GMAC; ++type) {
+		const char *name = MAC_NAMES[type];
+
+		for (size_t s = 0; s < BENCH_SIZES_COUNT && BENCH_SIZES[s] <= bench_max_size(); ++s) {
+			struct mac_arg arg = {type, key, iv, BENCH_SIZES[s]};
+
+			bench_run("mac", name, "sign", "simple", arg.message_len, mac_simple, &arg);
+			bench_run("mac", name, "sign", "stream", arg.message_len, mac_stream, &arg);
+		}
+	}
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("mac", "-", "setup", "-", 0, ret);
+
+	yaca_key_destroy(iv);
+	yaca_key_destroy(key);
+}
@@ -0,0 +1,233 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file bench_threads.c
+ * @brief Multi-threaded context initialization benchmarks
+ *
+ * Every thread creates and destroys contexts in a loop. With the implicit
+ * algorithm fetching of OpenSSL 3 each initialization takes a global lock, so
+ * the aggregate rate stops scaling with the number of threads.
+ *
+ * The RSA rows sign with one key shared by all of the threads, the blinding
+ * of which OpenSSL locks, and with one prepared by yaca_sign_prepare_key().
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <time.h>
+
+#include <yaca_crypto.h>
+#include <yaca_digest.h>
+#include <yaca_encrypt.h>
+#include <yaca_sign.h>
+#include <yaca_simple.h>
+#include <yaca_key.h>
+#include <yaca_error.h>
+
+#include "bench.h"
+
+
+#define MAX_THREADS 16
+
+static const size_t THREAD_COUNTS[] = {1, 2, 4, 8, MAX_THREADS};
+
+struct thread_arg {
+	pthread_barrier_t *barrier;
+	bench_op_fn fn;
+	void *fn_arg;
+	uint64_t duration;
+	size_t iterations;
+	int ret;
+};
+
+static uint64_t now_ns(void)
+{
+	struct timespec ts;
+
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+static void *thread_main(void *arg)
+{
+	struct thread_arg *a = arg;
+	uint64_t deadline;
+
+	a->ret = yaca_initialize();
+	pthread_barrier_wait(a->barrier);
+	if (a->ret != YACA_ERROR_NONE)
+		return NULL;
+
+	deadline = now_ns() + a->duration;
+	while (now_ns() < deadline) {
+		a->ret = a->fn(a->fn_arg);
+		if (a->ret != YACA_ERROR_NONE)
+			break;
+		a->iterations++;
+	}
+
+	yaca_cleanup();
+	return NULL;
+}
+
+static void bench_scaling(const char *name, const char *op, bench_op_fn fn, void *fn_arg)
+{
+	for (size_t t = 0; t < sizeof(THREAD_COUNTS) / sizeof(THREAD_COUNTS[0]); ++t) {
+		size_t count = THREAD_COUNTS[t];
+		pthread_t threads[MAX_THREADS];
+		struct thread_arg args[MAX_THREADS];
+		pthread_barrier_t barrier;
+		size_t iterations = 0;
+		int ret = YACA_ERROR_NONE;
+		uint64_t start, elapsed;
+		char api[16];
+
+		snprintf(api, sizeof(api), "%zut", count);
+
+		/* the threads wait for each other and for the main one */
+		if (pthread_barrier_init(&barrier, NULL, count + 1) != 0) {
+			bench_fail("threads", name, op, api, 0, YACA_ERROR_INTERNAL);
+			continue;
+		}
+
+		for (size_t i = 0; i < count; ++i) {
+			args[i] = (struct thread_arg){&barrier, fn, fn_arg,
+			                              (uint64_t)(bench_min_time() * 1e9), 0, 0};
+
+			/* the started ones would wait on the barrier forever */
+			if (pthread_create(&threads[i], NULL, thread_main, &args[i]) != 0) {
+				fprintf(stderr, "Failed to start %zu threads\n", count);
+				exit(EXIT_FAILURE);
+			}
+		}
+
+		pthread_barrier_wait(&barrier);
+		start = now_ns();
+
+		for (size_t i = 0; i < count; ++i) {
+			pthread_join(threads[i], NULL);
+			iterations += args[i].iterations;
+			if (args[i].ret != YACA_ERROR_NONE)
+				ret = args[i].ret;
+		}
+
+		elapsed = now_ns() - start;
+		pthread_barrier_destroy(&barrier);
+
+		if (ret != YACA_ERROR_NONE || iterations == 0)
+			bench_fail("threads", name, op, api, 0, ret);
+		else
+			bench_report("threads", name, op, api, 0, iterations, elapsed);
+	}
+}
+
+static int encrypt_init_op(void *arg)
+{
+	yaca_key_h *keys = arg;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	int ret;
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_GCM, keys[0], keys[1]);
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+static int digest_init_op(void *arg)
+{
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	int ret;
+	(void)arg;
+
+	ret = yaca_digest_initialize(&ctx, YACA_DIGEST_SHA256);
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+#define SIGN_MESSAGE_LEN ((size_t)64)
+
+static int sign_op(void *arg)
+{
+	char *signature = NULL;
+	size_t signature_len;
+	int ret;
+
+	ret = yaca_simple_calculate_signature(YACA_DIGEST_SHA256, arg, bench_input,
+	                                      SIGN_MESSAGE_LEN, &signature, &signature_len);
+	yaca_free(signature);
+	return ret;
+}
+
+static void bench_sign_scaling(void)
+{
+	int ret;
+	yaca_key_h shared = YACA_KEY_NULL;
+	yaca_key_h prepared = YACA_KEY_NULL;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_2048BIT, &shared);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_2048BIT, &prepared);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_sign_prepare_key(prepared, MAX_THREADS);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	bench_scaling("RSA-2048", "sign", sign_op, shared);
+	bench_scaling("RSA-2048-prepared", "sign", sign_op, prepared);
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("threads", "RSA-2048", "setup", "-", 0, ret);
+
+	yaca_key_destroy(prepared);
+	yaca_key_destroy(shared);
+}
+
+void bench_threads(void)
+{
+	int ret;
+	/* key and IV, only read by the threads */
+	yaca_key_h keys[2] = {YACA_KEY_NULL, YACA_KEY_NULL};
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &keys[0]);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &keys[1]);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	bench_scaling("AES-256-GCM", "init", encrypt_init_op, keys);
+	bench_scaling("SHA256", "init", digest_init_op, NULL);
+	bench_sign_scaling();
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		bench_fail("threads", "-", "setup", "-", 0, ret);
+
+	yaca_key_destroy(keys[1]);
+	yaca_key_destroy(keys[0]);
+}
@@ -0,0 +1,161 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+#
+# Contact: Lukasz Pawelczyk <l.pawelczyk@samsung.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+
+
+"""
+Compares the throughput of the ctypes and the native (yaca._native)
+implementations of the binding.
+
+Every case is run in a separate interpreter for both implementations, the
+ctypes one with YACA_NO_NATIVE set. Small calls show the per call overhead,
+large calls and the threaded cases show whether other Python threads can
+run while yaca is busy.
+
+Usage: run_bench.py [min_time_per_case_in_seconds]
+"""
+
+import os
+import subprocess
+import sys
+import threading
+import time
+
+
+SMALL = (16, 64)
+LARGE = (1024 * 1024,)
+THREADS = (1, 4)
+
+
+def measure(fn, min_time):
+    fn()
+    count = 0
+    start = time.perf_counter()
+    while True:
+        fn()
+        count += 1
+        elapsed = time.perf_counter() - start
+        if elapsed >= min_time:
+            return count / elapsed
+
+
+def measure_threads(fn, threads, min_time):
+    counts = [0] * threads
+    deadline = time.perf_counter() + min_time
+
+    def worker(i):
+        while time.perf_counter() < deadline:
+            fn()
+            counts[i] += 1
+
+    start = time.perf_counter()
+    workers = [threading.Thread(target=worker, args=(i,))
+               for i in range(threads)]
+    for w in workers:
+        w.start()
+    for w in workers:
+        w.join()
+    return sum(counts) / (time.perf_counter() - start)
+
+
+def cases(min_time):
+    import yaca
+
+    yaca.initialize()
+    key = yaca.key_generate()
+    iv = yaca.key_generate(yaca.KEY_TYPE.IV, yaca.KEY_BIT_LENGTH.IV_128BIT)
+    enc = yaca.encrypt_initialize(key, bcm=yaca.BLOCK_CIPHER_MODE.CTR,
+                                  iv=iv)
+    dgst = yaca.digest_initialize()
+
+    for size in SMALL + LARGE:
+        data = bytes(size)
+        out = bytearray(size)
+        yield ('digest_update', size, 1,
+               measure(lambda: yaca.digest_update(dgst, data), min_time))
+        yield ('encrypt_update', size, 1,
+               measure(lambda: yaca.encrypt_update(enc, data), min_time))
+        yield ('encrypt_update_into', size, 1,
+               measure(lambda: yaca.encrypt_update_into(enc, data, out),
+                       min_time))
+
+    # every thread needs its own context
+    for size in LARGE:
+        data = bytes(size)
+        local = threading.local()
+
+        def update():
+            if not hasattr(local, 'ctx'):
+                local.ctx = yaca.encrypt_initialize(
+                    key, bcm=yaca.BLOCK_CIPHER_MODE.CTR, iv=iv)
+            yaca.encrypt_update(local.ctx, data)
+
+        for threads in THREADS:
+            yield ('encrypt_update', size, threads,
+                   measure_threads(update, threads, min_time))
+
+    for threads in THREADS:
+        yield ('key_derive_pbkdf2', 0, threads,
+               measure_threads(lambda: yaca.key_derive_pbkdf2(
+                   b'password', salt=b'salt', iterations=10000),
+                   threads, min_time))
+        yield ('key_generate RSA-2048', 0, threads,
+               measure_threads(lambda: yaca.key_generate(
+                   yaca.KEY_TYPE.RSA_PRIV, yaca.KEY_BIT_LENGTH.L2048BIT),
+                   threads, min_time))
+
+    yaca.cleanup()
+
+
+def run(native, min_time):
+    env = dict(os.environ)
+    env.pop('YACA_NO_NATIVE', None)
+    if not native:
+        env['YACA_NO_NATIVE'] = '1'
+    output = subprocess.check_output(
+        [sys.executable, __file__, '--child', str(min_time)], env=env)
+    results = {}
+    for line in output.decode().splitlines():
+        name, size, threads, rate = line.split(',')
+        results[(name, int(size), int(threads))] = float(rate)
+    return results
+
+
+def main():
+    if len(sys.argv) > 1 and sys.argv[1] == '--child':
+        import yaca
+        if yaca._native is None and 'YACA_NO_NATIVE' not in os.environ:
+            sys.exit('yaca._native is not available')
+        for name, size, threads, rate in cases(float(sys.argv[2])):
+            print('%s,%d,%d,%f' % (name, size, threads, rate))
+        return
+
+    min_time = float(sys.argv[1]) if len(sys.argv) > 1 else 0.5
+    ctypes = run(False, min_time)
+    native = run(True, min_time)
+
+    print('%-22s %8s %4s %14s %14s %8s' %
+          ('case', 'size', 'thr', 'ctypes ops/s', 'native ops/s', 'speedup'))
+    for case, rate in ctypes.items():
+        name, size, threads = case
+        print('%-22s %8s %4d %14.1f %14.1f %7.2fx' %
+              (name, size if size else '-', threads, rate, native[case],
+               native[case] / rate))
+
+
+if __name__ == '__main__':
+    main()
@@ -0,0 +1,116 @@
+#!/usr/bin/env python3
+
+# Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+#
+# Contact: Lukasz Pawelczyk <l.pawelczyk@samsung.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+
+
+"""
+Compares the throughput of digest_file(), encrypt_file() and
+decrypt_file() with the usual read()/update()/write() loop that creates
+new bytes objects for every chunk. The input stays in the page cache and
+the output goes to /dev/null, so this measures the binding, not the disk.
+
+Usage: run_bench_files.py [file_size_in_MiB]
+"""
+
+import os
+import sys
+import tempfile
+import time
+import yaca
+
+
+CHUNK_SIZE = 64 * 1024
+REPEAT = 5
+
+
+def naive_digest(path):
+    ctx = yaca.digest_initialize()
+    with open(path, 'rb') as f:
+        while True:
+            chunk = f.read(CHUNK_SIZE)
+            if not chunk:
+                break
+            yaca.digest_update(ctx, chunk)
+    return yaca.digest_finalize(ctx)
+
+
+def naive_transform(initialize, update, finalize, key, iv, src, dst):
+    ctx = initialize(key, bcm=yaca.BLOCK_CIPHER_MODE.CBC, iv=iv)
+    with open(src, 'rb') as fin, open(dst, 'wb') as fout:
+        while True:
+            chunk = fin.read(CHUNK_SIZE)
+            if not chunk:
+                break
+            fout.write(update(ctx, chunk))
+        fout.write(finalize(ctx))
+
+
+def best_time(fn):
+    fn()
+    best = None
+    for _ in range(REPEAT):
+        start = time.perf_counter()
+        fn()
+        elapsed = time.perf_counter() - start
+        best = elapsed if best is None else min(best, elapsed)
+    return best
+
+
+def main():
+    size = int(sys.argv[1] if len(sys.argv) > 1 else 64) * 1024 * 1024
+
+    yaca.initialize()
+    key = yaca.key_generate()
+    iv = yaca.key_generate(yaca.KEY_TYPE.IV, yaca.KEY_BIT_LENGTH.IV_128BIT)
+
+    with tempfile.TemporaryDirectory() as tmp:
+        plain = os.path.join(tmp, 'plain')
+        enc = os.path.join(tmp, 'enc')
+        with open(plain, 'wb') as f:
+            f.write(yaca.random_bytes(size))
+        yaca.encrypt_file(key, plain, enc, bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                          iv=iv)
+
+        cases = [
+            ('digest', 'naive', lambda: naive_digest(plain)),
+            ('digest', 'digest_file', lambda: yaca.digest_file(plain)),
+            ('encrypt', 'naive', lambda: naive_transform(
+                yaca.encrypt_initialize, yaca.encrypt_update,
+                yaca.encrypt_finalize, key, iv, plain, os.devnull)),
+            ('encrypt', 'encrypt_file', lambda: yaca.encrypt_file(
+                key, plain, os.devnull, bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                iv=iv)),
+            ('decrypt', 'naive', lambda: naive_transform(
+                yaca.decrypt_initialize, yaca.decrypt_update,
+                yaca.decrypt_finalize, key, iv, enc, os.devnull)),
+            ('decrypt', 'decrypt_file', lambda: yaca.decrypt_file(
+                key, enc, os.devnull, bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                iv=iv)),
+        ]
+
+        print('%s MiB file, %s implementation' %
+              (size // (1024 * 1024),
+               'ctypes' if yaca._native is None else 'native'))
+        print('%-8s %-14s %10s' % ('op', 'api', 'MB/s'))
+        for op, api, fn in cases:
+            print('%-8s %-14s %10.1f' % (op, api, size / best_time(fn) / 1e6))
+
+    yaca.cleanup()
+
+
+if __name__ == '__main__':
+    main()
@@ -29,6 +29,17 @@ All the parameters for strings/data expect python's bytes type. All
 the parameters are named the same as in the C API and their meaning is
 exactly the same.
 
+The streaming update functions (digest, encrypt, decrypt, sign, verify,
+seal and open) also accept any contiguous buffer-protocol object
+(bytearray, memoryview, mmap, array, numpy arrays) and pass it to the C
+library without copying. The encrypt/decrypt/seal/open *_update_into()
+and *_finalize_into() variants write the output into a caller-owned
+writable buffer instead of returning new bytes.
+
+digest_file(), encrypt_file() and decrypt_file() stream whole files
+through a single reusable buffer (or a memory map), the yaca.aio module
+runs them and other long operations in an executor for asyncio.
+
 The major exception being encrypt/decrypt update where second
 parameter can have 2 meanings. This is only used for CCM_AAD. See
 examples.
@@ -42,6 +53,8 @@ For examples see tests/examples in yaca.tests module.
 
 import enum as _enum
 import ctypes as _ctypes
+import mmap as _mmap
+import os as _os
 import yaca.library
 from yaca.error import InvalidParameterError
 del yaca.error
@@ -66,6 +79,78 @@ def _context_get_output_length(ctx, input_length):
     return output_length.value
 
 
+class _Py_buffer(_ctypes.Structure):
+    _fields_ = [('buf', _ctypes.c_void_p),
+                ('obj', _ctypes.c_void_p),
+                ('len', _ctypes.c_ssize_t),
+                ('itemsize', _ctypes.c_ssize_t),
+                ('readonly', _ctypes.c_int),
+                ('ndim', _ctypes.c_int),
+                ('format', _ctypes.c_char_p),
+                ('shape', _ctypes.c_void_p),
+                ('strides', _ctypes.c_void_p),
+                ('suboffsets', _ctypes.c_void_p),
+                ('internal', _ctypes.c_void_p)]
+
+
+_PyBUF_SIMPLE = 0
+_PyBUF_WRITABLE = 1
+
+_PyObject_GetBuffer = _ctypes.pythonapi.PyObject_GetBuffer
+_PyObject_GetBuffer.argtypes = \
+    [_ctypes.py_object, _ctypes.POINTER(_Py_buffer), _ctypes.c_int]
+_PyObject_GetBuffer.restype = _ctypes.c_int
+_PyBuffer_Release = _ctypes.pythonapi.PyBuffer_Release
+_PyBuffer_Release.argtypes = [_ctypes.POINTER(_Py_buffer)]
+_PyBuffer_Release.restype = None
+
+
+class _Buffer:
+    """Exports the memory of a contiguous buffer-protocol object for the
+    duration of a with block, without copying it. The length is in bytes,
+    whatever the item size of the object is."""
+
+    def __init__(self, data, writable=False):
+        self._view = None
+        if isinstance(data, bytes) and not writable:
+            self.ptr = data
+            self.len = len(data)
+            return
+
+        view = _Py_buffer()
+        _PyObject_GetBuffer(data, _ctypes.byref(view),
+                            _PyBUF_WRITABLE if writable else _PyBUF_SIMPLE)
+        self._view = view
+        self.ptr = view.buf
+        self.len = view.len
+
+    def __enter__(self):
+        return self
+
+    def __exit__(self, *exc):
+        if self._view is not None:
+            _PyBuffer_Release(_ctypes.byref(self._view))
+            self._view = None
+
+
+def _update_into(update, ctx, data, output):
+    with _Buffer(data) as i, _Buffer(output, writable=True) as o:
+        if o.len < _context_get_output_length(ctx, i.len):
+            raise InvalidParameterError('Output buffer too small')
+        output_length = _ctypes.c_size_t()
+        update(ctx, i.ptr, i.len, o.ptr, _ctypes.byref(output_length))
+    return output_length.value
+
+
+def _finalize_into(finalize, ctx, output):
+    with _Buffer(output, writable=True) as o:
+        if o.len < _context_get_output_length(ctx, 0):
+            raise InvalidParameterError('Output buffer too small')
+        output_length = _ctypes.c_size_t()
+        finalize(ctx, o.ptr, _ctypes.byref(output_length))
+    return output_length.value
+
+
 # Types
 
 class Context():
@@ -208,6 +293,9 @@ class BLOCK_CIPHER_MODE(_enum.Enum):
     OFB = 8
     CCM = 9
     WRAP = 10
+    CBC_HMAC_SHA1 = 11
+    CBC_HMAC_SHA256 = 12
+    SIV = 13
 
 
 @_enum.unique
@@ -220,6 +308,13 @@ class PROPERTY(_enum.Enum):
     CCM_TAG = 5
     CCM_TAG_LEN = 6
     RC2_EFFECTIVE_KEY_BITS = 7
+    CBC_HMAC_KEY = 8
+    CBC_HMAC_AAD = 9
+    CBC_HMAC_TAG = 10
+    SIV_AAD = 11
+    SIV_TAG = 12
+    PLAINTEXT_DIGEST_ALGO = 13
+    PLAINTEXT_DIGEST = 14
 
 
 @_enum.unique
@@ -269,7 +364,7 @@ def random_bytes(length):
 def context_set_property(ctx, prop, prop_val):
     """Sets the non-standard context properties.
     Can only be called on an initialized context."""
-    if prop == PROPERTY.PADDING:
+    if (prop == PROPERTY.PADDING) or (prop == PROPERTY.PLAINTEXT_DIGEST_ALGO):
         value = _ctypes.c_int(prop_val.value)
         value_length = _ctypes.sizeof(value)
         _lib.yaca_context_set_property(ctx,
@@ -277,7 +372,10 @@ def context_set_property(ctx, prop, prop_val):
                                        _ctypes.byref(value),
                                        value_length)
     elif (prop == PROPERTY.GCM_AAD) or (prop == PROPERTY.CCM_AAD) or \
-         (prop == PROPERTY.GCM_TAG) or (prop == PROPERTY.CCM_TAG):
+         (prop == PROPERTY.GCM_TAG) or (prop == PROPERTY.CCM_TAG) or \
+         (prop == PROPERTY.CBC_HMAC_KEY) or (prop == PROPERTY.CBC_HMAC_AAD) or \
+         (prop == PROPERTY.CBC_HMAC_TAG) or (prop == PROPERTY.SIV_AAD) or \
+         (prop == PROPERTY.SIV_TAG):
         value = prop_val
         value_length = len(prop_val)
         _lib.yaca_context_set_property(ctx, prop.value,
@@ -292,32 +390,43 @@ def context_set_property(ctx, prop, prop_val):
         raise InvalidParameterError('Wrong property passed')
 
 
+# Large enough for any buffer property (a SHA512 digest is 64 bytes)
+_PROPERTY_BUFFER_SIZE = 64
+
+
 def context_get_property(ctx, prop):
     """Returns the non-standard context properties.
     Can only be called on an initialized context."""
-    value = _ctypes.c_void_p()
     value_length = _ctypes.c_size_t()
-    _lib.yaca_context_get_property(ctx, prop.value, _ctypes.byref(value),
-                                   _ctypes.byref(value_length))
     if prop == PROPERTY.PADDING:
-        value_cast = _ctypes.cast(value, _ctypes.POINTER(_ctypes.c_int))
-        value_proper = value_cast.contents.value
-        assert value_length.value == _ctypes.sizeof(value_cast.contents)
+        value = _ctypes.c_int()
+        _lib.yaca_context_get_property_into(ctx, prop.value,
+                                            _ctypes.byref(value),
+                                            _ctypes.sizeof(value),
+                                            _ctypes.byref(value_length))
+        assert value_length.value == _ctypes.sizeof(value)
+        return value.value
     elif (prop == PROPERTY.GCM_AAD) or (prop == PROPERTY.CCM_AAD) or \
-         (prop == PROPERTY.GCM_TAG) or (prop == PROPERTY.CCM_TAG):
-        value_cast = _ctypes.cast(value, _ctypes.POINTER(_ctypes.c_char))
-        value_proper = value_cast[:value_length.value]
-        assert value_length.value == len(value_proper)
+         (prop == PROPERTY.GCM_TAG) or (prop == PROPERTY.CCM_TAG) or \
+         (prop == PROPERTY.CBC_HMAC_TAG) or (prop == PROPERTY.SIV_TAG) or \
+         (prop == PROPERTY.PLAINTEXT_DIGEST):
+        value = _ctypes.create_string_buffer(_PROPERTY_BUFFER_SIZE)
+        _lib.yaca_context_get_property_into(ctx, prop.value, value,
+                                            _PROPERTY_BUFFER_SIZE,
+                                            _ctypes.byref(value_length))
+        return value.raw[:value_length.value]
     elif (prop == PROPERTY.GCM_TAG_LEN) or \
          (prop == PROPERTY.CCM_TAG_LEN) or \
          (prop == PROPERTY.RC2_EFFECTIVE_KEY_BITS):
-        value_cast = _ctypes.cast(value, _ctypes.POINTER(_ctypes.c_size_t))
-        value_proper = value_cast.contents.value
-        assert value_length.value == _ctypes.sizeof(value_cast.contents)
+        value = _ctypes.c_size_t()
+        _lib.yaca_context_get_property_into(ctx, prop.value,
+                                            _ctypes.byref(value),
+                                            _ctypes.sizeof(value),
+                                            _ctypes.byref(value_length))
+        assert value_length.value == _ctypes.sizeof(value)
+        return value.value
     else:
         raise InvalidParameterError('Wrong property passed')
-    _lib.yaca_free(value)
-    return value_proper
 
 
 # Implementation key
@@ -459,6 +568,35 @@ def simple_decrypt(sym_key, ciphertext, encrypt_algo=ENCRYPT_ALGORITHM.AES,
     return plaintext_bytes
 
 
+def simple_encrypt_siv(sym_key, plaintext, aad=b''):
+    """Encrypts data with AES-SIV, returns the tag followed by the ciphertext."""
+    plaintext_param = _get_char_param_nullify_if_zero(plaintext)
+    aad_param = _get_char_param_nullify_if_zero(aad)
+    ciphertext = _ctypes.POINTER(_ctypes.c_char)()
+    ciphertext_length = _ctypes.c_size_t()
+    _lib.yaca_simple_encrypt_siv(sym_key, aad_param, len(aad),
+                                 plaintext_param, len(plaintext),
+                                 _ctypes.byref(ciphertext),
+                                 _ctypes.byref(ciphertext_length))
+    ciphertext_bytes = ciphertext[:ciphertext_length.value]
+    _lib.yaca_free(ciphertext)
+    return ciphertext_bytes
+
+
+def simple_decrypt_siv(sym_key, ciphertext, aad=b''):
+    """Authenticates and decrypts data encrypted with simple_encrypt_siv()."""
+    aad_param = _get_char_param_nullify_if_zero(aad)
+    plaintext = _ctypes.POINTER(_ctypes.c_char)()
+    plaintext_length = _ctypes.c_size_t()
+    _lib.yaca_simple_decrypt_siv(sym_key, aad_param, len(aad),
+                                 ciphertext, len(ciphertext),
+                                 _ctypes.byref(plaintext),
+                                 _ctypes.byref(plaintext_length))
+    plaintext_bytes = plaintext[:plaintext_length.value]
+    _lib.yaca_free(plaintext)
+    return plaintext_bytes
+
+
 def simple_calculate_digest(message, digest_algo=DIGEST_ALGORITHM.SHA256):
     """Calculates a digest of a message."""
     message_param = _get_char_param_nullify_if_zero(message)
@@ -526,6 +664,20 @@ def simple_calculate_cmac(sym_key, message,
     return mac_bytes
 
 
+def simple_calculate_gmac(sym_key, iv, message):
+    """Calculates a GMAC of given message using AES key and IV."""
+    message_param = _get_char_param_nullify_if_zero(message)
+    mac = _ctypes.POINTER(_ctypes.c_char)()
+    mac_length = _ctypes.c_size_t()
+    _lib.yaca_simple_calculate_gmac(sym_key, iv,
+                                    message_param, len(message),
+                                    _ctypes.byref(mac),
+                                    _ctypes.byref(mac_length))
+    mac_bytes = mac[:mac_length.value]
+    _lib.yaca_free(mac)
+    return mac_bytes
+
+
 # Implementation digest
 
 def digest_initialize(digest_algo=DIGEST_ALGORITHM.SHA256):
@@ -537,7 +689,8 @@ def digest_initialize(digest_algo=DIGEST_ALGORITHM.SHA256):
 
 def digest_update(ctx, message):
     """Feeds the message into the message digest algorithm."""
-    _lib.yaca_digest_update(ctx, message, len(message))
+    with _Buffer(message) as m:
+        _lib.yaca_digest_update(ctx, m.ptr, m.len)
 
 
 def digest_finalize(ctx):
@@ -579,11 +732,12 @@ def encrypt_update(ctx, plaintext):
                                  _ctypes.byref(_ctypes.c_size_t()))
         return
 
-    output_length = _context_get_output_length(ctx, len(plaintext))
-    ciphertext = _ctypes.create_string_buffer(output_length)
-    ciphertext_length = _ctypes.c_size_t()
-    _lib.yaca_encrypt_update(ctx, plaintext, len(plaintext),
-                             ciphertext, _ctypes.byref(ciphertext_length))
+    with _Buffer(plaintext) as i:
+        output_length = _context_get_output_length(ctx, i.len)
+        ciphertext = _ctypes.create_string_buffer(output_length)
+        ciphertext_length = _ctypes.c_size_t()
+        _lib.yaca_encrypt_update(ctx, i.ptr, i.len,
+                                 ciphertext, _ctypes.byref(ciphertext_length))
     return bytes(ciphertext[:ciphertext_length.value])
 
 
@@ -597,6 +751,20 @@ def encrypt_finalize(ctx):
     return bytes(ciphertext[:ciphertext_length.value])
 
 
+def encrypt_update_into(ctx, plaintext, ciphertext):
+    """Encrypts chunk of the data into a caller-owned buffer.
+    ciphertext is a writable buffer of at least context_get_output_length()
+    bytes, it may start at the same address as plaintext (in-place).
+    Returns the number of bytes written."""
+    return _update_into(_lib.yaca_encrypt_update, ctx, plaintext, ciphertext)
+
+
+def encrypt_finalize_into(ctx, ciphertext):
+    """Encrypts the final chunk of the data into a caller-owned buffer.
+    Returns the number of bytes written."""
+    return _finalize_into(_lib.yaca_encrypt_finalize, ctx, ciphertext)
+
+
 def decrypt_initialize(sym_key, encrypt_algo=ENCRYPT_ALGORITHM.AES,
                        bcm=BLOCK_CIPHER_MODE.ECB, iv=KEY_NULL):
     """Initializes an decryption context."""
@@ -615,11 +783,12 @@ def decrypt_update(ctx, ciphertext):
                                  _ctypes.byref(_ctypes.c_size_t()))
         return
 
-    output_length = _context_get_output_length(ctx, len(ciphertext))
-    plaintext = _ctypes.create_string_buffer(output_length)
-    plaintext_length = _ctypes.c_size_t()
-    _lib.yaca_decrypt_update(ctx, ciphertext, len(ciphertext),
-                             plaintext, _ctypes.byref(plaintext_length))
+    with _Buffer(ciphertext) as i:
+        output_length = _context_get_output_length(ctx, i.len)
+        plaintext = _ctypes.create_string_buffer(output_length)
+        plaintext_length = _ctypes.c_size_t()
+        _lib.yaca_decrypt_update(ctx, i.ptr, i.len,
+                                 plaintext, _ctypes.byref(plaintext_length))
     return bytes(plaintext[:plaintext_length.value])
 
 
@@ -633,6 +802,20 @@ def decrypt_finalize(ctx):
     return bytes(plaintext[:plaintext_length.value])
 
 
+def decrypt_update_into(ctx, ciphertext, plaintext):
+    """Decrypts chunk of the data into a caller-owned buffer.
+    plaintext is a writable buffer of at least context_get_output_length()
+    bytes, it may start at the same address as ciphertext (in-place).
+    Returns the number of bytes written."""
+    return _update_into(_lib.yaca_decrypt_update, ctx, ciphertext, plaintext)
+
+
+def decrypt_finalize_into(ctx, plaintext):
+    """Decrypts the final chunk of the data into a caller-owned buffer.
+    Returns the number of bytes written."""
+    return _finalize_into(_lib.yaca_decrypt_finalize, ctx, plaintext)
+
+
 # Implementation sign
 
 def sign_initialize(prv_key, digest_algo=DIGEST_ALGORITHM.SHA256):
@@ -659,9 +842,17 @@ def sign_initialize_cmac(sym_key, encrypt_algo=ENCRYPT_ALGORITHM.AES):
     return Context(ctx)
 
 
+def sign_initialize_gmac(sym_key, iv):
+    """Initializes a signature context for GMAC."""
+    ctx = _ctypes.c_void_p()
+    _lib.yaca_sign_initialize_gmac(_ctypes.byref(ctx), sym_key, iv)
+    return Context(ctx)
+
+
 def sign_update(ctx, message):
     """Feeds the message into the digital signature or MAC algorithm."""
-    _lib.yaca_sign_update(ctx, message, len(message))
+    with _Buffer(message) as m:
+        _lib.yaca_sign_update(ctx, m.ptr, m.len)
 
 
 def sign_finalize(ctx):
@@ -684,12 +875,14 @@ def verify_initialize(pub_key, digest_algo=DIGEST_ALGORITHM.SHA256):
 
 def verify_update(ctx, message):
     """Feeds the message into the digital signature verification algorithm."""
-    _lib.yaca_verify_update(ctx, message, len(message))
+    with _Buffer(message) as m:
+        _lib.yaca_verify_update(ctx, m.ptr, m.len)
 
 
 def verify_finalize(ctx, signature):
     """Performs the verification."""
-    return _lib.yaca_verify_finalize(ctx, signature, len(signature))
+    with _Buffer(signature) as s:
+        return _lib.yaca_verify_finalize(ctx, s.ptr, s.len)
 
 
 # Implementation seal
@@ -709,11 +902,12 @@ def seal_initialize(pub_key, sym_key_bit_length=KEY_BIT_LENGTH.L256BIT,
 
 def seal_update(ctx, plaintext):
     """Encrypts piece of the data."""
-    output_length = _context_get_output_length(ctx, len(plaintext))
-    ciphertext = _ctypes.create_string_buffer(output_length)
-    ciphertext_length = _ctypes.c_size_t()
-    _lib.yaca_seal_update(ctx, plaintext, len(plaintext),
-                          ciphertext, _ctypes.byref(ciphertext_length))
+    with _Buffer(plaintext) as i:
+        output_length = _context_get_output_length(ctx, i.len)
+        ciphertext = _ctypes.create_string_buffer(output_length)
+        ciphertext_length = _ctypes.c_size_t()
+        _lib.yaca_seal_update(ctx, i.ptr, i.len,
+                              ciphertext, _ctypes.byref(ciphertext_length))
     return bytes(ciphertext[:ciphertext_length.value])
 
 
@@ -727,6 +921,20 @@ def seal_finalize(ctx):
     return bytes(ciphertext[:ciphertext_length.value])
 
 
+def seal_update_into(ctx, plaintext, ciphertext):
+    """Encrypts piece of the data into a caller-owned buffer.
+    ciphertext is a writable buffer of at least context_get_output_length()
+    bytes, it may start at the same address as plaintext (in-place).
+    Returns the number of bytes written."""
+    return _update_into(_lib.yaca_seal_update, ctx, plaintext, ciphertext)
+
+
+def seal_finalize_into(ctx, ciphertext):
+    """Encrypts the final piece of the data into a caller-owned buffer.
+    Returns the number of bytes written."""
+    return _finalize_into(_lib.yaca_seal_finalize, ctx, ciphertext)
+
+
 def open_initialize(prv_key, sym_key, iv=KEY_NULL,
                     sym_key_bit_length=KEY_BIT_LENGTH.L256BIT,
                     encrypt_algo=ENCRYPT_ALGORITHM.AES,
@@ -741,11 +949,12 @@ def open_initialize(prv_key, sym_key, iv=KEY_NULL,
 
 def open_update(ctx, ciphertext):
     """Decrypts piece of the data."""
-    output_length = _context_get_output_length(ctx, len(ciphertext))
-    plaintext = _ctypes.create_string_buffer(output_length)
-    plaintext_length = _ctypes.c_size_t()
-    _lib.yaca_open_update(ctx, ciphertext, len(ciphertext),
-                          plaintext, _ctypes.byref(plaintext_length))
+    with _Buffer(ciphertext) as i:
+        output_length = _context_get_output_length(ctx, i.len)
+        plaintext = _ctypes.create_string_buffer(output_length)
+        plaintext_length = _ctypes.c_size_t()
+        _lib.yaca_open_update(ctx, i.ptr, i.len,
+                              plaintext, _ctypes.byref(plaintext_length))
     return bytes(plaintext[:plaintext_length.value])
 
 
@@ -759,6 +968,20 @@ def open_finalize(ctx):
     return bytes(plaintext[:plaintext_length.value])
 
 
+def open_update_into(ctx, ciphertext, plaintext):
+    """Decrypts piece of the data into a caller-owned buffer.
+    plaintext is a writable buffer of at least context_get_output_length()
+    bytes, it may start at the same address as ciphertext (in-place).
+    Returns the number of bytes written."""
+    return _update_into(_lib.yaca_open_update, ctx, ciphertext, plaintext)
+
+
+def open_finalize_into(ctx, plaintext):
+    """Decrypts last chunk of sealed message into a caller-owned buffer.
+    Returns the number of bytes written."""
+    return _finalize_into(_lib.yaca_open_finalize, ctx, plaintext)
+
+
 # Implementation rsa
 
 def rsa_public_encrypt(pub_key, plaintext, padding=PADDING.PKCS1):
@@ -815,3 +1038,186 @@ def rsa_public_decrypt(pub_key, ciphertext, padding=PADDING.PKCS1):
     plaintext_bytes = plaintext[:plaintext_length.value]
     _lib.yaca_free(plaintext)
     return plaintext_bytes
+
+
+# Implementation file
+
+# Large enough to amortize the per call cost, small enough to stay in cache
+_FILE_CHUNK_SIZE = 64 * 1024
+_PATH_TYPES = (str, bytes, _os.PathLike)
+
+
+class _FileObject():
+    """Uses an already open file object in a with block without closing it."""
+
+    def __init__(self, file):
+        self._file = file
+
+    def __enter__(self):
+        return self._file
+
+    def __exit__(self, *exc):
+        return False
+
+
+def _file_open(file, mode):
+    if isinstance(file, _PATH_TYPES):
+        return open(file, mode)
+    return _FileObject(file)
+
+
+def _file_feed(file, feed, chunk_size):
+    """Calls feed() with consecutive chunks of a binary file. Files given by
+    path are memory mapped, file objects are read with readinto() into a
+    single reusable buffer. A chunk is only valid during the call."""
+    with _file_open(file, 'rb') as f:
+        mapped = None
+        if isinstance(file, _PATH_TYPES):
+            try:
+                mapped = _mmap.mmap(f.fileno(), 0, access=_mmap.ACCESS_READ)
+            except (OSError, ValueError):  # empty or not a regular file
+                pass
+
+        if mapped is not None:
+            if hasattr(mapped, 'madvise'):
+                mapped.madvise(_mmap.MADV_SEQUENTIAL)
+            with mapped, memoryview(mapped) as view:
+                for pos in range(0, len(view), chunk_size):
+                    feed(view[pos:pos + chunk_size])
+            return
+
+        buffer = bytearray(chunk_size)
+        with memoryview(buffer) as view:
+            while True:
+                length = f.readinto(buffer)
+                if not length:
+                    break
+                feed(view[:length])
+
+
+def _file_transform(update_into, finalize_into, ctx, src, dst, chunk_size):
+    output = bytearray(max(_context_get_output_length(ctx, chunk_size),
+                           _context_get_output_length(ctx, 0)))
+    written = 0
+
+    with memoryview(output) as view, _file_open(dst, 'wb') as f:
+        def feed(chunk):
+            nonlocal written
+            length = update_into(ctx, chunk, output)
+            f.write(view[:length])
+            written += length
+
+        _file_feed(src, feed, chunk_size)
+        length = finalize_into(ctx, output)
+        f.write(view[:length])
+        written += length
+
+    return written
+
+
+def digest_file(file, digest_algo=DIGEST_ALGORITHM.SHA256,
+                chunk_size=_FILE_CHUNK_SIZE):
+    """Calculates a digest of a file.
+    file is a path or a binary file object (read from its current position)."""
+    ctx = digest_initialize(digest_algo)
+    _file_feed(file, lambda chunk: digest_update(ctx, chunk), chunk_size)
+    return digest_finalize(ctx)
+
+
+def encrypt_file(sym_key, src, dst, encrypt_algo=ENCRYPT_ALGORITHM.AES,
+                 bcm=BLOCK_CIPHER_MODE.ECB, iv=KEY_NULL,
+                 chunk_size=_FILE_CHUNK_SIZE):
+    """Encrypts a file using a symmetric cipher.
+    src and dst are paths or binary file objects. Modes that need
+    properties (GCM, CCM tags and AAD) require the streaming functions.
+    Returns the number of bytes written."""
+    ctx = encrypt_initialize(sym_key, encrypt_algo, bcm, iv)
+    return _file_transform(encrypt_update_into, encrypt_finalize_into,
+                           ctx, src, dst, chunk_size)
+
+
+def decrypt_file(sym_key, src, dst, encrypt_algo=ENCRYPT_ALGORITHM.AES,
+                 bcm=BLOCK_CIPHER_MODE.ECB, iv=KEY_NULL,
+                 chunk_size=_FILE_CHUNK_SIZE):
+    """Decrypts a file using a symmetric cipher.
+    src and dst are paths or binary file objects. Modes that need
+    properties (GCM, CCM tags and AAD) require the streaming functions.
+    Returns the number of bytes written."""
+    ctx = decrypt_initialize(sym_key, encrypt_algo, bcm, iv)
+    return _file_transform(decrypt_update_into, decrypt_finalize_into,
+                           ctx, src, dst, chunk_size)
+
+
+# Native implementation
+#
+# When the yaca._native extension is installed it replaces the functions
+# above that are called often or may take long. It skips the ctypes
+# marshalling and releases the GIL around large updates, key generation,
+# PBKDF2 and RSA. Set YACA_NO_NATIVE in the environment to use ctypes only.
+
+try:
+    if _os.environ.get('YACA_NO_NATIVE'):
+        raise ImportError('disabled by YACA_NO_NATIVE')
+    from yaca import _native
+except ImportError:
+    _native = None
+
+if _native is not None:
+    digest_update = _native.digest_update
+    digest_finalize = _native.digest_finalize
+    encrypt_update = _native.encrypt_update
+    encrypt_finalize = _native.encrypt_finalize
+    encrypt_update_into = _native.encrypt_update_into
+    encrypt_finalize_into = _native.encrypt_finalize_into
+    decrypt_update = _native.decrypt_update
+    decrypt_finalize = _native.decrypt_finalize
+    decrypt_update_into = _native.decrypt_update_into
+    decrypt_finalize_into = _native.decrypt_finalize_into
+    sign_update = _native.sign_update
+    sign_finalize = _native.sign_finalize
+    verify_update = _native.verify_update
+    verify_finalize = _native.verify_finalize
+    seal_update = _native.seal_update
+    seal_finalize = _native.seal_finalize
+    seal_update_into = _native.seal_update_into
+    seal_finalize_into = _native.seal_finalize_into
+    open_update = _native.open_update
+    open_finalize = _native.open_finalize
+    open_update_into = _native.open_update_into
+    open_finalize_into = _native.open_finalize_into
+
+    def key_generate(key_type=KEY_TYPE.SYMMETRIC,
+                     key_bit_length=KEY_BIT_LENGTH.L256BIT):
+        """Generates a secure key or key generation parameters
+        (or an Initialization Vector)."""
+        key = _native.key_generate(key_type.value, key_bit_length)
+        return Key(_ctypes.c_void_p(key))
+
+    def key_derive_pbkdf2(password, key_bit_length=KEY_BIT_LENGTH.L256BIT,
+                          salt=b'', digest_algo=DIGEST_ALGORITHM.SHA256,
+                          iterations=50000):
+        """Derives a key from user password
+        (PKCS #5 a.k.a. pbkdf2 algorithm)."""
+        key = _native.key_derive_pbkdf2(password, salt, iterations,
+                                        digest_algo.value, key_bit_length)
+        return Key(_ctypes.c_void_p(key))
+
+    def rsa_public_encrypt(pub_key, plaintext, padding=PADDING.PKCS1):
+        """Encrypts data using a RSA public key
+        (low-level encrypt equivalent)."""
+        return _native.rsa_public_encrypt(padding.value, pub_key, plaintext)
+
+    def rsa_private_decrypt(prv_key, ciphertext, padding=PADDING.PKCS1):
+        """Decrypts data using a RSA private key
+        (low-level decrypt equivalent)."""
+        return _native.rsa_private_decrypt(padding.value, prv_key, ciphertext)
+
+    def rsa_private_encrypt(prv_key, plaintext, padding=PADDING.PKCS1):
+        """Encrypts data using a RSA private key
+        (low-level sign equivalent)."""
+        return _native.rsa_private_encrypt(padding.value, prv_key, plaintext)
+
+    def rsa_public_decrypt(pub_key, ciphertext, padding=PADDING.PKCS1):
+        """Decrypts data using a RSA public key
+        (low-level verify equivalent)."""
+        return _native.rsa_public_decrypt(padding.value, pub_key, ciphertext)
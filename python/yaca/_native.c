@@ -0,0 +1,553 @@
+/*
+ *  Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Lukasz Pawelczyk <l.pawelczyk@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file _native.c
+ * @brief Native implementation of the hot paths of the Python binding
+ *
+ * The functions take the same arguments as their ctypes counterparts in
+ * yaca/__init__.py, contexts and keys are the yaca.Context and yaca.Key
+ * objects created there. Enums are passed as their integer values by the
+ * Python wrappers.
+ */
+
+#define PY_SSIZE_T_CLEAN
+#include <Python.h>
+
+#include <stdbool.h>
+
+#include <yaca_crypto.h>
+#include <yaca_digest.h>
+#include <yaca_encrypt.h>
+#include <yaca_seal.h>
+#include <yaca_sign.h>
+#include <yaca_key.h>
+#include <yaca_rsa.h>
+#include <yaca_error.h>
+
+
+/* Below that the GIL is kept, releasing it costs more than the call itself */
+#define NATIVE_GIL_THRESHOLD 4096
+
+/* Releases the GIL around the call when slow is true */
+#define NATIVE_CALL(ret, slow, call)            \
+	do {                                        \
+		if (slow) {                             \
+			Py_BEGIN_ALLOW_THREADS              \
+			ret = call;                         \
+			Py_END_ALLOW_THREADS                \
+		} else {                                \
+			ret = call;                         \
+		}                                       \
+	} while (0)
+
+typedef int (*feed_fn)(yaca_context_h ctx, const char *data, size_t data_len);
+typedef int (*update_fn)(yaca_context_h ctx, const char *input, size_t input_len,
+                         char *output, size_t *output_len);
+typedef int (*finalize_fn)(yaca_context_h ctx, char *output, size_t *output_len);
+typedef int (*rsa_fn)(yaca_padding_e padding, const yaca_key_h key,
+                      const char *input, size_t input_len,
+                      char **output, size_t *output_len);
+
+static PyObject *str_as_parameter;
+static PyObject *str_value;
+static PyObject *InvalidParameterError;
+static PyObject *OutOfMemoryError;
+static PyObject *InternalError;
+static PyObject *InvalidPasswordError;
+
+/* The same exceptions and messages as yaca.library._errcheck() */
+static PyObject *set_error(int ret)
+{
+	switch (ret) {
+	case YACA_ERROR_INVALID_PARAMETER:
+		PyErr_SetString(InvalidParameterError, "Invalid Parameter error returned from YACA");
+		break;
+	case YACA_ERROR_OUT_OF_MEMORY:
+		PyErr_SetString(OutOfMemoryError, "Out Of Memory error returned from YACA");
+		break;
+	case YACA_ERROR_INTERNAL:
+		PyErr_SetString(InternalError, "Internal error returned from YACA");
+		break;
+	case YACA_ERROR_INVALID_PASSWORD:
+		PyErr_SetString(InvalidPasswordError, "Invalid Password error returned from YACA");
+		break;
+	default:
+		PyErr_SetString(PyExc_RuntimeError, "Unknown error returned from YACA");
+		break;
+	}
+
+	return NULL;
+}
+
+/* "O&" converter of yaca.Context and yaca.Key objects, None is a NULL handle */
+static int handle_converter(PyObject *obj, void *handle)
+{
+	PyObject *param;
+	PyObject *value;
+	void *ptr = NULL;
+
+	if (obj != Py_None) {
+		param = PyObject_GetAttr(obj, str_as_parameter);
+		if (param == NULL)
+			return 0;
+
+		value = PyObject_GetAttr(param, str_value);
+		Py_DECREF(param);
+		if (value == NULL)
+			return 0;
+
+		if (value != Py_None)
+			ptr = PyLong_AsVoidPtr(value);
+		Py_DECREF(value);
+		if (ptr == NULL && PyErr_Occurred())
+			return 0;
+	}
+
+	*(void **)handle = ptr;
+	return 1;
+}
+
+static PyObject *new_output(size_t len)
+{
+	if (len > PY_SSIZE_T_MAX)
+		return set_error(YACA_ERROR_INVALID_PARAMETER);
+
+	return PyBytes_FromStringAndSize(NULL, (Py_ssize_t)len);
+}
+
+/* Shrinks the output to the length actually written */
+static PyObject *fit_output(PyObject *output, size_t len)
+{
+	if ((Py_ssize_t)len != PyBytes_GET_SIZE(output) &&
+	    _PyBytes_Resize(&output, (Py_ssize_t)len) != 0)
+		return NULL;
+
+	return output;
+}
+
+static PyObject *feed(PyObject *args, feed_fn fn)
+{
+	int ret;
+	yaca_context_h ctx;
+	Py_buffer data;
+
+	if (!PyArg_ParseTuple(args, "O&y*", handle_converter, &ctx, &data))
+		return NULL;
+
+	NATIVE_CALL(ret, data.len >= NATIVE_GIL_THRESHOLD, fn(ctx, data.buf, data.len));
+	PyBuffer_Release(&data);
+
+	if (ret != YACA_ERROR_NONE)
+		return set_error(ret);
+
+	Py_RETURN_NONE;
+}
+
+static PyObject *update(PyObject *args, update_fn fn, bool aad_length)
+{
+	int ret;
+	yaca_context_h ctx;
+	PyObject *input;
+	PyObject *output;
+	Py_buffer data;
+	size_t output_len;
+
+	if (!PyArg_ParseTuple(args, "O&O", handle_converter, &ctx, &input))
+		return NULL;
+
+	/* The total length of the input, used for CCM_AAD */
+	if (aad_length && PyLong_Check(input)) {
+		size_t len = PyLong_AsSize_t(input);
+
+		if (len == (size_t)-1 && PyErr_Occurred())
+			return NULL;
+
+		ret = fn(ctx, NULL, len, NULL, &output_len);
+		if (ret != YACA_ERROR_NONE)
+			return set_error(ret);
+
+		Py_RETURN_NONE;
+	}
+
+	if (PyObject_GetBuffer(input, &data, PyBUF_SIMPLE) != 0)
+		return NULL;
+
+	ret = yaca_context_get_output_length(ctx, data.len, &output_len);
+	if (ret != YACA_ERROR_NONE) {
+		PyBuffer_Release(&data);
+		return set_error(ret);
+	}
+
+	output = new_output(output_len);
+	if (output == NULL) {
+		PyBuffer_Release(&data);
+		return NULL;
+	}
+
+	NATIVE_CALL(ret, data.len >= NATIVE_GIL_THRESHOLD,
+	            fn(ctx, data.buf, data.len, PyBytes_AS_STRING(output), &output_len));
+	PyBuffer_Release(&data);
+
+	if (ret != YACA_ERROR_NONE) {
+		Py_DECREF(output);
+		return set_error(ret);
+	}
+
+	return fit_output(output, output_len);
+}
+
+static PyObject *update_into(PyObject *args, update_fn fn)
+{
+	int ret;
+	yaca_context_h ctx;
+	Py_buffer data;
+	PyObject *obj;
+	Py_buffer output;
+	size_t output_len;
+
+	if (!PyArg_ParseTuple(args, "O&y*O", handle_converter, &ctx, &data, &obj))
+		return NULL;
+
+	if (PyObject_GetBuffer(obj, &output, PyBUF_WRITABLE) != 0) {
+		PyBuffer_Release(&data);
+		return NULL;
+	}
+
+	ret = yaca_context_get_output_length(ctx, data.len, &output_len);
+	if (ret == YACA_ERROR_NONE && (size_t)output.len < output_len) {
+		PyBuffer_Release(&output);
+		PyBuffer_Release(&data);
+		PyErr_SetString(InvalidParameterError, "Output buffer too small");
+		return NULL;
+	}
+
+	if (ret == YACA_ERROR_NONE)
+		NATIVE_CALL(ret, data.len >= NATIVE_GIL_THRESHOLD,
+		            fn(ctx, data.buf, data.len, output.buf, &output_len));
+
+	PyBuffer_Release(&output);
+	PyBuffer_Release(&data);
+
+	if (ret != YACA_ERROR_NONE)
+		return set_error(ret);
+
+	return PyLong_FromSize_t(output_len);
+}
+
+static PyObject *finalize(PyObject *args, finalize_fn fn, bool slow)
+{
+	int ret;
+	yaca_context_h ctx;
+	PyObject *output;
+	size_t output_len;
+
+	if (!PyArg_ParseTuple(args, "O&", handle_converter, &ctx))
+		return NULL;
+
+	ret = yaca_context_get_output_length(ctx, 0, &output_len);
+	if (ret != YACA_ERROR_NONE)
+		return set_error(ret);
+
+	output = new_output(output_len);
+	if (output == NULL)
+		return NULL;
+
+	NATIVE_CALL(ret, slow, fn(ctx, PyBytes_AS_STRING(output), &output_len));
+	if (ret != YACA_ERROR_NONE) {
+		Py_DECREF(output);
+		return set_error(ret);
+	}
+
+	return fit_output(output, output_len);
+}
+
+static PyObject *finalize_into(PyObject *args, finalize_fn fn)
+{
+	int ret;
+	yaca_context_h ctx;
+	PyObject *obj;
+	Py_buffer output;
+	size_t output_len;
+
+	if (!PyArg_ParseTuple(args, "O&O", handle_converter, &ctx, &obj))
+		return NULL;
+
+	/* BufferError for read-only objects, the same as the ctypes binding */
+	if (PyObject_GetBuffer(obj, &output, PyBUF_WRITABLE) != 0)
+		return NULL;
+
+	ret = yaca_context_get_output_length(ctx, 0, &output_len);
+	if (ret == YACA_ERROR_NONE && (size_t)output.len < output_len) {
+		PyBuffer_Release(&output);
+		PyErr_SetString(InvalidParameterError, "Output buffer too small");
+		return NULL;
+	}
+
+	if (ret == YACA_ERROR_NONE)
+		ret = fn(ctx, output.buf, &output_len);
+
+	PyBuffer_Release(&output);
+
+	if (ret != YACA_ERROR_NONE)
+		return set_error(ret);
+
+	return PyLong_FromSize_t(output_len);
+}
+
+static PyObject *rsa(PyObject *args, rsa_fn fn)
+{
+	int ret;
+	int padding;
+	yaca_key_h key;
+	Py_buffer data;
+	char *output = NULL;
+	size_t output_len;
+	PyObject *result;
+
+	if (!PyArg_ParseTuple(args, "iO&y*", &padding, handle_converter, &key, &data))
+		return NULL;
+
+	NATIVE_CALL(ret, true, fn((yaca_padding_e)padding, key, data.len > 0 ? data.buf : NULL,
+	                          data.len, &output, &output_len));
+	PyBuffer_Release(&data);
+
+	if (ret != YACA_ERROR_NONE)
+		return set_error(ret);
+
+	result = PyBytes_FromStringAndSize(output, (Py_ssize_t)output_len);
+	yaca_free(output);
+	return result;
+}
+
+#define NATIVE_FEED(name)                                                   \
+	static PyObject *native_##name(PyObject *self, PyObject *args)          \
+	{                                                                       \
+		(void)self;                                                         \
+		return feed(args, yaca_##name);                                     \
+	}
+
+#define NATIVE_STREAM(name, aad_length)                                     \
+	static PyObject *native_##name##_update(PyObject *self, PyObject *args) \
+	{                                                                       \
+		(void)self;                                                         \
+		return update(args, yaca_##name##_update, aad_length);              \
+	}                                                                       \
+	static PyObject *native_##name##_finalize(PyObject *self, PyObject *args) \
+	{                                                                       \
+		(void)self;                                                         \
+		return finalize(args, yaca_##name##_finalize, false);               \
+	}                                                                       \
+	static PyObject *native_##name##_update_into(PyObject *self, PyObject *args) \
+	{                                                                       \
+		(void)self;                                                         \
+		return update_into(args, yaca_##name##_update);                     \
+	}                                                                       \
+	static PyObject *native_##name##_finalize_into(PyObject *self, PyObject *args) \
+	{                                                                       \
+		(void)self;                                                         \
+		return finalize_into(args, yaca_##name##_finalize);                 \
+	}
+
+#define NATIVE_RSA(name)                                                    \
+	static PyObject *native_##name(PyObject *self, PyObject *args)          \
+	{                                                                       \
+		(void)self;                                                         \
+		return rsa(args, yaca_##name);                                      \
+	}
+
+NATIVE_FEED(digest_update)
+NATIVE_FEED(sign_update)
+NATIVE_FEED(verify_update)
+
+NATIVE_STREAM(encrypt, true)
+NATIVE_STREAM(decrypt, true)
+NATIVE_STREAM(seal, false)
+NATIVE_STREAM(open, false)
+
+NATIVE_RSA(rsa_public_encrypt)
+NATIVE_RSA(rsa_private_decrypt)
+NATIVE_RSA(rsa_private_encrypt)
+NATIVE_RSA(rsa_public_decrypt)
+
+static PyObject *native_digest_finalize(PyObject *self, PyObject *args)
+{
+	(void)self;
+	return finalize(args, yaca_digest_finalize, false);
+}
+
+/* Asymmetric signatures take time */
+static PyObject *native_sign_finalize(PyObject *self, PyObject *args)
+{
+	(void)self;
+	return finalize(args, yaca_sign_finalize, true);
+}
+
+static PyObject *native_verify_finalize(PyObject *self, PyObject *args)
+{
+	int ret;
+	yaca_context_h ctx;
+	Py_buffer signature;
+
+	(void)self;
+
+	if (!PyArg_ParseTuple(args, "O&y*", handle_converter, &ctx, &signature))
+		return NULL;
+
+	NATIVE_CALL(ret, true, yaca_verify_finalize(ctx, signature.buf, signature.len));
+	PyBuffer_Release(&signature);
+
+	if (ret == YACA_ERROR_DATA_MISMATCH)
+		Py_RETURN_FALSE;
+	if (ret != YACA_ERROR_NONE)
+		return set_error(ret);
+
+	Py_RETURN_TRUE;
+}
+
+/* Returns the new handle as an int, the wrapper makes a yaca.Key of it */
+static PyObject *native_key_generate(PyObject *self, PyObject *args)
+{
+	int ret;
+	int key_type;
+	Py_ssize_t key_bit_len;
+	yaca_key_h key = YACA_KEY_NULL;
+
+	(void)self;
+
+	if (!PyArg_ParseTuple(args, "in", &key_type, &key_bit_len))
+		return NULL;
+
+	if (key_bit_len < 0)
+		return set_error(YACA_ERROR_INVALID_PARAMETER);
+
+	NATIVE_CALL(ret, true, yaca_key_generate((yaca_key_type_e)key_type, key_bit_len, &key));
+	if (ret != YACA_ERROR_NONE)
+		return set_error(ret);
+
+	return PyLong_FromVoidPtr(key);
+}
+
+static PyObject *native_key_derive_pbkdf2(PyObject *self, PyObject *args)
+{
+	int ret;
+	const char *password;
+	Py_buffer salt;
+	Py_ssize_t iterations;
+	int digest_algo;
+	Py_ssize_t key_bit_len;
+	yaca_key_h key = YACA_KEY_NULL;
+
+	(void)self;
+
+	if (!PyArg_ParseTuple(args, "yy*nin", &password, &salt, &iterations,
+	                      &digest_algo, &key_bit_len))
+		return NULL;
+
+	if (iterations < 0 || key_bit_len < 0) {
+		PyBuffer_Release(&salt);
+		return set_error(YACA_ERROR_INVALID_PARAMETER);
+	}
+
+	NATIVE_CALL(ret, true, yaca_key_derive_pbkdf2(password, salt.len > 0 ? salt.buf : NULL,
+	                                              salt.len, iterations,
+	                                              (yaca_digest_algorithm_e)digest_algo,
+	                                              key_bit_len, &key));
+	PyBuffer_Release(&salt);
+
+	if (ret != YACA_ERROR_NONE)
+		return set_error(ret);
+
+	return PyLong_FromVoidPtr(key);
+}
+
+#define NATIVE_METHOD(name, doc) {#name, native_##name, METH_VARARGS, PyDoc_STR(doc)}
+
+static PyMethodDef native_methods[] = {
+	NATIVE_METHOD(digest_update, "Feeds the message into the message digest algorithm."),
+	NATIVE_METHOD(digest_finalize, "Calculates the final digest."),
+	NATIVE_METHOD(encrypt_update, "Encrypts chunk of the data.\n"
+	              "Alternatively plaintext can be the total length of the input (int).\n"
+	              "This is used for CCM_AAD."),
+	NATIVE_METHOD(encrypt_finalize, "Encrypts the final chunk of the data."),
+	NATIVE_METHOD(encrypt_update_into, "Encrypts chunk of the data into a caller-owned buffer."),
+	NATIVE_METHOD(encrypt_finalize_into, "Encrypts the final chunk of the data into a "
+	              "caller-owned buffer."),
+	NATIVE_METHOD(decrypt_update, "Decrypts chunk of the data.\n"
+	              "Alternatively ciphertext can be the total length of the input (int).\n"
+	              "This is used for CCM_AAD."),
+	NATIVE_METHOD(decrypt_finalize, "Decrypts the final chunk of the data."),
+	NATIVE_METHOD(decrypt_update_into, "Decrypts chunk of the data into a caller-owned buffer."),
+	NATIVE_METHOD(decrypt_finalize_into, "Decrypts the final chunk of the data into a "
+	              "caller-owned buffer."),
+	NATIVE_METHOD(sign_update, "Feeds the message into the digital signature or MAC algorithm."),
+	NATIVE_METHOD(sign_finalize, "Calculates the final signature or MAC."),
+	NATIVE_METHOD(verify_update, "Feeds the message into the digital signature verification "
+	              "algorithm."),
+	NATIVE_METHOD(verify_finalize, "Performs the verification."),
+	NATIVE_METHOD(seal_update, "Encrypts piece of the data."),
+	NATIVE_METHOD(seal_finalize, "Encrypts the final piece of the data."),
+	NATIVE_METHOD(seal_update_into, "Encrypts piece of the data into a caller-owned buffer."),
+	NATIVE_METHOD(seal_finalize_into, "Encrypts the final piece of the data into a "
+	              "caller-owned buffer."),
+	NATIVE_METHOD(open_update, "Decrypts piece of the data."),
+	NATIVE_METHOD(open_finalize, "Decrypts last chunk of sealed message."),
+	NATIVE_METHOD(open_update_into, "Decrypts piece of the data into a caller-owned buffer."),
+	NATIVE_METHOD(open_finalize_into, "Decrypts last chunk of sealed message into a "
+	              "caller-owned buffer."),
+	NATIVE_METHOD(key_generate, "key_generate(key_type, key_bit_length) -> handle"),
+	NATIVE_METHOD(key_derive_pbkdf2, "key_derive_pbkdf2(password, salt, iterations, "
+	              "digest_algo, key_bit_length) -> handle"),
+	NATIVE_METHOD(rsa_public_encrypt, "rsa_public_encrypt(padding, pub_key, plaintext)"),
+	NATIVE_METHOD(rsa_private_decrypt, "rsa_private_decrypt(padding, prv_key, ciphertext)"),
+	NATIVE_METHOD(rsa_private_encrypt, "rsa_private_encrypt(padding, prv_key, plaintext)"),
+	NATIVE_METHOD(rsa_public_decrypt, "rsa_public_decrypt(padding, pub_key, ciphertext)"),
+	{NULL, NULL, 0, NULL}
+};
+
+static struct PyModuleDef native_module = {
+	PyModuleDef_HEAD_INIT,
+	"yaca._native",
+	"Native implementation of the hot paths of the YACA Python binding.",
+	-1,
+	native_methods,
+	NULL, NULL, NULL, NULL
+};
+
+PyMODINIT_FUNC PyInit__native(void)
+{
+	PyObject *error = PyImport_ImportModule("yaca.error");
+
+	if (error == NULL)
+		return NULL;
+
+	InvalidParameterError = PyObject_GetAttrString(error, "InvalidParameterError");
+	OutOfMemoryError = PyObject_GetAttrString(error, "OutOfMemoryError");
+	InternalError = PyObject_GetAttrString(error, "InternalError");
+	InvalidPasswordError = PyObject_GetAttrString(error, "InvalidPasswordError");
+	Py_DECREF(error);
+
+	str_as_parameter = PyUnicode_InternFromString("_as_parameter_");
+	str_value = PyUnicode_InternFromString("value");
+
+	if (InvalidParameterError == NULL || OutOfMemoryError == NULL || InternalError == NULL ||
+	    InvalidPasswordError == NULL || str_as_parameter == NULL || str_value == NULL)
+		return NULL;
+
+	return PyModule_Create(&native_module);
+}
@@ -0,0 +1,79 @@
+# Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+#
+# Contact: Lukasz Pawelczyk <l.pawelczyk@samsung.com>
+#
+# Licensed under the Apache License, Version 2.0 (the "License");
+# you may not use this file except in compliance with the License.
+# You may obtain a copy of the License at
+#
+#     http://www.apache.org/licenses/LICENSE-2.0
+#
+# Unless required by applicable law or agreed to in writing, software
+# distributed under the License is distributed on an "AS IS" BASIS,
+# WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+# See the License for the specific language governing permissions and
+# limitations under the License
+
+
+"""
+asyncio wrappers for the long running functions of YACA.
+
+The coroutines take the same arguments as the functions of the yaca module
+and run them in an executor so the event loop is not blocked. Pass
+executor= to use your own one, its threads have to call yaca.initialize().
+By default a thread pool is used whose threads initialize yaca when they
+start.
+"""
+
+import asyncio as _asyncio
+import concurrent.futures as _futures
+import functools as _functools
+import threading as _threading
+import yaca
+
+
+_executor = None
+_executor_lock = _threading.Lock()
+
+
+def _default_executor():
+    global _executor
+    with _executor_lock:
+        if _executor is None:
+            _executor = _futures.ThreadPoolExecutor(
+                thread_name_prefix='yaca', initializer=yaca.initialize)
+        return _executor
+
+
+async def run(func, *args, executor=None, **kwargs):
+    """Runs func(*args, **kwargs) in the executor and returns its result."""
+    loop = _asyncio.get_running_loop()
+    return await loop.run_in_executor(
+        executor if executor is not None else _default_executor(),
+        _functools.partial(func, *args, **kwargs))
+
+
+async def digest_file(*args, executor=None, **kwargs):
+    """See yaca.digest_file()."""
+    return await run(yaca.digest_file, *args, executor=executor, **kwargs)
+
+
+async def encrypt_file(*args, executor=None, **kwargs):
+    """See yaca.encrypt_file()."""
+    return await run(yaca.encrypt_file, *args, executor=executor, **kwargs)
+
+
+async def decrypt_file(*args, executor=None, **kwargs):
+    """See yaca.decrypt_file()."""
+    return await run(yaca.decrypt_file, *args, executor=executor, **kwargs)
+
+
+async def key_generate(*args, executor=None, **kwargs):
+    """See yaca.key_generate()."""
+    return await run(yaca.key_generate, *args, executor=executor, **kwargs)
+
+
+async def key_derive_pbkdf2(*args, executor=None, **kwargs):
+    """See yaca.key_derive_pbkdf2()."""
+    return await run(yaca.key_derive_pbkdf2, *args, executor=executor,
+                     **kwargs)
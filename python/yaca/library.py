@@ -85,6 +85,10 @@ def get_yaca():
         [_ctypes.c_void_p, _ctypes.c_int, _ctypes.POINTER(_ctypes.c_void_p),
          _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_context_get_property.errcheck = _errcheck
+    lib.yaca_context_get_property_into.argtypes = \
+        [_ctypes.c_void_p, _ctypes.c_int, _ctypes.c_void_p, _ctypes.c_size_t,
+         _ctypes.POINTER(_ctypes.c_size_t)]
+    lib.yaca_context_get_property_into.errcheck = _errcheck
     lib.yaca_context_get_output_length.argtypes = \
         [_ctypes.c_void_p, _ctypes.c_size_t, _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_context_get_output_length.errcheck = _errcheck
@@ -104,6 +108,20 @@ def get_yaca():
          _ctypes.POINTER(_ctypes.POINTER(_ctypes.c_char)),
          _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_simple_decrypt.errcheck = _errcheck
+    lib.yaca_simple_encrypt_siv.argtypes = \
+        [_ctypes.c_void_p,
+         _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t,
+         _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t,
+         _ctypes.POINTER(_ctypes.POINTER(_ctypes.c_char)),
+         _ctypes.POINTER(_ctypes.c_size_t)]
+    lib.yaca_simple_encrypt_siv.errcheck = _errcheck
+    lib.yaca_simple_decrypt_siv.argtypes = \
+        [_ctypes.c_void_p,
+         _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t,
+         _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t,
+         _ctypes.POINTER(_ctypes.POINTER(_ctypes.c_char)),
+         _ctypes.POINTER(_ctypes.c_size_t)]
+    lib.yaca_simple_decrypt_siv.errcheck = _errcheck
     lib.yaca_simple_calculate_digest.argtypes = \
         [_ctypes.c_int, _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t,
          _ctypes.POINTER(_ctypes.POINTER(_ctypes.c_char)),
@@ -132,6 +150,12 @@ def get_yaca():
          _ctypes.POINTER(_ctypes.POINTER(_ctypes.c_char)),
          _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_simple_calculate_cmac.errcheck = _errcheck
+    lib.yaca_simple_calculate_gmac.argtypes = \
+        [_ctypes.c_void_p, _ctypes.c_void_p,
+         _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t,
+         _ctypes.POINTER(_ctypes.POINTER(_ctypes.c_char)),
+         _ctypes.POINTER(_ctypes.c_size_t)]
+    lib.yaca_simple_calculate_gmac.errcheck = _errcheck
 
     # key
     lib.yaca_key_get_type.argtypes = \
@@ -186,7 +210,7 @@ def get_yaca():
         [_ctypes.POINTER(_ctypes.c_void_p), _ctypes.c_int]
     lib.yaca_digest_initialize.errcheck = _errcheck
     lib.yaca_digest_update.argtypes = \
-        [_ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t]
+        [_ctypes.c_void_p, _ctypes.c_void_p, _ctypes.c_size_t]
     lib.yaca_digest_update.errcheck = _errcheck
     lib.yaca_digest_finalize.argtypes = \
         [_ctypes.c_void_p,
@@ -204,12 +228,12 @@ def get_yaca():
     lib.yaca_encrypt_initialize.errcheck = _errcheck
     lib.yaca_encrypt_update.argtypes = \
         [_ctypes.c_void_p,
-         _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t,
-         _ctypes.POINTER(_ctypes.c_char), _ctypes.POINTER(_ctypes.c_size_t)]
+         _ctypes.c_void_p, _ctypes.c_size_t,
+         _ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_encrypt_update.errcheck = _errcheck
     lib.yaca_encrypt_finalize.argtypes = \
         [_ctypes.c_void_p,
-         _ctypes.POINTER(_ctypes.c_char), _ctypes.POINTER(_ctypes.c_size_t)]
+         _ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_encrypt_finalize.errcheck = _errcheck
     lib.yaca_decrypt_initialize.argtypes = \
         [_ctypes.POINTER(_ctypes.c_void_p), _ctypes.c_int, _ctypes.c_int,
@@ -217,12 +241,12 @@ def get_yaca():
     lib.yaca_decrypt_initialize.errcheck = _errcheck
     lib.yaca_decrypt_update.argtypes = \
         [_ctypes.c_void_p,
-         _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t,
-         _ctypes.POINTER(_ctypes.c_char), _ctypes.POINTER(_ctypes.c_size_t)]
+         _ctypes.c_void_p, _ctypes.c_size_t,
+         _ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_decrypt_update.errcheck = _errcheck
     lib.yaca_decrypt_finalize.argtypes = \
         [_ctypes.c_void_p,
-         _ctypes.POINTER(_ctypes.c_char), _ctypes.POINTER(_ctypes.c_size_t)]
+         _ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_decrypt_finalize.errcheck = _errcheck
 
     # sign
@@ -235,8 +259,11 @@ def get_yaca():
     lib.yaca_sign_initialize_cmac.argtypes = \
         [_ctypes.POINTER(_ctypes.c_void_p), _ctypes.c_int, _ctypes.c_void_p]
     lib.yaca_sign_initialize_cmac.errcheck = _errcheck
+    lib.yaca_sign_initialize_gmac.argtypes = \
+        [_ctypes.POINTER(_ctypes.c_void_p), _ctypes.c_void_p, _ctypes.c_void_p]
+    lib.yaca_sign_initialize_gmac.errcheck = _errcheck
     lib.yaca_sign_update.argtypes = \
-        [_ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t]
+        [_ctypes.c_void_p, _ctypes.c_void_p, _ctypes.c_size_t]
     lib.yaca_sign_update.errcheck = _errcheck
     lib.yaca_sign_finalize.argtypes = \
         [_ctypes.c_void_p,
@@ -246,10 +273,10 @@ def get_yaca():
         [_ctypes.POINTER(_ctypes.c_void_p), _ctypes.c_int, _ctypes.c_void_p]
     lib.yaca_verify_initialize.errcheck = _errcheck
     lib.yaca_verify_update.argtypes = \
-        [_ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t]
+        [_ctypes.c_void_p, _ctypes.c_void_p, _ctypes.c_size_t]
     lib.yaca_verify_update.errcheck = _errcheck
     lib.yaca_verify_finalize.argtypes = \
-        [_ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t]
+        [_ctypes.c_void_p, _ctypes.c_void_p, _ctypes.c_size_t]
     lib.yaca_verify_finalize.errcheck = _errcheck
 
     # seal
@@ -259,12 +286,12 @@ def get_yaca():
          _ctypes.POINTER(_ctypes.c_void_p)]
     lib.yaca_seal_initialize.errcheck = _errcheck
     lib.yaca_seal_update.argtypes = \
-        [_ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t,
-         _ctypes.POINTER(_ctypes.c_char), _ctypes.POINTER(_ctypes.c_size_t)]
+        [_ctypes.c_void_p, _ctypes.c_void_p, _ctypes.c_size_t,
+         _ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_seal_update.errcheck = _errcheck
     lib.yaca_seal_finalize.argtypes = \
         [_ctypes.c_void_p,
-         _ctypes.POINTER(_ctypes.c_char), _ctypes.POINTER(_ctypes.c_size_t)]
+         _ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_seal_finalize.errcheck = _errcheck
     lib.yaca_open_initialize.argtypes = \
         [_ctypes.POINTER(_ctypes.c_void_p), _ctypes.c_void_p, _ctypes.c_int,
@@ -272,12 +299,12 @@ def get_yaca():
     lib.yaca_open_initialize.errcheck = _errcheck
     lib.yaca_open_update.argtypes = \
         [_ctypes.c_void_p,
-         _ctypes.POINTER(_ctypes.c_char), _ctypes.c_size_t,
-         _ctypes.POINTER(_ctypes.c_char), _ctypes.POINTER(_ctypes.c_size_t)]
+         _ctypes.c_void_p, _ctypes.c_size_t,
+         _ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_open_update.errcheck = _errcheck
     lib.yaca_open_finalize.argtypes = \
         [_ctypes.c_void_p,
-         _ctypes.POINTER(_ctypes.c_char), _ctypes.POINTER(_ctypes.c_size_t)]
+         _ctypes.c_void_p, _ctypes.POINTER(_ctypes.c_size_t)]
     lib.yaca_open_finalize.errcheck = _errcheck
 
     # rsa
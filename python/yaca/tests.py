@@ -24,7 +24,14 @@ returns expected things.
 They can also be used as examples.
 """
 
+import array
+import asyncio
+import io
+import mmap
+import os
+import tempfile
 import yaca
+import yaca.aio
 
 
 def split_into_parts(data, l):
@@ -54,9 +61,13 @@ def run_all_tests():
     simple()
     digest()
     encrypt_basic()
+    encrypt_buffers()
+    files()
     encrypt_rc2_property()
     encrypt_gcm_property()
     encrypt_ccm_property()
+    encrypt_siv_property()
+    encrypt_plaintext_digest_property()
     sign()
     seal()
     rsa()
@@ -274,6 +285,142 @@ def encrypt_basic():
     assert msg == dec
 
 
+def encrypt_buffers():
+    # prepare:
+    key_sym = yaca.key_generate()
+    key_iv_128 = yaca.key_generate(yaca.KEY_TYPE.IV,
+                                   yaca.KEY_BIT_LENGTH.IV_128BIT)
+    enc_simple = yaca.simple_encrypt(key_sym, msg,
+                                     yaca.ENCRYPT_ALGORITHM.AES,
+                                     yaca.BLOCK_CIPHER_MODE.CBC, key_iv_128)
+    # end prepare
+
+    # any buffer-protocol object, the length is counted in bytes
+    words = array.array('I', msg[:len(msg) // 4 * 4])
+    mapped = mmap.mmap(-1, len(msg))
+    mapped.write(msg)
+    view = memoryview(msg)
+
+    ctx = yaca.digest_initialize(yaca.DIGEST_ALGORITHM.SHA512)
+    yaca.digest_update(ctx, words)
+    yaca.digest_update(ctx, view[len(words) * 4:])
+    assert yaca.digest_finalize(ctx) == \
+        yaca.simple_calculate_digest(msg, yaca.DIGEST_ALGORITHM.SHA512)
+
+    ctx = yaca.encrypt_initialize(key_sym, bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                                  iv=key_iv_128)
+    enc = yaca.encrypt_update(ctx, bytearray(msg[:100]))
+    enc += yaca.encrypt_update(ctx, view[100:200])
+    enc += yaca.encrypt_update(ctx, memoryview(mapped)[200:])
+    enc += yaca.encrypt_finalize(ctx)
+
+    assert enc == enc_simple
+
+    # into a caller-owned buffer, in-place
+    block = 16
+    buf = bytearray(msg) + bytearray(block)
+    ctx = yaca.encrypt_initialize(key_sym, bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                                  iv=key_iv_128)
+    written = yaca.encrypt_update_into(ctx, memoryview(buf)[:len(msg)], buf)
+    written += yaca.encrypt_finalize_into(ctx, memoryview(buf)[written:])
+
+    assert buf[:written] == enc_simple
+
+    # into slices of a single preallocated buffer
+    dec = bytearray(len(enc_simple) + block)
+    ctx = yaca.decrypt_initialize(key_sym, bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                                  iv=key_iv_128)
+    written = 0
+    for part in split_into_parts(memoryview(enc_simple), 5):
+        written += yaca.decrypt_update_into(ctx, part,
+                                            memoryview(dec)[written:])
+    written += yaca.decrypt_finalize_into(ctx, memoryview(dec)[written:])
+
+    assert dec[:written] == msg
+
+    # the output has to fit
+    ctx = yaca.encrypt_initialize(key_sym, bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                                  iv=key_iv_128)
+    try:
+        yaca.encrypt_update_into(ctx, msg, bytearray(len(msg)))
+        assert False
+    except yaca.InvalidParameterError:
+        pass
+
+    # read-only output
+    try:
+        yaca.encrypt_update_into(ctx, msg, bytes(len(msg) + block))
+        assert False
+    except BufferError:
+        pass
+
+    mapped.close()
+
+
+def files():
+    # prepare:
+    key_sym = yaca.key_generate()
+    key_iv_128 = yaca.key_generate(yaca.KEY_TYPE.IV,
+                                   yaca.KEY_BIT_LENGTH.IV_128BIT)
+    data = msg * 100
+    tmp = tempfile.TemporaryDirectory()
+    plain = os.path.join(tmp.name, 'plain')
+    enc = os.path.join(tmp.name, 'enc')
+    dec = os.path.join(tmp.name, 'dec')
+    empty = os.path.join(tmp.name, 'empty')
+    with open(plain, 'wb') as f:
+        f.write(data)
+    open(empty, 'wb').close()
+    enc_simple = yaca.simple_encrypt(key_sym, data,
+                                     yaca.ENCRYPT_ALGORITHM.AES,
+                                     yaca.BLOCK_CIPHER_MODE.CBC, key_iv_128)
+    # end prepare
+
+    # paths are memory mapped, the chunks are smaller than the file
+    assert yaca.digest_file(plain, chunk_size=1000) == \
+        yaca.simple_calculate_digest(data)
+    assert yaca.digest_file(empty) == yaca.simple_calculate_digest(b'')
+
+    # file objects are read from their current position
+    with open(plain, 'rb') as f:
+        f.seek(len(msg))
+        assert yaca.digest_file(f, yaca.DIGEST_ALGORITHM.SHA512) == \
+            yaca.simple_calculate_digest(data[len(msg):],
+                                         yaca.DIGEST_ALGORITHM.SHA512)
+
+    written = yaca.encrypt_file(key_sym, plain, enc,
+                                bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                                iv=key_iv_128, chunk_size=1000)
+    with open(enc, 'rb') as f:
+        assert f.read() == enc_simple
+    assert written == len(enc_simple)
+
+    out = io.BytesIO()
+    written = yaca.decrypt_file(key_sym, io.BytesIO(enc_simple), out,
+                                bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                                iv=key_iv_128)
+    assert out.getvalue() == data
+    assert written == len(data)
+
+    # asyncio
+    async def aio():
+        return await asyncio.gather(
+            yaca.aio.digest_file(plain),
+            yaca.aio.decrypt_file(key_sym, enc, dec,
+                                  bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                                  iv=key_iv_128),
+            yaca.aio.key_derive_pbkdf2(b'password', iterations=1000))
+
+    dgst, written, key = asyncio.run(aio())
+    assert dgst == yaca.simple_calculate_digest(data)
+    with open(dec, 'rb') as f:
+        assert f.read() == data
+    assert written == len(data)
+    assert key.get_type() == yaca.KEY_TYPE.SYMMETRIC
+
+    tmp.cleanup()
+
+
 def encrypt_rc2_property():
     # prepare:
     key_sym = yaca.key_generate()
@@ -369,6 +516,65 @@ def encrypt_ccm_property():
     assert msg == dec
 
 
+def encrypt_siv_property():
+    # prepare:
+    key_sym = yaca.key_generate(yaca.KEY_TYPE.SYMMETRIC,
+                                yaca.KEY_BIT_LENGTH.L512BIT)
+    # end prepare
+
+    aad = yaca.random_bytes(16)
+    nonce = yaca.random_bytes(16)
+    ctx = yaca.encrypt_initialize(key_sym, bcm=yaca.BLOCK_CIPHER_MODE.SIV)
+    yaca.context_set_property(ctx, yaca.PROPERTY.SIV_AAD, aad)
+    yaca.context_set_property(ctx, yaca.PROPERTY.SIV_AAD, nonce)
+    enc = yaca.encrypt_update(ctx, msg)
+    enc += yaca.encrypt_finalize(ctx)
+    tag = yaca.context_get_property(ctx, yaca.PROPERTY.SIV_TAG)
+    assert len(tag) == 16
+
+    ctx = yaca.decrypt_initialize(key_sym, bcm=yaca.BLOCK_CIPHER_MODE.SIV)
+    yaca.context_set_property(ctx, yaca.PROPERTY.SIV_TAG, tag)
+    yaca.context_set_property(ctx, yaca.PROPERTY.SIV_AAD, aad)
+    yaca.context_set_property(ctx, yaca.PROPERTY.SIV_AAD, nonce)
+    dec = yaca.decrypt_update(ctx, enc)
+    dec += yaca.decrypt_finalize(ctx)
+
+    assert msg == dec
+
+    # deterministic, the simple API returns the tag and the ciphertext
+    enc_simple = yaca.simple_encrypt_siv(key_sym, msg, aad)
+    assert enc_simple == yaca.simple_encrypt_siv(key_sym, msg, aad)
+    assert yaca.simple_decrypt_siv(key_sym, enc_simple, aad) == msg
+
+
+def encrypt_plaintext_digest_property():
+    # prepare:
+    key_sym = yaca.key_generate()
+    iv = yaca.key_generate(yaca.KEY_TYPE.IV, yaca.KEY_BIT_LENGTH.IV_128BIT)
+    digest = yaca.simple_calculate_digest(msg, yaca.DIGEST_ALGORITHM.SHA256)
+    # end prepare
+
+    ctx = yaca.encrypt_initialize(key_sym, bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                                  iv=iv)
+    yaca.context_set_property(ctx, yaca.PROPERTY.PLAINTEXT_DIGEST_ALGO,
+                              yaca.DIGEST_ALGORITHM.SHA256)
+    enc = yaca.encrypt_update(ctx, msg)
+    enc += yaca.encrypt_finalize(ctx)
+    assert yaca.context_get_property(
+        ctx, yaca.PROPERTY.PLAINTEXT_DIGEST) == digest
+
+    ctx = yaca.decrypt_initialize(key_sym, bcm=yaca.BLOCK_CIPHER_MODE.CBC,
+                                  iv=iv)
+    yaca.context_set_property(ctx, yaca.PROPERTY.PLAINTEXT_DIGEST_ALGO,
+                              yaca.DIGEST_ALGORITHM.SHA256)
+    dec = yaca.decrypt_update(ctx, enc)
+    dec += yaca.decrypt_finalize(ctx)
+    assert yaca.context_get_property(
+        ctx, yaca.PROPERTY.PLAINTEXT_DIGEST) == digest
+
+    assert msg == dec
+
+
 def sign():
     # prepare:
     key_sym = yaca.key_generate()
@@ -379,6 +585,8 @@ def sign():
                                              yaca.DIGEST_ALGORITHM.SHA512)
     cmac_simple = yaca.simple_calculate_cmac(key_sym, msg,
                                              yaca.ENCRYPT_ALGORITHM.AES)
+    key_iv = yaca.key_generate(yaca.KEY_TYPE.IV, yaca.KEY_BIT_LENGTH.IV_128BIT)
+    gmac_simple = yaca.simple_calculate_gmac(key_sym, key_iv, msg)
     sign_simple = yaca.simple_calculate_signature(key_rsa_prv, msg,
                                                   yaca.DIGEST_ALGORITHM.SHA512)
     # end prepare
@@ -397,6 +605,13 @@ def sign():
 
     assert cmac == cmac_simple
 
+    ctx = yaca.sign_initialize_gmac(key_sym, key_iv)
+    for part in msg_parts:
+        yaca.sign_update(ctx, part)
+    gmac = yaca.sign_finalize(ctx)
+
+    assert gmac == gmac_simple
+
     ctx = yaca.sign_initialize(key_rsa_prv, yaca.DIGEST_ALGORITHM.SHA512)
     for part in msg_parts:
         yaca.sign_update(ctx, part)
@@ -43,6 +43,8 @@
 #include <yaca_error.h>
 
 #include "internal.h"
+#include "stats.h"
+#include "trace.h"
 
 #ifdef OPENSSL_MOCKUP_TESTS
 #include "../tests/openssl_mock_redefine.h"
@@ -61,11 +63,14 @@ static int getrandom_wrapper(unsigned char *buf, int num)
 {
 	size_t received = 0;
 	size_t remaining = num;
+	int ret = 1;
 
 #ifndef SYS_getrandom
 	assert(urandom_fd != -2);
 #endif /* SYS_getrandom */
 
+	TRACE(rng__entry, num);
+
 	while (remaining > 0) {
 #ifdef SYS_getrandom
 		ssize_t n = TEMP_FAILURE_RETRY(syscall(SYS_getrandom, buf + received, remaining, 0));
@@ -73,14 +78,21 @@ static int getrandom_wrapper(unsigned char *buf, int num)
 		ssize_t n = TEMP_FAILURE_RETRY(read(urandom_fd, buf + received, remaining));
 #endif /* SYS_getrandom */
 
-		if (n == -1)
-			return 0;
+		stats_rng_syscall();
+
+		if (n == -1) {
+			ret = 0;
+			break;
+		}
 
 		received += n;
 		remaining -= n;
 	}
 
-	return 1;
+	stats_rng_bytes(received);
+
+	TRACE(rng__return, num, received, ret);
+	return ret;
 }
 
 static int RAND_METHOD_bytes(unsigned char *buf, int num)
@@ -158,6 +170,15 @@ API int yaca_initialize(void)
 			OpenSSL_add_all_digests();
 			OpenSSL_add_all_ciphers();
 
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			/* From the default library context, so that the providers
+			 * and the configuration are the ones of the application and
+			 * of its keys. Only the implicit fetch on every init is saved.
+			 */
+			digest_prefetch();
+			encrypt_prefetch();
+#endif
+
 			/*
 			 * TODO:
 			 * - We should also decide on OpenSSL config.
@@ -191,6 +212,11 @@ API void yaca_cleanup(void)
 	{
 		/* last one turns off the light */
 		if (threads_cnt == 1) {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+			encrypt_release();
+			digest_release();
+#endif
+			key_release();
 			ERR_free_strings();
 			EVP_cleanup();
 			RAND_cleanup();
@@ -223,6 +249,8 @@ API int yaca_malloc(size_t size, void **memory)
 		return ret;
 	}
 
+	stats_allocation();
+
 	return YACA_ERROR_NONE;
 }
 
@@ -250,6 +278,7 @@ API int yaca_realloc(size_t size, void **memory)
 	}
 
 	*memory = tmp;
+	stats_allocation();
 
 	return YACA_ERROR_NONE;
 }
@@ -288,10 +317,43 @@ API int yaca_context_set_property(yaca_context_h ctx, yaca_property_e property,
 API int yaca_context_get_property(const yaca_context_h ctx, yaca_property_e property,
                                   void **value, size_t *value_len)
 {
-	if (ctx == YACA_CONTEXT_NULL || ctx->get_property == NULL)
+	int ret;
+	void *buf = NULL;
+	size_t len = 0;
+	size_t *plen = value_len != NULL ? &len : NULL;
+
+	if (ctx == YACA_CONTEXT_NULL || ctx->get_property == NULL || value == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = ctx->get_property(ctx, property, NULL, 0, plen);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = yaca_malloc(len, &buf);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = ctx->get_property(ctx, property, buf, len, plen);
+	if (ret != YACA_ERROR_NONE) {
+		yaca_free(buf);
+		return ret;
+	}
+
+	*value = buf;
+	if (value_len != NULL)
+		*value_len = len;
+
+	return YACA_ERROR_NONE;
+}
+
+API int yaca_context_get_property_into(const yaca_context_h ctx, yaca_property_e property,
+                                       void *value, size_t value_capacity, size_t *value_len)
+{
+	if (ctx == YACA_CONTEXT_NULL || ctx->get_property == NULL ||
+	    value == NULL || value_capacity == 0 || value_len == NULL)
 		return YACA_ERROR_INVALID_PARAMETER;
 
-	return ctx->get_property(ctx, property, value, value_len);
+	return ctx->get_property(ctx, property, value, value_capacity, value_len);
 }
 
 API void yaca_context_destroy(yaca_context_h ctx)
@@ -22,6 +22,7 @@
  */
 
 #include <stdbool.h>
+#include <stdio.h>
 #include <string.h>
 
 #include <openssl/err.h>
@@ -33,12 +34,20 @@
 
 #include "internal.h"
 #include "debug.h"
+#include "stats.h"
 
 
-// TODO any better idea than to use __thread?
+/* Per thread, the same as the OpenSSL error queue the records are made from */
 static __thread yaca_error_cb error_cb = NULL;
-static bool error_strings_loaded = false;
+static __thread struct {
+	/* the records[count % YACA_ERROR_RECORDS_MAX] is written next */
+	size_t count;
+	yaca_error_record_s records[YACA_ERROR_RECORDS_MAX];
+} error_ring;
 static const int GENERIC_REASON_MAX = 99;
+static const char ELLIPSIS[] = "...\n";
+/* the longest string from ERR_error_string_n() is about 250 bytes */
+#define OPENSSL_ERROR_STR_LEN 256
 
 API void yaca_debug_set_error_cb(yaca_error_cb fn)
 {
@@ -60,61 +69,149 @@ API const char *yaca_debug_translate_error(yaca_error_e err)
 }
 #undef ERRORDESCRIBE
 
-void error_dump(const char *file, int line, const char *function, int code)
+API int yaca_error_get_records(yaca_error_record_s *records, size_t max, size_t *count)
 {
-	if (error_cb == NULL) {
-		ERR_clear_error();
-		return;
-	}
+	size_t n;
 
-	static const size_t BUF_SIZE = 512;
-	static const char ELLIPSIS[] = "...\n";
-	static const size_t ELLIPSIS_SIZE = sizeof(ELLIPSIS) / sizeof(ELLIPSIS[0]);
-	char buf[BUF_SIZE];
-	unsigned long err;
+	if (records == NULL || max == 0 || count == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	n = error_ring.count < YACA_ERROR_RECORDS_MAX ? error_ring.count : YACA_ERROR_RECORDS_MAX;
+	if (n > max)
+		n = max;
+
+	for (size_t i = 0; i < n; ++i)
+		records[i] = error_ring.records[(error_ring.count - 1 - i) % YACA_ERROR_RECORDS_MAX];
+
+	*count = n;
+	return YACA_ERROR_NONE;
+}
+
+API void yaca_error_clear_records(void)
+{
+	error_ring.count = 0;
+}
+
+API int yaca_error_format_record(const yaca_error_record_s *record, char *buf, size_t buf_len)
+{
+	char err_buf[OPENSSL_ERROR_STR_LEN];
 	size_t written;
-	const char *err_str = yaca_debug_translate_error(code);
+	size_t errors;
+	int len;
+	int code;
 	const char *sign = "";
+	bool truncated;
 
+	if (record == NULL || buf == NULL || buf_len < sizeof(ELLIPSIS))
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	code = record->code;
 	if (code < 0) {
 		code *= -1;
 		sign = "-";
 	}
 
-	written = snprintf(buf, BUF_SIZE, "%s:%d %s() API error: %s0x%02X (%s)\n", file,
-	                   line, function, sign, code, err_str);
-
-	while ((err = ERR_get_error()) != 0 && written < BUF_SIZE - 1) {
-		if (!error_strings_loaded) {
-			/*
-			 * This function is thread-safe as long as static locks are
-			 * installed according to doc so calling it twice won't break
-			 * anything and I don't want to use synchronization mechanisms
-			 * here.
-			 */
-			ERR_load_crypto_strings();
-			error_strings_loaded = true;
-		}
+	len = snprintf(buf, buf_len, "%s:%d %s() API error: %s0x%02X (%s)\n", record->file,
+	               record->line, record->function, sign, code,
+	               yaca_debug_translate_error(record->code));
+	if (len < 0)
+		len = 0;
+	written = len;
+	truncated = written >= buf_len;
+
+	errors = record->openssl_errors_count;
+	if (errors > YACA_ERROR_RECORD_OPENSSL_MAX) {
+		errors = YACA_ERROR_RECORD_OPENSSL_MAX;
+		truncated = true;
+	}
+
+	/* thread-safe, only the first call loads them */
+	if (errors > 0)
+		OPENSSL_init_crypto(OPENSSL_INIT_LOAD_CRYPTO_STRINGS, NULL);
+
+	for (size_t i = 0; i < errors && written < buf_len; ++i) {
+		size_t err_len;
 
-		ERR_error_string_n(err, buf + written, BUF_SIZE - written);
-		written = strlen(buf); /* I trust you, openssl */
-		if (written < BUF_SIZE - 1) {
-			buf[written] = '\n';
-			written++;
+		ERR_error_string_n(record->openssl_errors[i], err_buf, sizeof(err_buf));
+		err_len = strlen(err_buf);
+
+		/* the line with its newline and the terminating NULL */
+		if (written + err_len + 2 > buf_len) {
+			truncated = true;
+			break;
 		}
+
+		memcpy(buf + written, err_buf, err_len);
+		written += err_len;
+		buf[written++] = '\n';
+		buf[written] = '\0';
+	}
+
+	if (truncated) {
+		if (written > buf_len - sizeof(ELLIPSIS))
+			written = buf_len - sizeof(ELLIPSIS);
+		memcpy(buf + written, ELLIPSIS, sizeof(ELLIPSIS));
+	}
+
+	return YACA_ERROR_NONE;
+}
+
+static void error_report(const yaca_error_record_s *record)
+{
+	static const size_t BUF_SIZE = 512;
+
+	if (error_cb != NULL) {
+		char buf[BUF_SIZE];
+
+		yaca_error_format_record(record, buf, BUF_SIZE);
+		(*error_cb)(buf);
 	}
+}
+
+void error_dump(const char *file, int line, const char *function, int code)
+{
+	yaca_error_record_s *record;
+	unsigned long err;
+
+	stats_error(code);
 
-	/* In case the while broke early due to the BUF_SIZE, write
-	 * ellipsis and clear remaining errors that might have not been
-	 * read by ERR_get_error() */
-	if (written >= BUF_SIZE - 1) {
-		strncpy(buf + BUF_SIZE - ELLIPSIS_SIZE, ELLIPSIS, ELLIPSIS_SIZE);
-		written = BUF_SIZE - 1;
-		ERR_clear_error();
+	/* No formatting here, most of the records are never looked at */
+	record = &error_ring.records[error_ring.count++ % YACA_ERROR_RECORDS_MAX];
+	record->code = code;
+	record->file = file;
+	record->line = line;
+	record->function = function;
+	record->openssl_errors_count = 0;
+
+	while ((err = ERR_get_error()) != 0) {
+		if (record->openssl_errors_count < YACA_ERROR_RECORD_OPENSSL_MAX)
+			record->openssl_errors[record->openssl_errors_count] = err;
+		record->openssl_errors_count++;
 	}
 
-	buf[written] = '\0';
-	(*error_cb)(buf);
+	error_report(record);
+}
+
+void error_records_save(struct error_records_s *saved)
+{
+	size_t n = error_ring.count < ERROR_RECORDS_SAVED ? error_ring.count : ERROR_RECORDS_SAVED;
+
+	for (size_t i = 0; i < n; ++i)
+		saved->records[i] = error_ring.records[(error_ring.count - n + i) % YACA_ERROR_RECORDS_MAX];
+
+	saved->count = n;
+	error_ring.count = 0;
+}
+
+void error_records_restore(const struct error_records_s *saved)
+{
+	/* Already counted in the stats by the thread that made them */
+	for (size_t i = 0; i < saved->count; ++i) {
+		yaca_error_record_s *record = &error_ring.records[error_ring.count++ % YACA_ERROR_RECORDS_MAX];
+
+		*record = saved->records[i];
+		error_report(record);
+	}
 }
 
 int error_handle(const char *file, int line, const char *function)
@@ -122,8 +219,10 @@ int error_handle(const char *file, int line, const char *function)
 	int ret = YACA_ERROR_NONE;
 	unsigned long err = ERR_peek_error();
 
-	if (err == 0)
+	if (err == 0) {
+		stats_error(YACA_ERROR_INTERNAL);
 		return YACA_ERROR_INTERNAL;
+	}
 
 	/* known errors */
 	switch (err) {
@@ -229,6 +328,8 @@ int error_handle(const char *file, int line, const char *function)
 	if (ret == YACA_ERROR_NONE) {
 		error_dump(file, line, function, YACA_ERROR_INTERNAL);
 		ret = YACA_ERROR_INTERNAL;
+	} else {
+		stats_error(ret);
 	}
 
 	/* remove all errors from queue */
@@ -45,6 +45,20 @@ const char *yaca_debug_translate_error(yaca_error_e err);
 void error_dump(const char *file, int line, const char *function, int code);
 #define ERROR_DUMP(code) error_dump(__FILE__, __LINE__, __func__, (code))
 
+/* A worker stops at its first failure, its last records are about it */
+#define ERROR_RECORDS_SAVED 2
+
+/* The latest error records of a thread, to be passed to another one */
+struct error_records_s {
+	size_t count;
+	yaca_error_record_s records[ERROR_RECORDS_SAVED];
+};
+
+/* Moves the latest records of the calling thread out, the oldest first */
+void error_records_save(struct error_records_s *saved);
+/* Adds them to the records of the calling thread and to its callback */
+void error_records_restore(const struct error_records_s *saved);
+
 /**
  * Function responsible for translating the openssl error to yaca error and
  * clearing/dumping the openssl error queue. Use only after openssl function
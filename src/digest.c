@@ -30,31 +30,41 @@
 #include <yaca_error.h>
 
 #include "internal.h"
+#include "stats.h"
+#include "trace.h"
 
 #ifdef OPENSSL_MOCKUP_TESTS
 #include "../tests/openssl_mock_redefine.h"
 #endif
 
 
-static const struct {
-	yaca_digest_algorithm_e algo;
-	const EVP_MD *(*digest)(void);
-} MESSAGE_DIGESTS[] = {
-	{YACA_DIGEST_MD5,    EVP_md5},
-	{YACA_DIGEST_SHA1,   EVP_sha1},
-	{YACA_DIGEST_SHA224, EVP_sha224},
-	{YACA_DIGEST_SHA256, EVP_sha256},
-	{YACA_DIGEST_SHA384, EVP_sha384},
-	{YACA_DIGEST_SHA512, EVP_sha512},
+#define DIGEST_ALGO_COUNT (YACA_DIGEST_SHA512 + 1)
+
+/* Indexed by yaca_digest_algorithm_e */
+static const EVP_MD *(*const MESSAGE_DIGESTS[DIGEST_ALGO_COUNT])(void) = {
+	[YACA_DIGEST_MD5]    = EVP_md5,
+	[YACA_DIGEST_SHA1]   = EVP_sha1,
+	[YACA_DIGEST_SHA224] = EVP_sha224,
+	[YACA_DIGEST_SHA256] = EVP_sha256,
+	[YACA_DIGEST_SHA384] = EVP_sha384,
+	[YACA_DIGEST_SHA512] = EVP_sha512,
 };
 
-static const size_t MESSAGE_DIGESTS_SIZE = sizeof(MESSAGE_DIGESTS) / sizeof(MESSAGE_DIGESTS[0]);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+/* Explicitly fetched MESSAGE_DIGESTS. Using the legacy EVP_sha256() style
+ * objects makes every EVP_DigestInit() do an implicit fetch that takes the
+ * provider store lock. NULL where the fetch failed, the legacy object is
+ * used then.
+ */
+static EVP_MD *FETCHED_DIGESTS[DIGEST_ALGO_COUNT];
+#endif
 
 struct yaca_digest_context_s {
 	struct yaca_context_s ctx;
 
 	EVP_MD_CTX *md_ctx;
 	enum context_state_e state;
+	yaca_digest_algorithm_e algo;
 };
 
 static bool CTX_DEFAULT_STATES[CTX_COUNT][CTX_COUNT] = {
@@ -109,6 +119,13 @@ static int get_digest_output_length(const yaca_context_h ctx,
 	return YACA_ERROR_NONE;
 }
 
+UNUSED static int trace_digest_algo(const yaca_context_h ctx)
+{
+	const struct yaca_digest_context_s *c = get_digest_context(ctx);
+
+	return c != NULL ? (int)c->algo : -1;
+}
+
 static void destroy_digest_context(yaca_context_h ctx)
 {
 	struct yaca_digest_context_s *c = get_digest_context(ctx);
@@ -118,30 +135,59 @@ static void destroy_digest_context(yaca_context_h ctx)
 	c->md_ctx = NULL;
 }
 
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+void digest_prefetch(void)
+{
+	size_t i;
+
+	for (i = 0; i < DIGEST_ALGO_COUNT; ++i) {
+		const EVP_MD *md = MESSAGE_DIGESTS[i]();
+
+		if (md != NULL)
+			FETCHED_DIGESTS[i] = EVP_MD_fetch(NULL, EVP_MD_get0_name(md), NULL);
+	}
+
+	/* failed fetches are not fatal */
+	ERROR_CLEAR();
+}
+
+void digest_release(void)
+{
+	size_t i;
+
+	for (i = 0; i < DIGEST_ALGO_COUNT; ++i) {
+		EVP_MD_free(FETCHED_DIGESTS[i]);
+		FETCHED_DIGESTS[i] = NULL;
+	}
+}
+#endif
+
 int digest_get_algorithm(yaca_digest_algorithm_e algo, const EVP_MD **md)
 {
 	int ret;
-	size_t i;
 
 	assert(md != NULL);
 
 	*md = NULL;
-	ret = YACA_ERROR_INVALID_PARAMETER;
 
-	for (i = 0; i < MESSAGE_DIGESTS_SIZE; ++i)
-		if (MESSAGE_DIGESTS[i].algo == algo) {
-			*md = MESSAGE_DIGESTS[i].digest();
-			ret = YACA_ERROR_NONE;
-			break;
-		}
+	if ((unsigned)algo >= DIGEST_ALGO_COUNT)
+		return YACA_ERROR_INVALID_PARAMETER;
 
-	if (ret == YACA_ERROR_NONE && *md == NULL) {
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	if (FETCHED_DIGESTS[algo] != NULL) {
+		*md = FETCHED_DIGESTS[algo];
+		return YACA_ERROR_NONE;
+	}
+#endif
+
+	*md = MESSAGE_DIGESTS[algo]();
+	if (*md == NULL) {
 		ret = YACA_ERROR_INTERNAL;
 		ERROR_DUMP(ret);
 		return ret;
 	}
 
-	return ret;
+	return YACA_ERROR_NONE;
 }
 
 API int yaca_digest_initialize(yaca_context_h *ctx, yaca_digest_algorithm_e algo)
@@ -182,6 +228,9 @@ API int yaca_digest_initialize(yaca_context_h *ctx, yaca_digest_algorithm_e algo
 	}
 
 	nc->state = CTX_INITIALIZED;
+	nc->algo = algo;
+	stats_context_initialized(YACA_STATS_CONTEXT_DIGEST);
+
 	*ctx = (yaca_context_h)nc;
 	nc = NULL;
 	ret = YACA_ERROR_NONE;
@@ -192,7 +241,7 @@ exit:
 	return ret;
 }
 
-API int yaca_digest_update(yaca_context_h ctx, const char *message, size_t message_len)
+static int digest_update(yaca_context_h ctx, const char *message, size_t message_len)
 {
 	struct yaca_digest_context_s *c = get_digest_context(ctx);
 	int ret;
@@ -211,10 +260,13 @@ API int yaca_digest_update(yaca_context_h ctx, const char *message, size_t messa
 	}
 
 	c->state = CTX_MSG_UPDATED;
+	stats_context_updated(YACA_STATS_CONTEXT_DIGEST);
+	stats_digest_bytes(c->algo, message_len);
+
 	return YACA_ERROR_NONE;
 }
 
-API int yaca_digest_finalize(yaca_context_h ctx, char *digest, size_t *digest_len)
+static int digest_finalize(yaca_context_h ctx, char *digest, size_t *digest_len)
 {
 	struct yaca_digest_context_s *c = get_digest_context(ctx);
 	int ret;
@@ -235,6 +287,31 @@ API int yaca_digest_finalize(yaca_context_h ctx, char *digest, size_t *digest_le
 
 	c->state = CTX_FINALIZED;
 	*digest_len = len;
+	stats_context_finalized(YACA_STATS_CONTEXT_DIGEST);
 
 	return YACA_ERROR_NONE;
 }
+
+API int yaca_digest_update(yaca_context_h ctx, const char *message, size_t message_len)
+{
+	int ret;
+
+	TRACE(digest__update__entry, trace_digest_algo(ctx), message_len);
+
+	ret = digest_update(ctx, message, message_len);
+
+	TRACE(digest__update__return, trace_digest_algo(ctx), message_len, ret);
+	return ret;
+}
+
+API int yaca_digest_finalize(yaca_context_h ctx, char *digest, size_t *digest_len)
+{
+	int ret;
+
+	TRACE(digest__finalize__entry, trace_digest_algo(ctx));
+
+	ret = digest_finalize(ctx, digest, digest_len);
+
+	TRACE(digest__finalize__return, trace_digest_algo(ctx), ret);
+	return ret;
+}
@@ -28,6 +28,8 @@
 #include <string.h>
 
 #include <openssl/evp.h>
+#include <openssl/cmac.h>
+#include <openssl/crypto.h>
 
 #include <yaca_crypto.h>
 #include <yaca_encrypt.h>
@@ -35,6 +37,8 @@
 #include <yaca_key.h>
 
 #include "internal.h"
+#include "stats.h"
+#include "trace.h"
 
 #ifdef OPENSSL_MOCKUP_TESTS
 #include "../tests/openssl_mock_redefine.h"
@@ -45,7 +49,7 @@ static int set_encrypt_property(yaca_context_h ctx, yaca_property_e property,
                                 const void *value, size_t value_len);
 
 static int get_encrypt_property(const yaca_context_h ctx, yaca_property_e property,
-                                void **value, size_t *value_len);
+                                void *value, size_t value_capacity, size_t *value_len);
 
 static const size_t DEFAULT_GCM_TAG_LEN = 16;
 static const size_t DEFAULT_CCM_TAG_LEN = 12;
@@ -70,6 +74,64 @@ struct yaca_encrypt_context_s {
 	enum encrypt_op_type_e op_type; /* Operation context was created for */
 	size_t tag_len;
 	enum encrypt_context_state_e state;
+	size_t msg_len; /* Message bytes passed to update so far */
+	yaca_encrypt_algorithm_e algo;
+	yaca_block_cipher_mode_e bcm;
+
+	/* Resolved once in encrypt_ctx_create(), they don't change afterwards */
+	int mode;
+	int nid;
+	int block_size;
+	bool (*states)[ENC_CTX_COUNT];
+	int (*update)(struct yaca_encrypt_context_s *c,
+	              const unsigned char *input, size_t input_len,
+	              unsigned char *output, int *output_len);
+	int (*update_in_place)(struct yaca_encrypt_context_s *c,
+	                       const unsigned char *input, size_t input_len,
+	                       unsigned char *output, int *output_len);
+	int (*finalize)(struct yaca_encrypt_context_s *c,
+	                unsigned char *output, int *output_len);
+
+	/* Only for the CBC-HMAC modes */
+	struct yaca_cbc_hmac_s *hmac;
+	/* Only for SIV */
+	struct yaca_siv_s *siv;
+	/* NULL until YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO is set */
+	struct yaca_plaintext_digest_s *digest;
+};
+
+struct yaca_cbc_hmac_s {
+	const EVP_MD *md;
+	/* NULL until YACA_PROPERTY_CBC_HMAC_KEY is set, the IV is MACed first */
+	EVP_MD_CTX *md_ctx;
+	unsigned char iv[EVP_MAX_IV_LENGTH];
+	size_t iv_len;
+	/* MACed after the ciphertext, the AAD can't be moved into it */
+	uint64_t aad_len;
+	/* Computed when encrypting, expected when decrypting */
+	unsigned char tag[EVP_MAX_MD_SIZE];
+	size_t tag_len;
+};
+
+/* The AES block, the length of the SIV tag */
+#define SIV_BLOCK 16
+
+struct yaca_siv_s {
+	/* Keyed with the first half of the key, restarted for every S2V string */
+	CMAC_CTX *cmac;
+	/* CMAC of the zero block, the S2V accumulator starts with it */
+	unsigned char d0[SIV_BLOCK];
+	/* The S2V accumulator, updated with every AAD */
+	unsigned char d[SIV_BLOCK];
+	/* The synthetic IV: computed when encrypting, expected when decrypting */
+	unsigned char v[SIV_BLOCK];
+};
+
+struct yaca_plaintext_digest_s {
+	EVP_MD_CTX *md_ctx;
+	unsigned char value[EVP_MAX_MD_SIZE];
+	/* 0 until the finalization */
+	unsigned int len;
 };
 
 struct yaca_backup_context_s {
@@ -79,79 +141,77 @@ struct yaca_backup_context_s {
 	yaca_padding_e padding;
 };
 
-static const struct {
-	yaca_encrypt_algorithm_e algo;
-	yaca_block_cipher_mode_e bcm;
-	size_t key_bit_len;
-	const EVP_CIPHER *(*cipher)(void);
-} ENCRYPTION_CIPHERS[] = {
-	{YACA_ENCRYPT_AES, YACA_BCM_CBC,  128, EVP_aes_128_cbc},
-	{YACA_ENCRYPT_AES, YACA_BCM_CCM,  128, EVP_aes_128_ccm},
-	{YACA_ENCRYPT_AES, YACA_BCM_CFB,  128, EVP_aes_128_cfb},
-	{YACA_ENCRYPT_AES, YACA_BCM_CFB1, 128, EVP_aes_128_cfb1},
-	{YACA_ENCRYPT_AES, YACA_BCM_CFB8, 128, EVP_aes_128_cfb8},
-	{YACA_ENCRYPT_AES, YACA_BCM_CTR,  128, EVP_aes_128_ctr},
-	{YACA_ENCRYPT_AES, YACA_BCM_ECB,  128, EVP_aes_128_ecb},
-	{YACA_ENCRYPT_AES, YACA_BCM_GCM,  128, EVP_aes_128_gcm},
-	{YACA_ENCRYPT_AES, YACA_BCM_OFB,  128, EVP_aes_128_ofb},
-	{YACA_ENCRYPT_AES, YACA_BCM_WRAP, 128, EVP_aes_128_wrap},
-
-	{YACA_ENCRYPT_AES, YACA_BCM_CBC,  192, EVP_aes_192_cbc},
-	{YACA_ENCRYPT_AES, YACA_BCM_CCM,  192, EVP_aes_192_ccm},
-	{YACA_ENCRYPT_AES, YACA_BCM_CFB,  192, EVP_aes_192_cfb},
-	{YACA_ENCRYPT_AES, YACA_BCM_CFB1, 192, EVP_aes_192_cfb1},
-	{YACA_ENCRYPT_AES, YACA_BCM_CFB8, 192, EVP_aes_192_cfb8},
-	{YACA_ENCRYPT_AES, YACA_BCM_CTR,  192, EVP_aes_192_ctr},
-	{YACA_ENCRYPT_AES, YACA_BCM_ECB,  192, EVP_aes_192_ecb},
-	{YACA_ENCRYPT_AES, YACA_BCM_GCM,  192, EVP_aes_192_gcm},
-	{YACA_ENCRYPT_AES, YACA_BCM_OFB,  192, EVP_aes_192_ofb},
-	{YACA_ENCRYPT_AES, YACA_BCM_WRAP, 192, EVP_aes_192_wrap},
-
-	{YACA_ENCRYPT_AES, YACA_BCM_CBC,  256, EVP_aes_256_cbc},
-	{YACA_ENCRYPT_AES, YACA_BCM_CCM,  256, EVP_aes_256_ccm},
-	{YACA_ENCRYPT_AES, YACA_BCM_CFB,  256, EVP_aes_256_cfb},
-	{YACA_ENCRYPT_AES, YACA_BCM_CFB1, 256, EVP_aes_256_cfb1},
-	{YACA_ENCRYPT_AES, YACA_BCM_CFB8, 256, EVP_aes_256_cfb8},
-	{YACA_ENCRYPT_AES, YACA_BCM_CTR,  256, EVP_aes_256_ctr},
-	{YACA_ENCRYPT_AES, YACA_BCM_ECB,  256, EVP_aes_256_ecb},
-	{YACA_ENCRYPT_AES, YACA_BCM_GCM,  256, EVP_aes_256_gcm},
-	{YACA_ENCRYPT_AES, YACA_BCM_OFB,  256, EVP_aes_256_ofb},
-	{YACA_ENCRYPT_AES, YACA_BCM_WRAP, 256, EVP_aes_256_wrap},
-
-	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CBC,  -1, EVP_des_cbc},
-	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CFB,  -1, EVP_des_cfb},
-	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CFB1, -1, EVP_des_cfb1},
-	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CFB8, -1, EVP_des_cfb8},
-	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_ECB,  -1, EVP_des_ecb},
-	{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_OFB,  -1, EVP_des_ofb},
-
-	{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_CBC, -1, EVP_des_ede_cbc},
-	{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_CFB, -1, EVP_des_ede_cfb},
-	{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_ECB, -1, EVP_des_ede_ecb},
-	{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_OFB, -1, EVP_des_ede_ofb},
-
-	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CBC,  -1, EVP_des_ede3_cbc},
-	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CFB,  -1, EVP_des_ede3_cfb},
-	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CFB1, -1, EVP_des_ede3_cfb1},
-	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CFB8, -1, EVP_des_ede3_cfb8},
-	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_ECB,  -1, EVP_des_ede3_ecb},
-	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_OFB,  -1, EVP_des_ede3_ofb},
-	{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_WRAP, -1, EVP_des_ede3_wrap},
-
-	{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_CBC, -1, EVP_rc2_cbc},
-	{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_CFB, -1, EVP_rc2_cfb},
-	{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_ECB, -1, EVP_rc2_ecb},
-	{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_OFB, -1, EVP_rc2_ofb},
-
-	{YACA_ENCRYPT_UNSAFE_RC4, YACA_BCM_NONE, -1, EVP_rc4},
-
-	{YACA_ENCRYPT_CAST5, YACA_BCM_CBC, -1, EVP_cast5_cbc},
-	{YACA_ENCRYPT_CAST5, YACA_BCM_CFB, -1, EVP_cast5_cfb},
-	{YACA_ENCRYPT_CAST5, YACA_BCM_ECB, -1, EVP_cast5_ecb},
-	{YACA_ENCRYPT_CAST5, YACA_BCM_OFB, -1, EVP_cast5_ofb},
+#define ENCRYPT_ALGO_COUNT (YACA_ENCRYPT_CAST5 + 1)
+#define ENCRYPT_BCM_COUNT (YACA_BCM_SIV + 1)
+/* AES 128, 192 and 256 bits, other algorithms only use the first slot */
+#define ENCRYPT_KEY_SLOTS 3
+
+/* Indexed by [algo][bcm][key slot], NULL for unsupported combinations */
+static const EVP_CIPHER *(*const ENCRYPTION_CIPHERS[ENCRYPT_ALGO_COUNT][ENCRYPT_BCM_COUNT][ENCRYPT_KEY_SLOTS])(void) = {
+	[YACA_ENCRYPT_AES] = {
+		[YACA_BCM_CBC]  = {EVP_aes_128_cbc, EVP_aes_192_cbc, EVP_aes_256_cbc},
+		[YACA_BCM_CCM]  = {EVP_aes_128_ccm, EVP_aes_192_ccm, EVP_aes_256_ccm},
+		[YACA_BCM_CFB]  = {EVP_aes_128_cfb, EVP_aes_192_cfb, EVP_aes_256_cfb},
+		[YACA_BCM_CFB1] = {EVP_aes_128_cfb1, EVP_aes_192_cfb1, EVP_aes_256_cfb1},
+		[YACA_BCM_CFB8] = {EVP_aes_128_cfb8, EVP_aes_192_cfb8, EVP_aes_256_cfb8},
+		[YACA_BCM_CTR]  = {EVP_aes_128_ctr, EVP_aes_192_ctr, EVP_aes_256_ctr},
+		[YACA_BCM_ECB]  = {EVP_aes_128_ecb, EVP_aes_192_ecb, EVP_aes_256_ecb},
+		[YACA_BCM_GCM]  = {EVP_aes_128_gcm, EVP_aes_192_gcm, EVP_aes_256_gcm},
+		[YACA_BCM_OFB]  = {EVP_aes_128_ofb, EVP_aes_192_ofb, EVP_aes_256_ofb},
+		[YACA_BCM_WRAP] = {EVP_aes_128_wrap, EVP_aes_192_wrap, EVP_aes_256_wrap},
+		/* The HMAC is added by the context, see encrypt_ctx_setup_cbc_hmac() */
+		[YACA_BCM_CBC_HMAC_SHA1]   = {EVP_aes_128_cbc, EVP_aes_192_cbc, EVP_aes_256_cbc},
+		[YACA_BCM_CBC_HMAC_SHA256] = {EVP_aes_128_cbc, EVP_aes_192_cbc, EVP_aes_256_cbc},
+		/* Slot of the half key, the CMAC is added by encrypt_ctx_setup_siv() */
+		[YACA_BCM_SIV] = {EVP_aes_128_ctr, EVP_aes_192_ctr, EVP_aes_256_ctr},
+	},
+	[YACA_ENCRYPT_UNSAFE_DES] = {
+		[YACA_BCM_CBC]  = {EVP_des_cbc},
+		[YACA_BCM_CFB]  = {EVP_des_cfb},
+		[YACA_BCM_CFB1] = {EVP_des_cfb1},
+		[YACA_BCM_CFB8] = {EVP_des_cfb8},
+		[YACA_BCM_ECB]  = {EVP_des_ecb},
+		[YACA_BCM_OFB]  = {EVP_des_ofb},
+	},
+	[YACA_ENCRYPT_UNSAFE_3DES_2TDEA] = {
+		[YACA_BCM_CBC] = {EVP_des_ede_cbc},
+		[YACA_BCM_CFB] = {EVP_des_ede_cfb},
+		[YACA_BCM_ECB] = {EVP_des_ede_ecb},
+		[YACA_BCM_OFB] = {EVP_des_ede_ofb},
+	},
+	[YACA_ENCRYPT_3DES_3TDEA] = {
+		[YACA_BCM_CBC]  = {EVP_des_ede3_cbc},
+		[YACA_BCM_CFB]  = {EVP_des_ede3_cfb},
+		[YACA_BCM_CFB1] = {EVP_des_ede3_cfb1},
+		[YACA_BCM_CFB8] = {EVP_des_ede3_cfb8},
+		[YACA_BCM_ECB]  = {EVP_des_ede3_ecb},
+		[YACA_BCM_OFB]  = {EVP_des_ede3_ofb},
+		[YACA_BCM_WRAP] = {EVP_des_ede3_wrap},
+	},
+	[YACA_ENCRYPT_UNSAFE_RC2] = {
+		[YACA_BCM_CBC] = {EVP_rc2_cbc},
+		[YACA_BCM_CFB] = {EVP_rc2_cfb},
+		[YACA_BCM_ECB] = {EVP_rc2_ecb},
+		[YACA_BCM_OFB] = {EVP_rc2_ofb},
+	},
+	[YACA_ENCRYPT_UNSAFE_RC4] = {
+		[YACA_BCM_NONE] = {EVP_rc4},
+	},
+	[YACA_ENCRYPT_CAST5] = {
+		[YACA_BCM_CBC] = {EVP_cast5_cbc},
+		[YACA_BCM_CFB] = {EVP_cast5_cfb},
+		[YACA_BCM_ECB] = {EVP_cast5_ecb},
+		[YACA_BCM_OFB] = {EVP_cast5_ofb},
+	},
 };
 
-static const size_t ENCRYPTION_CIPHERS_SIZE = sizeof(ENCRYPTION_CIPHERS) / sizeof(ENCRYPTION_CIPHERS[0]);
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+/* Explicitly fetched ENCRYPTION_CIPHERS, see FETCHED_DIGESTS in digest.c.
+ * NULL where the fetch failed (e.g. the legacy provider isn't loaded by the
+ * application), the legacy object is used then.
+ */
+static EVP_CIPHER *FETCHED_CIPHERS[ENCRYPT_ALGO_COUNT][ENCRYPT_BCM_COUNT][ENCRYPT_KEY_SLOTS];
+#endif
 
 static bool is_encryption_op(enum encrypt_op_type_e op_type)
 {
@@ -224,22 +284,68 @@ static bool WRAP_STATES[ENC_CTX_COUNT][ENC_CTX_COUNT] = {
 /* FIN  */  { 0,    0,    0,    0,    0,    0,    0 },
 };
 
-static bool verify_state_change(struct yaca_encrypt_context_s *c, enum encrypt_context_state_e to)
+static bool CBC_HMAC_STATES[2][ENC_CTX_COUNT][ENC_CTX_COUNT] = { {
+/* ENCRYPTION */
+/* from \ to  INIT, MLEN, AAD,  MSG,  TAG,  TLEN, FIN */
+/* INIT */  { 0,    0,    1,    1,    0,    0,    1 },
+/* MLEN */  { 0,    0,    0,    0,    0,    0,    0 },
+/* AAD  */  { 0,    0,    1,    1,    0,    0,    1 },
+/* MSG  */  { 0,    0,    0,    1,    0,    0,    1 },
+/* TAG  */  { 0,    0,    0,    0,    0,    0,    0 },
+/* TLEN */  { 0,    0,    0,    0,    0,    0,    0 },
+/* FIN  */  { 0,    0,    0,    0,    0,    0,    0 },
+}, {
+/* DECRYPTION */
+/* from \ to  INIT, MLEN, AAD,  MSG,  TAG,  TLEN, FIN */
+/* INIT */  { 0,    0,    1,    1,    1,    0,    0 },
+/* MLEN */  { 0,    0,    0,    0,    0,    0,    0 },
+/* AAD  */  { 0,    0,    1,    1,    1,    0,    0 },
+/* MSG  */  { 0,    0,    0,    1,    1,    0,    0 },
+/* TAG  */  { 0,    0,    0,    0,    0,    0,    1 },
+/* TLEN */  { 0,    0,    0,    0,    0,    0,    0 },
+/* FIN  */  { 0,    0,    0,    0,    0,    0,    0 },
+} };
+
+/* The tag is the IV of the CTR, it is needed before the ciphertext */
+static bool SIV_STATES[2][ENC_CTX_COUNT][ENC_CTX_COUNT] = { {
+/* ENCRYPTION */
+/* from \ to  INIT, MLEN, AAD,  MSG,  TAG,  TLEN, FIN */
+/* INIT */  { 0,    0,    1,    1,    0,    0,    1 },
+/* MLEN */  { 0,    0,    0,    0,    0,    0,    0 },
+/* AAD  */  { 0,    0,    1,    1,    0,    0,    1 },
+/* MSG  */  { 0,    0,    0,    0,    0,    0,    1 },
+/* TAG  */  { 0,    0,    0,    0,    0,    0,    0 },
+/* TLEN */  { 0,    0,    0,    0,    0,    0,    0 },
+/* FIN  */  { 0,    0,    0,    0,    0,    0,    0 },
+}, {
+/* DECRYPTION */
+/* from \ to  INIT, MLEN, AAD,  MSG,  TAG,  TLEN, FIN */
+/* INIT */  { 0,    0,    0,    0,    1,    0,    0 },
+/* MLEN */  { 0,    0,    0,    0,    0,    0,    0 },
+/* AAD  */  { 0,    0,    1,    1,    0,    0,    1 },
+/* MSG  */  { 0,    0,    0,    0,    0,    0,    1 },
+/* TAG  */  { 0,    0,    1,    1,    0,    0,    1 },
+/* TLEN */  { 0,    0,    0,    0,    0,    0,    0 },
+/* FIN  */  { 0,    0,    0,    0,    0,    0,    0 },
+} };
+
+static bool (*get_states(int mode, enum encrypt_op_type_e op_type))[ENC_CTX_COUNT]
 {
-	int mode = EVP_CIPHER_CTX_mode(c->cipher_ctx);
-	bool encryption = is_encryption_op(c->op_type);
-	int from = c->state;
+	bool encryption = is_encryption_op(op_type);
 
 	if (mode == EVP_CIPH_CCM_MODE)
-		return CCM_STATES[encryption ? 0 : 1][from][to];
+		return CCM_STATES[encryption ? 0 : 1];
 	else if (mode == EVP_CIPH_GCM_MODE)
-		return GCM_STATES[encryption ? 0 : 1][from][to];
+		return GCM_STATES[encryption ? 0 : 1];
 	else if (mode == EVP_CIPH_WRAP_MODE)
-		return WRAP_STATES[from][to];
+		return WRAP_STATES;
 	else
-		return DEFAULT_STATES[from][to];
+		return DEFAULT_STATES;
+}
 
-	return false;
+static bool verify_state_change(struct yaca_encrypt_context_s *c, enum encrypt_context_state_e to)
+{
+	return c->states[c->state][to];
 }
 
 static const size_t VALID_GCM_TAG_LENGTHS[] = { 4, 8, 12, 13, 14, 15, 16 };
@@ -271,6 +377,40 @@ static bool is_valid_tag_len(int mode, size_t tag_len)
 	}
 }
 
+static void siv_free(struct yaca_siv_s *siv)
+{
+	if (siv == NULL)
+		return;
+
+	CMAC_CTX_free(siv->cmac);
+	OPENSSL_cleanse(siv, sizeof(struct yaca_siv_s));
+	yaca_free(siv);
+}
+
+/* For the batch workers, each one needs a CMAC context of its own */
+static int siv_copy(const struct yaca_siv_s *siv, struct yaca_siv_s **copy)
+{
+	int ret;
+	struct yaca_siv_s *nsiv;
+
+	ret = yaca_zalloc(sizeof(struct yaca_siv_s), (void**)&nsiv);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	memcpy(nsiv->d0, siv->d0, SIV_BLOCK);
+
+	nsiv->cmac = CMAC_CTX_new();
+	if (nsiv->cmac == NULL || CMAC_CTX_copy(nsiv->cmac, siv->cmac) != 1) {
+		siv_free(nsiv);
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	*copy = nsiv;
+	return YACA_ERROR_NONE;
+}
+
 static struct yaca_encrypt_context_s *get_encrypt_context(const yaca_context_h ctx)
 {
 	if (ctx == YACA_CONTEXT_NULL)
@@ -284,6 +424,20 @@ static struct yaca_encrypt_context_s *get_encrypt_context(const yaca_context_h c
 	}
 }
 
+UNUSED static int trace_encrypt_algo(const yaca_context_h ctx)
+{
+	const struct yaca_encrypt_context_s *c = get_encrypt_context(ctx);
+
+	return c != NULL ? (int)c->algo : -1;
+}
+
+UNUSED static int trace_encrypt_bcm(const yaca_context_h ctx)
+{
+	const struct yaca_encrypt_context_s *c = get_encrypt_context(ctx);
+
+	return c != NULL ? (int)c->bcm : -1;
+}
+
 static void destroy_encrypt_context(const yaca_context_h ctx)
 {
 	struct yaca_encrypt_context_s *c = get_encrypt_context(ctx);
@@ -296,6 +450,21 @@ static void destroy_encrypt_context(const yaca_context_h ctx)
 		c->backup_ctx = NULL;
 	}
 
+	if (c->hmac != NULL) {
+		EVP_MD_CTX_destroy(c->hmac->md_ctx);
+		yaca_free(c->hmac);
+		c->hmac = NULL;
+	}
+
+	siv_free(c->siv);
+	c->siv = NULL;
+
+	if (c->digest != NULL) {
+		EVP_MD_CTX_destroy(c->digest->md_ctx);
+		yaca_free(c->digest);
+		c->digest = NULL;
+	}
+
 	EVP_CIPHER_CTX_free(c->cipher_ctx);
 	c->cipher_ctx = NULL;
 }
@@ -309,12 +478,8 @@ static int get_encrypt_output_length(const yaca_context_h ctx, size_t input_len,
 	assert(c != NULL);
 	assert(c->cipher_ctx != NULL);
 
-	block_size = EVP_CIPHER_CTX_block_size(c->cipher_ctx);
-	if (block_size <= 0) {
-		const int ret = YACA_ERROR_INTERNAL;
-		ERROR_DUMP(ret);
-		return ret;
-	}
+	block_size = c->block_size;
+	assert(block_size > 0);
 
 	if (input_len > 0) {
 		if ((size_t)block_size > SIZE_MAX - input_len + 1)
@@ -338,7 +503,7 @@ static int get_wrap_output_length(const yaca_context_h ctx, size_t input_len, si
 	assert(c->cipher_ctx != NULL);
 
 	bool encryption = is_encryption_op(c->op_type);
-	int nid = EVP_CIPHER_CTX_nid(c->cipher_ctx);
+	int nid = c->nid;
 
 	if (input_len > 0) {
 		if (nid == NID_id_aes128_wrap || nid == NID_id_aes192_wrap || nid == NID_id_aes256_wrap) {
@@ -356,187 +521,338 @@ static int get_wrap_output_length(const yaca_context_h ctx, size_t input_len, si
 	return YACA_ERROR_NONE;
 }
 
-static int encrypt_ctx_create(struct yaca_encrypt_context_s **c,
-                              enum encrypt_op_type_e op_type,
-                              const EVP_CIPHER *cipher)
+static int update_plain(struct yaca_encrypt_context_s *c,
+                        const unsigned char *input, size_t input_len,
+                        unsigned char *output, int *output_len)
 {
 	int ret;
-	int mode;
-	struct yaca_encrypt_context_s *nc;
-
-	assert(c != NULL);
-	assert(cipher != NULL);
 
-	ret = yaca_zalloc(sizeof(struct yaca_encrypt_context_s), (void**)&nc);
-	if (ret != YACA_ERROR_NONE)
+	ret = EVP_CipherUpdate(c->cipher_ctx, output, output_len, input, input_len);
+	if (ret != 1 || *output_len < 0) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
 		return ret;
+	}
 
-	mode = EVP_CIPHER_flags(cipher) & EVP_CIPH_MODE;
+	return YACA_ERROR_NONE;
+}
 
-	nc->ctx.type = YACA_CONTEXT_ENCRYPT;
-	nc->backup_ctx = NULL;
-	nc->ctx.context_destroy = destroy_encrypt_context;
-	nc->ctx.get_output_length = (mode == EVP_CIPH_WRAP_MODE) ?
-	                            get_wrap_output_length :
-	                            get_encrypt_output_length;
-	nc->ctx.set_property = set_encrypt_property;
-	nc->ctx.get_property = get_encrypt_property;
-	nc->op_type = op_type;
-	nc->tag_len = 0;
+static int update_ccm_decrypt(struct yaca_encrypt_context_s *c,
+                              const unsigned char *input, size_t input_len,
+                              unsigned char *output, int *output_len)
+{
+	int ret;
 
-	/* set default tag length for GCM and CCM */
-	if (mode == EVP_CIPH_GCM_MODE)
-		nc->tag_len = DEFAULT_GCM_TAG_LEN;
-	else if (mode == EVP_CIPH_CCM_MODE)
-		nc->tag_len = DEFAULT_CCM_TAG_LEN;
+	ret = EVP_CipherUpdate(c->cipher_ctx, output, output_len, input, input_len);
+	if (ret != 1 || *output_len < 0) {
+		/* A non positive return value from EVP_CipherUpdate should be considered as
+		 * a failure to authenticate ciphertext and/or AAD.
+		 * It does not necessarily indicate a more serious error.
+		 * There is no call to EVP_CipherFinal.
+		 */
+		stats_authentication_failure();
+		return YACA_ERROR_INVALID_PARAMETER;
+	}
 
-	nc->cipher_ctx = EVP_CIPHER_CTX_new();
-	if (nc->cipher_ctx == NULL) {
-		ret =  YACA_ERROR_INTERNAL;
-		ERROR_DUMP(ret);
-		goto exit;
+	return YACA_ERROR_NONE;
+}
+
+static int update_wrap(struct yaca_encrypt_context_s *c,
+                       const unsigned char *input, size_t input_len,
+                       unsigned char *output, int *output_len)
+{
+	int nid = c->nid;
+
+	if (c->op_type == OP_ENCRYPT) {
+		if (nid == NID_id_aes128_wrap || nid == NID_id_aes192_wrap || nid == NID_id_aes256_wrap) {
+			if (input_len % 8 != 0 || input_len < (YACA_KEY_LENGTH_UNSAFE_128BIT / 8))
+				return YACA_ERROR_INVALID_PARAMETER;
+		} else if (nid == NID_id_smime_alg_CMS3DESwrap) {
+			if (input_len != (YACA_KEY_LENGTH_UNSAFE_128BIT / 8) &&
+			    input_len != (YACA_KEY_LENGTH_192BIT / 8))
+				return YACA_ERROR_INVALID_PARAMETER;
+		} else {
+			assert(false);
+			return YACA_ERROR_INTERNAL;
+		}
+	} else if (c->op_type == OP_DECRYPT) {
+		if (nid == NID_id_aes128_wrap || nid == NID_id_aes192_wrap || nid == NID_id_aes256_wrap) {
+			if (input_len % 8 != 0 || input_len < (YACA_KEY_LENGTH_UNSAFE_128BIT / 8 + 8))
+				return YACA_ERROR_INVALID_PARAMETER;
+		} else if (nid == NID_id_smime_alg_CMS3DESwrap) {
+			if (input_len != (YACA_KEY_LENGTH_UNSAFE_128BIT / 8 + 16) &&
+			    input_len != (YACA_KEY_LENGTH_192BIT / 8 + 16))
+				return YACA_ERROR_INVALID_PARAMETER;
+		} else {
+			assert(false);
+			return YACA_ERROR_INTERNAL;
+		}
+	} else {
+		assert(false);
+		return YACA_ERROR_INTERNAL;
 	}
 
-	if (mode == EVP_CIPH_WRAP_MODE)
-		EVP_CIPHER_CTX_set_flags(nc->cipher_ctx, EVP_CIPHER_CTX_FLAG_WRAP_ALLOW);
+	return update_plain(c, input, input_len, output, output_len);
+}
 
-	*c = nc;
-	nc = NULL;
+/* Input processed per EVP_CipherUpdate() call by update_in_place_block() */
+#define IN_PLACE_CHUNK 4096
+/* ECB and CBC keep up to one partial block and, when decrypting with
+ * padding, one full block inside the EVP context. Once released they are
+ * written before the new data, so the output runs ahead of the input.
+ */
+#define IN_PLACE_LEAD (2 * EVP_MAX_BLOCK_LENGTH)
+
+/* OpenSSL refuses output == input for ECB and CBC whenever it holds some
+ * data back, and even if it didn't the output would overwrite the input
+ * not read yet. Copy the input to a bounce buffer in chunks, saving ahead
+ * of time the part of the next chunk that the output may reach.
+ */
+static int update_in_place_block(struct yaca_encrypt_context_s *c,
+                                 const unsigned char *input, size_t input_len,
+                                 unsigned char *output, int *output_len)
+{
+	int ret;
+	unsigned char chunk[IN_PLACE_CHUNK];
+	unsigned char ahead[IN_PLACE_LEAD];
+	size_t in_pos = 0;
+	size_t saved = 0;
+	int out_pos = 0;
+	int written;
+
+	assert(input == output);
+
+	/* Nothing held back yet, whole blocks are then processed in place */
+	if (c->msg_len % c->block_size == 0 && (is_encryption_op(c->op_type) || c->msg_len == 0))
+		return update_plain(c, input, input_len, output, output_len);
+
+	while (in_pos < input_len) {
+		size_t len = input_len - in_pos;
+		size_t next;
+
+		if (len > IN_PLACE_CHUNK)
+			len = IN_PLACE_CHUNK;
+		next = input_len - in_pos - len;
+		if (next > IN_PLACE_LEAD)
+			next = IN_PLACE_LEAD;
+
+		memcpy(chunk + saved, input + in_pos + saved, len - saved);
+		memcpy(ahead, input + in_pos + len, next);
+
+		ret = update_plain(c, chunk, len, output + out_pos, &written);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		in_pos += len;
+		out_pos += written;
+		memcpy(chunk, ahead, next);
+		saved = next;
+	}
 
+	*output_len = out_pos;
 	ret = YACA_ERROR_NONE;
 
 exit:
-	yaca_free(nc);
+	/* short records only touched the beginning of the chunk */
+	OPENSSL_cleanse(chunk, input_len < IN_PLACE_CHUNK ? input_len : IN_PLACE_CHUNK);
+	OPENSSL_cleanse(ahead, sizeof(ahead));
 	return ret;
 }
 
-static int encrypt_ctx_init(struct yaca_encrypt_context_s *c,
-                            const EVP_CIPHER *cipher,
-                            size_t key_bit_len)
+/* OpenSSL computes the ICV of the 3DES key wrap from the input after having
+ * moved it within the output, so wrap a copy. The input is a 3DES key.
+ */
+static int update_in_place_des_wrap(struct yaca_encrypt_context_s *c,
+                                    const unsigned char *input, size_t input_len,
+                                    unsigned char *output, int *output_len)
 {
 	int ret;
+	unsigned char copy[YACA_KEY_LENGTH_192BIT / 8];
 
-	assert(c != NULL);
-	assert(cipher != NULL);
+	assert(input == output);
 
-	if (key_bit_len / 8 > INT_MAX)
+	if (input_len > sizeof(copy))
 		return YACA_ERROR_INVALID_PARAMETER;
 
-	ret = EVP_CipherInit_ex(c->cipher_ctx,
-	                        cipher,
-	                        NULL,
-	                        NULL,
-	                        NULL,
-	                        is_encryption_op(c->op_type) ? 1 : 0);
-	if (ret != 1) {
-		ret = YACA_ERROR_INTERNAL;
-		ERROR_DUMP(ret);
+	memcpy(copy, input, input_len);
+	ret = update_wrap(c, copy, input_len, output, output_len);
+	OPENSSL_cleanse(copy, sizeof(copy));
+
+	return ret;
+}
+
+static int finalize_plain(struct yaca_encrypt_context_s *c,
+                          unsigned char *output, int *output_len)
+{
+	int ret;
+
+	ret = EVP_CipherFinal(c->cipher_ctx, output, output_len);
+	if (ret != 1 || *output_len < 0) {
+		/* The same error code is used if trying to import a key with a
+		 * wrong password and in case of a decrypt error due to wrong
+		 * BCM or a key. Finalize cannot return INVALID_PASS so handle
+		 * this here.
+		 */
+		ret = ERROR_HANDLE();
+		if (ret == YACA_ERROR_INVALID_PASSWORD)
+			ret = YACA_ERROR_INVALID_PARAMETER;
 		return ret;
 	}
 
-	/* Handling of algorithms with variable key length */
-	ret = EVP_CIPHER_CTX_set_key_length(c->cipher_ctx, key_bit_len / 8);
-	if (ret != 1)
-		return ERROR_HANDLE();
+	return YACA_ERROR_NONE;
+}
+
+static int finalize_gcm_decrypt(struct yaca_encrypt_context_s *c,
+                                unsigned char *output, int *output_len)
+{
+	int ret;
+
+	ret = EVP_CipherFinal(c->cipher_ctx, output, output_len);
+	if (ret != 1 || *output_len < 0) {
+		/* A non positive return value from EVP_CipherFinal should be
+		 * considered as a failure to authenticate ciphertext and/or
+		 * AAD. It does not necessarily indicate a more serious error.
+		 */
+		stats_authentication_failure();
+		return YACA_ERROR_INVALID_PARAMETER;
+	}
 
 	return YACA_ERROR_NONE;
 }
 
-static int encrypt_ctx_setup_iv(struct yaca_encrypt_context_s *c,
-                                const EVP_CIPHER *cipher,
-                                const struct yaca_key_simple_s *iv)
+/* WRAP and CCM process everything in update */
+static int finalize_nothing(struct yaca_encrypt_context_s *c,
+                            unsigned char *output, int *output_len)
+{
+	(void)c;
+	(void)output;
+
+	*output_len = 0;
+	return YACA_ERROR_NONE;
+}
+
+/* Ciphertext processed per EVP_CipherUpdate() call by update_cbc_hmac(),
+ * small enough to be still in the L1 cache when it is MACed.
+ */
+#define CBC_HMAC_CHUNK 4096
+
+static int cbc_hmac_mac(struct yaca_encrypt_context_s *c,
+                        const unsigned char *data, size_t data_len)
 {
 	int ret;
-	size_t default_iv_bit_len;
 
-	assert(c != NULL);
-	assert(cipher != NULL);
+	if (data_len == 0)
+		return YACA_ERROR_NONE;
 
-	ret = EVP_CIPHER_iv_length(cipher);
-	if (ret < 0) {
+	ret = EVP_DigestSignUpdate(c->hmac->md_ctx, data, data_len);
+	if (ret != 1) {
 		ret = YACA_ERROR_INTERNAL;
 		ERROR_DUMP(ret);
 		return ret;
 	}
 
-	default_iv_bit_len = ret * 8;
+	return YACA_ERROR_NONE;
+}
 
-	/* 0 -> cipher doesn't use iv, but it was provided */
-	if (default_iv_bit_len == 0 && iv != NULL)
+/* Encrypt-then-MAC in a single pass: each chunk of the ciphertext is MACed
+ * right after it has been encrypted, or before it is decrypted, while it is
+ * still in the cache. With no output the input is the AAD.
+ */
+static int update_cbc_hmac(struct yaca_encrypt_context_s *c,
+                           const unsigned char *input, size_t input_len,
+                           unsigned char *output, int *output_len)
+{
+	int ret;
+	bool encryption = is_encryption_op(c->op_type);
+	size_t in_pos = 0;
+	int out_pos = 0;
+	int written;
+
+	if (c->hmac->md_ctx == NULL)
 		return YACA_ERROR_INVALID_PARAMETER;
 
-	if (default_iv_bit_len != 0) { /* cipher requires iv */
-		 /* iv was not provided */
-		if (iv == NULL || iv->key.type != YACA_KEY_TYPE_IV)
-			return YACA_ERROR_INVALID_PARAMETER;
+	if (output == NULL) {
+		*output_len = 0;
+		return cbc_hmac_mac(c, input, input_len);
+	}
 
-		if (iv->bit_len / 8 > INT_MAX)
-			return YACA_ERROR_INVALID_PARAMETER;
+	while (in_pos < input_len) {
+		size_t len = input_len - in_pos;
 
-		/* IV length doesn't match cipher (GCM & CCM supports variable IV length) */
-		if (default_iv_bit_len != iv->bit_len) {
-			size_t iv_len = iv->bit_len / 8;
-			int mode = EVP_CIPHER_CTX_mode(c->cipher_ctx);
+		if (len > CBC_HMAC_CHUNK)
+			len = CBC_HMAC_CHUNK;
 
-			if (mode == EVP_CIPH_GCM_MODE) {
-				ret = EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_GCM_SET_IVLEN,
-				                          iv_len, NULL);
-			} else if (mode == EVP_CIPH_CCM_MODE) {
-				/* OpenSSL does not return a specific error code when
-				 * wrong IVLEN is passed. It just returns 0. So there
-				 * is no way to distinguish this error from ENOMEM for
-				 * example. Handle this in our code then.
-				 */
-				if (iv_len < 7 || iv_len > 13)
-					return YACA_ERROR_INVALID_PARAMETER;
-				ret = EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_CCM_SET_IVLEN,
-				                          iv_len, NULL);
-			} else {
-				return YACA_ERROR_INVALID_PARAMETER;
-			}
+		if (!encryption) {
+			ret = cbc_hmac_mac(c, input + in_pos, len);
+			if (ret != YACA_ERROR_NONE)
+				return ret;
+		}
 
-			if (ret != 1)
-				return ERROR_HANDLE();
+		ret = update_plain(c, input + in_pos, len, output + out_pos, &written);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+
+		if (encryption) {
+			ret = cbc_hmac_mac(c, output + out_pos, written);
+			if (ret != YACA_ERROR_NONE)
+				return ret;
 		}
+
+		in_pos += len;
+		out_pos += written;
 	}
 
+	*output_len = out_pos;
 	return YACA_ERROR_NONE;
 }
 
-static int encrypt_ctx_setup(struct yaca_encrypt_context_s *c,
-                             const yaca_key_h key,
-                             const yaca_key_h iv)
+/* In place the output of a chunk may overwrite the input of the next one,
+ * see update_in_place_block(), so MAC the whole ciphertext in one go.
+ */
+static int update_in_place_cbc_hmac(struct yaca_encrypt_context_s *c,
+                                    const unsigned char *input, size_t input_len,
+                                    unsigned char *output, int *output_len)
 {
 	int ret;
-	unsigned char *iv_data = NULL;
-	const struct yaca_key_simple_s *lkey;
-	const struct yaca_key_simple_s *liv;
+	bool encryption = is_encryption_op(c->op_type);
 
-	assert(c != NULL);
-	assert(key != YACA_KEY_NULL);
+	if (c->hmac->md_ctx == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
 
-	const EVP_CIPHER *cipher = EVP_CIPHER_CTX_cipher(c->cipher_ctx);
-	assert(cipher != NULL);
+	if (!encryption) {
+		ret = cbc_hmac_mac(c, input, input_len);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+	}
 
-	lkey = key_get_simple(key);
-	assert(lkey != NULL);
+	ret = update_in_place_block(c, input, input_len, output, output_len);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
 
-	liv = key_get_simple(iv);
+	if (encryption)
+		return cbc_hmac_mac(c, output, *output_len);
 
-	ret = encrypt_ctx_setup_iv(c, cipher, liv);
+	return YACA_ERROR_NONE;
+}
+
+static int cbc_hmac_final(struct yaca_encrypt_context_s *c,
+                          unsigned char *tag, size_t *tag_len)
+{
+	int ret;
+	unsigned char al[8];
+	uint64_t aad_bits = c->hmac->aad_len * 8;
+
+	/* The AAD length in bits, big endian, the AL of RFC 7518 */
+	for (size_t i = 0; i < sizeof(al); ++i)
+		al[i] = (unsigned char)(aad_bits >> (56 - 8 * i));
+
+	ret = cbc_hmac_mac(c, al, sizeof(al));
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
-	if (liv != NULL)
-		iv_data = (unsigned char*)liv->d;
-
-	ret = EVP_CipherInit_ex(c->cipher_ctx,
-	                        NULL,
-	                        NULL,
-	                        (unsigned char*)lkey->d,
-	                        iv_data,
-	                        is_encryption_op(c->op_type) ? 1 : 0);
-	if (ret != 1) {
+	*tag_len = EVP_MAX_MD_SIZE;
+	ret = EVP_DigestSignFinal(c->hmac->md_ctx, tag, tag_len);
+	if (ret != 1 || *tag_len > EVP_MAX_MD_SIZE) {
 		ret = YACA_ERROR_INTERNAL;
 		ERROR_DUMP(ret);
 		return ret;
@@ -545,199 +861,944 @@ static int encrypt_ctx_setup(struct yaca_encrypt_context_s *c,
 	return YACA_ERROR_NONE;
 }
 
-static int key_copy_simple(const yaca_key_h key, yaca_key_h *out)
+static int finalize_cbc_hmac_encrypt(struct yaca_encrypt_context_s *c,
+                                     unsigned char *output, int *output_len)
 {
-	assert(key != YACA_KEY_NULL);
-	assert(out != NULL);
-
 	int ret;
-	struct yaca_key_simple_s *simple = key_get_simple(key);
-	assert(simple != NULL);
 
-	struct yaca_key_simple_s *copy;
-	size_t size = sizeof(struct yaca_key_simple_s) + simple->bit_len / 8;
+	if (c->hmac->md_ctx == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
 
-	ret = yaca_zalloc(size, (void**)&copy);
+	ret = finalize_plain(c, output, output_len);
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
-	memcpy(copy, key, size);
-	*out = (yaca_key_h)copy;
-	return YACA_ERROR_NONE;
+	ret = cbc_hmac_mac(c, output, *output_len);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	return cbc_hmac_final(c, c->hmac->tag, &c->hmac->tag_len);
 }
 
-static int encrypt_ctx_backup(struct yaca_encrypt_context_s *c,
-                              const EVP_CIPHER *cipher,
-                              const yaca_key_h sym_key,
-                              const yaca_key_h iv)
+/* The tag is compared before the padding is looked at */
+static int finalize_cbc_hmac_decrypt(struct yaca_encrypt_context_s *c,
+                                     unsigned char *output, int *output_len)
 {
 	int ret;
-	struct yaca_backup_context_s *bc;
+	unsigned char tag[EVP_MAX_MD_SIZE];
+	size_t tag_len;
 
-	assert(c != NULL);
-	assert(cipher != NULL);
-	assert(sym_key != YACA_KEY_NULL);
-	assert(c->backup_ctx == NULL);
+	if (c->hmac->md_ctx == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
 
-	ret = yaca_zalloc(sizeof(struct yaca_backup_context_s), (void**)&bc);
+	ret = cbc_hmac_final(c, tag, &tag_len);
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
-	ret = key_copy_simple(sym_key, &bc->sym_key);
-	if (ret != YACA_ERROR_NONE)
-		goto err;
-	if (iv != YACA_KEY_NULL) {
-		ret = key_copy_simple(iv, &bc->iv);
-		if (ret != YACA_ERROR_NONE)
-			goto err;
+	assert(c->hmac->tag_len <= tag_len);
+	if (CRYPTO_memcmp(tag, c->hmac->tag, c->hmac->tag_len) != 0) {
+		stats_authentication_failure();
+		return YACA_ERROR_INVALID_PARAMETER;
 	}
-	bc->cipher = cipher;
-	bc->padding = YACA_PADDING_PKCS7;
-
-	c->backup_ctx = bc;
-
-	return YACA_ERROR_NONE;
 
-err:
-	yaca_key_destroy(bc->iv);
-	yaca_key_destroy(bc->sym_key);
-	yaca_free(bc);
-	return ret;
+	return finalize_plain(c, output, output_len);
 }
 
-static int encrypt_ctx_restore(struct yaca_encrypt_context_s *c)
+/* Plaintext processed per update by update_plaintext_digest(), small enough
+ * to be still in the L1 cache when it is hashed.
+ */
+#define PLAINTEXT_DIGEST_CHUNK 4096
+
+static int plaintext_digest_update(struct yaca_encrypt_context_s *c,
+                                   const unsigned char *data, size_t data_len)
 {
 	int ret;
-	struct yaca_key_simple_s *key;
 
-	assert(c != NULL);
-	assert(c->backup_ctx != NULL);
+	if (data_len == 0)
+		return YACA_ERROR_NONE;
 
-	ret = EVP_CIPHER_CTX_cleanup(c->cipher_ctx);
+	ret = EVP_DigestUpdate(c->digest->md_ctx, data, data_len);
 	if (ret != 1) {
 		ret = YACA_ERROR_INTERNAL;
 		ERROR_DUMP(ret);
 		return ret;
 	}
 
-	key = key_get_simple(c->backup_ctx->sym_key);
-	assert(key != NULL);
+	return YACA_ERROR_NONE;
+}
 
-	ret = encrypt_ctx_init(c, c->backup_ctx->cipher, key->bit_len);
-	assert(ret != YACA_ERROR_INVALID_PARAMETER);
-	if (ret != YACA_ERROR_NONE)
-		return ret;
+/* Encrypt-and-hash in a single pass: each chunk of the plaintext is hashed
+ * right before it is encrypted, or right after it has been decrypted, while
+ * it is still in the cache.
+ */
+static int update_plaintext_digest(struct yaca_encrypt_context_s *c,
+                                   const unsigned char *input, size_t input_len,
+                                   unsigned char *output, int *output_len)
+{
+	int ret;
+	bool encryption = is_encryption_op(c->op_type);
+	size_t in_pos = 0;
+	int out_pos = 0;
+	int written;
+
+	/* In place the output of a chunk may overwrite the input of the next
+	 * one, see update_in_place_block(), and CCM, wrapping and SIV take the
+	 * whole message in a single update. Hash the whole plaintext in one go.
+	 */
+	if (output == input || !c->states[ENC_CTX_MSG_UPDATED][ENC_CTX_MSG_UPDATED]) {
+		if (encryption) {
+			ret = plaintext_digest_update(c, input, input_len);
+			if (ret != YACA_ERROR_NONE)
+				return ret;
+		}
 
-	if (c->backup_ctx->padding == YACA_PADDING_NONE &&
-	    EVP_CIPHER_CTX_set_padding(c->cipher_ctx, 0) != 1) {
-		ret = YACA_ERROR_INTERNAL;
-		ERROR_DUMP(ret);
-		return ret;
+		if (output == input)
+			ret = c->update_in_place(c, input, input_len, output, output_len);
+		else
+			ret = c->update(c, input, input_len, output, output_len);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+
+		if (!encryption)
+			return plaintext_digest_update(c, output, *output_len);
+
+		return YACA_ERROR_NONE;
 	}
 
-	return ret;
+	while (in_pos < input_len) {
+		size_t len = input_len - in_pos;
+
+		if (len > PLAINTEXT_DIGEST_CHUNK)
+			len = PLAINTEXT_DIGEST_CHUNK;
+
+		if (encryption) {
+			ret = plaintext_digest_update(c, input + in_pos, len);
+			if (ret != YACA_ERROR_NONE)
+				return ret;
+		}
+
+		ret = c->update(c, input + in_pos, len, output + out_pos, &written);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+
+		if (!encryption) {
+			ret = plaintext_digest_update(c, output + out_pos, written);
+			if (ret != YACA_ERROR_NONE)
+				return ret;
+		}
+
+		in_pos += len;
+		out_pos += written;
+	}
+
+	*output_len = out_pos;
+	return YACA_ERROR_NONE;
 }
 
-static int encrypt_ctx_set_ccm_tag_len(struct yaca_encrypt_context_s *c, size_t tag_len)
+static int finalize_plaintext_digest(struct yaca_encrypt_context_s *c,
+                                     const unsigned char *output, int output_len)
 {
 	int ret;
+	unsigned int len;
 
-	assert(c != NULL);
-	assert(c->backup_ctx != NULL);
-	assert(is_encryption_op(c->op_type));
+	/* the last block of the decrypted plaintext */
+	if (!is_encryption_op(c->op_type)) {
+		ret = plaintext_digest_update(c, output, output_len);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+	}
 
-	ret = encrypt_ctx_restore(c);
-	if (ret != YACA_ERROR_NONE)
+	ret = EVP_DigestFinal_ex(c->digest->md_ctx, c->digest->value, &len);
+	if (ret != 1 || len == 0) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
 		return ret;
+	}
 
-	c->tag_len = tag_len;
-	ret = EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_CCM_SET_TAG, tag_len, NULL);
-	if (ret != 1) {
+	c->digest->len = len;
+	return YACA_ERROR_NONE;
+}
+
+/* CMAC of the concatenation of the two buffers, the key stays */
+static int siv_cmac(struct yaca_siv_s *siv,
+                    const unsigned char *data, size_t data_len,
+                    const unsigned char *last, size_t last_len,
+                    unsigned char *mac)
+{
+	int ret;
+	size_t mac_len;
+
+	if (CMAC_Init(siv->cmac, NULL, 0, NULL, NULL) != 1 ||
+	    (data_len > 0 && CMAC_Update(siv->cmac, data, data_len) != 1) ||
+	    (last_len > 0 && CMAC_Update(siv->cmac, last, last_len) != 1) ||
+	    CMAC_Final(siv->cmac, mac, &mac_len) != 1 || mac_len != SIV_BLOCK) {
 		ret = YACA_ERROR_INTERNAL;
 		ERROR_DUMP(ret);
 		return ret;
 	}
 
-	ret = encrypt_ctx_setup(c, c->backup_ctx->sym_key, c->backup_ctx->iv);
-	assert(ret != YACA_ERROR_INVALID_PARAMETER);
-	return ret;
+	return YACA_ERROR_NONE;
 }
 
-static int encrypt_ctx_set_ccm_tag(struct yaca_encrypt_context_s *c, char *tag, size_t tag_len)
+/* Multiplication by x in GF(2^128), RFC 5297 */
+static void siv_dbl(unsigned char *block)
 {
-	int ret;
+	unsigned char carry = block[0] >> 7;
 
-	assert(c != NULL);
-	assert(c->backup_ctx != NULL);
-	assert(!is_encryption_op(c->op_type));
-	assert(tag != NULL);
+	for (int i = 0; i < SIV_BLOCK - 1; ++i)
+		block[i] = (block[i] << 1) | (block[i + 1] >> 7);
+	block[SIV_BLOCK - 1] = (block[SIV_BLOCK - 1] << 1) ^ (carry * 0x87);
+}
 
-	ret = encrypt_ctx_restore(c);
+/* Every AAD is a separate string of the S2V */
+static int siv_aad(struct yaca_siv_s *siv, const unsigned char *aad, size_t aad_len)
+{
+	int ret;
+	unsigned char mac[SIV_BLOCK];
+
+	ret = siv_cmac(siv, aad, aad_len, NULL, 0, mac);
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
-	ret = EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_CCM_SET_TAG, tag_len, tag);
+	siv_dbl(siv->d);
+	for (int i = 0; i < SIV_BLOCK; ++i)
+		siv->d[i] ^= mac[i];
+
+	return YACA_ERROR_NONE;
+}
+
+/* The last string of the S2V is the plaintext, it gives the synthetic IV */
+static int siv_s2v(struct yaca_siv_s *siv, const unsigned char *plaintext, size_t plaintext_len,
+                   unsigned char *v)
+{
+	unsigned char t[SIV_BLOCK];
+
+	if (plaintext_len >= SIV_BLOCK) {
+		/* xorend, the accumulator goes into the last block */
+		size_t head = plaintext_len - SIV_BLOCK;
+
+		for (int i = 0; i < SIV_BLOCK; ++i)
+			t[i] = plaintext[head + i] ^ siv->d[i];
+
+		return siv_cmac(siv, plaintext, head, t, SIV_BLOCK, v);
+	}
+
+	memcpy(t, siv->d, SIV_BLOCK);
+	siv_dbl(t);
+	for (size_t i = 0; i < plaintext_len; ++i)
+		t[i] ^= plaintext[i];
+	t[plaintext_len] ^= 0x80;
+
+	return siv_cmac(siv, NULL, 0, t, SIV_BLOCK, v);
+}
+
+/* The CTR counter is the synthetic IV with two bits cleared */
+static int siv_ctr(struct yaca_encrypt_context_s *c,
+                   const unsigned char *input, size_t input_len,
+                   unsigned char *output, int *output_len)
+{
+	int ret;
+	unsigned char q[SIV_BLOCK];
+
+	memcpy(q, c->siv->v, SIV_BLOCK);
+	q[8] &= 0x7f;
+	q[12] &= 0x7f;
+
+	ret = EVP_CipherInit_ex(c->cipher_ctx, NULL, NULL, NULL, q, -1);
 	if (ret != 1) {
 		ret = YACA_ERROR_INTERNAL;
 		ERROR_DUMP(ret);
 		return ret;
 	}
 
-	ret = encrypt_ctx_setup(c, c->backup_ctx->sym_key, c->backup_ctx->iv);
-	assert(ret != YACA_ERROR_INVALID_PARAMETER);
-	return ret;
+	return update_plain(c, input, input_len, output, output_len);
 }
 
-static int encrypt_ctx_set_rc2_effective_key_bits(struct yaca_encrypt_context_s *c, size_t key_bits)
+/* The whole message at once, the S2V of the plaintext is the IV of the
+ * CTR. With no output the input is an AAD.
+ */
+static int update_siv(struct yaca_encrypt_context_s *c,
+                      const unsigned char *input, size_t input_len,
+                      unsigned char *output, int *output_len)
 {
 	int ret;
+	unsigned char v[SIV_BLOCK];
 
-	assert(c != NULL);
-	assert(c->backup_ctx != NULL);
+	if (output == NULL) {
+		*output_len = 0;
+		return siv_aad(c->siv, input, input_len);
+	}
 
-	if (key_bits == 0 || key_bits > 1024)
-		return YACA_ERROR_INVALID_PARAMETER;
+	if (is_encryption_op(c->op_type)) {
+		ret = siv_s2v(c->siv, input, input_len, c->siv->v);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
 
-	ret = encrypt_ctx_restore(c);
+		return siv_ctr(c, input, input_len, output, output_len);
+	}
+
+	ret = siv_ctr(c, input, input_len, output, output_len);
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
-	ret = EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_SET_RC2_KEY_BITS, key_bits, NULL);
-	if (ret != 1) {
-		ret = YACA_ERROR_INTERNAL;
-		ERROR_DUMP(ret);
+	ret = siv_s2v(c->siv, output, *output_len, v);
+	if (ret != YACA_ERROR_NONE)
 		return ret;
+
+	/* As with CCM, nothing of a forged message is released */
+	if (CRYPTO_memcmp(v, c->siv->v, SIV_BLOCK) != 0) {
+		OPENSSL_cleanse(output, *output_len);
+		stats_authentication_failure();
+		return YACA_ERROR_INVALID_PARAMETER;
 	}
 
-	ret = encrypt_ctx_setup(c, c->backup_ctx->sym_key, c->backup_ctx->iv);
-	assert(ret != YACA_ERROR_INVALID_PARAMETER);
-	return ret;
+	return YACA_ERROR_NONE;
 }
 
-static int set_encrypt_property(yaca_context_h ctx,
-                                yaca_property_e property,
-                                const void *value,
-                                size_t value_len)
+/* Only an empty message is left for the finalization */
+static int finalize_siv(struct yaca_encrypt_context_s *c,
+                        unsigned char *output, int *output_len)
 {
-	int len;
-	int ret = YACA_ERROR_NONE;
-	struct yaca_encrypt_context_s *c = get_encrypt_context(ctx);
-	assert(c != NULL);
-	assert(c->cipher_ctx != NULL);
+	int ret;
+	unsigned char v[SIV_BLOCK];
 
-	if (value == NULL || value_len == 0)
-		return YACA_ERROR_INVALID_PARAMETER;
+	(void)output;
+	*output_len = 0;
 
-	int mode = EVP_CIPHER_CTX_mode(c->cipher_ctx);
-	int nid = EVP_CIPHER_CTX_nid(c->cipher_ctx);
+	if (c->msg_len > 0)
+		return YACA_ERROR_NONE;
 
-	switch (property) {
-	case YACA_PROPERTY_GCM_AAD:
-		if (mode != EVP_CIPH_GCM_MODE ||
-		    !verify_state_change(c, ENC_CTX_AAD_UPDATED))
-			return YACA_ERROR_INVALID_PARAMETER;
+	ret = siv_s2v(c->siv, NULL, 0, v);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
 
-		if (EVP_CipherUpdate(c->cipher_ctx, NULL, &len, value, value_len) != 1) {
+	if (is_encryption_op(c->op_type)) {
+		memcpy(c->siv->v, v, SIV_BLOCK);
+	} else if (CRYPTO_memcmp(v, c->siv->v, SIV_BLOCK) != 0) {
+		stats_authentication_failure();
+		return YACA_ERROR_INVALID_PARAMETER;
+	}
+
+	return YACA_ERROR_NONE;
+}
+
+static int encrypt_ctx_create(struct yaca_encrypt_context_s **c,
+                              enum encrypt_op_type_e op_type,
+                              const EVP_CIPHER *cipher)
+{
+	int ret;
+	int mode;
+	struct yaca_encrypt_context_s *nc;
+
+	assert(c != NULL);
+	assert(cipher != NULL);
+
+	ret = yaca_zalloc(sizeof(struct yaca_encrypt_context_s), (void**)&nc);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	mode = EVP_CIPHER_flags(cipher) & EVP_CIPH_MODE;
+	bool encryption = is_encryption_op(op_type);
+
+	nc->mode = mode;
+	nc->nid = EVP_CIPHER_nid(cipher);
+	nc->block_size = EVP_CIPHER_block_size(cipher);
+	if (nc->block_size <= 0) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	nc->states = get_states(mode, op_type);
+
+	if (mode == EVP_CIPH_WRAP_MODE)
+		nc->update = update_wrap;
+	else if (mode == EVP_CIPH_CCM_MODE && !encryption)
+		nc->update = update_ccm_decrypt;
+	else
+		nc->update = update_plain;
+
+	/* The remaining modes either hold nothing back or, like AES WRAP and
+	 * CCM, process everything at once and handle output == input themselves.
+	 */
+	if (mode == EVP_CIPH_ECB_MODE || mode == EVP_CIPH_CBC_MODE)
+		nc->update_in_place = update_in_place_block;
+	else if (nc->nid == NID_id_smime_alg_CMS3DESwrap && encryption)
+		nc->update_in_place = update_in_place_des_wrap;
+	else
+		nc->update_in_place = nc->update;
+
+	if (mode == EVP_CIPH_WRAP_MODE || mode == EVP_CIPH_CCM_MODE)
+		nc->finalize = finalize_nothing;
+	else if (mode == EVP_CIPH_GCM_MODE && !encryption)
+		nc->finalize = finalize_gcm_decrypt;
+	else
+		nc->finalize = finalize_plain;
+
+	nc->ctx.type = YACA_CONTEXT_ENCRYPT;
+	nc->backup_ctx = NULL;
+	nc->ctx.context_destroy = destroy_encrypt_context;
+	nc->ctx.get_output_length = (mode == EVP_CIPH_WRAP_MODE) ?
+	                            get_wrap_output_length :
+	                            get_encrypt_output_length;
+	nc->ctx.set_property = set_encrypt_property;
+	nc->ctx.get_property = get_encrypt_property;
+	nc->op_type = op_type;
+	nc->tag_len = 0;
+
+	/* set default tag length for GCM and CCM */
+	if (mode == EVP_CIPH_GCM_MODE)
+		nc->tag_len = DEFAULT_GCM_TAG_LEN;
+	else if (mode == EVP_CIPH_CCM_MODE)
+		nc->tag_len = DEFAULT_CCM_TAG_LEN;
+
+	nc->cipher_ctx = EVP_CIPHER_CTX_new();
+	if (nc->cipher_ctx == NULL) {
+		ret =  YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	if (mode == EVP_CIPH_WRAP_MODE)
+		EVP_CIPHER_CTX_set_flags(nc->cipher_ctx, EVP_CIPHER_CTX_FLAG_WRAP_ALLOW);
+
+	*c = nc;
+	nc = NULL;
+
+	ret = YACA_ERROR_NONE;
+
+exit:
+	yaca_free(nc);
+	return ret;
+}
+
+static int encrypt_ctx_init(struct yaca_encrypt_context_s *c,
+                            const EVP_CIPHER *cipher,
+                            size_t key_bit_len)
+{
+	int ret;
+
+	assert(c != NULL);
+	assert(cipher != NULL);
+
+	if (key_bit_len / 8 > INT_MAX)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = EVP_CipherInit_ex(c->cipher_ctx,
+	                        cipher,
+	                        NULL,
+	                        NULL,
+	                        NULL,
+	                        is_encryption_op(c->op_type) ? 1 : 0);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	/* Handling of algorithms with variable key length */
+	ret = EVP_CIPHER_CTX_set_key_length(c->cipher_ctx, key_bit_len / 8);
+	if (ret != 1)
+		return ERROR_HANDLE();
+
+	return YACA_ERROR_NONE;
+}
+
+static int encrypt_ctx_setup_iv(struct yaca_encrypt_context_s *c,
+                                const EVP_CIPHER *cipher,
+                                const struct yaca_key_simple_s *iv)
+{
+	int ret;
+	size_t default_iv_bit_len;
+
+	assert(c != NULL);
+	assert(cipher != NULL);
+
+	ret = EVP_CIPHER_iv_length(cipher);
+	if (ret < 0) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	default_iv_bit_len = ret * 8;
+
+	/* 0 -> cipher doesn't use iv, but it was provided */
+	if (default_iv_bit_len == 0 && iv != NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	if (default_iv_bit_len != 0) { /* cipher requires iv */
+		 /* iv was not provided */
+		if (iv == NULL || iv->key.type != YACA_KEY_TYPE_IV)
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		if (iv->bit_len / 8 > INT_MAX)
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		/* IV length doesn't match cipher (GCM & CCM supports variable IV length) */
+		if (default_iv_bit_len != iv->bit_len) {
+			size_t iv_len = iv->bit_len / 8;
+			int mode = c->mode;
+
+			if (mode == EVP_CIPH_GCM_MODE) {
+				ret = EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_GCM_SET_IVLEN,
+				                          iv_len, NULL);
+			} else if (mode == EVP_CIPH_CCM_MODE) {
+				/* OpenSSL does not return a specific error code when
+				 * wrong IVLEN is passed. It just returns 0. So there
+				 * is no way to distinguish this error from ENOMEM for
+				 * example. Handle this in our code then.
+				 */
+				if (iv_len < 7 || iv_len > 13)
+					return YACA_ERROR_INVALID_PARAMETER;
+				ret = EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_CCM_SET_IVLEN,
+				                          iv_len, NULL);
+			} else {
+				return YACA_ERROR_INVALID_PARAMETER;
+			}
+
+			if (ret != 1)
+				return ERROR_HANDLE();
+		}
+	}
+
+	return YACA_ERROR_NONE;
+}
+
+static int encrypt_ctx_setup(struct yaca_encrypt_context_s *c,
+                             const yaca_key_h key,
+                             const yaca_key_h iv)
+{
+	int ret;
+	unsigned char *iv_data = NULL;
+	const struct yaca_key_simple_s *lkey;
+	const struct yaca_key_simple_s *liv;
+
+	assert(c != NULL);
+	assert(key != YACA_KEY_NULL);
+
+	const EVP_CIPHER *cipher = EVP_CIPHER_CTX_cipher(c->cipher_ctx);
+	assert(cipher != NULL);
+
+	lkey = key_get_simple(key);
+	assert(lkey != NULL);
+
+	liv = key_get_simple(iv);
+
+	ret = encrypt_ctx_setup_iv(c, cipher, liv);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	if (liv != NULL)
+		iv_data = (unsigned char*)liv->d;
+
+	ret = EVP_CipherInit_ex(c->cipher_ctx,
+	                        NULL,
+	                        NULL,
+	                        (unsigned char*)lkey->d,
+	                        iv_data,
+	                        is_encryption_op(c->op_type) ? 1 : 0);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	return YACA_ERROR_NONE;
+}
+
+/* The CBC-HMAC modes use plain CBC ciphers, the HMAC is added here */
+static int encrypt_ctx_setup_cbc_hmac(struct yaca_encrypt_context_s *c,
+                                      yaca_block_cipher_mode_e bcm,
+                                      const yaca_key_h iv)
+{
+	int ret;
+	bool encryption = is_encryption_op(c->op_type);
+	struct yaca_key_simple_s *liv = key_get_simple(iv);
+
+	assert(c != NULL);
+	assert(c->hmac == NULL);
+	assert(c->mode == EVP_CIPH_CBC_MODE);
+	/* checked by encrypt_ctx_setup() */
+	assert(liv != NULL && liv->bit_len / 8 <= EVP_MAX_IV_LENGTH);
+
+	ret = yaca_zalloc(sizeof(struct yaca_cbc_hmac_s), (void**)&c->hmac);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	/* kept until the HMAC key is set */
+	memcpy(c->hmac->iv, liv->d, liv->bit_len / 8);
+	c->hmac->iv_len = liv->bit_len / 8;
+
+	ret = digest_get_algorithm(bcm == YACA_BCM_CBC_HMAC_SHA1 ? YACA_DIGEST_SHA1 :
+	                                                           YACA_DIGEST_SHA256,
+	                           &c->hmac->md);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	c->states = CBC_HMAC_STATES[encryption ? 0 : 1];
+	c->update = update_cbc_hmac;
+	c->update_in_place = update_in_place_cbc_hmac;
+	c->finalize = encryption ? finalize_cbc_hmac_encrypt : finalize_cbc_hmac_decrypt;
+
+	return YACA_ERROR_NONE;
+}
+
+static int encrypt_ctx_set_cbc_hmac_key(struct yaca_encrypt_context_s *c,
+                                        const void *key, size_t key_len)
+{
+	int ret;
+	EVP_PKEY *pkey;
+	EVP_MD_CTX *md_ctx = NULL;
+
+	assert(c != NULL);
+	assert(c->hmac != NULL);
+
+	if (key_len > INT_MAX)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	pkey = EVP_PKEY_new_mac_key(EVP_PKEY_HMAC, NULL, key, key_len);
+	if (pkey == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	md_ctx = EVP_MD_CTX_create();
+	if (md_ctx == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	ret = EVP_DigestSignInit(md_ctx, NULL, c->hmac->md, NULL, pkey);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	/* The IV first, a modified one changes the first plaintext block */
+	ret = EVP_DigestSignUpdate(md_ctx, c->hmac->iv, c->hmac->iv_len);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	/* a key set again replaces the previous one */
+	EVP_MD_CTX_destroy(c->hmac->md_ctx);
+	c->hmac->md_ctx = md_ctx;
+	md_ctx = NULL;
+	ret = YACA_ERROR_NONE;
+
+exit:
+	EVP_MD_CTX_destroy(md_ctx);
+	EVP_PKEY_free(pkey);
+	return ret;
+}
+
+static int encrypt_ctx_set_plaintext_digest(struct yaca_encrypt_context_s *c,
+                                            yaca_digest_algorithm_e algo)
+{
+	int ret;
+	const EVP_MD *md;
+	struct yaca_plaintext_digest_s *digest = NULL;
+
+	assert(c != NULL);
+	assert(c->digest == NULL);
+
+	ret = digest_get_algorithm(algo, &md);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = yaca_zalloc(sizeof(struct yaca_plaintext_digest_s), (void**)&digest);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	digest->md_ctx = EVP_MD_CTX_create();
+	if (digest->md_ctx == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	ret = EVP_DigestInit(digest->md_ctx, md);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	c->digest = digest;
+	digest = NULL;
+	ret = YACA_ERROR_NONE;
+
+exit:
+	if (digest != NULL) {
+		EVP_MD_CTX_destroy(digest->md_ctx);
+		yaca_free(digest);
+	}
+	return ret;
+}
+
+/* SIV takes the double length AES key of RFC 5297, the first half for the
+ * S2V and the second one for the CTR. The cipher was chosen for the half.
+ */
+static int encrypt_ctx_setup_siv(struct yaca_encrypt_context_s *c,
+                                 const struct yaca_key_simple_s *key,
+                                 const yaca_key_h iv)
+{
+	int ret;
+	const EVP_CIPHER *mac_cipher;
+	size_t half = key->bit_len / 16;
+	static const unsigned char ZERO[SIV_BLOCK];
+	bool encryption = is_encryption_op(c->op_type);
+
+	assert(c != NULL);
+	assert(c->siv == NULL);
+	assert(c->mode == EVP_CIPH_CTR_MODE);
+
+	/* the IV is synthetic */
+	if (iv != YACA_KEY_NULL || key->key.type != YACA_KEY_TYPE_SYMMETRIC)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = encrypt_get_algorithm(YACA_ENCRYPT_AES, YACA_BCM_CBC, key->bit_len / 2, &mac_cipher);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = yaca_zalloc(sizeof(struct yaca_siv_s), (void**)&c->siv);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	c->siv->cmac = CMAC_CTX_new();
+	if (c->siv->cmac == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	if (CMAC_Init(c->siv->cmac, key->d, half, mac_cipher, NULL) != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	ret = EVP_CipherInit_ex(c->cipher_ctx, NULL, NULL,
+	                        (const unsigned char *)key->d + half, NULL, -1);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	ret = siv_cmac(c->siv, NULL, 0, ZERO, sizeof(ZERO), c->siv->d0);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+	memcpy(c->siv->d, c->siv->d0, SIV_BLOCK);
+
+	c->tag_len = SIV_BLOCK;
+	c->states = SIV_STATES[encryption ? 0 : 1];
+	c->update = update_siv;
+	c->update_in_place = update_siv;
+	c->finalize = finalize_siv;
+
+	return YACA_ERROR_NONE;
+}
+
+static int key_copy_simple(const yaca_key_h key, yaca_key_h *out)
+{
+	assert(key != YACA_KEY_NULL);
+	assert(out != NULL);
+
+	int ret;
+	struct yaca_key_simple_s *simple = key_get_simple(key);
+	assert(simple != NULL);
+
+	struct yaca_key_simple_s *copy;
+	size_t size = sizeof(struct yaca_key_simple_s) + simple->bit_len / 8;
+
+	ret = yaca_zalloc(size, (void**)&copy);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	memcpy(copy, key, size);
+	*out = (yaca_key_h)copy;
+	return YACA_ERROR_NONE;
+}
+
+static int encrypt_ctx_backup(struct yaca_encrypt_context_s *c,
+                              const EVP_CIPHER *cipher,
+                              const yaca_key_h sym_key,
+                              const yaca_key_h iv)
+{
+	int ret;
+	struct yaca_backup_context_s *bc;
+
+	assert(c != NULL);
+	assert(cipher != NULL);
+	assert(sym_key != YACA_KEY_NULL);
+	assert(c->backup_ctx == NULL);
+
+	ret = yaca_zalloc(sizeof(struct yaca_backup_context_s), (void**)&bc);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = key_copy_simple(sym_key, &bc->sym_key);
+	if (ret != YACA_ERROR_NONE)
+		goto err;
+	if (iv != YACA_KEY_NULL) {
+		ret = key_copy_simple(iv, &bc->iv);
+		if (ret != YACA_ERROR_NONE)
+			goto err;
+	}
+	bc->cipher = cipher;
+	bc->padding = YACA_PADDING_PKCS7;
+
+	c->backup_ctx = bc;
+
+	return YACA_ERROR_NONE;
+
+err:
+	yaca_key_destroy(bc->iv);
+	yaca_key_destroy(bc->sym_key);
+	yaca_free(bc);
+	return ret;
+}
+
+static int encrypt_ctx_restore(struct yaca_encrypt_context_s *c)
+{
+	int ret;
+	struct yaca_key_simple_s *key;
+
+	assert(c != NULL);
+	assert(c->backup_ctx != NULL);
+
+	ret = EVP_CIPHER_CTX_cleanup(c->cipher_ctx);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	key = key_get_simple(c->backup_ctx->sym_key);
+	assert(key != NULL);
+
+	ret = encrypt_ctx_init(c, c->backup_ctx->cipher, key->bit_len);
+	assert(ret != YACA_ERROR_INVALID_PARAMETER);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	if (c->backup_ctx->padding == YACA_PADDING_NONE &&
+	    EVP_CIPHER_CTX_set_padding(c->cipher_ctx, 0) != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	return ret;
+}
+
+static int encrypt_ctx_set_ccm_tag_len(struct yaca_encrypt_context_s *c, size_t tag_len)
+{
+	int ret;
+
+	assert(c != NULL);
+	assert(c->backup_ctx != NULL);
+	assert(is_encryption_op(c->op_type));
+
+	ret = encrypt_ctx_restore(c);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	c->tag_len = tag_len;
+	ret = EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_CCM_SET_TAG, tag_len, NULL);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	ret = encrypt_ctx_setup(c, c->backup_ctx->sym_key, c->backup_ctx->iv);
+	assert(ret != YACA_ERROR_INVALID_PARAMETER);
+	return ret;
+}
+
+static int encrypt_ctx_set_ccm_tag(struct yaca_encrypt_context_s *c, char *tag, size_t tag_len)
+{
+	int ret;
+
+	assert(c != NULL);
+	assert(c->backup_ctx != NULL);
+	assert(!is_encryption_op(c->op_type));
+	assert(tag != NULL);
+
+	ret = encrypt_ctx_restore(c);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_CCM_SET_TAG, tag_len, tag);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	ret = encrypt_ctx_setup(c, c->backup_ctx->sym_key, c->backup_ctx->iv);
+	assert(ret != YACA_ERROR_INVALID_PARAMETER);
+	return ret;
+}
+
+static int encrypt_ctx_set_rc2_effective_key_bits(struct yaca_encrypt_context_s *c, size_t key_bits)
+{
+	int ret;
+
+	assert(c != NULL);
+	assert(c->backup_ctx != NULL);
+
+	if (key_bits == 0 || key_bits > 1024)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = encrypt_ctx_restore(c);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_SET_RC2_KEY_BITS, key_bits, NULL);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	ret = encrypt_ctx_setup(c, c->backup_ctx->sym_key, c->backup_ctx->iv);
+	assert(ret != YACA_ERROR_INVALID_PARAMETER);
+	return ret;
+}
+
+static int set_encrypt_property(yaca_context_h ctx,
+                                yaca_property_e property,
+                                const void *value,
+                                size_t value_len)
+{
+	int len;
+	int ret = YACA_ERROR_NONE;
+	struct yaca_encrypt_context_s *c = get_encrypt_context(ctx);
+	assert(c != NULL);
+	assert(c->cipher_ctx != NULL);
+
+	if (value == NULL || value_len == 0)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	int mode = c->mode;
+	int nid = c->nid;
+
+	switch (property) {
+	case YACA_PROPERTY_GCM_AAD:
+		if (mode != EVP_CIPH_GCM_MODE ||
+		    !verify_state_change(c, ENC_CTX_AAD_UPDATED))
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		if (EVP_CipherUpdate(c->cipher_ctx, NULL, &len, value, value_len) != 1) {
 			ret = YACA_ERROR_INTERNAL;
 			ERROR_DUMP(ret);
 			return ret;
@@ -749,443 +1810,1149 @@ static int set_encrypt_property(yaca_context_h ctx,
 		    !verify_state_change(c, ENC_CTX_AAD_UPDATED))
 			return YACA_ERROR_INVALID_PARAMETER;
 
-		if (EVP_CipherUpdate(c->cipher_ctx, NULL, &len, value, value_len) != 1) {
-			ret = YACA_ERROR_INTERNAL;
-			ERROR_DUMP(ret);
-			return ret;
+		if (EVP_CipherUpdate(c->cipher_ctx, NULL, &len, value, value_len) != 1) {
+			ret = YACA_ERROR_INTERNAL;
+			ERROR_DUMP(ret);
+			return ret;
+		}
+		c->state = ENC_CTX_AAD_UPDATED;
+		break;
+	case YACA_PROPERTY_GCM_TAG:
+		if (mode != EVP_CIPH_GCM_MODE || is_encryption_op(c->op_type) ||
+		    !is_valid_tag_len(mode, value_len) ||
+		    !verify_state_change(c, ENC_CTX_TAG_SET))
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		if (EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_GCM_SET_TAG, value_len, (void*)value) != 1) {
+			ret = YACA_ERROR_INTERNAL;
+			ERROR_DUMP(ret);
+			return ret;
+		}
+		c->state = ENC_CTX_TAG_SET;
+		break;
+	case YACA_PROPERTY_GCM_TAG_LEN:
+		if (value_len != sizeof(size_t) || mode != EVP_CIPH_GCM_MODE ||
+		    !is_encryption_op(c->op_type) ||
+		    !is_valid_tag_len(mode, *(size_t*)value) ||
+		    !verify_state_change(c, ENC_CTX_TAG_LENGTH_SET))
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		c->tag_len = *(size_t*)value;
+		c->state = ENC_CTX_TAG_LENGTH_SET;
+		break;
+	case YACA_PROPERTY_CCM_TAG:
+		if (mode != EVP_CIPH_CCM_MODE || is_encryption_op(c->op_type) ||
+		    !is_valid_tag_len(mode, value_len) ||
+		    !verify_state_change(c, ENC_CTX_TAG_SET))
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		ret = encrypt_ctx_set_ccm_tag(c, (char*)value, value_len);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+
+		c->state = ENC_CTX_TAG_SET;
+		break;
+	case YACA_PROPERTY_CCM_TAG_LEN:
+		if (value_len != sizeof(size_t) || mode != EVP_CIPH_CCM_MODE ||
+		    !is_encryption_op(c->op_type) ||
+		    !is_valid_tag_len(mode, *(size_t*)value) ||
+		    !verify_state_change(c, ENC_CTX_TAG_LENGTH_SET))
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		ret = encrypt_ctx_set_ccm_tag_len(c, *(size_t*)value);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+
+		c->state = ENC_CTX_TAG_LENGTH_SET;
+		break;
+	case YACA_PROPERTY_PADDING:
+		if ((mode != EVP_CIPH_ECB_MODE && mode != EVP_CIPH_CBC_MODE) ||
+		    value_len != sizeof(yaca_padding_e) ||
+		    (*(yaca_padding_e*)value != YACA_PADDING_NONE &&
+		    *(yaca_padding_e*)value != YACA_PADDING_PKCS7) ||
+		    ((is_encryption_op(c->op_type)) && c->state == ENC_CTX_FINALIZED) ||
+		    (!(is_encryption_op(c->op_type)) && c->state != ENC_CTX_INITIALIZED &&
+		     c->state != ENC_CTX_AAD_UPDATED))
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		int padding = *(yaca_padding_e*)value == YACA_PADDING_NONE ? 0 : 1;
+		if (EVP_CIPHER_CTX_set_padding(c->cipher_ctx, padding) != 1) {
+			ret = YACA_ERROR_INTERNAL;
+			ERROR_DUMP(ret);
+			return ret;
+		}
+		if (c->backup_ctx != NULL)
+			c->backup_ctx->padding = padding;
+		break;
+	case YACA_PROPERTY_CBC_HMAC_KEY:
+		if (c->hmac == NULL || c->state != ENC_CTX_INITIALIZED)
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		ret = encrypt_ctx_set_cbc_hmac_key(c, value, value_len);
+		break;
+	case YACA_PROPERTY_CBC_HMAC_AAD:
+		if (c->hmac == NULL || c->hmac->md_ctx == NULL ||
+		    !verify_state_change(c, ENC_CTX_AAD_UPDATED))
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		ret = cbc_hmac_mac(c, value, value_len);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+
+		c->hmac->aad_len += value_len;
+		c->state = ENC_CTX_AAD_UPDATED;
+		break;
+	case YACA_PROPERTY_CBC_HMAC_TAG: {
+		size_t md_len;
+
+		if (c->hmac == NULL || is_encryption_op(c->op_type) ||
+		    !verify_state_change(c, ENC_CTX_TAG_SET))
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		/* Truncated to no less than half of the digest, RFC 2104 */
+		md_len = EVP_MD_size(c->hmac->md);
+		if (value_len < md_len / 2 || value_len > md_len)
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		memcpy(c->hmac->tag, value, value_len);
+		c->hmac->tag_len = value_len;
+		c->state = ENC_CTX_TAG_SET;
+		break;
+	}
+	case YACA_PROPERTY_SIV_AAD:
+		if (c->siv == NULL || !verify_state_change(c, ENC_CTX_AAD_UPDATED))
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		ret = siv_aad(c->siv, value, value_len);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+
+		c->state = ENC_CTX_AAD_UPDATED;
+		break;
+	case YACA_PROPERTY_SIV_TAG:
+		if (c->siv == NULL || is_encryption_op(c->op_type) || value_len != SIV_BLOCK ||
+		    !verify_state_change(c, ENC_CTX_TAG_SET))
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		memcpy(c->siv->v, value, SIV_BLOCK);
+		c->state = ENC_CTX_TAG_SET;
+		break;
+	case YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO:
+		/* Before anything else, it doesn't change the state */
+		if (value_len != sizeof(yaca_digest_algorithm_e) || c->digest != NULL ||
+		    c->state != ENC_CTX_INITIALIZED)
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		ret = encrypt_ctx_set_plaintext_digest(c, *(yaca_digest_algorithm_e*)value);
+		break;
+	case YACA_PROPERTY_RC2_EFFECTIVE_KEY_BITS:
+		if (value_len != sizeof(size_t) ||
+		    (nid != NID_rc2_cbc && nid != NID_rc2_ecb && nid != NID_rc2_cfb64 && nid != NID_rc2_ofb64) ||
+		    c->state != ENC_CTX_INITIALIZED)
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		ret = encrypt_ctx_set_rc2_effective_key_bits(c, *(size_t*)value);
+		break;
+	default:
+		return YACA_ERROR_INVALID_PARAMETER;
+	}
+
+	return ret;
+}
+
+static int get_encrypt_property(const yaca_context_h ctx, yaca_property_e property,
+                                void *value, size_t value_capacity, size_t *value_len)
+{
+	int ret;
+	struct yaca_encrypt_context_s *c = get_encrypt_context(ctx);
+	int mode;
+
+	if (c == NULL || value_len == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+	assert(c->cipher_ctx != NULL);
+
+	mode = c->mode;
+
+	switch (property) {
+	case YACA_PROPERTY_GCM_TAG:
+		if (!is_encryption_op(c->op_type) ||
+		    mode != EVP_CIPH_GCM_MODE ||
+		    (c->state != ENC_CTX_TAG_LENGTH_SET && c->state != ENC_CTX_FINALIZED))
+			return YACA_ERROR_INVALID_PARAMETER;
+		break;
+	case YACA_PROPERTY_CCM_TAG:
+		if (!is_encryption_op(c->op_type) ||
+		    mode != EVP_CIPH_CCM_MODE ||
+		    c->state != ENC_CTX_FINALIZED)
+			return YACA_ERROR_INVALID_PARAMETER;
+		break;
+	case YACA_PROPERTY_CBC_HMAC_TAG:
+		if (!is_encryption_op(c->op_type) ||
+		    c->hmac == NULL ||
+		    c->state != ENC_CTX_FINALIZED)
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		/* computed by the finalization, not by OpenSSL */
+		if (value != NULL && value_capacity < c->hmac->tag_len) {
+			*value_len = c->hmac->tag_len;
+			return YACA_ERROR_INVALID_PARAMETER;
+		}
+
+		if (value != NULL)
+			memcpy(value, c->hmac->tag, c->hmac->tag_len);
+		*value_len = c->hmac->tag_len;
+		return YACA_ERROR_NONE;
+	case YACA_PROPERTY_SIV_TAG:
+		if (!is_encryption_op(c->op_type) ||
+		    c->siv == NULL ||
+		    c->state != ENC_CTX_FINALIZED)
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		if (value != NULL && value_capacity < SIV_BLOCK) {
+			*value_len = SIV_BLOCK;
+			return YACA_ERROR_INVALID_PARAMETER;
 		}
-		c->state = ENC_CTX_AAD_UPDATED;
-		break;
-	case YACA_PROPERTY_GCM_TAG:
-		if (mode != EVP_CIPH_GCM_MODE || is_encryption_op(c->op_type) ||
-		    !is_valid_tag_len(mode, value_len) ||
-		    !verify_state_change(c, ENC_CTX_TAG_SET))
+
+		if (value != NULL)
+			memcpy(value, c->siv->v, SIV_BLOCK);
+		*value_len = SIV_BLOCK;
+		return YACA_ERROR_NONE;
+	case YACA_PROPERTY_PLAINTEXT_DIGEST:
+		/* computed by the finalization */
+		if (c->digest == NULL || c->digest->len == 0)
 			return YACA_ERROR_INVALID_PARAMETER;
 
-		if (EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_GCM_SET_TAG, value_len, (void*)value) != 1) {
-			ret = YACA_ERROR_INTERNAL;
-			ERROR_DUMP(ret);
-			return ret;
+		if (value != NULL && value_capacity < c->digest->len) {
+			*value_len = c->digest->len;
+			return YACA_ERROR_INVALID_PARAMETER;
 		}
-		c->state = ENC_CTX_TAG_SET;
+
+		if (value != NULL)
+			memcpy(value, c->digest->value, c->digest->len);
+		*value_len = c->digest->len;
+		return YACA_ERROR_NONE;
+	default:
+		return YACA_ERROR_INVALID_PARAMETER;
+	}
+
+	assert(c->tag_len <= INT_MAX);
+
+	/* length query only */
+	if (value == NULL) {
+		*value_len = c->tag_len;
+		return YACA_ERROR_NONE;
+	}
+
+	if (value_capacity < c->tag_len) {
+		*value_len = c->tag_len;
+		return YACA_ERROR_INVALID_PARAMETER;
+	}
+
+	if (EVP_CIPHER_CTX_ctrl(c->cipher_ctx,
+	                        mode == EVP_CIPH_GCM_MODE ? EVP_CTRL_GCM_GET_TAG : EVP_CTRL_CCM_GET_TAG,
+	                        c->tag_len,
+	                        value) != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	*value_len = c->tag_len;
+	return YACA_ERROR_NONE;
+}
+
+static int check_key_bit_length_for_algo(yaca_encrypt_algorithm_e algo, size_t key_bit_len)
+{
+	assert(key_bit_len % 8 == 0);
+	int ret = YACA_ERROR_NONE;
+
+	switch (algo) {
+	case YACA_ENCRYPT_AES:
+		if (key_bit_len != YACA_KEY_LENGTH_UNSAFE_128BIT &&
+		    key_bit_len != YACA_KEY_LENGTH_192BIT &&
+		    key_bit_len != YACA_KEY_LENGTH_256BIT)
+			ret = YACA_ERROR_INVALID_PARAMETER;
 		break;
-	case YACA_PROPERTY_GCM_TAG_LEN:
-		if (value_len != sizeof(size_t) || mode != EVP_CIPH_GCM_MODE ||
-		    !is_encryption_op(c->op_type) ||
-		    !is_valid_tag_len(mode, *(size_t*)value) ||
-		    !verify_state_change(c, ENC_CTX_TAG_LENGTH_SET))
+	case YACA_ENCRYPT_UNSAFE_DES:
+		if (key_bit_len != YACA_KEY_LENGTH_UNSAFE_64BIT)
+			ret = YACA_ERROR_INVALID_PARAMETER;
+		break;
+	case YACA_ENCRYPT_UNSAFE_3DES_2TDEA:
+		if (key_bit_len != YACA_KEY_LENGTH_UNSAFE_128BIT)
+			ret = YACA_ERROR_INVALID_PARAMETER;
+		break;
+	case YACA_ENCRYPT_3DES_3TDEA:
+		if (key_bit_len != YACA_KEY_LENGTH_192BIT)
+			ret = YACA_ERROR_INVALID_PARAMETER;
+		break;
+	case YACA_ENCRYPT_UNSAFE_RC2:
+		if (key_bit_len < YACA_KEY_LENGTH_UNSAFE_8BIT || key_bit_len > YACA_KEY_LENGTH_1024BIT)
+			ret = YACA_ERROR_INVALID_PARAMETER;
+		break;
+	case YACA_ENCRYPT_UNSAFE_RC4:
+		if (key_bit_len < YACA_KEY_LENGTH_UNSAFE_40BIT || key_bit_len > YACA_KEY_LENGTH_2048BIT)
+			ret = YACA_ERROR_INVALID_PARAMETER;
+		break;
+	case YACA_ENCRYPT_CAST5:
+		if (key_bit_len < YACA_KEY_LENGTH_UNSAFE_40BIT || key_bit_len > YACA_KEY_LENGTH_UNSAFE_128BIT)
+			ret = YACA_ERROR_INVALID_PARAMETER;
+		break;
+	default:
+		ret = YACA_ERROR_INVALID_PARAMETER;
+		break;
+	}
+
+	return ret;
+}
+
+static size_t key_slot_for_algo(yaca_encrypt_algorithm_e algo, size_t key_bit_len)
+{
+	/* the length has already been checked by check_key_bit_length_for_algo() */
+	if (algo == YACA_ENCRYPT_AES)
+		return key_bit_len / 64 - 2;
+
+	return 0;
+}
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+void encrypt_prefetch(void)
+{
+	size_t algo, bcm, slot;
+
+	for (algo = 0; algo < ENCRYPT_ALGO_COUNT; ++algo)
+		for (bcm = 0; bcm < ENCRYPT_BCM_COUNT; ++bcm)
+			for (slot = 0; slot < ENCRYPT_KEY_SLOTS; ++slot) {
+				const EVP_CIPHER *cipher;
+
+				if (ENCRYPTION_CIPHERS[algo][bcm][slot] == NULL)
+					continue;
+
+				cipher = ENCRYPTION_CIPHERS[algo][bcm][slot]();
+				if (cipher != NULL)
+					FETCHED_CIPHERS[algo][bcm][slot] =
+						EVP_CIPHER_fetch(NULL, EVP_CIPHER_get0_name(cipher), NULL);
+			}
+
+	/* failed fetches are not fatal */
+	ERROR_CLEAR();
+}
+
+void encrypt_release(void)
+{
+	size_t algo, bcm, slot;
+
+	for (algo = 0; algo < ENCRYPT_ALGO_COUNT; ++algo)
+		for (bcm = 0; bcm < ENCRYPT_BCM_COUNT; ++bcm)
+			for (slot = 0; slot < ENCRYPT_KEY_SLOTS; ++slot) {
+				EVP_CIPHER_free(FETCHED_CIPHERS[algo][bcm][slot]);
+				FETCHED_CIPHERS[algo][bcm][slot] = NULL;
+			}
+}
+#endif
+
+int encrypt_get_algorithm(yaca_encrypt_algorithm_e algo,
+                          yaca_block_cipher_mode_e bcm,
+                          size_t key_bit_len,
+                          const EVP_CIPHER **cipher)
+{
+	int ret;
+	size_t slot;
+
+	assert(cipher != NULL);
+
+	/* two keys of the same length, the cipher is the one of a half */
+	if (bcm == YACA_BCM_SIV) {
+		if (key_bit_len % 16 != 0)
 			return YACA_ERROR_INVALID_PARAMETER;
+		key_bit_len /= 2;
+	}
+
+	ret = check_key_bit_length_for_algo(algo, key_bit_len);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	if ((unsigned)bcm >= ENCRYPT_BCM_COUNT)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	slot = key_slot_for_algo(algo, key_bit_len);
+	if (ENCRYPTION_CIPHERS[algo][bcm][slot] == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+	if (FETCHED_CIPHERS[algo][bcm][slot] != NULL) {
+		*cipher = FETCHED_CIPHERS[algo][bcm][slot];
+		return YACA_ERROR_NONE;
+	}
+#endif
+
+	*cipher = ENCRYPTION_CIPHERS[algo][bcm][slot]();
+	if (*cipher == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	return YACA_ERROR_NONE;
+}
+
+int encrypt_initialize(yaca_context_h *ctx,
+                       yaca_encrypt_algorithm_e algo,
+                       yaca_block_cipher_mode_e bcm,
+                       const EVP_CIPHER *cipher,
+                       const yaca_key_h sym_key,
+                       const yaca_key_h iv,
+                       enum encrypt_op_type_e op_type)
+{
+	struct yaca_encrypt_context_s *nc = NULL;
+	struct yaca_key_simple_s *lsym_key;
+	int ret;
+
+	TRACE(encrypt__init__entry, algo, bcm, op_type);
+
+	if (ctx == NULL || sym_key == YACA_KEY_NULL) {
+		ret = YACA_ERROR_INVALID_PARAMETER;
+		goto exit;
+	}
+
+	lsym_key = key_get_simple(sym_key);
+	assert(lsym_key != NULL);
+
+	if (lsym_key->key.type != YACA_KEY_TYPE_DES &&
+	    lsym_key->key.type != YACA_KEY_TYPE_SYMMETRIC) {
+		ret = YACA_ERROR_INVALID_PARAMETER;
+		goto exit;
+	}
+
+	ret = encrypt_ctx_create(&nc, op_type, cipher);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (bcm == YACA_BCM_SIV) {
+		ret = encrypt_ctx_init(nc, cipher, lsym_key->bit_len / 2);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = encrypt_ctx_setup_siv(nc, lsym_key, iv);
+	} else {
+		ret = encrypt_ctx_init(nc, cipher, lsym_key->bit_len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = encrypt_ctx_setup(nc, sym_key, iv);
+	}
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (bcm == YACA_BCM_CBC_HMAC_SHA1 || bcm == YACA_BCM_CBC_HMAC_SHA256) {
+		ret = encrypt_ctx_setup_cbc_hmac(nc, bcm, iv);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	int mode = nc->mode;
+	int nid = nc->nid;
+	if (mode == EVP_CIPH_CCM_MODE ||
+	    nid == NID_rc2_cbc || nid == NID_rc2_ecb || nid == NID_rc2_cfb64 || nid == NID_rc2_ofb64) {
+		ret = encrypt_ctx_backup(nc, cipher, sym_key, iv);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	nc->state = ENC_CTX_INITIALIZED;
+	nc->algo = algo;
+	nc->bcm = bcm;
+	stats_context_initialized(YACA_STATS_CONTEXT_ENCRYPT);
+
+	*ctx = (yaca_context_h)nc;
+	nc = NULL;
+	ret = YACA_ERROR_NONE;
+
+exit:
+	yaca_context_destroy((yaca_context_h)nc);
+
+	TRACE(encrypt__init__return, algo, bcm, op_type, ret);
+	return ret;
+}
+
+static int encrypt_ctx_update(yaca_context_h ctx,
+                              const unsigned char *input, size_t input_len,
+                              unsigned char *output, size_t *output_len,
+                              enum encrypt_op_type_e op_type)
+{
+	struct yaca_encrypt_context_s *c = get_encrypt_context(ctx);
+	int ret;
+	int loutput_len;
+
+	if (c == NULL || input_len == 0 || output_len == NULL || op_type != c->op_type)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	enum encrypt_context_state_e target_state;
+	if (output == NULL && input == NULL)
+		target_state = ENC_CTX_MSG_LENGTH_UPDATED;
+	else if (output == NULL)
+		target_state = ENC_CTX_AAD_UPDATED;
+	else if (input == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+	else
+		target_state = ENC_CTX_MSG_UPDATED;
+
+	if (!verify_state_change(c, target_state))
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	/* Either exactly the same buffer or no overlap at all */
+	if (output != NULL && output != input &&
+	    output < input + input_len && input < output + input_len)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	if (target_state == ENC_CTX_MSG_UPDATED && c->digest != NULL)
+		ret = update_plaintext_digest(c, input, input_len, output, &loutput_len);
+	else if (output != NULL && output == input)
+		ret = c->update_in_place(c, input, input_len, output, &loutput_len);
+	else
+		ret = c->update(c, input, input_len, output, &loutput_len);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	*output_len = loutput_len;
+
+	c->state = target_state;
+	if (target_state == ENC_CTX_MSG_UPDATED) {
+		c->msg_len += input_len;
+		stats_context_updated(YACA_STATS_CONTEXT_ENCRYPT);
+		stats_cipher_bytes(c->algo, input_len);
+	}
+
+	return YACA_ERROR_NONE;
+}
+
+static int encrypt_ctx_finalize(yaca_context_h ctx,
+                                unsigned char *output, size_t *output_len,
+                                enum encrypt_op_type_e op_type)
+{
+	struct yaca_encrypt_context_s *c = get_encrypt_context(ctx);
+	int ret;
+	int loutput_len = 0;
+
+	if (c == NULL || output == NULL || output_len == NULL || op_type != c->op_type)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	if (!verify_state_change(c, ENC_CTX_FINALIZED))
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = c->finalize(c, output, &loutput_len);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	if (c->digest != NULL) {
+		ret = finalize_plaintext_digest(c, output, loutput_len);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+	}
+
+	*output_len = loutput_len;
+
+	c->state = ENC_CTX_FINALIZED;
+	stats_context_finalized(YACA_STATS_CONTEXT_ENCRYPT);
+
+	return YACA_ERROR_NONE;
+}
+
+int encrypt_update(yaca_context_h ctx,
+                   const unsigned char *input, size_t input_len,
+                   unsigned char *output, size_t *output_len,
+                   enum encrypt_op_type_e op_type)
+{
+	int ret;
 
-		c->tag_len = *(size_t*)value;
-		c->state = ENC_CTX_TAG_LENGTH_SET;
-		break;
-	case YACA_PROPERTY_CCM_TAG:
-		if (mode != EVP_CIPH_CCM_MODE || is_encryption_op(c->op_type) ||
-		    !is_valid_tag_len(mode, value_len) ||
-		    !verify_state_change(c, ENC_CTX_TAG_SET))
-			return YACA_ERROR_INVALID_PARAMETER;
+	TRACE(encrypt__update__entry, trace_encrypt_algo(ctx), trace_encrypt_bcm(ctx),
+	      op_type, input_len);
 
-		ret = encrypt_ctx_set_ccm_tag(c, (char*)value, value_len);
-		if (ret != YACA_ERROR_NONE)
-			return ret;
+	ret = encrypt_ctx_update(ctx, input, input_len, output, output_len, op_type);
 
-		c->state = ENC_CTX_TAG_SET;
-		break;
-	case YACA_PROPERTY_CCM_TAG_LEN:
-		if (value_len != sizeof(size_t) || mode != EVP_CIPH_CCM_MODE ||
-		    !is_encryption_op(c->op_type) ||
-		    !is_valid_tag_len(mode, *(size_t*)value) ||
-		    !verify_state_change(c, ENC_CTX_TAG_LENGTH_SET))
-			return YACA_ERROR_INVALID_PARAMETER;
+	TRACE(encrypt__update__return, trace_encrypt_algo(ctx), trace_encrypt_bcm(ctx),
+	      op_type, input_len, ret);
+	return ret;
+}
 
-		ret = encrypt_ctx_set_ccm_tag_len(c, *(size_t*)value);
-		if (ret != YACA_ERROR_NONE)
-			return ret;
+int encrypt_finalize(yaca_context_h ctx,
+                     unsigned char *output, size_t *output_len,
+                     enum encrypt_op_type_e op_type)
+{
+	int ret;
 
-		c->state = ENC_CTX_TAG_LENGTH_SET;
-		break;
-	case YACA_PROPERTY_PADDING:
-		if ((mode != EVP_CIPH_ECB_MODE && mode != EVP_CIPH_CBC_MODE) ||
-		    value_len != sizeof(yaca_padding_e) ||
-		    (*(yaca_padding_e*)value != YACA_PADDING_NONE &&
-		    *(yaca_padding_e*)value != YACA_PADDING_PKCS7) ||
-		    ((is_encryption_op(c->op_type)) && c->state == ENC_CTX_FINALIZED) ||
-		    (!(is_encryption_op(c->op_type)) && c->state != ENC_CTX_INITIALIZED))
-			return YACA_ERROR_INVALID_PARAMETER;
+	TRACE(encrypt__finalize__entry, trace_encrypt_algo(ctx), trace_encrypt_bcm(ctx), op_type);
 
-		int padding = *(yaca_padding_e*)value == YACA_PADDING_NONE ? 0 : 1;
-		if (EVP_CIPHER_CTX_set_padding(c->cipher_ctx, padding) != 1) {
-			ret = YACA_ERROR_INTERNAL;
-			ERROR_DUMP(ret);
-			return ret;
-		}
-		if (c->backup_ctx != NULL)
-			c->backup_ctx->padding = padding;
-		break;
-	case YACA_PROPERTY_RC2_EFFECTIVE_KEY_BITS:
-		if (value_len != sizeof(size_t) ||
-		    (nid != NID_rc2_cbc && nid != NID_rc2_ecb && nid != NID_rc2_cfb64 && nid != NID_rc2_ofb64) ||
-		    c->state != ENC_CTX_INITIALIZED)
-			return YACA_ERROR_INVALID_PARAMETER;
+	ret = encrypt_ctx_finalize(ctx, output, output_len, op_type);
 
-		ret = encrypt_ctx_set_rc2_effective_key_bits(c, *(size_t*)value);
-		break;
-	default:
+	TRACE(encrypt__finalize__return, trace_encrypt_algo(ctx), trace_encrypt_bcm(ctx),
+	      op_type, ret);
+	return ret;
+}
+
+API int yaca_encrypt_get_iv_bit_length(yaca_encrypt_algorithm_e algo,
+                                       yaca_block_cipher_mode_e bcm,
+                                       size_t key_bit_len,
+                                       size_t *iv_bit_len)
+{
+	int ret;
+	const EVP_CIPHER *cipher;
+
+	if (iv_bit_len == NULL || key_bit_len % 8 != 0)
 		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = encrypt_get_algorithm(algo, bcm, key_bit_len, &cipher);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	/* the IV of the CTR is synthetic */
+	if (bcm == YACA_BCM_SIV) {
+		*iv_bit_len = 0;
+		return YACA_ERROR_NONE;
 	}
 
-	return ret;
+	ret = EVP_CIPHER_iv_length(cipher);
+	if (ret < 0) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	*iv_bit_len = ret * 8;
+	return YACA_ERROR_NONE;
 }
 
-static int get_encrypt_property(const yaca_context_h ctx, yaca_property_e property,
-                                void **value, size_t *value_len)
+API int yaca_encrypt_initialize(yaca_context_h *ctx,
+                                yaca_encrypt_algorithm_e algo,
+                                yaca_block_cipher_mode_e bcm,
+                                const yaca_key_h sym_key,
+                                const yaca_key_h iv)
 {
 	int ret;
-	void *tag = NULL;
-	struct yaca_encrypt_context_s *c = get_encrypt_context(ctx);
-	int mode;
+	const EVP_CIPHER *cipher;
+	struct yaca_key_simple_s *key = key_get_simple(sym_key);
 
-	if (c == NULL || value == NULL)
+	if (key == NULL)
 		return YACA_ERROR_INVALID_PARAMETER;
-	assert(c->cipher_ctx != NULL);
 
-	mode = EVP_CIPHER_CTX_mode(c->cipher_ctx);
+	ret = encrypt_get_algorithm(algo, bcm, key->bit_len, &cipher);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
 
-	switch (property) {
-	case YACA_PROPERTY_GCM_TAG:
-		if (value_len == NULL ||
-		    !is_encryption_op(c->op_type) ||
-		    mode != EVP_CIPH_GCM_MODE ||
-		    (c->state != ENC_CTX_TAG_LENGTH_SET && c->state != ENC_CTX_FINALIZED))
-			return YACA_ERROR_INVALID_PARAMETER;
+	return encrypt_initialize(ctx, algo, bcm, cipher, sym_key, iv, OP_ENCRYPT);
+}
+
+API int yaca_encrypt_update(yaca_context_h ctx,
+                            const char *plaintext,
+                            size_t plaintext_len,
+                            char *ciphertext,
+                            size_t *ciphertext_len)
+{
+	return encrypt_update(ctx, (const unsigned char*)plaintext, plaintext_len,
+	                      (unsigned char*)ciphertext, ciphertext_len, OP_ENCRYPT);
+}
 
-		assert(c->tag_len <= INT_MAX);
+API int yaca_encrypt_finalize(yaca_context_h ctx,
+                              char *ciphertext,
+                              size_t *ciphertext_len)
+{
+	return encrypt_finalize(ctx, (unsigned char*)ciphertext, ciphertext_len, OP_ENCRYPT);
+}
 
-		ret = yaca_malloc(c->tag_len, &tag);
-		if (ret != YACA_ERROR_NONE)
-			return ret;
+API int yaca_decrypt_initialize(yaca_context_h *ctx,
+                                yaca_encrypt_algorithm_e algo,
+                                yaca_block_cipher_mode_e bcm,
+                                const yaca_key_h sym_key,
+                                const yaca_key_h iv)
+{
+	int ret;
+	const EVP_CIPHER *cipher;
+	struct yaca_key_simple_s *key = key_get_simple(sym_key);
+
+	if (key == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = encrypt_get_algorithm(algo, bcm, key->bit_len, &cipher);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	return encrypt_initialize(ctx, algo, bcm, cipher, sym_key, iv, OP_DECRYPT);
+}
+
+API int yaca_decrypt_update(yaca_context_h ctx,
+                            const char *ciphertext,
+                            size_t ciphertext_len,
+                            char *plaintext,
+                            size_t *plaintext_len)
+{
+	return encrypt_update(ctx, (const unsigned char*)ciphertext, ciphertext_len,
+	                      (unsigned char*)plaintext, plaintext_len, OP_DECRYPT);
+}
+
+API int yaca_decrypt_finalize(yaca_context_h ctx,
+                              char *plaintext,
+                              size_t *plaintext_len)
+{
+	return encrypt_finalize(ctx, (unsigned char*)plaintext, plaintext_len, OP_DECRYPT);
+}
+
+/* Processes the items [first, last) of a batch with the context c */
+typedef int (*batch_range_fn)(struct yaca_encrypt_context_s *c, const void *batch,
+                              size_t first, size_t last);
+
+struct batch_job {
+	struct yaca_encrypt_context_s *c;
+	/* [1, threads) are copies of c with EVP contexts of their own */
+	struct yaca_encrypt_context_s *copies;
+	batch_range_fn range;
+	const void *batch;
+};
+
+static int batch_job_range(void *arg, size_t slice, size_t first, size_t last)
+{
+	struct batch_job *j = arg;
+
+	return j->range(slice == 0 ? j->c : &j->copies[slice], j->batch, first, last);
+}
 
-		if (EVP_CIPHER_CTX_ctrl(c->cipher_ctx,
-		                        EVP_CTRL_GCM_GET_TAG,
-		                        c->tag_len,
-		                        tag) != 1) {
+static int batch_run(struct yaca_encrypt_context_s *c, batch_range_fn range,
+                     const void *batch, size_t count, size_t threads)
+{
+	int ret = YACA_ERROR_NONE;
+	struct yaca_encrypt_context_s copies[PARALLEL_MAX_THREADS];
+	struct batch_job job = {c, copies, range, batch};
+	size_t slices = parallel_threads(count, threads);
+	size_t made;
+
+	/* Slice 0 works on c itself, the other slices copy its cipher state
+	 * before parallel_run() lets it change
+	 */
+	for (made = 1; made < slices; ++made) {
+		struct yaca_encrypt_context_s *copy = &copies[made];
+
+		*copy = *c;
+		copy->siv = NULL;
+		copy->cipher_ctx = EVP_CIPHER_CTX_new();
+		if (copy->cipher_ctx == NULL ||
+		    EVP_CIPHER_CTX_copy(copy->cipher_ctx, c->cipher_ctx) != 1) {
+			EVP_CIPHER_CTX_free(copy->cipher_ctx);
 			ret = YACA_ERROR_INTERNAL;
 			ERROR_DUMP(ret);
-			goto err;
+			goto exit;
 		}
-		*value = tag;
-		*value_len = c->tag_len;
-		break;
-	case YACA_PROPERTY_CCM_TAG:
-		if (value_len == NULL ||
-		    !is_encryption_op(c->op_type) ||
-		    mode != EVP_CIPH_CCM_MODE ||
-		    c->state != ENC_CTX_FINALIZED)
-			return YACA_ERROR_INVALID_PARAMETER;
 
-		assert(c->tag_len <= INT_MAX);
+		if (c->siv != NULL) {
+			ret = siv_copy(c->siv, &copy->siv);
+			if (ret != YACA_ERROR_NONE) {
+				EVP_CIPHER_CTX_free(copy->cipher_ctx);
+				goto exit;
+			}
+		}
+	}
+
+	ret = parallel_run(batch_job_range, &job, count, threads);
+
+exit:
+	for (size_t t = 1; t < made; ++t) {
+		siv_free(copies[t].siv);
+		EVP_CIPHER_CTX_free(copies[t].cipher_ctx);
+	}
+
+	return ret;
+}
+
+struct wrap_batch {
+	const unsigned char *const *inputs;
+	const size_t *input_lens;
+	unsigned char *const *outputs;
+	size_t *output_lens;
+};
+
+static size_t wrap_overhead(yaca_encrypt_algorithm_e algo)
+{
+	/* the AES integrity check value, 3DES adds an IV as well */
+	return algo == YACA_ENCRYPT_AES ? 8 : 16;
+}
+
+static int wrap_batch_range(struct yaca_encrypt_context_s *c, const void *batch,
+                            size_t first, size_t last)
+{
+	const struct wrap_batch *b = batch;
+	int ret;
+	int written;
 
-		ret = yaca_malloc(c->tag_len, &tag);
+	for (size_t i = first; i < last; ++i) {
+		ret = update_wrap(c, b->inputs[i], b->input_lens[i], b->outputs[i], &written);
 		if (ret != YACA_ERROR_NONE)
 			return ret;
 
-		if (EVP_CIPHER_CTX_ctrl(c->cipher_ctx,
-		                        EVP_CTRL_CCM_GET_TAG,
-		                        c->tag_len,
-		                        tag) != 1) {
-			ret = YACA_ERROR_INTERNAL;
-			ERROR_DUMP(ret);
-			goto err;
-		}
-		*value = tag;
-		*value_len = c->tag_len;
-		break;
-	default:
-		return YACA_ERROR_INVALID_PARAMETER;
-		break;
+		b->output_lens[i] = written;
 	}
 
 	return YACA_ERROR_NONE;
-
-err:
-	yaca_free(tag);
-	return ret;
 }
 
-static int check_key_bit_length_for_algo(yaca_encrypt_algorithm_e algo, size_t key_bit_len)
+static int wrap_batch_run(yaca_encrypt_algorithm_e algo,
+                          const yaca_key_h kek,
+                          const yaca_key_h iv,
+                          enum encrypt_op_type_e op_type,
+                          const struct wrap_batch *batch,
+                          size_t count,
+                          size_t threads)
 {
-	assert(key_bit_len % 8 == 0);
-	int ret = YACA_ERROR_NONE;
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	const EVP_CIPHER *cipher;
+	struct yaca_key_simple_s *lkek = key_get_simple(kek);
+	size_t total_len = 0;
 
-	switch (algo) {
-	case YACA_ENCRYPT_AES:
-		if (key_bit_len != YACA_KEY_LENGTH_UNSAFE_128BIT &&
-		    key_bit_len != YACA_KEY_LENGTH_192BIT &&
-		    key_bit_len != YACA_KEY_LENGTH_256BIT)
-			ret = YACA_ERROR_INVALID_PARAMETER;
-		break;
-	case YACA_ENCRYPT_UNSAFE_DES:
-		if (key_bit_len != YACA_KEY_LENGTH_UNSAFE_64BIT)
-			ret = YACA_ERROR_INVALID_PARAMETER;
-		break;
-	case YACA_ENCRYPT_UNSAFE_3DES_2TDEA:
-		if (key_bit_len != YACA_KEY_LENGTH_UNSAFE_128BIT)
-			ret = YACA_ERROR_INVALID_PARAMETER;
-		break;
-	case YACA_ENCRYPT_3DES_3TDEA:
-		if (key_bit_len != YACA_KEY_LENGTH_192BIT)
-			ret = YACA_ERROR_INVALID_PARAMETER;
-		break;
-	case YACA_ENCRYPT_UNSAFE_RC2:
-		if (key_bit_len < YACA_KEY_LENGTH_UNSAFE_8BIT || key_bit_len > YACA_KEY_LENGTH_1024BIT)
-			ret = YACA_ERROR_INVALID_PARAMETER;
-		break;
-	case YACA_ENCRYPT_UNSAFE_RC4:
-		if (key_bit_len < YACA_KEY_LENGTH_UNSAFE_40BIT || key_bit_len > YACA_KEY_LENGTH_2048BIT)
-			ret = YACA_ERROR_INVALID_PARAMETER;
-		break;
-	case YACA_ENCRYPT_CAST5:
-		if (key_bit_len < YACA_KEY_LENGTH_UNSAFE_40BIT || key_bit_len > YACA_KEY_LENGTH_UNSAFE_128BIT)
-			ret = YACA_ERROR_INVALID_PARAMETER;
-		break;
-	default:
-		ret = YACA_ERROR_INVALID_PARAMETER;
-		break;
+	if (lkek == NULL || count == 0 || threads > PARALLEL_MAX_THREADS)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	for (size_t i = 0; i < count; ++i) {
+		if (batch->inputs[i] == NULL || batch->outputs[i] == NULL)
+			return YACA_ERROR_INVALID_PARAMETER;
+		total_len += batch->input_lens[i];
+	}
+
+	ret = encrypt_get_algorithm(algo, YACA_BCM_WRAP, lkek->bit_len, &cipher);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	/* The KEK is expanded once, batch_run() copies the context with it */
+	ret = encrypt_initialize(&ctx, algo, YACA_BCM_WRAP, cipher, kek, iv, op_type);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = batch_run(get_encrypt_context(ctx), wrap_batch_range, batch, count, threads);
+
+	if (ret == YACA_ERROR_NONE) {
+		stats_context_updated(YACA_STATS_CONTEXT_ENCRYPT);
+		stats_cipher_bytes(algo, total_len);
 	}
 
+	yaca_context_destroy(ctx);
 	return ret;
 }
 
-int encrypt_get_algorithm(yaca_encrypt_algorithm_e algo,
-                          yaca_block_cipher_mode_e bcm,
-                          size_t key_bit_len,
-                          const EVP_CIPHER **cipher)
+API int yaca_encrypt_wrap_batch(yaca_encrypt_algorithm_e algo,
+                                const yaca_key_h kek,
+                                const yaca_key_h iv,
+                                const char *const *keys,
+                                const size_t *key_lens,
+                                size_t count,
+                                char *const *wrapped,
+                                size_t *wrapped_lens,
+                                size_t threads)
+{
+	if (keys == NULL || key_lens == NULL || wrapped == NULL || wrapped_lens == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	struct wrap_batch batch = {(const unsigned char *const *)keys, key_lens,
+	                           (unsigned char *const *)wrapped, wrapped_lens};
+
+	return wrap_batch_run(algo, kek, iv, OP_ENCRYPT, &batch, count, threads);
+}
+
+API int yaca_decrypt_unwrap_batch(yaca_encrypt_algorithm_e algo,
+                                  const yaca_key_h kek,
+                                  const yaca_key_h iv,
+                                  const char *const *wrapped,
+                                  const size_t *wrapped_lens,
+                                  size_t count,
+                                  char *const *keys,
+                                  size_t *key_lens,
+                                  size_t threads)
+{
+	if (wrapped == NULL || wrapped_lens == NULL || keys == NULL || key_lens == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	struct wrap_batch batch = {(const unsigned char *const *)wrapped, wrapped_lens,
+	                           (unsigned char *const *)keys, key_lens};
+
+	return wrap_batch_run(algo, kek, iv, OP_DECRYPT, &batch, count, threads);
+}
+
+API int yaca_encrypt_wrap_keys(yaca_encrypt_algorithm_e algo,
+                               const yaca_key_h kek,
+                               const yaca_key_h iv,
+                               const yaca_key_h *keys,
+                               size_t count,
+                               char **wrapped,
+                               size_t *wrapped_lens,
+                               size_t threads)
 {
 	int ret;
+	const unsigned char **inputs = NULL;
+	size_t *input_lens = NULL;
 	size_t i;
 
-	assert(cipher != NULL);
+	if (keys == NULL || count == 0 || count > SIZE_MAX / sizeof(size_t) ||
+	    wrapped == NULL || wrapped_lens == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
 
-	ret = check_key_bit_length_for_algo(algo, key_bit_len);
+	for (i = 0; i < count; ++i)
+		wrapped[i] = NULL;
+
+	ret = yaca_malloc(count * sizeof(*inputs), (void**)&inputs);
 	if (ret != YACA_ERROR_NONE)
-		return ret;
+		goto exit;
+
+	ret = yaca_malloc(count * sizeof(*input_lens), (void**)&input_lens);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
 
-	*cipher = NULL;
-	ret = YACA_ERROR_INVALID_PARAMETER;
-
-	for (i = 0; i < ENCRYPTION_CIPHERS_SIZE; ++i)
-		if (ENCRYPTION_CIPHERS[i].algo == algo &&
-		    ENCRYPTION_CIPHERS[i].bcm == bcm &&
-		    (ENCRYPTION_CIPHERS[i].key_bit_len == key_bit_len ||
-		     ENCRYPTION_CIPHERS[i].key_bit_len == (size_t)-1)) {
-			*cipher = ENCRYPTION_CIPHERS[i].cipher();
-			ret = YACA_ERROR_NONE;
-			break;
+	for (i = 0; i < count; ++i) {
+		struct yaca_key_simple_s *key = key_get_simple(keys[i]);
+
+		if (key == NULL ||
+		    (key->key.type != YACA_KEY_TYPE_SYMMETRIC && key->key.type != YACA_KEY_TYPE_DES)) {
+			ret = YACA_ERROR_INVALID_PARAMETER;
+			goto exit;
 		}
 
-	if (ret == YACA_ERROR_NONE && *cipher == NULL) {
-		ret = YACA_ERROR_INTERNAL;
-		ERROR_DUMP(ret);
-		return ret;
+		inputs[i] = (const unsigned char *)key->d;
+		input_lens[i] = key->bit_len / 8;
+
+		ret = yaca_malloc(input_lens[i] + wrap_overhead(algo), (void**)&wrapped[i]);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
 	}
 
+	struct wrap_batch batch = {inputs, input_lens, (unsigned char *const *)wrapped, wrapped_lens};
+
+	ret = wrap_batch_run(algo, kek, iv, OP_ENCRYPT, &batch, count, threads);
+
+exit:
+	if (ret != YACA_ERROR_NONE)
+		for (i = 0; i < count; ++i) {
+			yaca_free(wrapped[i]);
+			wrapped[i] = NULL;
+		}
+
+	yaca_free(input_lens);
+	yaca_free(inputs);
 	return ret;
 }
 
-int encrypt_initialize(yaca_context_h *ctx,
-                       const EVP_CIPHER *cipher,
-                       const yaca_key_h sym_key,
-                       const yaca_key_h iv,
-                       enum encrypt_op_type_e op_type)
+API int yaca_decrypt_unwrap_keys(yaca_encrypt_algorithm_e algo,
+                                 const yaca_key_h kek,
+                                 const yaca_key_h iv,
+                                 yaca_key_type_e key_type,
+                                 const char *const *wrapped,
+                                 const size_t *wrapped_lens,
+                                 size_t count,
+                                 yaca_key_h *keys,
+                                 size_t threads)
 {
-	struct yaca_encrypt_context_s *nc;
-	struct yaca_key_simple_s *lsym_key;
 	int ret;
+	struct yaca_key_simple_s **nkeys = NULL;
+	unsigned char **outputs = NULL;
+	size_t *output_lens = NULL;
+	size_t i;
 
-	if (ctx == NULL || sym_key == YACA_KEY_NULL)
+	if (wrapped == NULL || wrapped_lens == NULL || count == 0 ||
+	    count > SIZE_MAX / sizeof(size_t) || keys == NULL ||
+	    (key_type != YACA_KEY_TYPE_SYMMETRIC && key_type != YACA_KEY_TYPE_DES))
 		return YACA_ERROR_INVALID_PARAMETER;
 
-	lsym_key = key_get_simple(sym_key);
-	assert(lsym_key != NULL);
-
-	if (lsym_key->key.type != YACA_KEY_TYPE_DES &&
-	    lsym_key->key.type != YACA_KEY_TYPE_SYMMETRIC)
-		return YACA_ERROR_INVALID_PARAMETER;
+	for (i = 0; i < count; ++i)
+		keys[i] = YACA_KEY_NULL;
 
-	ret = encrypt_ctx_create(&nc, op_type, cipher);
+	ret = yaca_zalloc(count * sizeof(*nkeys), (void**)&nkeys);
 	if (ret != YACA_ERROR_NONE)
-		return ret;
+		goto exit;
 
-	ret = encrypt_ctx_init(nc, cipher, lsym_key->bit_len);
+	ret = yaca_malloc(count * sizeof(*outputs), (void**)&outputs);
 	if (ret != YACA_ERROR_NONE)
 		goto exit;
 
-	ret = encrypt_ctx_setup(nc, sym_key, iv);
+	ret = yaca_malloc(count * sizeof(*output_lens), (void**)&output_lens);
 	if (ret != YACA_ERROR_NONE)
 		goto exit;
 
-	int mode = EVP_CIPHER_CTX_mode(nc->cipher_ctx);
-	int nid = EVP_CIPHER_CTX_nid(nc->cipher_ctx);
-	if (mode == EVP_CIPH_CCM_MODE ||
-	    nid == NID_rc2_cbc || nid == NID_rc2_ecb || nid == NID_rc2_cfb64 || nid == NID_rc2_ofb64) {
-		ret = encrypt_ctx_backup(nc, cipher, sym_key, iv);
+	/* Unwrapped straight into the new keys, they are shorter than the input */
+	for (i = 0; i < count; ++i) {
+		ret = yaca_zalloc(sizeof(struct yaca_key_simple_s) + wrapped_lens[i],
+		                  (void**)&nkeys[i]);
 		if (ret != YACA_ERROR_NONE)
 			goto exit;
+
+		nkeys[i]->key.type = key_type;
+		outputs[i] = (unsigned char *)nkeys[i]->d;
 	}
 
-	nc->state = ENC_CTX_INITIALIZED;
+	struct wrap_batch batch = {(const unsigned char *const *)wrapped, wrapped_lens,
+	                           outputs, output_lens};
 
-	*ctx = (yaca_context_h)nc;
-	nc = NULL;
-	ret = YACA_ERROR_NONE;
+	ret = wrap_batch_run(algo, kek, iv, OP_DECRYPT, &batch, count, threads);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	for (i = 0; i < count; ++i) {
+		size_t bit_len = output_lens[i] * 8;
+
+		if (key_type == YACA_KEY_TYPE_DES &&
+		    bit_len != YACA_KEY_LENGTH_UNSAFE_64BIT &&
+		    bit_len != YACA_KEY_LENGTH_UNSAFE_128BIT &&
+		    bit_len != YACA_KEY_LENGTH_192BIT) {
+			ret = YACA_ERROR_INVALID_PARAMETER;
+			goto exit;
+		}
+
+		nkeys[i]->bit_len = bit_len;
+	}
+
+	for (i = 0; i < count; ++i) {
+		keys[i] = (yaca_key_h)nkeys[i];
+		nkeys[i] = NULL;
+	}
 
 exit:
-	yaca_context_destroy((yaca_context_h)nc);
+	if (nkeys != NULL)
+		for (i = 0; i < count; ++i)
+			if (nkeys[i] != NULL) {
+				OPENSSL_cleanse(nkeys[i]->d, wrapped_lens[i]);
+				yaca_free(nkeys[i]);
+			}
 
+	yaca_free(output_lens);
+	yaca_free(outputs);
+	yaca_free(nkeys);
 	return ret;
 }
 
-int encrypt_update(yaca_context_h ctx,
-                   const unsigned char *input, size_t input_len,
-                   unsigned char *output, size_t *output_len,
-                   enum encrypt_op_type_e op_type)
+static int aead_batch_range(struct yaca_encrypt_context_s *c, const void *batch,
+                            size_t first, size_t last)
 {
-	struct yaca_encrypt_context_s *c = get_encrypt_context(ctx);
+	yaca_aead_record_s *records = (yaca_aead_record_s *)batch;
+	EVP_CIPHER_CTX *cctx = c->cipher_ctx;
+	bool ccm = c->mode == EVP_CIPH_CCM_MODE;
+	bool encryption = is_encryption_op(c->op_type);
+	int tag_len = c->tag_len;
 	int ret;
-	int loutput_len;
-
-	if (c == NULL || input_len == 0 || output_len == NULL || op_type != c->op_type)
-		return YACA_ERROR_INVALID_PARAMETER;
-
-	int mode = EVP_CIPHER_CTX_mode(c->cipher_ctx);
-	int nid = EVP_CIPHER_CTX_nid(c->cipher_ctx);
-
-	enum encrypt_context_state_e target_state;
-	if (output == NULL && input == NULL)
-		target_state = ENC_CTX_MSG_LENGTH_UPDATED;
-	else if (output == NULL)
-		target_state = ENC_CTX_AAD_UPDATED;
-	else if (input == NULL)
-		return YACA_ERROR_INVALID_PARAMETER;
-	else
-		target_state = ENC_CTX_MSG_UPDATED;
+	int written;
+
+	for (size_t i = first; i < last; ++i) {
+		yaca_aead_record_s *r = &records[i];
+		unsigned char *output = (unsigned char *)r->output;
+		bool authentic = true;
+
+		/* CCM checks the tag in the update */
+		if (ccm && !encryption &&
+		    EVP_CIPHER_CTX_ctrl(cctx, EVP_CTRL_CCM_SET_TAG, tag_len, r->tag) != 1)
+			goto internal;
+
+		/* Only the IV changes, the key schedule stays */
+		if (EVP_CipherInit_ex(cctx, NULL, NULL, NULL, (const unsigned char *)r->iv, -1) != 1)
+			goto internal;
+
+		if (ccm && EVP_CipherUpdate(cctx, NULL, &written, NULL, r->input_len) != 1)
+			goto internal;
+
+		if (r->aad_len > 0 &&
+		    EVP_CipherUpdate(cctx, NULL, &written, (const unsigned char *)r->aad,
+		                     r->aad_len) != 1)
+			goto internal;
+
+		ret = EVP_CipherUpdate(cctx, output, &written, (const unsigned char *)r->input,
+		                       r->input_len);
+		if (ret != 1) {
+			if (!ccm || encryption)
+				goto internal;
+			authentic = false;
+		}
 
-	if (!verify_state_change(c, target_state))
-		return YACA_ERROR_INVALID_PARAMETER;
+		if (!ccm) {
+			if (!encryption &&
+			    EVP_CIPHER_CTX_ctrl(cctx, EVP_CTRL_GCM_SET_TAG, tag_len, r->tag) != 1)
+				goto internal;
 
-	if (mode == EVP_CIPH_WRAP_MODE) {
-		if (op_type == OP_ENCRYPT) {
-			if (nid == NID_id_aes128_wrap || nid == NID_id_aes192_wrap || nid == NID_id_aes256_wrap) {
-				if (input_len % 8 != 0 || input_len < (YACA_KEY_LENGTH_UNSAFE_128BIT / 8))
-					return YACA_ERROR_INVALID_PARAMETER;
-			} else if (nid == NID_id_smime_alg_CMS3DESwrap) {
-				if (input_len != (YACA_KEY_LENGTH_UNSAFE_128BIT / 8) &&
-				    input_len != (YACA_KEY_LENGTH_192BIT / 8))
-					return YACA_ERROR_INVALID_PARAMETER;
-			} else {
-				assert(false);
-				return YACA_ERROR_INTERNAL;
-			}
-		} else if (op_type == OP_DECRYPT) {
-			if (nid == NID_id_aes128_wrap || nid == NID_id_aes192_wrap || nid == NID_id_aes256_wrap) {
-				if (input_len % 8 != 0 || input_len < (YACA_KEY_LENGTH_UNSAFE_128BIT / 8 + 8))
-					return YACA_ERROR_INVALID_PARAMETER;
-			} else if (nid == NID_id_smime_alg_CMS3DESwrap) {
-				if (input_len != (YACA_KEY_LENGTH_UNSAFE_128BIT / 8 + 16) &&
-				    input_len != (YACA_KEY_LENGTH_192BIT / 8 + 16))
-					return YACA_ERROR_INVALID_PARAMETER;
-			} else {
-				assert(false);
-				return YACA_ERROR_INTERNAL;
+			ret = EVP_CipherFinal(cctx, output + written, &written);
+			if (ret != 1) {
+				if (encryption)
+					goto internal;
+				authentic = false;
 			}
-		} else {
-			assert(false);
-			return YACA_ERROR_INTERNAL;
 		}
-	}
 
-	ret = EVP_CipherUpdate(c->cipher_ctx, output, &loutput_len, input, input_len);
-	if (ret != 1 || loutput_len < 0) {
-		if (mode == EVP_CIPH_CCM_MODE && (op_type == OP_DECRYPT || op_type == OP_OPEN)) {
-			/* A non positive return value from EVP_CipherUpdate should be considered as
-			 * a failure to authenticate ciphertext and/or AAD.
-			 * It does not necessarily indicate a more serious error.
-			 * There is no call to EVP_CipherFinal.
-			 */
-			return YACA_ERROR_INVALID_PARAMETER;
+		if (encryption &&
+		    EVP_CIPHER_CTX_ctrl(cctx, ccm ? EVP_CTRL_CCM_GET_TAG : EVP_CTRL_GCM_GET_TAG,
+		                        tag_len, r->tag) != 1)
+			goto internal;
+
+		if (authentic) {
+			r->result = YACA_ERROR_NONE;
 		} else {
-			ret = YACA_ERROR_INTERNAL;
-			ERROR_DUMP(ret);
-			return ret;
+			/* Nothing of a forged record is released */
+			OPENSSL_cleanse(r->output, r->input_len);
+			stats_authentication_failure();
+			r->result = YACA_ERROR_INVALID_PARAMETER;
 		}
 	}
 
-	*output_len = loutput_len;
-
-	c->state = target_state;
 	return YACA_ERROR_NONE;
+
+internal:
+	ret = YACA_ERROR_INTERNAL;
+	ERROR_DUMP(ret);
+	return ret;
 }
 
-int encrypt_finalize(yaca_context_h ctx,
-                     unsigned char *output, size_t *output_len,
-                     enum encrypt_op_type_e op_type)
+/* The same steps as the SIV contexts, the S2V starts over for every record */
+static int siv_batch_range(struct yaca_encrypt_context_s *c, const void *batch,
+                           size_t first, size_t last)
 {
-	struct yaca_encrypt_context_s *c = get_encrypt_context(ctx);
+	yaca_aead_record_s *records = (yaca_aead_record_s *)batch;
+	bool encryption = is_encryption_op(c->op_type);
 	int ret;
-	int mode;
-	int loutput_len = 0;
+	int written;
 
-	if (c == NULL || output == NULL || output_len == NULL || op_type != c->op_type)
-		return YACA_ERROR_INVALID_PARAMETER;
+	for (size_t i = first; i < last; ++i) {
+		yaca_aead_record_s *r = &records[i];
 
-	if (!verify_state_change(c, ENC_CTX_FINALIZED))
-		return YACA_ERROR_INVALID_PARAMETER;
+		memcpy(c->siv->d, c->siv->d0, SIV_BLOCK);
 
-	mode = EVP_CIPHER_CTX_mode(c->cipher_ctx);
-	if (mode != EVP_CIPH_WRAP_MODE && mode != EVP_CIPH_CCM_MODE) {
-		ret = EVP_CipherFinal(c->cipher_ctx, output, &loutput_len);
-		if (ret != 1 || loutput_len < 0) {
-			if (mode == EVP_CIPH_GCM_MODE && (op_type == OP_DECRYPT || op_type == OP_OPEN)) {
-				/* A non positive return value from EVP_CipherFinal should be
-				 * considered as a failure to authenticate ciphertext and/or
-				 * AAD. It does not necessarily indicate a more serious error.
-				 */
-				return YACA_ERROR_INVALID_PARAMETER;
-			} else {
-				/* The same error code is used if trying to import a key with a
-				 * wrong password and in case of a decrypt error due to wrong
-				 * BCM or a key. Finalize cannot return INVALID_PASS so handle
-				 * this here.
-				 */
-				ret = ERROR_HANDLE();
-				if (ret == YACA_ERROR_INVALID_PASSWORD)
-					ret = YACA_ERROR_INVALID_PARAMETER;
+		if (r->aad_len > 0) {
+			ret = siv_aad(c->siv, (const unsigned char *)r->aad, r->aad_len);
+			if (ret != YACA_ERROR_NONE)
 				return ret;
-			}
 		}
-	}
 
-	*output_len = loutput_len;
+		if (!encryption)
+			memcpy(c->siv->v, r->tag, SIV_BLOCK);
+
+		ret = update_siv(c, (const unsigned char *)r->input, r->input_len,
+		                 (unsigned char *)r->output, &written);
+		if (ret == YACA_ERROR_INVALID_PARAMETER && !encryption) {
+			r->result = ret;
+			continue;
+		}
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+
+		if (encryption)
+			memcpy(r->tag, c->siv->v, SIV_BLOCK);
+		r->result = YACA_ERROR_NONE;
+	}
 
-	c->state = ENC_CTX_FINALIZED;
 	return YACA_ERROR_NONE;
 }
 
-API int yaca_encrypt_get_iv_bit_length(yaca_encrypt_algorithm_e algo,
-                                       yaca_block_cipher_mode_e bcm,
-                                       size_t key_bit_len,
-                                       size_t *iv_bit_len)
+static int aead_batch_setup(struct yaca_encrypt_context_s *c, const EVP_CIPHER *cipher,
+                            const struct yaca_key_simple_s *lkey, int mode,
+                            size_t iv_len, size_t tag_len)
 {
 	int ret;
-	const EVP_CIPHER *cipher;
-
-	if (iv_bit_len == NULL || key_bit_len % 8 != 0)
-		return YACA_ERROR_INVALID_PARAMETER;
 
-	ret = encrypt_get_algorithm(algo, bcm, key_bit_len, &cipher);
+	ret = encrypt_ctx_init(c, cipher, lkey->bit_len);
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
+	/* CCM takes both lengths into the key setup, they can't change later.
+	 * The IV length is only set when it differs from the default, exactly
+	 * as in encrypt_ctx_setup_iv(), so that the contexts open what the
+	 * batch seals and the other way round.
+	 */
 	ret = EVP_CIPHER_iv_length(cipher);
 	if (ret < 0) {
 		ret = YACA_ERROR_INTERNAL;
@@ -1193,80 +2960,148 @@ API int yaca_encrypt_get_iv_bit_length(yaca_encrypt_algorithm_e algo,
 		return ret;
 	}
 
-	*iv_bit_len = ret * 8;
+	if (iv_len != (size_t)ret &&
+	    EVP_CIPHER_CTX_ctrl(c->cipher_ctx, mode == EVP_CIPH_GCM_MODE ?
+	                        EVP_CTRL_GCM_SET_IVLEN : EVP_CTRL_CCM_SET_IVLEN,
+	                        iv_len, NULL) != 1)
+		return ERROR_HANDLE();
+
+	if (mode == EVP_CIPH_CCM_MODE &&
+	    EVP_CIPHER_CTX_ctrl(c->cipher_ctx, EVP_CTRL_CCM_SET_TAG, tag_len, NULL) != 1)
+		return ERROR_HANDLE();
+
+	/* The key without a nonce, every record sets its own in aead_batch_range() */
+	ret = EVP_CipherInit_ex(c->cipher_ctx, NULL, NULL, (const unsigned char *)lkey->d,
+	                        NULL, -1);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	c->tag_len = tag_len;
 	return YACA_ERROR_NONE;
 }
 
-API int yaca_encrypt_initialize(yaca_context_h *ctx,
-                                yaca_encrypt_algorithm_e algo,
-                                yaca_block_cipher_mode_e bcm,
-                                const yaca_key_h sym_key,
-                                const yaca_key_h iv)
+static int aead_batch_run(yaca_encrypt_algorithm_e algo,
+                          yaca_block_cipher_mode_e bcm,
+                          const yaca_key_h sym_key,
+                          size_t iv_len,
+                          size_t tag_len,
+                          yaca_aead_record_s *records,
+                          size_t count,
+                          size_t threads,
+                          enum encrypt_op_type_e op_type)
 {
 	int ret;
+	struct yaca_encrypt_context_s *c = NULL;
 	const EVP_CIPHER *cipher;
-	struct yaca_key_simple_s *key = key_get_simple(sym_key);
+	const struct yaca_key_simple_s *lkey = key_get_simple(sym_key);
+	int mode;
+	size_t total_len = 0;
 
-	if (key == NULL)
+	if (lkey == NULL || lkey->key.type != YACA_KEY_TYPE_SYMMETRIC ||
+	    records == NULL || count == 0 || threads > PARALLEL_MAX_THREADS ||
+	    iv_len > INT_MAX)
 		return YACA_ERROR_INVALID_PARAMETER;
 
-	ret = encrypt_get_algorithm(algo, bcm, key->bit_len, &cipher);
-	if (ret != YACA_ERROR_NONE)
-		return ret;
+	if (bcm == YACA_BCM_GCM)
+		mode = EVP_CIPH_GCM_MODE;
+	else if (bcm == YACA_BCM_CCM)
+		mode = EVP_CIPH_CCM_MODE;
+	else if (bcm == YACA_BCM_SIV)
+		mode = EVP_CIPH_CTR_MODE;
+	else
+		return YACA_ERROR_INVALID_PARAMETER;
 
-	return encrypt_initialize(ctx, cipher, sym_key, iv, OP_ENCRYPT);
-}
+	/* SIV has no IV of its own */
+	if (mode == EVP_CIPH_CTR_MODE) {
+		if (iv_len != 0 || tag_len != SIV_BLOCK)
+			return YACA_ERROR_INVALID_PARAMETER;
+	} else if (iv_len == 0 || !is_valid_tag_len(mode, tag_len) ||
+	           (mode == EVP_CIPH_CCM_MODE && (iv_len < 7 || iv_len > 13))) {
+		return YACA_ERROR_INVALID_PARAMETER;
+	}
 
-API int yaca_encrypt_update(yaca_context_h ctx,
-                            const char *plaintext,
-                            size_t plaintext_len,
-                            char *ciphertext,
-                            size_t *ciphertext_len)
-{
-	return encrypt_update(ctx, (const unsigned char*)plaintext, plaintext_len,
-	                      (unsigned char*)ciphertext, ciphertext_len, OP_ENCRYPT);
-}
+	for (size_t i = 0; i < count; ++i) {
+		const yaca_aead_record_s *r = &records[i];
 
-API int yaca_encrypt_finalize(yaca_context_h ctx,
-                              char *ciphertext,
-                              size_t *ciphertext_len)
-{
-	return encrypt_finalize(ctx, (unsigned char*)ciphertext, ciphertext_len, OP_ENCRYPT);
-}
+		if ((r->iv == NULL && iv_len > 0) || r->input == NULL || r->input_len == 0 ||
+		    r->input_len > INT_MAX || r->output == NULL || r->tag == NULL ||
+		    r->aad_len > INT_MAX || (r->aad == NULL && r->aad_len > 0))
+			return YACA_ERROR_INVALID_PARAMETER;
 
-API int yaca_decrypt_initialize(yaca_context_h *ctx,
-                                yaca_encrypt_algorithm_e algo,
-                                yaca_block_cipher_mode_e bcm,
-                                const yaca_key_h sym_key,
-                                const yaca_key_h iv)
-{
-	int ret;
-	const EVP_CIPHER *cipher;
-	struct yaca_key_simple_s *key = key_get_simple(sym_key);
+		/* Either exactly the same buffer or no overlap at all */
+		if (r->output != r->input &&
+		    r->output < r->input + r->input_len && r->input < r->output + r->input_len)
+			return YACA_ERROR_INVALID_PARAMETER;
 
-	if (key == NULL)
-		return YACA_ERROR_INVALID_PARAMETER;
+		total_len += r->input_len;
+	}
 
-	ret = encrypt_get_algorithm(algo, bcm, key->bit_len, &cipher);
+	ret = encrypt_get_algorithm(algo, bcm, lkey->bit_len, &cipher);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = encrypt_ctx_create(&c, op_type, cipher);
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
-	return encrypt_initialize(ctx, cipher, sym_key, iv, OP_DECRYPT);
+	if (mode == EVP_CIPH_CTR_MODE) {
+		ret = encrypt_ctx_init(c, cipher, lkey->bit_len / 2);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = encrypt_ctx_setup_siv(c, lkey, YACA_KEY_NULL);
+	} else {
+		ret = aead_batch_setup(c, cipher, lkey, mode, iv_len, tag_len);
+	}
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	c->algo = algo;
+	c->bcm = bcm;
+	stats_context_initialized(YACA_STATS_CONTEXT_ENCRYPT);
+
+	ret = batch_run(c, mode == EVP_CIPH_CTR_MODE ? siv_batch_range : aead_batch_range,
+	                records, count, threads);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	stats_context_updated(YACA_STATS_CONTEXT_ENCRYPT);
+	stats_cipher_bytes(algo, total_len);
+
+	for (size_t i = 0; i < count; ++i)
+		if (records[i].result != YACA_ERROR_NONE)
+			ret = YACA_ERROR_INVALID_PARAMETER;
+
+exit:
+	yaca_context_destroy((yaca_context_h)c);
+	return ret;
 }
 
-API int yaca_decrypt_update(yaca_context_h ctx,
-                            const char *ciphertext,
-                            size_t ciphertext_len,
-                            char *plaintext,
-                            size_t *plaintext_len)
+API int yaca_encrypt_aead_batch(yaca_encrypt_algorithm_e algo,
+                                yaca_block_cipher_mode_e bcm,
+                                const yaca_key_h sym_key,
+                                size_t iv_len,
+                                size_t tag_len,
+                                yaca_aead_record_s *records,
+                                size_t count,
+                                size_t threads)
 {
-	return encrypt_update(ctx, (const unsigned char*)ciphertext, ciphertext_len,
-	                      (unsigned char*)plaintext, plaintext_len, OP_DECRYPT);
+	return aead_batch_run(algo, bcm, sym_key, iv_len, tag_len, records, count, threads,
+	                      OP_ENCRYPT);
 }
 
-API int yaca_decrypt_finalize(yaca_context_h ctx,
-                              char *plaintext,
-                              size_t *plaintext_len)
+API int yaca_decrypt_aead_batch(yaca_encrypt_algorithm_e algo,
+                                yaca_block_cipher_mode_e bcm,
+                                const yaca_key_h sym_key,
+                                size_t iv_len,
+                                size_t tag_len,
+                                yaca_aead_record_s *records,
+                                size_t count,
+                                size_t threads)
 {
-	return encrypt_finalize(ctx, (unsigned char*)plaintext, plaintext_len, OP_DECRYPT);
+	return aead_batch_run(algo, bcm, sym_key, iv_len, tag_len, records, count, threads,
+	                      OP_DECRYPT);
 }
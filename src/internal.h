@@ -41,12 +41,23 @@
 #define API __attribute__ ((visibility("default")))
 #define UNUSED __attribute__((unused))
 
+/* Stores a lazily built object in a slot that is still NULL, the acquire
+ * loads of the slot then see it complete. False if another thread stored
+ * its own first, the caller frees the one it built and uses the slot's.
+ */
+#define PUBLISH_ONCE(slot, obj) __extension__ ({ \
+	__typeof__(*(slot)) publish_expected_ = NULL; \
+	__atomic_compare_exchange_n((slot), &publish_expected_, (obj), false, \
+	                            __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE); \
+})
+
 
 enum yaca_context_type_e {
 	YACA_CONTEXT_INVALID = 0,
 	YACA_CONTEXT_DIGEST,
 	YACA_CONTEXT_SIGN,
-	YACA_CONTEXT_ENCRYPT
+	YACA_CONTEXT_ENCRYPT,
+	YACA_CONTEXT_DERIVE_DH
 };
 
 enum encrypt_op_type_e {
@@ -64,8 +75,9 @@ struct yaca_context_s {
 	int (*get_output_length)(const yaca_context_h ctx, size_t input_len, size_t *output_len);
 	int (*set_property)(yaca_context_h ctx, yaca_property_e property,
 	                    const void *value, size_t value_len);
+	/* Writes into the caller's buffer, with value == NULL only sets value_len */
 	int (*get_property)(const yaca_context_h ctx, yaca_property_e property,
-	                    void **value, size_t *value_len);
+	                    void *value, size_t value_capacity, size_t *value_len);
 };
 
 enum context_state_e {
@@ -110,16 +122,41 @@ struct yaca_key_evp_s {
 	struct yaca_key_s key;
 
 	EVP_PKEY *evp;
+	/* Set by yaca_verify_prepare_key(), shared with the verify contexts */
+	struct yaca_verify_cache_s *verify_cache;
+	/* Set by yaca_sign_prepare_key(), copies of an RSA private key */
+	struct yaca_key_pool_s *pool;
+};
+
+/* A copy of the key taken from its pool for one operation, or the key
+ * itself when it has no pool or all of the copies are taken
+ */
+struct key_lease_s {
+	struct yaca_key_pool_s *pool;
+	unsigned slot;
+	EVP_PKEY *evp;
 };
 
 int digest_get_algorithm(yaca_digest_algorithm_e algo, const EVP_MD **md);
 
+#if OPENSSL_VERSION_NUMBER >= 0x30000000L
+/* Fetch the digests/ciphers once from the default library context in
+ * yaca_initialize(), they are returned by *_get_algorithm() afterwards.
+ */
+void digest_prefetch(void);
+void digest_release(void);
+void encrypt_prefetch(void);
+void encrypt_release(void);
+#endif
+
 int encrypt_get_algorithm(yaca_encrypt_algorithm_e algo,
                           yaca_block_cipher_mode_e bcm,
                           size_t key_bit_len,
                           const EVP_CIPHER **cipher);
 
 int encrypt_initialize(yaca_context_h *ctx,
+                       yaca_encrypt_algorithm_e algo,
+                       yaca_block_cipher_mode_e bcm,
                        const EVP_CIPHER *cipher,
                        const yaca_key_h sym_key,
                        const yaca_key_h iv,
@@ -135,9 +172,36 @@ int encrypt_finalize(yaca_context_h ctx,
                      enum encrypt_op_type_e op_type);
 
 struct yaca_key_simple_s *key_get_simple(const yaca_key_h key);
+/* Frees what the key functions keep between the calls, by yaca_cleanup() */
+void key_release(void);
 struct yaca_key_evp_s *key_get_evp(const yaca_key_h key);
 
+/* Up to 64 warmed up copies of an RSA private key, a no-op if there are some */
+int key_pool_create(struct yaca_key_evp_s *key, size_t count);
+void key_pool_unref(struct yaca_key_pool_s *pool);
+void key_lease_acquire(const struct yaca_key_evp_s *key, struct key_lease_s *lease);
+void key_lease_release(struct key_lease_s *lease);
+
 int rsa_padding2openssl(yaca_padding_e padding);
+/* One private operation, sets up what OpenSSL caches in the RSA key */
+int rsa_warm_up(EVP_PKEY *evp);
+
+void verify_cache_unref(struct yaca_verify_cache_s *cache);
+
+/* Upper bound for the threads argument of the batch functions */
+#define PARALLEL_MAX_THREADS 64
+
+/* Processes the items [first, last) of a batch. The slice is the index of
+ * the thread, below parallel_threads(), for the contexts of each thread.
+ */
+typedef int (*parallel_range_fn)(void *arg, size_t slice, size_t first, size_t last);
+/* Number of the slices the items are split into, 1 for threads == 0 */
+size_t parallel_threads(size_t count, size_t threads);
+/* Runs slice 0 on the calling thread and the others on threads of their
+ * own, the first error is returned. The error records of the other threads
+ * are moved to the calling one.
+ */
+int parallel_run(parallel_range_fn range, void *arg, size_t count, size_t threads);
 
 
 #endif /* YACA_INTERNAL_H */
@@ -33,6 +33,8 @@
 #include <openssl/pem.h>
 #include <openssl/des.h>
 #include <openssl/dh.h>
+#include <openssl/ec.h>
+#include <openssl/hmac.h>
 
 #include <yaca_crypto.h>
 #include <yaca_error.h>
@@ -40,6 +42,7 @@
 #include <yaca_types.h>
 
 #include "internal.h"
+#include "trace.h"
 
 #ifdef OPENSSL_MOCKUP_TESTS
 #include "../tests/openssl_mock_redefine.h"
@@ -152,24 +155,58 @@ static const struct {
 
 static const size_t EC_NID_PAIRS_SIZE = sizeof(EC_NID_PAIRS) / sizeof(EC_NID_PAIRS[0]);
 
+/* Groups of the EC_NID_PAIRS curves for the raw imports. Building a group
+ * from the curve data costs more than the import itself, they are created
+ * on first use, copied into the keys and freed by yaca_cleanup().
+ */
+static EC_GROUP *ec_groups[sizeof(EC_NID_PAIRS) / sizeof(EC_NID_PAIRS[0])];
+
+enum key_types_row_e {
+	KEY_TYPES_ROW_RSA,
+	KEY_TYPES_ROW_DSA,
+	KEY_TYPES_ROW_DH,
+	KEY_TYPES_ROW_EC,
+	KEY_TYPES_ROW_DHX,
+};
+
 static const struct {
 	int evp_id;
 	yaca_key_type_e priv;
 	yaca_key_type_e pub;
 	yaca_key_type_e params;
 } KEY_TYPES_PARAMS[] = {
-	{EVP_PKEY_RSA, YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_TYPE_RSA_PUB, -1},
-	{EVP_PKEY_DSA, YACA_KEY_TYPE_DSA_PRIV, YACA_KEY_TYPE_DSA_PUB, YACA_KEY_TYPE_DSA_PARAMS},
-	{EVP_PKEY_DH,  YACA_KEY_TYPE_DH_PRIV,  YACA_KEY_TYPE_DH_PUB,  YACA_KEY_TYPE_DH_PARAMS},
-	{EVP_PKEY_EC,  YACA_KEY_TYPE_EC_PRIV,  YACA_KEY_TYPE_EC_PUB,  YACA_KEY_TYPE_EC_PARAMS},
+	[KEY_TYPES_ROW_RSA] = {EVP_PKEY_RSA, YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_TYPE_RSA_PUB, -1},
+	[KEY_TYPES_ROW_DSA] = {EVP_PKEY_DSA, YACA_KEY_TYPE_DSA_PRIV, YACA_KEY_TYPE_DSA_PUB, YACA_KEY_TYPE_DSA_PARAMS},
+	[KEY_TYPES_ROW_DH]  = {EVP_PKEY_DH,  YACA_KEY_TYPE_DH_PRIV,  YACA_KEY_TYPE_DH_PUB,  YACA_KEY_TYPE_DH_PARAMS},
+	[KEY_TYPES_ROW_EC]  = {EVP_PKEY_EC,  YACA_KEY_TYPE_EC_PRIV,  YACA_KEY_TYPE_EC_PUB,  YACA_KEY_TYPE_EC_PARAMS},
 	/* The following line is only used to import DHX (RFC5114) keys/params.
-	 * In all other cases DH is used. It has to be below the DH one so conversions from YACA
-	 * internal types are prioritized to EVP_PKEY_DH which is what we want. */
-	{EVP_PKEY_DHX, YACA_KEY_TYPE_DH_PRIV,  YACA_KEY_TYPE_DH_PUB,  YACA_KEY_TYPE_DH_PARAMS}
+	 * In all other cases DH is used. KEY_TYPES_ROWS never points at it so conversions from
+	 * YACA internal types are resolved to EVP_PKEY_DH which is what we want. */
+	[KEY_TYPES_ROW_DHX] = {EVP_PKEY_DHX, YACA_KEY_TYPE_DH_PRIV,  YACA_KEY_TYPE_DH_PUB,  YACA_KEY_TYPE_DH_PARAMS}
 };
 
 static const size_t KEY_TYPES_PARAMS_SIZE = sizeof(KEY_TYPES_PARAMS) / sizeof(KEY_TYPES_PARAMS[0]);
 
+#define KEY_TYPES_COUNT (YACA_KEY_TYPE_EC_PARAMS + 1)
+
+/* KEY_TYPES_PARAMS row of every yaca_key_type_e, -1 for the symmetric ones */
+static const int KEY_TYPES_ROWS[KEY_TYPES_COUNT] = {
+	[YACA_KEY_TYPE_SYMMETRIC]  = -1,
+	[YACA_KEY_TYPE_DES]        = -1,
+	[YACA_KEY_TYPE_IV]         = -1,
+	[YACA_KEY_TYPE_RSA_PUB]    = KEY_TYPES_ROW_RSA,
+	[YACA_KEY_TYPE_RSA_PRIV]   = KEY_TYPES_ROW_RSA,
+	[YACA_KEY_TYPE_DSA_PUB]    = KEY_TYPES_ROW_DSA,
+	[YACA_KEY_TYPE_DSA_PRIV]   = KEY_TYPES_ROW_DSA,
+	[YACA_KEY_TYPE_DSA_PARAMS] = KEY_TYPES_ROW_DSA,
+	[YACA_KEY_TYPE_DH_PUB]     = KEY_TYPES_ROW_DH,
+	[YACA_KEY_TYPE_DH_PRIV]    = KEY_TYPES_ROW_DH,
+	[YACA_KEY_TYPE_DH_PARAMS]  = KEY_TYPES_ROW_DH,
+	[YACA_KEY_TYPE_EC_PUB]     = KEY_TYPES_ROW_EC,
+	[YACA_KEY_TYPE_EC_PRIV]    = KEY_TYPES_ROW_EC,
+	[YACA_KEY_TYPE_EC_PARAMS]  = KEY_TYPES_ROW_EC,
+};
+
 #define CONVERT_TYPES_TEMPLATE(data, src_type, src, dst_type, dst) \
 	static int convert_##src##_to_##dst(src_type src, dst_type *dst) \
 	{ \
@@ -185,18 +222,34 @@ static const size_t KEY_TYPES_PARAMS_SIZE = sizeof(KEY_TYPES_PARAMS) / sizeof(KE
 		return YACA_ERROR_INVALID_PARAMETER; \
 	}
 
+/* Same as above for the yaca_key_type_e sources, looked up directly */
+#define CONVERT_KEY_TYPES_TEMPLATE(src, dst_type, dst) \
+	static int convert_##src##_to_##dst(yaca_key_type_e src, dst_type *dst) \
+	{ \
+		assert(dst != NULL); \
+		int row; \
+		if ((unsigned)src >= KEY_TYPES_COUNT) \
+			return YACA_ERROR_INVALID_PARAMETER; \
+		row = KEY_TYPES_ROWS[src]; \
+		if (row < 0 || KEY_TYPES_PARAMS[row].src != src || \
+		    KEY_TYPES_PARAMS[row].dst == (dst_type)-1) \
+			return YACA_ERROR_INVALID_PARAMETER; \
+		*dst = KEY_TYPES_PARAMS[row].dst; \
+		return YACA_ERROR_NONE; \
+	}
+
 CONVERT_TYPES_TEMPLATE(EC_NID_PAIRS, int, nid, size_t, ec)
 CONVERT_TYPES_TEMPLATE(EC_NID_PAIRS, size_t, ec, int, nid)
 
-CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, yaca_key_type_e, params, int, evp_id)
-CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, yaca_key_type_e, priv,   int, evp_id)
-CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, yaca_key_type_e, params, yaca_key_type_e, priv)
-CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, yaca_key_type_e, priv,   yaca_key_type_e, pub)
-CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, yaca_key_type_e, priv,   yaca_key_type_e, params)
-CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, yaca_key_type_e, pub,    yaca_key_type_e, params)
-CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, int, evp_id,             yaca_key_type_e, priv)
-CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, int, evp_id,             yaca_key_type_e, pub)
-CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, int, evp_id,             yaca_key_type_e, params)
+CONVERT_KEY_TYPES_TEMPLATE(params, int, evp_id)
+CONVERT_KEY_TYPES_TEMPLATE(priv,   int, evp_id)
+CONVERT_KEY_TYPES_TEMPLATE(params, yaca_key_type_e, priv)
+CONVERT_KEY_TYPES_TEMPLATE(priv,   yaca_key_type_e, pub)
+CONVERT_KEY_TYPES_TEMPLATE(priv,   yaca_key_type_e, params)
+CONVERT_KEY_TYPES_TEMPLATE(pub,    yaca_key_type_e, params)
+CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, int, evp_id, yaca_key_type_e, priv)
+CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, int, evp_id, yaca_key_type_e, pub)
+CONVERT_TYPES_TEMPLATE(KEY_TYPES_PARAMS, int, evp_id, yaca_key_type_e, params)
 
 static int base64_decode_length(const char *data, size_t data_len, size_t *len)
 {
@@ -1088,6 +1141,80 @@ exit:
 	return ret;
 }
 
+static int export_ec_raw(struct yaca_key_evp_s *evp_key,
+                         yaca_key_format_e key_fmt,
+                         char **data,
+                         size_t *data_len)
+{
+	assert(evp_key != NULL);
+	assert(data != NULL);
+	assert(data_len != NULL);
+
+	int ret;
+	const EC_KEY *eck = EVP_PKEY_get0(evp_key->evp);
+	const EC_GROUP *ecg;
+	point_conversion_form_t form = POINT_CONVERSION_UNCOMPRESSED;
+	char *out = NULL;
+	size_t out_len;
+
+	if (eck == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+	ecg = EC_KEY_get0_group(eck);
+
+	switch (key_fmt) {
+	case YACA_KEY_FORMAT_DEFAULT:
+		break;
+	case YACA_KEY_FORMAT_EC_COMPRESSED:
+		if (evp_key->key.type != YACA_KEY_TYPE_EC_PUB)
+			return YACA_ERROR_INVALID_PARAMETER;
+		form = POINT_CONVERSION_COMPRESSED;
+		break;
+	default:
+		return YACA_ERROR_INVALID_PARAMETER;
+	}
+
+	if (evp_key->key.type == YACA_KEY_TYPE_EC_PRIV)
+		out_len = (EC_GROUP_order_bits(ecg) + 7) / 8;
+	else
+		out_len = EC_POINT_point2oct(ecg, EC_KEY_get0_public_key(eck), form, NULL, 0, NULL);
+
+	if (out_len == 0) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	ret = yaca_malloc(out_len, (void**)&out);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	if (evp_key->key.type == YACA_KEY_TYPE_EC_PRIV)
+		ret = BN_bn2binpad(EC_KEY_get0_private_key(eck), (unsigned char*)out,
+		                   out_len) == (int)out_len;
+	else
+		ret = EC_POINT_point2oct(ecg, EC_KEY_get0_public_key(eck), form,
+		                         (unsigned char*)out, out_len, NULL) == out_len;
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	*data = out;
+	out = NULL;
+	*data_len = out_len;
+	ret = YACA_ERROR_NONE;
+
+exit:
+	if (out != NULL)
+		OPENSSL_cleanse(out, out_len);
+	yaca_free(out);
+	return ret;
+}
+
 static int generate_simple(struct yaca_key_simple_s **out, size_t key_bit_len)
 {
 	assert(out != NULL);
@@ -1593,6 +1720,166 @@ API int yaca_key_import(yaca_key_type_e key_type,
 	}
 }
 
+static int ec_group_get(size_t key_bit_len, const EC_GROUP **group)
+{
+	EC_GROUP *ecg;
+	size_t i;
+
+	for (i = 0; i < EC_NID_PAIRS_SIZE; ++i)
+		if (EC_NID_PAIRS[i].ec == key_bit_len)
+			break;
+	if (i == EC_NID_PAIRS_SIZE)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ecg = __atomic_load_n(&ec_groups[i], __ATOMIC_ACQUIRE);
+	if (ecg == NULL) {
+		ecg = EC_GROUP_new_by_curve_name(EC_NID_PAIRS[i].nid);
+		if (ecg == NULL) {
+			const int ret = YACA_ERROR_INTERNAL;
+			ERROR_DUMP(ret);
+			return ret;
+		}
+
+		if (!PUBLISH_ONCE(&ec_groups[i], ecg)) {
+			EC_GROUP_free(ecg);
+			ecg = __atomic_load_n(&ec_groups[i], __ATOMIC_ACQUIRE);
+		}
+	}
+
+	*group = ecg;
+	return YACA_ERROR_NONE;
+}
+
+void key_release(void)
+{
+	for (size_t i = 0; i < EC_NID_PAIRS_SIZE; ++i) {
+		EC_GROUP_free(ec_groups[i]);
+		ec_groups[i] = NULL;
+	}
+}
+
+/* Straight from the SEC1 encoding, without the BIO and ASN1 layers of import_evp() */
+static int import_ec_raw(yaca_key_type_e key_type,
+                         const EC_GROUP *group,
+                         const unsigned char *data,
+                         size_t data_len,
+                         yaca_key_h *key)
+{
+	int ret;
+	EC_KEY *eck = NULL;
+	const EC_GROUP *ecg;
+	EC_POINT *point = NULL;
+	BIGNUM *priv = NULL;
+	EVP_PKEY *pkey = NULL;
+	struct yaca_key_evp_s *nk = NULL;
+
+	eck = EC_KEY_new();
+	if (eck == NULL || EC_KEY_set_group(eck, group) != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+	ecg = EC_KEY_get0_group(eck);
+
+	point = EC_POINT_new(ecg);
+	if (point == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	if (key_type == YACA_KEY_TYPE_EC_PUB) {
+		/* checks that the point is on the curve */
+		if (EC_POINT_oct2point(ecg, point, data, data_len, NULL) != 1 ||
+		    EC_POINT_is_at_infinity(ecg, point)) {
+			ERROR_CLEAR();
+			ret = YACA_ERROR_INVALID_PARAMETER;
+			goto exit;
+		}
+	} else {
+		if (data_len != (size_t)(EC_GROUP_order_bits(ecg) + 7) / 8) {
+			ret = YACA_ERROR_INVALID_PARAMETER;
+			goto exit;
+		}
+
+		priv = BN_secure_new();
+		if (priv == NULL || BN_bin2bn(data, data_len, priv) == NULL) {
+			ret = YACA_ERROR_INTERNAL;
+			ERROR_DUMP(ret);
+			goto exit;
+		}
+
+		if (BN_is_zero(priv) || BN_cmp(priv, EC_GROUP_get0_order(ecg)) >= 0) {
+			ret = YACA_ERROR_INVALID_PARAMETER;
+			goto exit;
+		}
+
+		if (EC_KEY_set_private_key(eck, priv) != 1 ||
+		    EC_POINT_mul(ecg, point, priv, NULL, NULL, NULL) != 1) {
+			ret = YACA_ERROR_INTERNAL;
+			ERROR_DUMP(ret);
+			goto exit;
+		}
+	}
+
+	if (EC_KEY_set_public_key(eck, point) != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	pkey = EVP_PKEY_new();
+	if (pkey == NULL || EVP_PKEY_assign_EC_KEY(pkey, eck) != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+	eck = NULL;
+
+	ret = yaca_zalloc(sizeof(struct yaca_key_evp_s), (void**)&nk);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	nk->key.type = key_type;
+	nk->evp = pkey;
+	pkey = NULL;
+
+	*key = (yaca_key_h)nk;
+	ret = YACA_ERROR_NONE;
+
+exit:
+	EVP_PKEY_free(pkey);
+	BN_clear_free(priv);
+	EC_POINT_free(point);
+	EC_KEY_free(eck);
+	return ret;
+}
+
+API int yaca_key_import_raw(yaca_key_type_e key_type,
+                            size_t key_bit_len,
+                            const char *data,
+                            size_t data_len,
+                            yaca_key_h *key)
+{
+	int ret;
+	const EC_GROUP *group;
+
+	if (key == NULL || data == NULL || data_len == 0)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	switch (key_type) {
+	case YACA_KEY_TYPE_EC_PUB:
+	case YACA_KEY_TYPE_EC_PRIV:
+		ret = ec_group_get(key_bit_len, &group);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+
+		return import_ec_raw(key_type, group, (const unsigned char*)data, data_len, key);
+	default:
+		return YACA_ERROR_INVALID_PARAMETER;
+	}
+}
+
 API int yaca_key_export(const yaca_key_h key,
                         yaca_key_format_e key_fmt,
                         yaca_key_file_format_e key_file_fmt,
@@ -1623,6 +1910,11 @@ API int yaca_key_export(const yaca_key_h key,
 	    simple_key != NULL)
 		return export_simple_base64(simple_key, data, data_len);
 
+	if (key_file_fmt == YACA_KEY_FILE_FORMAT_RAW && password == NULL && evp_key != NULL &&
+	    (evp_key->key.type == YACA_KEY_TYPE_EC_PUB ||
+	     evp_key->key.type == YACA_KEY_TYPE_EC_PRIV))
+		return export_ec_raw(evp_key, key_fmt, data, data_len);
+
 	if (evp_key != NULL)
 		return export_evp(evp_key, key_fmt, key_file_fmt,
 		                  password, data, data_len);
@@ -1641,6 +1933,8 @@ API int yaca_key_generate(yaca_key_type_e key_type,
 	if (key == NULL || key_bit_len == 0)
 		return YACA_ERROR_INVALID_PARAMETER;
 
+	TRACE(key__generate__entry, key_type, key_bit_len);
+
 	switch (key_type) {
 	case YACA_KEY_TYPE_SYMMETRIC:
 	case YACA_KEY_TYPE_IV:
@@ -1659,9 +1953,12 @@ API int yaca_key_generate(yaca_key_type_e key_type,
 		ret = generate_evp(key_type, key_bit_len, NULL, &nk_evp);
 		break;
 	default:
-		return YACA_ERROR_INVALID_PARAMETER;
+		ret = YACA_ERROR_INVALID_PARAMETER;
+		break;
 	}
 
+	TRACE(key__generate__return, key_type, key_bit_len, ret);
+
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
@@ -1696,7 +1993,12 @@ API int yaca_key_generate_from_parameters(const yaca_key_h params, yaca_key_h *p
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
+	TRACE(key__generate__entry, key_type, 0);
+
 	ret = generate_evp(key_type, 0, evp_params, &nk_evp);
+
+	TRACE(key__generate__return, key_type, 0, ret);
+
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
@@ -1834,6 +2136,143 @@ exit:
 	return ret;
 }
 
+#define KEY_POOL_MAX 64
+
+/* Private copies of an RSA key, so that the concurrent operations don't
+ * share (and lock) the blinding of a single RSA object.
+ */
+struct yaca_key_pool_s {
+	int refs;
+
+	/* bit i is set when copies[i] is not leased */
+	uint64_t free;
+	size_t count;
+	EVP_PKEY *copies[KEY_POOL_MAX];
+};
+
+void key_pool_unref(struct yaca_key_pool_s *pool)
+{
+	if (pool == NULL || __atomic_sub_fetch(&pool->refs, 1, __ATOMIC_ACQ_REL) > 0)
+		return;
+
+	for (size_t i = 0; i < pool->count; ++i)
+		EVP_PKEY_free(pool->copies[i]);
+	yaca_free(pool);
+}
+
+static int key_pool_copy(EVP_PKEY *evp, EVP_PKEY **copy)
+{
+	int ret;
+	RSA *rsa = NULL;
+	EVP_PKEY *pkey = NULL;
+
+	rsa = RSAPrivateKey_dup(EVP_PKEY_get0_RSA(evp));
+	if (rsa == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	pkey = EVP_PKEY_new();
+	if (pkey == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	ret = EVP_PKEY_assign_RSA(pkey, rsa);
+	if (ret != 1) {
+		ret = ERROR_HANDLE();
+		goto exit;
+	}
+	rsa = NULL;
+
+	ret = rsa_warm_up(pkey);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	*copy = pkey;
+	pkey = NULL;
+
+exit:
+	EVP_PKEY_free(pkey);
+	RSA_free(rsa);
+	return ret;
+}
+
+int key_pool_create(struct yaca_key_evp_s *key, size_t count)
+{
+	int ret;
+	struct yaca_key_pool_s *pool = NULL;
+
+	assert(key != NULL && key->key.type == YACA_KEY_TYPE_RSA_PRIV);
+
+	if (count > KEY_POOL_MAX)
+		count = KEY_POOL_MAX;
+
+	if (__atomic_load_n(&key->pool, __ATOMIC_ACQUIRE) != NULL)
+		return YACA_ERROR_NONE;
+
+	ret = yaca_zalloc(sizeof(struct yaca_key_pool_s), (void**)&pool);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	pool->refs = 1;
+	for (; pool->count < count; ++pool->count) {
+		ret = key_pool_copy(key->evp, &pool->copies[pool->count]);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+	pool->free = count == KEY_POOL_MAX ? UINT64_MAX : (UINT64_C(1) << count) - 1;
+
+	if (PUBLISH_ONCE(&key->pool, pool))
+		pool = NULL;
+
+	ret = YACA_ERROR_NONE;
+
+exit:
+	key_pool_unref(pool);
+	return ret;
+}
+
+void key_lease_acquire(const struct yaca_key_evp_s *key, struct key_lease_s *lease)
+{
+	struct yaca_key_pool_s *pool = __atomic_load_n(&key->pool, __ATOMIC_ACQUIRE);
+	uint64_t free;
+	unsigned slot;
+
+	lease->pool = NULL;
+	lease->evp = key->evp;
+
+	if (pool == NULL)
+		return;
+
+	free = __atomic_load_n(&pool->free, __ATOMIC_RELAXED);
+	do {
+		/* all of them are leased, share the key itself */
+		if (free == 0)
+			return;
+		slot = __builtin_ctzll(free);
+	} while (!__atomic_compare_exchange_n(&pool->free, &free, free & ~(UINT64_C(1) << slot),
+	                                      true, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED));
+
+	__atomic_add_fetch(&pool->refs, 1, __ATOMIC_RELAXED);
+	lease->pool = pool;
+	lease->slot = slot;
+	lease->evp = pool->copies[slot];
+}
+
+void key_lease_release(struct key_lease_s *lease)
+{
+	if (lease->pool == NULL)
+		return;
+
+	__atomic_or_fetch(&lease->pool->free, UINT64_C(1) << lease->slot, __ATOMIC_RELEASE);
+	key_pool_unref(lease->pool);
+	lease->pool = NULL;
+	lease->evp = NULL;
+}
+
 API void yaca_key_destroy(yaca_key_h key)
 {
 	struct yaca_key_simple_s *simple_key = key_get_simple(key);
@@ -1845,6 +2284,8 @@ API void yaca_key_destroy(yaca_key_h key)
 	}
 
 	if (evp_key != NULL) {
+		verify_cache_unref(evp_key->verify_cache);
+		key_pool_unref(evp_key->pool);
 		EVP_PKEY_free(evp_key->evp);
 		yaca_free(evp_key);
 	}
@@ -1925,6 +2366,207 @@ exit:
 	return ret;
 }
 
+/* A private key prepared for derivation against many peers */
+struct yaca_derive_dh_context_s {
+	struct yaca_context_s ctx;
+
+	yaca_key_type_e pub_type;
+	size_t secret_len;
+	/* [0] is derive_init()-ed once, the others are its copies for the
+	 * batch workers, made when first needed and kept for the next batches
+	 */
+	EVP_PKEY_CTX *pkey_ctx[PARALLEL_MAX_THREADS];
+};
+
+struct derive_dh_batch {
+	const struct yaca_derive_dh_context_s *c;
+	const yaca_key_h *pub_keys;
+	char *const *secrets;
+	size_t *secret_lens;
+};
+
+static struct yaca_derive_dh_context_s *get_derive_dh_context(const yaca_context_h ctx)
+{
+	if (ctx == YACA_CONTEXT_NULL)
+		return NULL;
+
+	switch (ctx->type) {
+	case YACA_CONTEXT_DERIVE_DH:
+		return (struct yaca_derive_dh_context_s *)ctx;
+	default:
+		return NULL;
+	}
+}
+
+static int get_derive_dh_output_length(const yaca_context_h ctx,
+                                       size_t input_len,
+                                       size_t *output_len)
+{
+	assert(output_len != NULL);
+
+	struct yaca_derive_dh_context_s *c = get_derive_dh_context(ctx);
+	assert(c != NULL);
+
+	if (input_len != 0)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	*output_len = c->secret_len;
+	return YACA_ERROR_NONE;
+}
+
+static void destroy_derive_dh_context(yaca_context_h ctx)
+{
+	struct yaca_derive_dh_context_s *c = get_derive_dh_context(ctx);
+	assert(c != NULL);
+
+	for (size_t i = 0; i < PARALLEL_MAX_THREADS; ++i) {
+		EVP_PKEY_CTX_free(c->pkey_ctx[i]);
+		c->pkey_ctx[i] = NULL;
+	}
+}
+
+static int derive_dh_one(EVP_PKEY_CTX *pkey_ctx, const struct yaca_derive_dh_context_s *c,
+                         const yaca_key_h pub_key, char *secret, size_t *secret_len)
+{
+	int ret;
+	struct yaca_key_evp_s *lpub_key = key_get_evp(pub_key);
+	size_t len = c->secret_len;
+
+	if (lpub_key == NULL || lpub_key->key.type != c->pub_type || secret == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	/* replaces the previous peer */
+	ret = EVP_PKEY_derive_set_peer(pkey_ctx, lpub_key->evp);
+	if (ret != 1)
+		return ERROR_HANDLE();
+
+	ret = EVP_PKEY_derive(pkey_ctx, (unsigned char*)secret, &len);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+
+	*secret_len = len;
+	return YACA_ERROR_NONE;
+}
+
+static int derive_dh_batch_range(void *arg, size_t slice, size_t first, size_t last)
+{
+	const struct derive_dh_batch *b = arg;
+	int ret = YACA_ERROR_NONE;
+
+	for (size_t i = first; i < last && ret == YACA_ERROR_NONE; ++i)
+		ret = derive_dh_one(b->c->pkey_ctx[slice], b->c, b->pub_keys[i], b->secrets[i],
+		                    &b->secret_lens[i]);
+
+	return ret;
+}
+
+API int yaca_key_derive_dh_initialize(yaca_context_h *ctx, const yaca_key_h prv_key)
+{
+	int ret;
+	struct yaca_derive_dh_context_s *nc = NULL;
+	struct yaca_key_evp_s *lprv_key = key_get_evp(prv_key);
+	EVP_PKEY_CTX *pkey_ctx;
+
+	if (ctx == NULL || lprv_key == NULL ||
+	    (lprv_key->key.type != YACA_KEY_TYPE_DH_PRIV &&
+	     lprv_key->key.type != YACA_KEY_TYPE_EC_PRIV))
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = yaca_zalloc(sizeof(struct yaca_derive_dh_context_s), (void**)&nc);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	nc->ctx.type = YACA_CONTEXT_DERIVE_DH;
+	nc->ctx.context_destroy = destroy_derive_dh_context;
+	nc->ctx.get_output_length = get_derive_dh_output_length;
+	nc->ctx.set_property = NULL;
+	nc->ctx.get_property = NULL;
+	nc->pub_type = lprv_key->key.type == YACA_KEY_TYPE_DH_PRIV ?
+	               YACA_KEY_TYPE_DH_PUB : YACA_KEY_TYPE_EC_PUB;
+
+	/* Holds a reference to the key, it may be destroyed afterwards */
+	pkey_ctx = nc->pkey_ctx[0] = EVP_PKEY_CTX_new(lprv_key->evp, NULL);
+	if (pkey_ctx == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	ret = EVP_PKEY_derive_init(pkey_ctx);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	/* The size query needs a peer, the key's own public part will do.
+	 * Nothing is derived, it's only the length of the group's elements.
+	 */
+	ret = EVP_PKEY_derive_set_peer(pkey_ctx, lprv_key->evp);
+	if (ret != 1) {
+		ret = ERROR_HANDLE();
+		goto exit;
+	}
+
+	ret = EVP_PKEY_derive(pkey_ctx, NULL, &nc->secret_len);
+	if (ret != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	if (nc->secret_len == 0 || nc->secret_len > SIZE_MAX / 8) {
+		ret = YACA_ERROR_INTERNAL;
+		goto exit;
+	}
+
+	*ctx = (yaca_context_h)nc;
+	nc = NULL;
+	ret = YACA_ERROR_NONE;
+
+exit:
+	yaca_context_destroy((yaca_context_h)nc);
+	return ret;
+}
+
+API int yaca_key_derive_dh_batch(const yaca_context_h ctx,
+                                 const yaca_key_h *pub_keys,
+                                 size_t count,
+                                 char *const *secrets,
+                                 size_t *secret_lens,
+                                 size_t threads)
+{
+	int ret;
+	struct yaca_derive_dh_context_s *c = get_derive_dh_context(ctx);
+	struct derive_dh_batch batch = {c, pub_keys, secrets, secret_lens};
+	size_t slices;
+
+	if (c == NULL || pub_keys == NULL || count == 0 || secrets == NULL ||
+	    secret_lens == NULL || threads > PARALLEL_MAX_THREADS)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	/* Slice 0 derives with pkey_ctx[0], it is duplicated while no thread uses
+	 * it. The duplicates stay in the context for the next batch.
+	 */
+	slices = parallel_threads(count, threads);
+	for (size_t t = 1; t < slices; ++t) {
+		if (c->pkey_ctx[t] != NULL)
+			continue;
+
+		c->pkey_ctx[t] = EVP_PKEY_CTX_dup(c->pkey_ctx[0]);
+		if (c->pkey_ctx[t] == NULL) {
+			ret = YACA_ERROR_INTERNAL;
+			ERROR_DUMP(ret);
+			return ret;
+		}
+	}
+
+	return parallel_run(derive_dh_batch_range, &batch, count, threads);
+}
+
 API int yaca_key_derive_kdf(yaca_kdf_e kdf,
                             yaca_digest_algorithm_e algo,
                             const char *secret,
@@ -1986,22 +2628,181 @@ exit:
 	return ret;
 }
 
-API int yaca_key_derive_pbkdf2(const char *password,
-                               const char *salt,
-                               size_t salt_len,
-                               size_t iterations,
-                               yaca_digest_algorithm_e algo,
-                               size_t key_bit_len,
-                               yaca_key_h *key)
-{
+/* Output blocks [first_block, first_block + ceil(out_len / md_size)) of
+ * a single PBKDF2 derivation
+ */
+struct pbkdf2_job {
 	const EVP_MD *md;
-	struct yaca_key_simple_s *nk;
-	size_t key_byte_len = key_bit_len / 8;
+	const char *password;
+	const unsigned char *salt;
+	size_t salt_len;
+	size_t iterations;
+	uint32_t first_block;
+	unsigned char *out;
+	size_t out_len;
+};
+
+/* Hashes K ^ pad into ctx, the HMAC inner or outer state for the key */
+static int pbkdf2_hmac_pad(EVP_MD_CTX *ctx, const EVP_MD *md,
+                           const unsigned char *key, size_t key_len, unsigned char pad)
+{
+	unsigned char block[HMAC_MAX_MD_CBLOCK];
+	size_t block_len = EVP_MD_block_size(md);
 	int ret;
 
-	if (password == NULL ||
-	    (salt == NULL && salt_len > 0) || (salt != NULL && salt_len == 0) ||
-	    iterations == 0 || key_bit_len == 0 || key == NULL)
+	assert(key_len <= block_len);
+	if (block_len > sizeof(block))
+		return 0;
+
+	for (size_t i = 0; i < block_len; ++i)
+		block[i] = (i < key_len ? key[i] : 0) ^ pad;
+
+	ret = (EVP_DigestInit_ex(ctx, md, NULL) == 1 &&
+	       EVP_DigestUpdate(ctx, block, block_len) == 1);
+
+	OPENSSL_cleanse(block, sizeof(block));
+	return ret;
+}
+
+/* HMAC(prefix || in) from the precomputed inner and outer states, out may
+ * alias in. The prefix is only used for U1 = HMAC(S || INT(i)).
+ */
+static int pbkdf2_hmac(EVP_MD_CTX *work, const EVP_MD_CTX *inner, const EVP_MD_CTX *outer,
+                       const unsigned char *in, size_t in_len,
+                       const unsigned char *prefix, size_t prefix_len,
+                       unsigned char *out)
+{
+	unsigned char h[EVP_MAX_MD_SIZE];
+	unsigned int h_len;
+
+	return EVP_MD_CTX_copy_ex(work, inner) == 1 &&
+	       (prefix_len == 0 || EVP_DigestUpdate(work, prefix, prefix_len) == 1) &&
+	       EVP_DigestUpdate(work, in, in_len) == 1 &&
+	       EVP_DigestFinal_ex(work, h, &h_len) == 1 &&
+	       EVP_MD_CTX_copy_ex(work, outer) == 1 &&
+	       EVP_DigestUpdate(work, h, h_len) == 1 &&
+	       EVP_DigestFinal_ex(work, out, NULL) == 1;
+}
+
+/* PKCS #5 PBKDF2. The HMAC key schedule is hashed once per job and copied
+ * for every iteration instead of starting the HMAC over.
+ */
+static int pbkdf2_job_run_from(const struct pbkdf2_job *j)
+{
+	int ret = YACA_ERROR_NONE;
+	EVP_MD_CTX *inner = NULL, *outer = NULL, *work = NULL;
+	const unsigned char *key = (const unsigned char*)j->password;
+	size_t key_len = strlen(j->password);
+	size_t md_len = EVP_MD_size(j->md);
+	unsigned char hashed_key[EVP_MAX_MD_SIZE];
+	unsigned char u[EVP_MAX_MD_SIZE];
+	unsigned char t[EVP_MAX_MD_SIZE];
+	unsigned char counter[4];
+	uint32_t block = j->first_block;
+
+	inner = EVP_MD_CTX_new();
+	outer = EVP_MD_CTX_new();
+	work = EVP_MD_CTX_new();
+	if (inner == NULL || outer == NULL || work == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	/* Longer HMAC keys are replaced by their hash */
+	if (key_len > (size_t)EVP_MD_block_size(j->md)) {
+		if (EVP_DigestInit_ex(work, j->md, NULL) != 1 ||
+		    EVP_DigestUpdate(work, key, key_len) != 1 ||
+		    EVP_DigestFinal_ex(work, hashed_key, NULL) != 1) {
+			ret = YACA_ERROR_INTERNAL;
+			ERROR_DUMP(ret);
+			goto exit;
+		}
+		key = hashed_key;
+		key_len = md_len;
+	}
+
+	if (!pbkdf2_hmac_pad(inner, j->md, key, key_len, 0x36) ||
+	    !pbkdf2_hmac_pad(outer, j->md, key, key_len, 0x5c)) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	for (size_t done = 0; done < j->out_len; done += md_len, ++block) {
+		size_t len = j->out_len - done < md_len ? j->out_len - done : md_len;
+
+		counter[0] = (unsigned char)(block >> 24);
+		counter[1] = (unsigned char)(block >> 16);
+		counter[2] = (unsigned char)(block >> 8);
+		counter[3] = (unsigned char)block;
+
+		/* U1 = HMAC(S || INT(i)) */
+		if (!pbkdf2_hmac(work, inner, outer, counter, sizeof(counter),
+		                 j->salt, j->salt_len, u)) {
+			ret = YACA_ERROR_INTERNAL;
+			ERROR_DUMP(ret);
+			goto exit;
+		}
+		memcpy(t, u, md_len);
+
+		for (size_t i = 1; i < j->iterations; ++i) {
+			if (!pbkdf2_hmac(work, inner, outer, u, md_len, NULL, 0, u)) {
+				ret = YACA_ERROR_INTERNAL;
+				ERROR_DUMP(ret);
+				goto exit;
+			}
+
+			for (size_t k = 0; k < md_len; ++k)
+				t[k] ^= u[k];
+		}
+
+		memcpy(j->out + done, t, len);
+	}
+
+exit:
+	OPENSSL_cleanse(hashed_key, sizeof(hashed_key));
+	OPENSSL_cleanse(u, sizeof(u));
+	OPENSSL_cleanse(t, sizeof(t));
+	EVP_MD_CTX_free(work);
+	EVP_MD_CTX_free(outer);
+	EVP_MD_CTX_free(inner);
+	return ret;
+}
+
+static int pbkdf2_job_run(const struct pbkdf2_job *j)
+{
+	/* OpenSSL can't start past the first block, only the split keys need
+	 * the code above. The rest keeps the provider (and FIPS) implementation.
+	 */
+	if (j->first_block > 1)
+		return pbkdf2_job_run_from(j);
+
+	if (PKCS5_PBKDF2_HMAC(j->password, -1, j->salt, j->salt_len, j->iterations,
+	                      j->md, j->out_len, j->out) != 1) {
+		ERROR_DUMP(YACA_ERROR_INTERNAL);
+		return YACA_ERROR_INTERNAL;
+	}
+
+	return YACA_ERROR_NONE;
+}
+
+static int pbkdf2_jobs_range(void *arg, size_t slice UNUSED, size_t first, size_t last)
+{
+	const struct pbkdf2_job *jobs = arg;
+	int ret = YACA_ERROR_NONE;
+
+	for (size_t i = first; i < last && ret == YACA_ERROR_NONE; ++i)
+		ret = pbkdf2_job_run(&jobs[i]);
+
+	return ret;
+}
+
+static int pbkdf2_check_params(const char *salt, size_t salt_len, size_t iterations,
+                               size_t key_bit_len)
+{
+	if ((salt == NULL && salt_len > 0) || (salt != NULL && salt_len == 0) ||
+	    iterations == 0 || key_bit_len == 0)
 		return YACA_ERROR_INVALID_PARAMETER;
 
 	if (key_bit_len % 8) /* Key length must be multiple of 8-bit_len */
@@ -2010,10 +2811,41 @@ API int yaca_key_derive_pbkdf2(const char *password,
 	if (iterations > INT_MAX) /* OpenSSL limitation */
 		return YACA_ERROR_INVALID_PARAMETER;
 
+	return YACA_ERROR_NONE;
+}
+
+static int pbkdf2_derive(const char *password,
+                         const char *salt,
+                         size_t salt_len,
+                         size_t iterations,
+                         yaca_digest_algorithm_e algo,
+                         size_t key_bit_len,
+                         yaca_key_h *key,
+                         size_t threads)
+{
+	const EVP_MD *md;
+	struct yaca_key_simple_s *nk;
+	struct pbkdf2_job jobs[PARALLEL_MAX_THREADS];
+	size_t key_byte_len = key_bit_len / 8;
+	size_t md_len, blocks, per_job, count = 1;
+	int ret;
+
+	if (password == NULL || key == NULL || threads > PARALLEL_MAX_THREADS)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = pbkdf2_check_params(salt, salt_len, iterations, key_bit_len);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
 	ret = digest_get_algorithm(algo, &md);
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
+	md_len = EVP_MD_size(md);
+	blocks = (key_byte_len + md_len - 1) / md_len;
+	if (blocks > UINT32_MAX)
+		return YACA_ERROR_INVALID_PARAMETER;
+
 	ret = yaca_zalloc(sizeof(struct yaca_key_simple_s) + key_byte_len, (void**)&nk);
 	if (ret != YACA_ERROR_NONE)
 		return ret;
@@ -2021,20 +2853,131 @@ API int yaca_key_derive_pbkdf2(const char *password,
 	nk->bit_len = key_bit_len;
 	nk->key.type = YACA_KEY_TYPE_SYMMETRIC;
 
-	ret = PKCS5_PBKDF2_HMAC(password, -1, (const unsigned char*)salt,
-	                        salt_len, iterations, md, key_byte_len,
-	                        (unsigned char*)nk->d);
-	if (ret != 1) {
-		ret = YACA_ERROR_INTERNAL;
-		ERROR_DUMP(ret);
-		goto exit;
+	/* The output blocks are independent, up to a thread per block */
+	if (threads > 1)
+		count = blocks < threads ? blocks : threads;
+	per_job = (blocks + count - 1) / count;
+	/* Fewer jobs when they don't divide the blocks, 5 blocks on 4 threads
+	 * are 3 jobs of 2 blocks at most. A 4th one would start past the key.
+	 */
+	count = (blocks + per_job - 1) / per_job;
+
+	for (size_t i = 0; i < count; ++i) {
+		size_t first = i * per_job * md_len;
+
+		jobs[i] = (struct pbkdf2_job){md, password, (const unsigned char*)salt, salt_len,
+		                              iterations, (uint32_t)(i * per_job + 1),
+		                              (unsigned char*)nk->d + first,
+		                              per_job * md_len < key_byte_len - first ?
+		                              per_job * md_len : key_byte_len - first};
 	}
 
+	ret = parallel_run(pbkdf2_jobs_range, jobs, count, count);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
 	*key = (yaca_key_h)nk;
 	nk = NULL;
 	ret = YACA_ERROR_NONE;
 exit:
-	yaca_free(nk);
+	yaca_key_destroy((yaca_key_h)nk);
+
+	return ret;
+}
+
+API int yaca_key_derive_pbkdf2(const char *password,
+                               const char *salt,
+                               size_t salt_len,
+                               size_t iterations,
+                               yaca_digest_algorithm_e algo,
+                               size_t key_bit_len,
+                               yaca_key_h *key)
+{
+	return pbkdf2_derive(password, salt, salt_len, iterations, algo, key_bit_len, key, 1);
+}
+
+API int yaca_key_derive_pbkdf2_parallel(const char *password,
+                                        const char *salt,
+                                        size_t salt_len,
+                                        size_t iterations,
+                                        yaca_digest_algorithm_e algo,
+                                        size_t key_bit_len,
+                                        yaca_key_h *key,
+                                        size_t threads)
+{
+	return pbkdf2_derive(password, salt, salt_len, iterations, algo, key_bit_len, key,
+	                     threads);
+}
+
+API int yaca_key_derive_pbkdf2_batch(const char *const *passwords,
+                                     const char *const *salts,
+                                     const size_t *salt_lens,
+                                     size_t count,
+                                     size_t iterations,
+                                     yaca_digest_algorithm_e algo,
+                                     size_t key_bit_len,
+                                     yaca_key_h *keys,
+                                     size_t threads)
+{
+	const EVP_MD *md;
+	struct pbkdf2_job *jobs = NULL;
+	struct yaca_key_simple_s *nk;
+	size_t key_byte_len = key_bit_len / 8;
+	size_t i;
+	int ret;
+
+	if (passwords == NULL || salts == NULL || salt_lens == NULL || count == 0 ||
+	    keys == NULL || threads > PARALLEL_MAX_THREADS ||
+	    count > SIZE_MAX / sizeof(struct pbkdf2_job))
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	for (i = 0; i < count; ++i) {
+		if (passwords[i] == NULL)
+			return YACA_ERROR_INVALID_PARAMETER;
+
+		ret = pbkdf2_check_params(salts[i], salt_lens[i], iterations, key_bit_len);
+		if (ret != YACA_ERROR_NONE)
+			return ret;
+	}
+
+	ret = digest_get_algorithm(algo, &md);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	if ((key_byte_len + EVP_MD_size(md) - 1) / EVP_MD_size(md) > UINT32_MAX)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = yaca_zalloc(count * sizeof(struct pbkdf2_job), (void**)&jobs);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	for (i = 0; i < count; ++i)
+		keys[i] = YACA_KEY_NULL;
+
+	for (i = 0; i < count; ++i) {
+		ret = yaca_zalloc(sizeof(struct yaca_key_simple_s) + key_byte_len, (void**)&nk);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		nk->bit_len = key_bit_len;
+		nk->key.type = YACA_KEY_TYPE_SYMMETRIC;
+		keys[i] = (yaca_key_h)nk;
+
+		jobs[i] = (struct pbkdf2_job){md, passwords[i], (const unsigned char*)salts[i],
+		                              salt_lens[i], iterations, 1,
+		                              (unsigned char*)nk->d, key_byte_len};
+	}
+
+	ret = parallel_run(pbkdf2_jobs_range, jobs, count, threads);
+
+exit:
+	if (ret != YACA_ERROR_NONE) {
+		for (i = 0; i < count; ++i) {
+			yaca_key_destroy(keys[i]);
+			keys[i] = YACA_KEY_NULL;
+		}
+	}
 
+	yaca_free(jobs);
 	return ret;
 }
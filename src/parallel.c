@@ -0,0 +1,115 @@
+/*
+ *  Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file parallel.c
+ * @brief Splitting the batch functions between threads
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#include <yaca_error.h>
+
+#include "internal.h"
+
+
+struct parallel_worker {
+	parallel_range_fn range;
+	void *arg;
+	size_t slice;
+	size_t first;
+	size_t last;
+	int ret;
+	bool started;
+	pthread_t thread;
+	struct error_records_s errors;
+};
+
+static void *parallel_worker_main(void *arg)
+{
+	struct parallel_worker *w = arg;
+
+	w->ret = w->range(w->arg, w->slice, w->first, w->last);
+
+	/* The records are per thread and this one is about to end */
+	error_records_save(&w->errors);
+	return NULL;
+}
+
+static size_t parallel_per_thread(size_t count, size_t threads)
+{
+	if (threads == 0)
+		threads = 1;
+	if (threads > count)
+		threads = count;
+
+	return (count + threads - 1) / threads;
+}
+
+size_t parallel_threads(size_t count, size_t threads)
+{
+	size_t per_thread = parallel_per_thread(count, threads);
+
+	/* 5 items on 4 threads are 3 slices of 2, the 4th one would be empty */
+	return (count + per_thread - 1) / per_thread;
+}
+
+int parallel_run(parallel_range_fn range, void *arg, size_t count, size_t threads)
+{
+	int ret;
+	struct parallel_worker workers[PARALLEL_MAX_THREADS];
+	size_t per_thread;
+
+	assert(range != NULL && count > 0 && threads <= PARALLEL_MAX_THREADS);
+
+	per_thread = parallel_per_thread(count, threads);
+	threads = parallel_threads(count, threads);
+
+	for (size_t t = 1; t < threads; ++t) {
+		struct parallel_worker *w = &workers[t];
+
+		w->range = range;
+		w->arg = arg;
+		w->slice = t;
+		w->first = t * per_thread;
+		w->last = w->first + per_thread < count ? w->first + per_thread : count;
+		w->ret = YACA_ERROR_NONE;
+		w->started = (pthread_create(&w->thread, NULL, parallel_worker_main, w) == 0);
+	}
+
+	ret = range(arg, 0, 0, per_thread < count ? per_thread : count);
+
+	for (size_t t = 1; t < threads; ++t) {
+		struct parallel_worker *w = &workers[t];
+
+		if (w->started) {
+			pthread_join(w->thread, NULL);
+			error_records_restore(&w->errors);
+		} else if (ret == YACA_ERROR_NONE) {
+			/* a thread that couldn't be started is replaced by this one */
+			w->ret = range(arg, t, w->first, w->last);
+		}
+
+		if (ret == YACA_ERROR_NONE)
+			ret = w->ret;
+	}
+
+	return ret;
+}
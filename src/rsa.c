@@ -60,6 +60,41 @@ int rsa_padding2openssl(yaca_padding_e padding)
 	}
 }
 
+int rsa_warm_up(EVP_PKEY *evp)
+{
+	int ret;
+	EVP_PKEY_CTX *pctx;
+	unsigned char *buf = NULL;
+	size_t len = EVP_PKEY_size(evp);
+
+	ret = yaca_zalloc(len, (void**)&buf);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	pctx = EVP_PKEY_CTX_new(evp, NULL);
+	if (pctx == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	/* 1 < n, the Montgomery contexts and the blinding get created */
+	buf[len - 1] = 1;
+	if (EVP_PKEY_sign_init(pctx) != 1 ||
+	    EVP_PKEY_CTX_set_rsa_padding(pctx, RSA_NO_PADDING) != 1 ||
+	    EVP_PKEY_sign(pctx, buf, &len, buf, len) != 1) {
+		ret = ERROR_HANDLE();
+		goto exit;
+	}
+
+	ret = YACA_ERROR_NONE;
+
+exit:
+	EVP_PKEY_CTX_free(pctx);
+	yaca_free(buf);
+	return ret;
+}
+
 typedef int (*encrypt_decrypt_fn)(int, const unsigned char*, unsigned char*, RSA*, int);
 
 static int encrypt_decrypt(yaca_padding_e padding,
@@ -74,6 +109,7 @@ static int encrypt_decrypt(yaca_padding_e padding,
 	size_t max_len;
 	char *loutput = NULL;
 	struct yaca_key_evp_s *lasym_key;
+	struct key_lease_s lease;
 	int lpadding;
 
 	if ((input == NULL && input_len > 0) || (input != NULL && input_len == 0) ||
@@ -101,11 +137,13 @@ static int encrypt_decrypt(yaca_padding_e padding,
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
+	key_lease_acquire(lasym_key, &lease);
 	ret = fn(input_len,
 	         (const unsigned char*)input,
 	         (unsigned char*)loutput,
-	         EVP_PKEY_get0_RSA(lasym_key->evp),
+	         EVP_PKEY_get0_RSA(lease.evp),
 	         lpadding);
+	key_lease_release(&lease);
 
 	if (ret < 0) {
 		ret = ERROR_HANDLE();
@@ -161,7 +161,8 @@ API int yaca_seal_initialize(yaca_context_h *ctx,
 	yaca_key_h lenc_sym_key = YACA_KEY_NULL;
 
 	if (pub_key == YACA_KEY_NULL || pub_key->type != YACA_KEY_TYPE_RSA_PUB ||
-	    sym_key == NULL || bcm == YACA_BCM_WRAP || sym_key_bit_len % 8 != 0)
+	    sym_key == NULL || bcm == YACA_BCM_WRAP || bcm == YACA_BCM_SIV ||
+	    sym_key_bit_len % 8 != 0)
 		return YACA_ERROR_INVALID_PARAMETER;
 
 	ret = encrypt_get_algorithm(algo, bcm, sym_key_bit_len, &cipher);
@@ -186,7 +187,7 @@ API int yaca_seal_initialize(yaca_context_h *ctx,
 	if (ret != YACA_ERROR_NONE)
 		goto exit;
 
-	ret = encrypt_initialize(ctx, cipher, lsym_key, liv, OP_SEAL);
+	ret = encrypt_initialize(ctx, algo, bcm, cipher, lsym_key, liv, OP_SEAL);
 	if (ret != YACA_ERROR_NONE)
 		goto exit;
 
@@ -237,7 +238,8 @@ API int yaca_open_initialize(yaca_context_h *ctx,
 	yaca_key_h lsym_key = YACA_KEY_NULL;
 
 	if (prv_key == YACA_KEY_NULL || prv_key->type != YACA_KEY_TYPE_RSA_PRIV ||
-	    sym_key == YACA_KEY_NULL || bcm == YACA_BCM_WRAP || sym_key_bit_len % 8 != 0 ||
+	    sym_key == YACA_KEY_NULL || bcm == YACA_BCM_WRAP || bcm == YACA_BCM_SIV ||
+	    sym_key_bit_len % 8 != 0 ||
 	    (sym_key->type != YACA_KEY_TYPE_SYMMETRIC && sym_key->type != YACA_KEY_TYPE_DES))
 		return YACA_ERROR_INVALID_PARAMETER;
 
@@ -250,7 +252,7 @@ API int yaca_open_initialize(yaca_context_h *ctx,
 	if (ret != YACA_ERROR_NONE)
 		goto exit;
 
-	ret = encrypt_initialize(ctx, cipher, lsym_key, iv, OP_OPEN);
+	ret = encrypt_initialize(ctx, algo, bcm, cipher, lsym_key, iv, OP_OPEN);
 	if (ret != YACA_ERROR_NONE)
 		goto exit;
 
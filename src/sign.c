@@ -23,10 +23,13 @@
 
 #include <assert.h>
 #include <string.h>
+#include <limits.h>
 
 #include <openssl/evp.h>
 #include <openssl/rsa.h>
 #include <openssl/cmac.h>
+#include <openssl/ec.h>
+#include <openssl/dsa.h>
 
 #include <yaca_crypto.h>
 #include <yaca_sign.h>
@@ -34,6 +37,8 @@
 #include <yaca_key.h>
 
 #include "internal.h"
+#include "stats.h"
+#include "trace.h"
 
 #ifdef OPENSSL_MOCKUP_TESTS
 #include "../tests/openssl_mock_redefine.h"
@@ -54,8 +59,36 @@ struct yaca_sign_context_s {
 	EVP_MD_CTX *md_ctx;
 	enum sign_op_type op_type;
 	enum context_state_e state;
+
+	/* yaca_encrypt_algorithm_e for CMAC and GMAC, yaca_digest_algorithm_e otherwise */
+	bool cmac;
+	int algo;
+
+	/* GMAC is GCM with the message as its AAD, there is no md_ctx then */
+	EVP_CIPHER_CTX *gmac_ctx;
+
+	/* A prepared EC key, the md_ctx is a plain digest then */
+	struct yaca_verify_cache_s *verify_cache;
+	/* The copy of a prepared RSA key that signs */
+	struct key_lease_s lease;
 };
 
+/* ECDSA verification with both points fixed. Only made for the curves
+ * whose implementation has fast fixed-base multiplication, where two of
+ * them beat the double point multiplication of a plain verification.
+ */
+struct yaca_verify_cache_s {
+	int refs;
+
+	/* The key's curve, with the tables of its generator */
+	EC_GROUP *group;
+	/* The same curve with the public point as the generator and its tables */
+	EC_GROUP *pub_group;
+};
+
+/* The full GCM tag, shorter GMAC tags are truncations of it */
+#define GMAC_TAG_LEN 16
+
 static bool CTX_DEFAULT_STATES[CTX_COUNT][CTX_COUNT] = {
 /* from \ to  INIT, MSG, FIN */
 /* INIT */  { 0,    1,    1 },
@@ -70,6 +103,16 @@ static bool verify_state_change(struct yaca_sign_context_s *c, enum context_stat
 	return CTX_DEFAULT_STATES[from][to];
 }
 
+static void update_sign_stats(const struct yaca_sign_context_s *c, size_t message_len)
+{
+	stats_context_updated(YACA_STATS_CONTEXT_SIGN);
+
+	if (c->cmac || c->gmac_ctx != NULL)
+		stats_cipher_bytes(c->algo, message_len);
+	else
+		stats_digest_bytes(c->algo, message_len);
+}
+
 static struct yaca_sign_context_s *get_sign_context(const yaca_context_h ctx)
 {
 	if (ctx == YACA_CONTEXT_NULL)
@@ -83,6 +126,20 @@ static struct yaca_sign_context_s *get_sign_context(const yaca_context_h ctx)
 	}
 }
 
+UNUSED static int trace_sign_algo(const yaca_context_h ctx)
+{
+	const struct yaca_sign_context_s *c = get_sign_context(ctx);
+
+	return c != NULL ? c->algo : -1;
+}
+
+UNUSED static int trace_sign_cmac(const yaca_context_h ctx)
+{
+	const struct yaca_sign_context_s *c = get_sign_context(ctx);
+
+	return c != NULL ? c->cmac || c->gmac_ctx != NULL : -1;
+}
+
 static int get_sign_output_length(const yaca_context_h ctx,
                                   size_t input_len,
                                   size_t *output_len)
@@ -93,11 +150,17 @@ static int get_sign_output_length(const yaca_context_h ctx,
 	EVP_PKEY_CTX *pctx;
 	struct yaca_sign_context_s *c = get_sign_context(ctx);
 	assert(c != NULL);
-	assert(c->md_ctx != NULL);
 
 	if (input_len != 0)
 		return YACA_ERROR_INVALID_PARAMETER;
 
+	if (c->gmac_ctx != NULL) {
+		*output_len = GMAC_TAG_LEN;
+		return YACA_ERROR_NONE;
+	}
+
+	assert(c->md_ctx != NULL);
+
 	pctx = EVP_MD_CTX_pkey_ctx(c->md_ctx);
 	if (pctx == NULL) {
 		ret = YACA_ERROR_INTERNAL;
@@ -123,6 +186,16 @@ static int get_sign_output_length(const yaca_context_h ctx,
 	return YACA_ERROR_NONE;
 }
 
+void verify_cache_unref(struct yaca_verify_cache_s *cache)
+{
+	if (cache == NULL || __atomic_sub_fetch(&cache->refs, 1, __ATOMIC_ACQ_REL) > 0)
+		return;
+
+	EC_GROUP_free(cache->pub_group);
+	EC_GROUP_free(cache->group);
+	yaca_free(cache);
+}
+
 static void destroy_sign_context(yaca_context_h ctx)
 {
 	struct yaca_sign_context_s *c = get_sign_context(ctx);
@@ -130,6 +203,11 @@ static void destroy_sign_context(yaca_context_h ctx)
 
 	EVP_MD_CTX_destroy(c->md_ctx);
 	c->md_ctx = NULL;
+	EVP_CIPHER_CTX_free(c->gmac_ctx);
+	c->gmac_ctx = NULL;
+	verify_cache_unref(c->verify_cache);
+	c->verify_cache = NULL;
+	key_lease_release(&c->lease);
 }
 
 int set_sign_property(yaca_context_h ctx,
@@ -146,7 +224,8 @@ int set_sign_property(yaca_context_h ctx,
 	assert(c != NULL);
 	assert(c->md_ctx != NULL);
 
-	if (value == NULL || c->state == CTX_FINALIZED)
+	/* a prepared EC key, no padding */
+	if (value == NULL || c->state == CTX_FINALIZED || c->verify_cache != NULL)
 		return YACA_ERROR_INVALID_PARAMETER;
 
 	pctx = EVP_MD_CTX_pkey_ctx(c->md_ctx);
@@ -240,13 +319,18 @@ API int yaca_sign_initialize(yaca_context_h *ctx,
 		goto exit;
 	}
 
-	ret = EVP_DigestSignInit(nc->md_ctx, NULL, md, NULL, evp_key->evp);
+	key_lease_acquire(evp_key, &nc->lease);
+
+	ret = EVP_DigestSignInit(nc->md_ctx, NULL, md, NULL, nc->lease.evp);
 	if (ret != 1) {
 		ret = ERROR_HANDLE();
 		goto exit;
 	}
 
 	nc->state = CTX_INITIALIZED;
+	nc->algo = algo;
+	stats_context_initialized(YACA_STATS_CONTEXT_SIGN);
+
 	*ctx = (yaca_context_h)nc;
 	nc = NULL;
 	ret = YACA_ERROR_NONE;
@@ -311,6 +395,9 @@ API int yaca_sign_initialize_hmac(yaca_context_h *ctx,
 	}
 
 	nc->state = CTX_INITIALIZED;
+	nc->algo = algo;
+	stats_context_initialized(YACA_STATS_CONTEXT_SIGN);
+
 	*ctx = (yaca_context_h)nc;
 	nc = NULL;
 	ret = YACA_ERROR_NONE;
@@ -396,6 +483,10 @@ API int yaca_sign_initialize_cmac(yaca_context_h *ctx,
 	}
 
 	nc->state = CTX_INITIALIZED;
+	nc->cmac = true;
+	nc->algo = algo;
+	stats_context_initialized(YACA_STATS_CONTEXT_SIGN);
+
 	*ctx = (yaca_context_h)nc;
 	nc = NULL;
 	ret = YACA_ERROR_NONE;
@@ -408,9 +499,112 @@ exit:
 	return ret;
 }
 
-API int yaca_sign_update(yaca_context_h ctx,
-                         const char *message,
-                         size_t message_len)
+API int yaca_sign_initialize_gmac(yaca_context_h *ctx,
+                                  const yaca_key_h sym_key,
+                                  const yaca_key_h iv)
+{
+	struct yaca_sign_context_s *nc = NULL;
+	const EVP_CIPHER *cipher = NULL;
+	int ret;
+	const struct yaca_key_simple_s *simple_key = key_get_simple(sym_key);
+	const struct yaca_key_simple_s *simple_iv = key_get_simple(iv);
+
+	if (ctx == NULL || simple_key == NULL || sym_key->type != YACA_KEY_TYPE_SYMMETRIC ||
+	    simple_iv == NULL || iv->type != YACA_KEY_TYPE_IV || simple_iv->bit_len == 0 ||
+	    simple_iv->bit_len / 8 > INT_MAX)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = encrypt_get_algorithm(YACA_ENCRYPT_AES, YACA_BCM_GCM, simple_key->bit_len, &cipher);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = yaca_zalloc(sizeof(struct yaca_sign_context_s), (void**)&nc);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	nc->op_type = OP_SIGN;
+	nc->ctx.type = YACA_CONTEXT_SIGN;
+	nc->ctx.context_destroy = destroy_sign_context;
+	nc->ctx.get_output_length = get_sign_output_length;
+	nc->ctx.set_property = NULL;
+	nc->ctx.get_property = NULL;
+
+	nc->gmac_ctx = EVP_CIPHER_CTX_new();
+	if (nc->gmac_ctx == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	/* the IV length has to be set before the IV itself */
+	if (EVP_CipherInit_ex(nc->gmac_ctx, cipher, NULL, NULL, NULL, 1) != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	if (simple_iv->bit_len != 96 &&
+	    EVP_CIPHER_CTX_ctrl(nc->gmac_ctx, EVP_CTRL_GCM_SET_IVLEN,
+	                        simple_iv->bit_len / 8, NULL) != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	if (EVP_CipherInit_ex(nc->gmac_ctx, NULL, NULL, (const unsigned char *)simple_key->d,
+	                      (const unsigned char *)simple_iv->d, 1) != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	nc->state = CTX_INITIALIZED;
+	nc->algo = YACA_ENCRYPT_AES;
+	stats_context_initialized(YACA_STATS_CONTEXT_SIGN);
+
+	*ctx = (yaca_context_h)nc;
+	nc = NULL;
+	ret = YACA_ERROR_NONE;
+
+exit:
+	yaca_context_destroy((yaca_context_h)nc);
+
+	return ret;
+}
+
+/* The message as AAD, in pieces that fit the int of the EVP */
+static int gmac_update(EVP_CIPHER_CTX *gmac_ctx, const char *message, size_t message_len)
+{
+	int len;
+
+	while (message_len > 0) {
+		int chunk = message_len > INT_MAX ? INT_MAX : (int)message_len;
+
+		if (EVP_CipherUpdate(gmac_ctx, NULL, &len, (const unsigned char *)message, chunk) != 1)
+			return 0;
+
+		message += chunk;
+		message_len -= chunk;
+	}
+
+	return 1;
+}
+
+/* GCM with no plaintext, its tag is the GMAC */
+static int gmac_final(EVP_CIPHER_CTX *gmac_ctx, unsigned char *tag)
+{
+	unsigned char empty[1];
+	int len;
+
+	if (EVP_CipherFinal(gmac_ctx, empty, &len) != 1)
+		return 0;
+
+	return EVP_CIPHER_CTX_ctrl(gmac_ctx, EVP_CTRL_GCM_GET_TAG, GMAC_TAG_LEN, tag);
+}
+
+static int sign_update(yaca_context_h ctx,
+                       const char *message,
+                       size_t message_len)
 {
 	struct yaca_sign_context_s *c = get_sign_context(ctx);
 	int ret;
@@ -422,7 +616,10 @@ API int yaca_sign_update(yaca_context_h ctx,
 	if (!verify_state_change(c, CTX_MSG_UPDATED))
 		return YACA_ERROR_INVALID_PARAMETER;
 
-	ret = EVP_DigestSignUpdate(c->md_ctx, message, message_len);
+	if (c->gmac_ctx != NULL)
+		ret = gmac_update(c->gmac_ctx, message, message_len);
+	else
+		ret = EVP_DigestSignUpdate(c->md_ctx, message, message_len);
 	if (ret != 1) {
 		ret = YACA_ERROR_INTERNAL;
 		ERROR_DUMP(ret);
@@ -430,12 +627,14 @@ API int yaca_sign_update(yaca_context_h ctx,
 	}
 
 	c->state = CTX_MSG_UPDATED;
+	update_sign_stats(c, message_len);
+
 	return YACA_ERROR_NONE;
 }
 
-API int yaca_sign_finalize(yaca_context_h ctx,
-                           char *signature,
-                           size_t *signature_len)
+static int sign_finalize(yaca_context_h ctx,
+                         char *signature,
+                         size_t *signature_len)
 {
 	struct yaca_sign_context_s *c = get_sign_context(ctx);
 	int ret;
@@ -455,7 +654,10 @@ API int yaca_sign_finalize(yaca_context_h ctx,
 	if (ret != YACA_ERROR_NONE)
 		return ret;
 
-	ret = EVP_DigestSignFinal(c->md_ctx, (unsigned char *)signature, signature_len);
+	if (c->gmac_ctx != NULL)
+		ret = gmac_final(c->gmac_ctx, (unsigned char *)signature);
+	else
+		ret = EVP_DigestSignFinal(c->md_ctx, (unsigned char *)signature, signature_len);
 	if (ret != 1) {
 		ret = YACA_ERROR_INTERNAL;
 		ERROR_DUMP(ret);
@@ -463,6 +665,8 @@ API int yaca_sign_finalize(yaca_context_h ctx,
 	}
 
 	c->state = CTX_FINALIZED;
+	stats_context_finalized(YACA_STATS_CONTEXT_SIGN);
+
 	return YACA_ERROR_NONE;
 }
 
@@ -473,7 +677,8 @@ API int yaca_verify_initialize(yaca_context_h *ctx,
 	struct yaca_sign_context_s *nc = NULL;
 	const EVP_MD *md = NULL;
 	int ret;
-	const struct yaca_key_evp_s *evp_key = key_get_evp(pub_key);
+	struct yaca_key_evp_s *evp_key = key_get_evp(pub_key);
+	struct yaca_verify_cache_s *cache;
 
 	if (ctx == NULL || evp_key == NULL)
 		return YACA_ERROR_INVALID_PARAMETER;
@@ -513,13 +718,35 @@ API int yaca_verify_initialize(yaca_context_h *ctx,
 		goto exit;
 	}
 
-	ret = EVP_DigestVerifyInit(nc->md_ctx, NULL, md, NULL, evp_key->evp);
-	if (ret != 1) {
-		ret = ERROR_HANDLE();
-		goto exit;
+	cache = __atomic_load_n(&evp_key->verify_cache, __ATOMIC_ACQUIRE);
+	if (cache != NULL) {
+		/* the same as for the EVP_PKEY_EC digests */
+		if (algo == YACA_DIGEST_MD5) {
+			ret = YACA_ERROR_INVALID_PARAMETER;
+			goto exit;
+		}
+
+		ret = EVP_DigestInit(nc->md_ctx, md);
+		if (ret != 1) {
+			ret = YACA_ERROR_INTERNAL;
+			ERROR_DUMP(ret);
+			goto exit;
+		}
+
+		__atomic_add_fetch(&cache->refs, 1, __ATOMIC_RELAXED);
+		nc->verify_cache = cache;
+	} else {
+		ret = EVP_DigestVerifyInit(nc->md_ctx, NULL, md, NULL, evp_key->evp);
+		if (ret != 1) {
+			ret = ERROR_HANDLE();
+			goto exit;
+		}
 	}
 
 	nc->state = CTX_INITIALIZED;
+	nc->algo = algo;
+	stats_context_initialized(YACA_STATS_CONTEXT_SIGN);
+
 	*ctx = (yaca_context_h)nc;
 	nc = NULL;
 	ret = YACA_ERROR_NONE;
@@ -530,9 +757,9 @@ exit:
 	return ret;
 }
 
-API int yaca_verify_update(yaca_context_h ctx,
-                           const char *message,
-                           size_t message_len)
+static int verify_update(yaca_context_h ctx,
+                         const char *message,
+                         size_t message_len)
 {
 	struct yaca_sign_context_s *c = get_sign_context(ctx);
 	int ret;
@@ -543,7 +770,10 @@ API int yaca_verify_update(yaca_context_h ctx,
 	if (!verify_state_change(c, CTX_MSG_UPDATED))
 		return YACA_ERROR_INVALID_PARAMETER;
 
-	ret = EVP_DigestVerifyUpdate(c->md_ctx, message, message_len);
+	if (c->verify_cache != NULL)
+		ret = EVP_DigestUpdate(c->md_ctx, message, message_len);
+	else
+		ret = EVP_DigestVerifyUpdate(c->md_ctx, message, message_len);
 	if (ret != 1) {
 		ret = YACA_ERROR_INTERNAL;
 		ERROR_DUMP(ret);
@@ -551,12 +781,119 @@ API int yaca_verify_update(yaca_context_h ctx,
 	}
 
 	c->state = CTX_MSG_UPDATED;
+	update_sign_stats(c, message_len);
+
 	return YACA_ERROR_NONE;
 }
 
-API int yaca_verify_finalize(yaca_context_h ctx,
-                             const char *signature,
-                             size_t signature_len)
+/* ECDSA verification of the digest with the prepared key, the same
+ * result as EVP_DigestVerifyFinal(): 1 on match, 0 on mismatch, -1 on error
+ */
+static int verify_ec_prepared(struct yaca_sign_context_s *c,
+                              const unsigned char *signature, size_t signature_len)
+{
+	int ret = -1;
+	const EC_GROUP *group = c->verify_cache->group;
+	const BIGNUM *order = EC_GROUP_get0_order(group);
+	int order_bits = EC_GROUP_order_bits(group);
+	EVP_MD_CTX *md_ctx = NULL;
+	unsigned char digest[EVP_MAX_MD_SIZE];
+	unsigned int digest_len;
+	const unsigned char *p = signature;
+	unsigned char *der = NULL;
+	ECDSA_SIG *sig = NULL;
+	const BIGNUM *r, *s;
+	BN_CTX *bn_ctx = NULL;
+	BIGNUM *e, *w, *u1, *u2, *x;
+	EC_POINT *point = NULL, *pub_point = NULL;
+
+	/* The context stays usable after a mismatch, as for the EVP */
+	md_ctx = EVP_MD_CTX_new();
+	if (md_ctx == NULL ||
+	    EVP_MD_CTX_copy_ex(md_ctx, c->md_ctx) != 1 ||
+	    EVP_DigestFinal_ex(md_ctx, digest, &digest_len) != 1)
+		goto exit;
+
+	if (signature_len > LONG_MAX)
+		goto exit;
+
+	/* Only the DER encoding, anything else is an error, as for the EVP */
+	sig = d2i_ECDSA_SIG(NULL, &p, signature_len);
+	if (sig == NULL || p != signature + signature_len ||
+	    i2d_ECDSA_SIG(sig, &der) != (int)signature_len ||
+	    memcmp(der, signature, signature_len) != 0)
+		goto exit;
+
+	ECDSA_SIG_get0(sig, &r, &s);
+	if (BN_is_zero(r) || BN_is_negative(r) || BN_ucmp(r, order) >= 0 ||
+	    BN_is_zero(s) || BN_is_negative(s) || BN_ucmp(s, order) >= 0) {
+		ret = 0;
+		goto exit;
+	}
+
+	bn_ctx = BN_CTX_new();
+	if (bn_ctx == NULL)
+		goto exit;
+
+	BN_CTX_start(bn_ctx);
+	e = BN_CTX_get(bn_ctx);
+	w = BN_CTX_get(bn_ctx);
+	u1 = BN_CTX_get(bn_ctx);
+	u2 = BN_CTX_get(bn_ctx);
+	x = BN_CTX_get(bn_ctx);
+	if (x == NULL)
+		goto exit;
+
+	/* The leftmost order_bits bits of the digest */
+	if (8 * digest_len > (unsigned)order_bits)
+		digest_len = (order_bits + 7) / 8;
+	if (BN_bin2bn(digest, digest_len, e) == NULL ||
+	    (8 * digest_len > (unsigned)order_bits && !BN_rshift(e, e, 8 - (order_bits & 0x7))))
+		goto exit;
+
+	/* u1 = e / s, u2 = r / s, all of it public */
+	if (BN_mod_inverse(w, s, order, bn_ctx) == NULL ||
+	    !BN_mod_mul(u1, e, w, order, bn_ctx) ||
+	    !BN_mod_mul(u2, r, w, order, bn_ctx))
+		goto exit;
+
+	point = EC_POINT_new(group);
+	pub_point = EC_POINT_new(c->verify_cache->pub_group);
+	if (point == NULL || pub_point == NULL)
+		goto exit;
+
+	/* u1 * G + u2 * Q, both from their tables */
+	if (EC_POINT_mul(group, point, u1, NULL, NULL, bn_ctx) != 1 ||
+	    EC_POINT_mul(c->verify_cache->pub_group, pub_point, u2, NULL, NULL, bn_ctx) != 1 ||
+	    EC_POINT_add(group, point, point, pub_point, bn_ctx) != 1)
+		goto exit;
+
+	if (EC_POINT_is_at_infinity(group, point)) {
+		ret = 0;
+		goto exit;
+	}
+
+	if (EC_POINT_get_affine_coordinates(group, point, x, NULL, bn_ctx) != 1 ||
+	    !BN_nnmod(x, x, order, bn_ctx))
+		goto exit;
+
+	ret = BN_ucmp(x, r) == 0 ? 1 : 0;
+
+exit:
+	if (bn_ctx != NULL)
+		BN_CTX_end(bn_ctx);
+	BN_CTX_free(bn_ctx);
+	EC_POINT_free(pub_point);
+	EC_POINT_free(point);
+	OPENSSL_free(der);
+	ECDSA_SIG_free(sig);
+	EVP_MD_CTX_free(md_ctx);
+	return ret;
+}
+
+static int verify_finalize(yaca_context_h ctx,
+                           const char *signature,
+                           size_t signature_len)
 {
 	struct yaca_sign_context_s *c = get_sign_context(ctx);
 	int ret;
@@ -567,17 +904,22 @@ API int yaca_verify_finalize(yaca_context_h ctx,
 	if (!verify_state_change(c, CTX_FINALIZED))
 		return YACA_ERROR_INVALID_PARAMETER;
 
-	ret = EVP_DigestVerifyFinal(c->md_ctx,
-	                            (unsigned char *)signature,
-	                            signature_len);
+	if (c->verify_cache != NULL)
+		ret = verify_ec_prepared(c, (const unsigned char *)signature, signature_len);
+	else
+		ret = EVP_DigestVerifyFinal(c->md_ctx,
+		                            (const unsigned char *)signature,
+		                            signature_len);
 
 	if (ret == 1) {
 		c->state = CTX_FINALIZED;
+		stats_context_finalized(YACA_STATS_CONTEXT_SIGN);
 		return YACA_ERROR_NONE;
 	}
 
 	if (ret == 0) {
 		ERROR_CLEAR();
+		stats_verification_failure();
 		return YACA_ERROR_DATA_MISMATCH;
 	}
 
@@ -585,3 +927,205 @@ API int yaca_verify_finalize(yaca_context_h ctx,
 	ERROR_DUMP(ret);
 	return ret;
 }
+
+API int yaca_sign_update(yaca_context_h ctx,
+                         const char *message,
+                         size_t message_len)
+{
+	int ret;
+
+	TRACE(sign__update__entry, trace_sign_algo(ctx), trace_sign_cmac(ctx), message_len);
+
+	ret = sign_update(ctx, message, message_len);
+
+	TRACE(sign__update__return, trace_sign_algo(ctx), trace_sign_cmac(ctx), message_len, ret);
+	return ret;
+}
+
+API int yaca_sign_finalize(yaca_context_h ctx,
+                           char *signature,
+                           size_t *signature_len)
+{
+	int ret;
+
+	TRACE(sign__finalize__entry, trace_sign_algo(ctx), trace_sign_cmac(ctx));
+
+	ret = sign_finalize(ctx, signature, signature_len);
+
+	TRACE(sign__finalize__return, trace_sign_algo(ctx), trace_sign_cmac(ctx), ret);
+	return ret;
+}
+
+API int yaca_verify_update(yaca_context_h ctx,
+                           const char *message,
+                           size_t message_len)
+{
+	int ret;
+
+	TRACE(verify__update__entry, trace_sign_algo(ctx), message_len);
+
+	ret = verify_update(ctx, message, message_len);
+
+	TRACE(verify__update__return, trace_sign_algo(ctx), message_len, ret);
+	return ret;
+}
+
+API int yaca_verify_finalize(yaca_context_h ctx,
+                             const char *signature,
+                             size_t signature_len)
+{
+	int ret;
+
+	TRACE(verify__finalize__entry, trace_sign_algo(ctx), signature_len);
+
+	ret = verify_finalize(ctx, signature, signature_len);
+
+	TRACE(verify__finalize__return, trace_sign_algo(ctx), signature_len, ret);
+	return ret;
+}
+
+/* A verification that fails, only to make OpenSSL compute and cache the
+ * Montgomery contexts of the RSA modulus or the DSA prime in the key
+ */
+static int verify_warm_up(EVP_PKEY *pkey)
+{
+	int ret;
+	EVP_PKEY_CTX *pctx;
+	/* a DER DSA signature with r = s = 1, passes the range checks */
+	static const unsigned char DSA_SIG_ONE[] = {0x30, 0x06, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01};
+	unsigned char tbs[32] = {0};
+	unsigned char *sig = NULL;
+	size_t sig_len;
+
+	pctx = EVP_PKEY_CTX_new(pkey, NULL);
+	if (pctx == NULL || EVP_PKEY_verify_init(pctx) != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	if (EVP_PKEY_base_id(pkey) == EVP_PKEY_RSA) {
+		/* 1 < n, of the modulus length, fails the padding check */
+		sig_len = EVP_PKEY_size(pkey);
+		ret = yaca_zalloc(sig_len, (void**)&sig);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+		sig[sig_len - 1] = 1;
+
+		EVP_PKEY_verify(pctx, sig, sig_len, tbs, sizeof(tbs));
+	} else {
+		EVP_PKEY_verify(pctx, DSA_SIG_ONE, sizeof(DSA_SIG_ONE), tbs, sizeof(tbs));
+	}
+
+	ERROR_CLEAR();
+	ret = YACA_ERROR_NONE;
+
+exit:
+	yaca_free(sig);
+	EVP_PKEY_CTX_free(pctx);
+	return ret;
+}
+
+static int verify_cache_create(const struct yaca_key_evp_s *evp_key,
+                               struct yaca_verify_cache_s **cache)
+{
+	int ret;
+	const EC_KEY *eck = EVP_PKEY_get0(evp_key->evp);
+	const EC_GROUP *ecg;
+	struct yaca_verify_cache_s *nc = NULL;
+
+	*cache = NULL;
+
+	if (eck == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		return ret;
+	}
+	ecg = EC_KEY_get0_group(eck);
+
+	ret = yaca_zalloc(sizeof(struct yaca_verify_cache_s), (void**)&nc);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	nc->refs = 1;
+	nc->group = EC_GROUP_dup(ecg);
+	if (nc->group == NULL) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	/* The generic implementation multiplies a fixed point in constant
+	 * time, without the tables, slower than the double multiplication.
+	 */
+	if (!EC_GROUP_have_precompute_mult(nc->group)) {
+		ret = YACA_ERROR_NONE;
+		goto exit;
+	}
+
+	nc->pub_group = EC_GROUP_dup(ecg);
+	if (nc->pub_group == NULL ||
+	    EC_GROUP_set_generator(nc->pub_group, EC_KEY_get0_public_key(eck),
+	                           EC_GROUP_get0_order(ecg), EC_GROUP_get0_cofactor(ecg)) != 1 ||
+	    EC_GROUP_precompute_mult(nc->pub_group, NULL) != 1) {
+		ret = YACA_ERROR_INTERNAL;
+		ERROR_DUMP(ret);
+		goto exit;
+	}
+
+	*cache = nc;
+	nc = NULL;
+	ret = YACA_ERROR_NONE;
+
+exit:
+	verify_cache_unref(nc);
+	return ret;
+}
+
+API int yaca_sign_prepare_key(const yaca_key_h prv_key, size_t threads)
+{
+	int ret;
+	struct yaca_key_evp_s *evp_key = key_get_evp(prv_key);
+
+	if (evp_key == NULL || prv_key->type != YACA_KEY_TYPE_RSA_PRIV || threads == 0)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	/* what the key itself is used for when there are no free copies */
+	ret = rsa_warm_up(evp_key->evp);
+	if (ret != YACA_ERROR_NONE || threads == 1)
+		return ret;
+
+	return key_pool_create(evp_key, threads);
+}
+
+API int yaca_verify_prepare_key(const yaca_key_h pub_key)
+{
+	int ret;
+	struct yaca_key_evp_s *evp_key = key_get_evp(pub_key);
+	struct yaca_verify_cache_s *cache = NULL;
+
+	if (evp_key == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	switch (pub_key->type) {
+	case YACA_KEY_TYPE_RSA_PUB:
+	case YACA_KEY_TYPE_DSA_PUB:
+		return verify_warm_up(evp_key->evp);
+	case YACA_KEY_TYPE_EC_PUB:
+		break;
+	default:
+		return YACA_ERROR_INVALID_PARAMETER;
+	}
+
+	if (__atomic_load_n(&evp_key->verify_cache, __ATOMIC_ACQUIRE) != NULL)
+		return YACA_ERROR_NONE;
+
+	ret = verify_cache_create(evp_key, &cache);
+	if (ret != YACA_ERROR_NONE || cache == NULL)
+		return ret;
+
+	if (!PUBLISH_ONCE(&evp_key->verify_cache, cache))
+		verify_cache_unref(cache);
+
+	return YACA_ERROR_NONE;
+}
@@ -33,6 +33,10 @@
 
 #include "internal.h"
 
+/* The tag of YACA_BCM_SIV */
+#define SIV_TAG_LEN ((size_t)16)
+
+
 API int yaca_simple_calculate_digest(yaca_digest_algorithm_e algo,
                                      const char *data,
                                      size_t data_len,
@@ -102,7 +106,7 @@ API int yaca_simple_encrypt(yaca_encrypt_algorithm_e algo,
 	if ((plaintext == NULL && plaintext_len > 0) || (plaintext != NULL && plaintext_len == 0) ||
 	    ciphertext == NULL || ciphertext_len == NULL ||
 	    sym_key == YACA_KEY_NULL ||
-	    bcm == YACA_BCM_CCM || bcm == YACA_BCM_GCM)
+	    bcm == YACA_BCM_CCM || bcm == YACA_BCM_GCM || bcm == YACA_BCM_SIV)
 		return YACA_ERROR_INVALID_PARAMETER;
 
 	ret = yaca_encrypt_initialize(&ctx, algo, bcm, sym_key, iv);
@@ -188,7 +192,7 @@ API int yaca_simple_decrypt(yaca_encrypt_algorithm_e algo,
 	    ((bcm == YACA_BCM_ECB || bcm == YACA_BCM_CBC) && ciphertext == NULL && ciphertext_len == 0) ||
 	    plaintext == NULL || plaintext_len == NULL ||
 	    sym_key == YACA_KEY_NULL ||
-	    bcm == YACA_BCM_CCM || bcm == YACA_BCM_GCM)
+	    bcm == YACA_BCM_CCM || bcm == YACA_BCM_GCM || bcm == YACA_BCM_SIV)
 		return YACA_ERROR_INVALID_PARAMETER;
 
 	ret = yaca_decrypt_initialize(&ctx, algo, bcm, sym_key, iv);
@@ -393,3 +397,164 @@ API int yaca_simple_calculate_cmac(yaca_encrypt_algorithm_e algo,
 
 	return ret;
 }
+
+API int yaca_simple_calculate_gmac(const yaca_key_h sym_key,
+                                   const yaca_key_h iv,
+                                   const char *data,
+                                   size_t data_len,
+                                   char **mac,
+                                   size_t *mac_len)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+
+	if ((data == NULL && data_len > 0) || (data != NULL && data_len == 0) ||
+	    mac == NULL || mac_len == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = yaca_sign_initialize_gmac(&ctx, sym_key, iv);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = sign(ctx, data, data_len, mac, mac_len);
+
+	yaca_context_destroy(ctx);
+
+	return ret;
+}
+
+/* The tag goes in front of the ciphertext, as V || C of RFC 5297 */
+API int yaca_simple_encrypt_siv(const yaca_key_h sym_key,
+                                const char *aad,
+                                size_t aad_len,
+                                const char *plaintext,
+                                size_t plaintext_len,
+                                char **ciphertext,
+                                size_t *ciphertext_len)
+{
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	int ret;
+	char *lciphertext = NULL;
+	size_t lciphertext_len;
+	size_t written = 0;
+	size_t out_len;
+	size_t tag_len;
+
+	if ((plaintext == NULL && plaintext_len > 0) || (plaintext != NULL && plaintext_len == 0) ||
+	    (aad == NULL && aad_len > 0) || (aad != NULL && aad_len == 0) ||
+	    ciphertext == NULL || ciphertext_len == NULL ||
+	    plaintext_len > SIZE_MAX - SIV_TAG_LEN)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, sym_key, YACA_KEY_NULL);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	if (aad_len > 0) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad, aad_len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	lciphertext_len = SIV_TAG_LEN + plaintext_len;
+	ret = yaca_malloc(lciphertext_len, (void**)&lciphertext);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (plaintext_len > 0) {
+		ret = yaca_encrypt_update(ctx, plaintext, plaintext_len, lciphertext + SIV_TAG_LEN,
+		                          &written);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	ret = yaca_encrypt_finalize(ctx, lciphertext + SIV_TAG_LEN + written, &out_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	written += out_len;
+	assert(written == plaintext_len);
+
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_SIV_TAG, lciphertext, SIV_TAG_LEN,
+	                                     &tag_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	assert(tag_len == SIV_TAG_LEN);
+
+	*ciphertext = lciphertext;
+	*ciphertext_len = lciphertext_len;
+	lciphertext = NULL;
+
+exit:
+	yaca_free(lciphertext);
+	yaca_context_destroy(ctx);
+
+	return ret;
+}
+
+API int yaca_simple_decrypt_siv(const yaca_key_h sym_key,
+                                const char *aad,
+                                size_t aad_len,
+                                const char *ciphertext,
+                                size_t ciphertext_len,
+                                char **plaintext,
+                                size_t *plaintext_len)
+{
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	int ret;
+	char *lplaintext = NULL;
+	size_t lplaintext_len;
+	size_t written = 0;
+	size_t out_len;
+	char empty[1];
+
+	if (ciphertext == NULL || ciphertext_len < SIV_TAG_LEN ||
+	    (aad == NULL && aad_len > 0) || (aad != NULL && aad_len == 0) ||
+	    plaintext == NULL || plaintext_len == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, sym_key, YACA_KEY_NULL);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_TAG, ciphertext, SIV_TAG_LEN);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	if (aad_len > 0) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad, aad_len);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	lplaintext_len = ciphertext_len - SIV_TAG_LEN;
+	if (lplaintext_len > 0) {
+		ret = yaca_malloc(lplaintext_len, (void**)&lplaintext);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+
+		ret = yaca_decrypt_update(ctx, ciphertext + SIV_TAG_LEN, lplaintext_len, lplaintext,
+		                          &written);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	/* SIV has nothing to output here, an empty message has no buffer */
+	ret = yaca_decrypt_finalize(ctx, lplaintext == NULL ? empty : lplaintext + written, &out_len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+
+	written += out_len;
+	assert(written == lplaintext_len);
+
+	*plaintext = lplaintext;
+	*plaintext_len = written;
+	lplaintext = NULL;
+
+exit:
+	yaca_free(lplaintext);
+	yaca_context_destroy(ctx);
+
+	return ret;
+}
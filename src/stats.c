@@ -0,0 +1,165 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file stats.c
+ * @brief
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdlib.h>
+#include <string.h>
+#include <pthread.h>
+
+#include <yaca_stats.h>
+#include <yaca_error.h>
+
+#include "internal.h"
+#include "stats.h"
+
+
+#define STATS_CACHE_LINE 64
+#define STATS_FIELDS (sizeof(yaca_stats_s) / sizeof(uint64_t))
+
+/* One per thread, aligned so that two threads never share a cache line */
+struct stats_shard {
+	yaca_stats_s counters;
+	struct stats_shard *next;
+};
+
+bool stats_enabled = false;
+
+static __thread struct stats_shard *local_shard = NULL;
+static struct stats_shard *shards = NULL;
+/* counters of the threads that have already exited */
+static yaca_stats_s retired;
+/* totals at the time of the last reset */
+static yaca_stats_s baseline;
+static pthread_mutex_t stats_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_once_t stats_once = PTHREAD_ONCE_INIT;
+static pthread_key_t stats_key;
+static bool stats_key_created = false;
+
+static void stats_accumulate(yaca_stats_s *dst, const yaca_stats_s *src)
+{
+	uint64_t *d = (uint64_t *)dst;
+	const uint64_t *s = (const uint64_t *)src;
+
+	for (size_t i = 0; i < STATS_FIELDS; ++i)
+		d[i] += __atomic_load_n(&s[i], __ATOMIC_RELAXED);
+}
+
+static void stats_total(yaca_stats_s *total)
+{
+	*total = retired;
+
+	for (struct stats_shard *s = shards; s != NULL; s = s->next)
+		stats_accumulate(total, &s->counters);
+}
+
+static void stats_thread_exit(void *arg)
+{
+	struct stats_shard *shard = arg;
+	struct stats_shard **it;
+
+	pthread_mutex_lock(&stats_mutex);
+	{
+		stats_accumulate(&retired, &shard->counters);
+
+		for (it = &shards; *it != NULL; it = &(*it)->next)
+			if (*it == shard) {
+				*it = shard->next;
+				break;
+			}
+	}
+	pthread_mutex_unlock(&stats_mutex);
+
+	local_shard = NULL;
+	free(shard);
+}
+
+static void stats_key_create(void)
+{
+	stats_key_created = (pthread_key_create(&stats_key, stats_thread_exit) == 0);
+}
+
+yaca_stats_s *stats_local(void)
+{
+	struct stats_shard *shard = local_shard;
+
+	if (shard != NULL)
+		return &shard->counters;
+
+	/* Plain allocator on purpose, yaca_malloc() is counted itself */
+	if (posix_memalign((void **)&shard, STATS_CACHE_LINE, sizeof(struct stats_shard)) != 0)
+		return NULL;
+
+	memset(shard, 0, sizeof(struct stats_shard));
+
+	pthread_once(&stats_once, stats_key_create);
+	if (stats_key_created)
+		pthread_setspecific(stats_key, shard);
+
+	pthread_mutex_lock(&stats_mutex);
+	{
+		shard->next = shards;
+		shards = shard;
+	}
+	pthread_mutex_unlock(&stats_mutex);
+
+	local_shard = shard;
+	return &shard->counters;
+}
+
+API void yaca_stats_set_enabled(bool enabled)
+{
+	__atomic_store_n(&stats_enabled, enabled, __ATOMIC_RELAXED);
+}
+
+API int yaca_stats_snapshot(yaca_stats_s *stats)
+{
+	yaca_stats_s total;
+	uint64_t *d;
+	const uint64_t *b;
+
+	if (stats == NULL)
+		return YACA_ERROR_INVALID_PARAMETER;
+
+	pthread_mutex_lock(&stats_mutex);
+	{
+		stats_total(&total);
+		d = (uint64_t *)&total;
+		b = (const uint64_t *)&baseline;
+
+		for (size_t i = 0; i < STATS_FIELDS; ++i)
+			d[i] -= b[i];
+	}
+	pthread_mutex_unlock(&stats_mutex);
+
+	*stats = total;
+	return YACA_ERROR_NONE;
+}
+
+API void yaca_stats_reset(void)
+{
+	pthread_mutex_lock(&stats_mutex);
+	{
+		stats_total(&baseline);
+	}
+	pthread_mutex_unlock(&stats_mutex);
+}
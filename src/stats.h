@@ -0,0 +1,148 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file stats.h
+ * @brief
+ */
+
+#ifndef YACA_STATS_INTERNAL_H
+#define YACA_STATS_INTERNAL_H
+
+
+#include <stddef.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#include <yaca_stats.h>
+#include <yaca_error.h>
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+extern bool stats_enabled;
+
+/* Counters of the calling thread, allocated on first use. Only the owning
+ * thread writes them so there is no read-modify-write contention, readers
+ * aggregate all the shards under a lock. May return NULL on allocation
+ * failure in which case the event is simply not counted.
+ */
+yaca_stats_s *stats_local(void);
+
+static inline bool stats_is_enabled(void)
+{
+	return __atomic_load_n(&stats_enabled, __ATOMIC_RELAXED);
+}
+
+static inline void stats_add(uint64_t *counter, uint64_t n)
+{
+	__atomic_store_n(counter, __atomic_load_n(counter, __ATOMIC_RELAXED) + n, __ATOMIC_RELAXED);
+}
+
+#define STATS_ADD(field, n) \
+	do { \
+		if (stats_is_enabled()) { \
+			yaca_stats_s *stats_ = stats_local(); \
+			if (stats_ != NULL) \
+				stats_add(&stats_->field, (n)); \
+		} \
+	} while (0)
+
+static inline void stats_context_initialized(yaca_stats_context_e type)
+{
+	STATS_ADD(initialized[type], 1);
+}
+
+static inline void stats_context_updated(yaca_stats_context_e type)
+{
+	STATS_ADD(updated[type], 1);
+}
+
+static inline void stats_context_finalized(yaca_stats_context_e type)
+{
+	STATS_ADD(finalized[type], 1);
+}
+
+static inline void stats_digest_bytes(yaca_digest_algorithm_e algo, size_t len)
+{
+	if ((unsigned)algo < YACA_STATS_DIGEST_COUNT)
+		STATS_ADD(digest_bytes[algo], len);
+}
+
+static inline void stats_cipher_bytes(yaca_encrypt_algorithm_e algo, size_t len)
+{
+	if ((unsigned)algo < YACA_STATS_ENCRYPT_COUNT)
+		STATS_ADD(cipher_bytes[algo], len);
+}
+
+static inline void stats_rng_bytes(size_t len)
+{
+	STATS_ADD(rng_bytes, len);
+}
+
+static inline void stats_rng_syscall(void)
+{
+	STATS_ADD(rng_syscalls, 1);
+}
+
+static inline void stats_allocation(void)
+{
+	STATS_ADD(allocations, 1);
+}
+
+static inline void stats_authentication_failure(void)
+{
+	STATS_ADD(failures[YACA_STATS_FAILURE_AUTHENTICATION], 1);
+}
+
+static inline void stats_verification_failure(void)
+{
+	STATS_ADD(failures[YACA_STATS_FAILURE_VERIFICATION], 1);
+}
+
+/* An error dumped or mapped from the OpenSSL queue by debug.c */
+static inline void stats_error(int code)
+{
+	switch (code) {
+	case YACA_ERROR_INVALID_PARAMETER:
+		STATS_ADD(failures[YACA_STATS_FAILURE_OPENSSL_INVALID_PARAMETER], 1);
+		break;
+	case YACA_ERROR_INVALID_PASSWORD:
+		STATS_ADD(failures[YACA_STATS_FAILURE_INVALID_PASSWORD], 1);
+		break;
+	case YACA_ERROR_OUT_OF_MEMORY:
+		STATS_ADD(failures[YACA_STATS_FAILURE_OUT_OF_MEMORY], 1);
+		break;
+	case YACA_ERROR_INTERNAL:
+		STATS_ADD(failures[YACA_STATS_FAILURE_INTERNAL], 1);
+		break;
+	default:
+		break;
+	}
+}
+
+
+#ifdef __cplusplus
+} /* extern */
+#endif
+
+
+#endif /* YACA_STATS_INTERNAL_H */
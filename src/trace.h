@@ -0,0 +1,52 @@
+/*
+ *  Copyright (c) 2016-2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file trace.h
+ * @brief
+ */
+
+#ifndef YACA_TRACE_H
+#define YACA_TRACE_H
+
+
+/**
+ * Static tracepoints (USDT) for bpftrace/systemtap/perf, all under the "yaca"
+ * provider. Enabled with -DWITH_USDT=ON when sys/sdt.h is available, otherwise
+ * the probes, including their arguments, are compiled out entirely.
+ *
+ * Every traced operation has a pair of probes: name__entry and name__return.
+ * The return probe repeats the entry arguments followed by the yaca return
+ * code so that a script can attribute latency without keeping extra state.
+ * Arguments are integers only, algorithms and modes are the yaca enum values
+ * (-1 when the context is invalid). See tools/bpftrace for sample scripts.
+ */
+#ifdef YACA_USDT
+
+#include <sys/sdt.h>
+
+#define TRACE(name, ...) STAP_PROBEV(yaca, name, __VA_ARGS__)
+
+#else /* YACA_USDT */
+
+#define TRACE(name, ...) do {} while (0)
+
+#endif /* YACA_USDT */
+
+
+#endif /* YACA_TRACE_H */
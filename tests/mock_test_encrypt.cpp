@@ -30,6 +30,7 @@
 #include <yaca_encrypt.h>
 #include <yaca_key.h>
 #include <yaca_digest.h>
+#include <yaca_simple.h>
 #include <yaca_error.h>
 
 #include "common.h"
@@ -681,4 +682,395 @@ BOOST_FIXTURE_TEST_CASE(T1605__mock__negative__encrypt_decrypt_gcm, InitFixture)
 	}
 }
 
+BOOST_FIXTURE_TEST_CASE(T1606__mock__negative__wrap_unwrap_batch, InitFixture)
+{
+	struct encrypt_args {
+		yaca_encrypt_algorithm_e algo;
+		yaca_key_type_e key_type;
+		size_t kek_bit_len;
+		size_t key_bit_len;
+	};
+
+	const std::vector<encrypt_args> eargs = {
+		{YACA_ENCRYPT_AES,        YACA_KEY_TYPE_SYMMETRIC, 128, 256},
+		{YACA_ENCRYPT_3DES_3TDEA, YACA_KEY_TYPE_DES,       192, 192},
+	};
+
+	for (const auto &ea: eargs) {
+		auto test_code = [&ea]()
+			{
+				const size_t COUNT = 3;
+				int ret;
+				yaca_key_h kek = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+				yaca_key_h keys[COUNT] = {}, unwrapped[COUNT] = {};
+				char *wrapped[COUNT] = {};
+				size_t wrapped_lens[COUNT];
+				size_t iv_bit_len;
+
+				ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, ea.kek_bit_len, &kek);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_encrypt_get_iv_bit_length(ea.algo, YACA_BCM_WRAP, ea.kek_bit_len, &iv_bit_len);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				if (iv_bit_len > 0) {
+					ret = yaca_key_generate(YACA_KEY_TYPE_IV, iv_bit_len, &iv);
+					if (ret != YACA_ERROR_NONE) goto exit;
+				}
+
+				for (size_t i = 0; i < COUNT; ++i) {
+					ret = yaca_key_generate(ea.key_type, ea.key_bit_len, &keys[i]);
+					if (ret != YACA_ERROR_NONE) goto exit;
+				}
+
+				/* a single thread, the failure counter is shared */
+				ret = yaca_encrypt_wrap_keys(ea.algo, kek, iv, keys, COUNT,
+				                             wrapped, wrapped_lens, 1);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_decrypt_unwrap_keys(ea.algo, kek, iv, ea.key_type, wrapped,
+				                               wrapped_lens, COUNT, unwrapped, 1);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+			exit:
+				for (size_t i = 0; i < COUNT; ++i) {
+					yaca_key_destroy(keys[i]);
+					yaca_key_destroy(unwrapped[i]);
+					yaca_free(wrapped[i]);
+				}
+				yaca_key_destroy(kek);
+				yaca_key_destroy(iv);
+				return ret;
+			};
+
+		call_mock_test(test_code);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T1607__mock__negative__aead_batch, InitFixture)
+{
+	for (yaca_block_cipher_mode_e bcm: {YACA_BCM_GCM, YACA_BCM_CCM}) {
+		auto test_code = [bcm]()
+			{
+				const size_t COUNT = 3;
+				const size_t LEN = 32;
+				int ret;
+				yaca_key_h key = YACA_KEY_NULL;
+				char iv[12] = {};
+				char tags[COUNT][16];
+				char sealed[COUNT][LEN];
+				yaca_aead_record_s records[COUNT];
+
+				for (size_t i = 0; i < COUNT; ++i)
+					records[i] = {iv, INPUT_DATA, 8, INPUT_DATA + i, LEN, sealed[i],
+					              tags[i], -1};
+
+				ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				/* a single thread, the failure counter is shared */
+				ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, bcm, key, sizeof(iv), 16,
+				                              records, COUNT, 1);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				for (size_t i = 0; i < COUNT; ++i) {
+					records[i].input = sealed[i];
+					records[i].output = sealed[i];
+				}
+
+				ret = yaca_decrypt_aead_batch(YACA_ENCRYPT_AES, bcm, key, sizeof(iv), 16,
+				                              records, COUNT, 1);
+
+			exit:
+				yaca_key_destroy(key);
+				return ret;
+			};
+
+		call_mock_test(test_code);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T1608__mock__negative__encrypt_decrypt_cbc_hmac, InitFixture)
+{
+	for (yaca_block_cipher_mode_e bcm: {YACA_BCM_CBC_HMAC_SHA1, YACA_BCM_CBC_HMAC_SHA256}) {
+		auto test_code = [bcm]()
+			{
+				int ret;
+				yaca_context_h ctx = YACA_CONTEXT_NULL;
+				yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+				char mac_key[32] = {};
+				char aad[16] = {};
+				char tag[32];
+				char *encrypted = NULL, *decrypted = NULL;
+				size_t encrypted_len = 0, tag_len, written;
+
+				ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_zalloc(INPUT_DATA_SIZE + 16, (void**)&encrypted);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_zalloc(INPUT_DATA_SIZE + 16, (void**)&decrypted);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				/* ENCRYPT */
+				{
+					ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, bcm, key, iv);
+					if (ret != YACA_ERROR_NONE) goto exit;
+
+					ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY,
+					                                mac_key, sizeof(mac_key));
+					if (ret != YACA_ERROR_NONE) goto exit;
+
+					ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_AAD,
+					                                aad, sizeof(aad));
+					if (ret != YACA_ERROR_NONE) goto exit;
+
+					ret = yaca_encrypt_update(ctx, INPUT_DATA, INPUT_DATA_SIZE,
+					                          encrypted, &written);
+					if (ret != YACA_ERROR_NONE) goto exit;
+					encrypted_len = written;
+
+					ret = yaca_encrypt_finalize(ctx, encrypted + encrypted_len, &written);
+					if (ret != YACA_ERROR_NONE) goto exit;
+					encrypted_len += written;
+
+					ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_CBC_HMAC_TAG,
+					                                     tag, sizeof(tag), &tag_len);
+					if (ret != YACA_ERROR_NONE) goto exit;
+
+					yaca_context_destroy(ctx);
+					ctx = YACA_CONTEXT_NULL;
+				}
+
+				/* DECRYPT */
+				{
+					ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, bcm, key, iv);
+					if (ret != YACA_ERROR_NONE) goto exit;
+
+					ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY,
+					                                mac_key, sizeof(mac_key));
+					if (ret != YACA_ERROR_NONE) goto exit;
+
+					ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_AAD,
+					                                aad, sizeof(aad));
+					if (ret != YACA_ERROR_NONE) goto exit;
+
+					ret = yaca_decrypt_update(ctx, encrypted, encrypted_len,
+					                          decrypted, &written);
+					if (ret != YACA_ERROR_NONE) goto exit;
+
+					ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_TAG,
+					                                tag, tag_len);
+					if (ret != YACA_ERROR_NONE) goto exit;
+
+					ret = yaca_decrypt_finalize(ctx, decrypted + written, &written);
+					if (ret != YACA_ERROR_NONE) goto exit;
+				}
+
+			exit:
+				yaca_context_destroy(ctx);
+				yaca_key_destroy(key);
+				yaca_key_destroy(iv);
+				yaca_free(encrypted);
+				yaca_free(decrypted);
+				return ret;
+			};
+
+		call_mock_test(test_code);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T1609__mock__negative__encrypt_decrypt_siv, InitFixture)
+{
+	auto test_code = []()
+		{
+			const size_t COUNT = 2;
+			int ret;
+			yaca_context_h ctx = YACA_CONTEXT_NULL;
+			yaca_key_h key = YACA_KEY_NULL;
+			char aad[16] = {};
+			char tag[16];
+			char tags[COUNT][16];
+			char sealed[COUNT][INPUT_DATA_SIZE];
+			char *encrypted = NULL, *decrypted = NULL;
+			size_t encrypted_len, decrypted_len, tag_len, written;
+			yaca_aead_record_s records[COUNT];
+
+			ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_512BIT, &key);
+			if (ret != YACA_ERROR_NONE) goto exit;
+
+			/* ENCRYPT */
+			{
+				ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, key,
+				                              YACA_KEY_NULL);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad, sizeof(aad));
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_encrypt_update(ctx, INPUT_DATA, INPUT_DATA_SIZE, sealed[0], &written);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_encrypt_finalize(ctx, sealed[0] + written, &written);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_SIV_TAG,
+				                                     tag, sizeof(tag), &tag_len);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				yaca_context_destroy(ctx);
+				ctx = YACA_CONTEXT_NULL;
+			}
+
+			/* DECRYPT */
+			{
+				ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, key,
+				                              YACA_KEY_NULL);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_TAG, tag, tag_len);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad, sizeof(aad));
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_decrypt_update(ctx, sealed[0], INPUT_DATA_SIZE, sealed[1], &written);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_decrypt_finalize(ctx, sealed[1] + written, &written);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				yaca_context_destroy(ctx);
+				ctx = YACA_CONTEXT_NULL;
+			}
+
+			/* SIMPLE */
+			{
+				ret = yaca_simple_encrypt_siv(key, aad, sizeof(aad), INPUT_DATA, INPUT_DATA_SIZE,
+				                              &encrypted, &encrypted_len);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_simple_decrypt_siv(key, aad, sizeof(aad), encrypted, encrypted_len,
+				                              &decrypted, &decrypted_len);
+				if (ret != YACA_ERROR_NONE) goto exit;
+			}
+
+			/* BATCH, a single thread, the failure counter is shared */
+			{
+				for (size_t i = 0; i < COUNT; ++i)
+					records[i] = {NULL, aad, sizeof(aad), INPUT_DATA + i, 64, sealed[i],
+					              tags[i], -1};
+
+				ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_SIV, key, 0, 16,
+				                              records, COUNT, 1);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				for (size_t i = 0; i < COUNT; ++i)
+					records[i].input = sealed[i];
+
+				ret = yaca_decrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_SIV, key, 0, 16,
+				                              records, COUNT, 1);
+			}
+
+		exit:
+			yaca_context_destroy(ctx);
+			yaca_key_destroy(key);
+			yaca_free(encrypted);
+			yaca_free(decrypted);
+			return ret;
+		};
+
+	call_mock_test(test_code);
+}
+
+BOOST_FIXTURE_TEST_CASE(T1610__mock__negative__encrypt_decrypt_plaintext_digest, InitFixture)
+{
+	auto test_code = []()
+		{
+			/* more than a single chunk hashed at once */
+			const size_t SPLIT = 5000;
+			int ret;
+			yaca_context_h ctx = YACA_CONTEXT_NULL;
+			yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+			yaca_digest_algorithm_e algo = YACA_DIGEST_SHA256;
+			char input[2 * INPUT_DATA_SIZE];
+			char encrypted[sizeof(input) + 16], decrypted[sizeof(encrypted)];
+			char digest[32];
+			size_t encrypted_len = 0, decrypted_len = 0, written, digest_len;
+
+			memcpy(input, INPUT_DATA, INPUT_DATA_SIZE);
+			memcpy(input + INPUT_DATA_SIZE, INPUT_DATA, INPUT_DATA_SIZE);
+
+			ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+			if (ret != YACA_ERROR_NONE) goto exit;
+
+			ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+			if (ret != YACA_ERROR_NONE) goto exit;
+
+			/* ENCRYPT */
+			{
+				ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC, key, iv);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO,
+				                                &algo, sizeof(algo));
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_encrypt_update(ctx, input, SPLIT, encrypted, &written);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				encrypted_len += written;
+
+				ret = yaca_encrypt_update(ctx, input + SPLIT, sizeof(input) - SPLIT,
+				                          encrypted + encrypted_len, &written);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				encrypted_len += written;
+
+				ret = yaca_encrypt_finalize(ctx, encrypted + encrypted_len, &written);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				encrypted_len += written;
+
+				ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST,
+				                                     digest, sizeof(digest), &digest_len);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				yaca_context_destroy(ctx);
+				ctx = YACA_CONTEXT_NULL;
+			}
+
+			/* DECRYPT, in place */
+			{
+				ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC, key, iv);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO,
+				                                &algo, sizeof(algo));
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				memcpy(decrypted, encrypted, encrypted_len);
+				ret = yaca_decrypt_update(ctx, decrypted, encrypted_len, decrypted, &written);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				decrypted_len += written;
+
+				ret = yaca_decrypt_finalize(ctx, decrypted + decrypted_len, &written);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST,
+				                                     digest, sizeof(digest), &digest_len);
+				if (ret != YACA_ERROR_NONE) goto exit;
+			}
+
+		exit:
+			yaca_context_destroy(ctx);
+			yaca_key_destroy(iv);
+			yaca_key_destroy(key);
+			return ret;
+		};
+
+	call_mock_test(test_code);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
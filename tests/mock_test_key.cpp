@@ -472,6 +472,21 @@ BOOST_FIXTURE_TEST_CASE(T1208__mock__negative__key_derive_pbkdf2, InitFixture)
 			};
 
 		call_mock_test(test_code);
+
+		/* the blocks past the first one are derived by yaca */
+		auto test_code_parallel = [&pa, &salt]()
+			{
+				int ret;
+				yaca_key_h key = YACA_KEY_NULL;
+
+				ret = yaca_key_derive_pbkdf2_parallel(PASSWORD, salt, SALT_LEN, pa.iter,
+				                                      pa.digest, 2 * pa.bit_len, &key, 2);
+
+				yaca_key_destroy(key);
+				return ret;
+			};
+
+		call_mock_test(test_code_parallel);
 	}
 }
 
@@ -570,4 +585,127 @@ hajHIasdGWcAfj+Cyuk1KcTIEkBfdYR6a8C4g04Vbg6M0qEjFl5UTMwm\n\
 	call_mock_test(test_code);
 }
 
+BOOST_FIXTURE_TEST_CASE(T1210__mock__negative__key_derive_pbkdf2_batch, InitFixture)
+{
+	static const size_t COUNT = 2;
+
+	auto test_code = []()
+		{
+			int ret;
+			const char *passwords[COUNT] = {"Password_ExamplE", "Password_ExamplE_2"};
+			const char *salts[COUNT] = {"salt", NULL};
+			const size_t salt_lens[COUNT] = {4, 0};
+			yaca_key_h keys[COUNT] = {YACA_KEY_NULL, YACA_KEY_NULL};
+
+			/* a single thread, the failure counter is shared */
+			ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, COUNT, 3,
+			                                   YACA_DIGEST_SHA256, 384, keys, 1);
+
+			for (size_t i = 0; i < COUNT; ++i)
+				yaca_key_destroy(keys[i]);
+			return ret;
+		};
+
+	call_mock_test(test_code);
+}
+
+BOOST_FIXTURE_TEST_CASE(T1211__mock__negative__key_derive_dh_batch, InitFixture)
+{
+	static const size_t COUNT = 2;
+
+	struct key_args {
+		yaca_key_type_e type;
+		yaca_key_bit_length_e len;
+	};
+
+	const std::vector<struct key_args> kargs = {
+		{YACA_KEY_TYPE_DH_PRIV,
+		 (yaca_key_bit_length_e)YACA_KEY_LENGTH_DH_RFC_1024_160},
+		{YACA_KEY_TYPE_EC_PRIV,
+		 (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_SECP256K1}
+	};
+
+	for (const auto &ka: kargs) {
+		auto test_code = [&ka]()
+			{
+				int ret;
+				yaca_key_h priv1 = YACA_KEY_NULL, priv2 = YACA_KEY_NULL;
+				yaca_key_h pub2 = YACA_KEY_NULL;
+				yaca_context_h ctx = YACA_CONTEXT_NULL;
+				char buffer1[256], buffer2[256];
+				char *secrets[COUNT] = {buffer1, buffer2};
+				size_t secret_lens[COUNT];
+
+				ret = yaca_key_generate(ka.type, ka.len, &priv1);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				ret = yaca_key_generate(ka.type, ka.len, &priv2);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				ret = yaca_key_extract_public(priv2, &pub2);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_key_derive_dh_initialize(&ctx, priv1);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				{
+					const yaca_key_h pub_keys[COUNT] = {pub2, pub2};
+
+					/* a single thread, the failure counter is shared */
+					ret = yaca_key_derive_dh_batch(ctx, pub_keys, COUNT, secrets,
+					                               secret_lens, 1);
+				}
+
+			exit:
+				yaca_context_destroy(ctx);
+				yaca_key_destroy(priv1);
+				yaca_key_destroy(priv2);
+				yaca_key_destroy(pub2);
+				return ret;
+			};
+
+		call_mock_test(test_code);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T1212__mock__negative__key_import_export_raw, InitFixture)
+{
+	auto test_code = []()
+		{
+			int ret;
+			yaca_key_h prv = YACA_KEY_NULL, pub = YACA_KEY_NULL;
+			yaca_key_h prv_imp = YACA_KEY_NULL, pub_imp = YACA_KEY_NULL;
+			char *prv_raw = NULL, *pub_raw = NULL;
+			size_t prv_raw_len, pub_raw_len;
+
+			ret = yaca_key_generate(YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_PRIME256V1, &prv);
+			if (ret != YACA_ERROR_NONE) goto exit;
+			ret = yaca_key_extract_public(prv, &pub);
+			if (ret != YACA_ERROR_NONE) goto exit;
+
+			ret = yaca_key_export(prv, YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW,
+			                      NULL, &prv_raw, &prv_raw_len);
+			if (ret != YACA_ERROR_NONE) goto exit;
+			ret = yaca_key_export(pub, YACA_KEY_FORMAT_EC_COMPRESSED, YACA_KEY_FILE_FORMAT_RAW,
+			                      NULL, &pub_raw, &pub_raw_len);
+			if (ret != YACA_ERROR_NONE) goto exit;
+
+			ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_PRIME256V1,
+			                          prv_raw, prv_raw_len, &prv_imp);
+			if (ret != YACA_ERROR_NONE) goto exit;
+			ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, YACA_KEY_LENGTH_EC_PRIME256V1,
+			                          pub_raw, pub_raw_len, &pub_imp);
+			if (ret != YACA_ERROR_NONE) goto exit;
+
+		exit:
+			yaca_key_destroy(prv);
+			yaca_key_destroy(pub);
+			yaca_key_destroy(prv_imp);
+			yaca_key_destroy(pub_imp);
+			yaca_free(prv_raw);
+			yaca_free(pub_raw);
+			return ret;
+		};
+
+	call_mock_test(test_code);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -239,4 +239,153 @@ BOOST_FIXTURE_TEST_CASE(T1803__mock__negative__sign_hmac, InitFixture)
 	}
 }
 
+BOOST_FIXTURE_TEST_CASE(T1804__mock__negative__verify_prepare_key, InitFixture)
+{
+	struct prepare_args {
+		yaca_key_type_e type_prv;
+		yaca_key_bit_length_e len;
+		yaca_digest_algorithm_e digest;
+	};
+
+	const std::vector<prepare_args> pargs = {
+		{YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_512BIT, YACA_DIGEST_SHA1},
+		{YACA_KEY_TYPE_EC_PRIV, (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_PRIME256V1,
+		 YACA_DIGEST_SHA256}
+	};
+
+	for (const auto &pa: pargs) {
+		auto test_code = [&pa]() -> int
+			{
+				int ret;
+				yaca_context_h ctx = YACA_CONTEXT_NULL;
+				yaca_key_h key_prv = YACA_KEY_NULL, key_pub = YACA_KEY_NULL;
+
+				char *signature = NULL;
+				size_t signature_len;
+
+				ret = yaca_key_generate(pa.type_prv, pa.len, &key_prv);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				ret = yaca_key_extract_public(key_prv, &key_pub);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_sign_initialize(&ctx, pa.digest, key_prv);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				ret = yaca_sign_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				ret = yaca_context_get_output_length(ctx, 0, &signature_len);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				ret = yaca_malloc(signature_len, (void **)&signature);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				ret = yaca_sign_finalize(ctx, signature, &signature_len);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				yaca_context_destroy(ctx);
+				ctx = YACA_CONTEXT_NULL;
+
+				ret = yaca_verify_prepare_key(key_pub);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_verify_initialize(&ctx, pa.digest, key_pub);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				ret = yaca_verify_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+				if (ret != YACA_ERROR_NONE) goto exit;
+				ret = yaca_verify_finalize(ctx, signature, signature_len);
+
+			exit:
+				yaca_context_destroy(ctx);
+				yaca_key_destroy(key_prv);
+				yaca_key_destroy(key_pub);
+				yaca_free(signature);
+				return ret;
+			};
+
+		call_mock_test(test_code);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T1805__mock__negative__sign_prepare_key, InitFixture)
+{
+	auto test_code = []() -> int
+		{
+			int ret;
+			yaca_context_h ctx = YACA_CONTEXT_NULL;
+			yaca_key_h key_prv = YACA_KEY_NULL;
+
+			char *signature = NULL;
+			size_t signature_len;
+
+			ret = yaca_key_generate(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_512BIT, &key_prv);
+			if (ret != YACA_ERROR_NONE) goto exit;
+
+			ret = yaca_sign_prepare_key(key_prv, 2);
+			if (ret != YACA_ERROR_NONE) goto exit;
+
+			ret = yaca_sign_initialize(&ctx, YACA_DIGEST_SHA1, key_prv);
+			if (ret != YACA_ERROR_NONE) goto exit;
+			ret = yaca_sign_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+			if (ret != YACA_ERROR_NONE) goto exit;
+			ret = yaca_context_get_output_length(ctx, 0, &signature_len);
+			if (ret != YACA_ERROR_NONE) goto exit;
+			ret = yaca_malloc(signature_len, (void **)&signature);
+			if (ret != YACA_ERROR_NONE) goto exit;
+			ret = yaca_sign_finalize(ctx, signature, &signature_len);
+
+		exit:
+			yaca_context_destroy(ctx);
+			yaca_key_destroy(key_prv);
+			yaca_free(signature);
+			return ret;
+		};
+
+	call_mock_test(test_code);
+}
+
+BOOST_FIXTURE_TEST_CASE(T1806__mock__negative__sign_gmac, InitFixture)
+{
+	/* 96 bits is the IV length of the cipher, others set it first */
+	const std::vector<size_t> iv_lens = {96, 128};
+
+	for (const auto &iv_len: iv_lens) {
+		auto test_code = [&iv_len]() -> int
+			{
+				int ret;
+				yaca_context_h ctx = YACA_CONTEXT_NULL;
+				yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+
+				char *signature = NULL;
+				size_t signature_len;
+
+				ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_key_generate(YACA_KEY_TYPE_IV, iv_len, &iv);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_sign_initialize_gmac(&ctx, key, iv);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_sign_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_context_get_output_length(ctx, 0, &signature_len);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_malloc(signature_len, (void **)&signature);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+				ret = yaca_sign_finalize(ctx, signature, &signature_len);
+				if (ret != YACA_ERROR_NONE) goto exit;
+
+			exit:
+				yaca_context_destroy(ctx);
+				yaca_key_destroy(iv);
+				yaca_key_destroy(key);
+				yaca_free(signature);
+				return ret;
+			};
+
+		call_mock_test(test_code);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -248,4 +248,34 @@ BOOST_FIXTURE_TEST_CASE(T1305__mock__negative__simple_calculate_cmac, InitFixtur
 	}
 }
 
+BOOST_FIXTURE_TEST_CASE(T1306__mock__negative__simple_calculate_gmac, InitFixture)
+{
+	auto test_code = []() -> int
+		{
+			int ret;
+			yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+			char *mac = NULL;
+			size_t mac_len;
+
+			ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_192BIT, &key);
+			if (ret != YACA_ERROR_NONE) goto exit;
+
+			ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+			if (ret != YACA_ERROR_NONE) goto exit;
+
+			ret = yaca_simple_calculate_gmac(key, iv,
+			                                 INPUT_DATA, INPUT_DATA_SIZE,
+			                                 &mac, &mac_len);
+			if (ret != YACA_ERROR_NONE) goto exit;
+
+		exit:
+			yaca_key_destroy(iv);
+			yaca_key_destroy(key);
+			yaca_free(mac);
+			return ret;
+		};
+
+	call_mock_test(test_code);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
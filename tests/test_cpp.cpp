@@ -0,0 +1,288 @@
+/*
+ *  Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file    test_cpp.cpp
+ * @author  Krzysztof Jackiewicz <k.jackiewicz@samsung.com>
+ * @brief   C++ API unit tests.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <cstring>
+#include <vector>
+
+#include <yaca.hpp>
+#include <yaca_simple.h>
+
+#include "common.h"
+
+
+namespace {
+
+using AesCbc = yaca::encryptor<YACA_ENCRYPT_AES, YACA_BCM_CBC>;
+using AesCtr = yaca::encryptor<YACA_ENCRYPT_AES, YACA_BCM_CTR>;
+using AesWrap = yaca::decryptor<YACA_ENCRYPT_AES, YACA_BCM_WRAP>;
+
+/* Resolved at compile time */
+static_assert(yaca::digest<YACA_DIGEST_SHA384>::length == 48);
+static_assert(AesCbc::block_size == 16);
+static_assert(AesCbc::output_length(32) == 47);
+static_assert(AesCbc::finalize_length == 16);
+static_assert(AesCtr::output_length(32) == 32);
+static_assert(AesWrap::output_length(40) == 32);
+static_assert(!yaca::detail::cipher_supported(YACA_ENCRYPT_UNSAFE_RC4, YACA_BCM_CBC));
+static_assert(!yaca::detail::cipher_supported(YACA_ENCRYPT_CAST5, YACA_BCM_GCM));
+static_assert(!yaca::detail::cipher_supported(YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CBC_HMAC_SHA1));
+static_assert(yaca::encryptor<YACA_ENCRYPT_AES, YACA_BCM_CBC_HMAC_SHA256>::block_size == 16);
+static_assert(yaca::encryptor<YACA_ENCRYPT_AES, YACA_BCM_SIV>::output_length(32) == 32);
+static_assert(!yaca::detail::cipher_supported(YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_SIV));
+
+yaca::key generate_iv(yaca_encrypt_algorithm_e algo, yaca_block_cipher_mode_e bcm,
+                      size_t key_bit_len)
+{
+	size_t iv_bit_len;
+
+	int ret = yaca_encrypt_get_iv_bit_length(algo, bcm, key_bit_len, &iv_bit_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	if (iv_bit_len == 0)
+		return yaca::key();
+	return yaca::key::generate(YACA_KEY_TYPE_IV, iv_bit_len);
+}
+
+/* The compile time lengths against the ones of the C API */
+template <yaca_encrypt_algorithm_e Algo, yaca_block_cipher_mode_e Bcm, bool Encrypt>
+void check_output_length(yaca_key_type_e key_type, size_t key_bit_len)
+{
+	using cipher = yaca::cipher<Algo, Bcm, Encrypt>;
+
+	const std::vector<size_t> sizes = Bcm == YACA_BCM_WRAP ?
+	                                  std::vector<size_t>{0, 16, 24, 40} :
+	                                  std::vector<size_t>{0, 1, 15, 16, 17, 1000};
+	yaca::key key = yaca::key::generate(key_type, key_bit_len);
+	yaca::key iv = generate_iv(Algo, Bcm, key_bit_len);
+	cipher ctx(key, iv);
+
+	for (size_t size: sizes) {
+		size_t output_len;
+
+		int ret = yaca_context_get_output_length(ctx.get(), size, &output_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE_MESSAGE(cipher::output_length(size) == output_len,
+		                      "algo " << Algo << " bcm " << Bcm << " input " << size);
+	}
+}
+
+template <yaca_encrypt_algorithm_e Algo, yaca_block_cipher_mode_e Bcm>
+void check_output_length(yaca_key_type_e key_type, size_t key_bit_len)
+{
+	check_output_length<Algo, Bcm, true>(key_type, key_bit_len);
+	check_output_length<Algo, Bcm, false>(key_type, key_bit_len);
+}
+
+} /* namespace */
+
+
+BOOST_AUTO_TEST_SUITE(TESTS_CPP)
+
+BOOST_FIXTURE_TEST_CASE(T951__positive__cpp_key, InitDebugFixture)
+{
+	yaca::key key = yaca::key::generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT);
+	BOOST_REQUIRE(key);
+	BOOST_REQUIRE(key.type() == YACA_KEY_TYPE_SYMMETRIC);
+	BOOST_REQUIRE(key.bit_length() == YACA_KEY_LENGTH_256BIT);
+
+	yaca::key moved(std::move(key));
+	BOOST_REQUIRE(!key);
+	BOOST_REQUIRE(moved.bit_length() == YACA_KEY_LENGTH_256BIT);
+
+	key = yaca::key::generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_UNSAFE_128BIT);
+	moved = std::move(key);
+	BOOST_REQUIRE(!key);
+	BOOST_REQUIRE(moved.bit_length() == YACA_KEY_LENGTH_UNSAFE_128BIT);
+
+	yaca_key_h handle = moved.release();
+	BOOST_REQUIRE(!moved);
+	BOOST_REQUIRE(handle != YACA_KEY_NULL);
+	yaca_key_destroy(handle);
+
+	const char raw[16] = {};
+	key = yaca::key::import(YACA_KEY_TYPE_SYMMETRIC, raw);
+	BOOST_REQUIRE(key.bit_length() == 128);
+
+	key = yaca::key::derive_pbkdf2("password", yaca::span<const char>("salt", 4), 1000,
+	                               YACA_DIGEST_SHA256, YACA_KEY_LENGTH_192BIT);
+	BOOST_REQUIRE(key.bit_length() == YACA_KEY_LENGTH_192BIT);
+}
+
+BOOST_FIXTURE_TEST_CASE(T952__positive__cpp_digest, InitDebugFixture)
+{
+	int ret;
+	char *expected = NULL;
+	size_t expected_len;
+
+	ret = yaca_simple_calculate_digest(YACA_DIGEST_SHA512, INPUT_DATA, INPUT_DATA_SIZE,
+	                                   &expected, &expected_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(expected_len == yaca::digest<YACA_DIGEST_SHA512>::length);
+
+	yaca::digest<YACA_DIGEST_SHA512> ctx;
+	yaca::span<const char> input(INPUT_DATA, INPUT_DATA_SIZE);
+	ctx.update(input.first(100));
+	ctx.update(input.subspan(100));
+
+	auto digest = ctx.finalize();
+	BOOST_REQUIRE(memcmp(digest.data(), expected, expected_len) == 0);
+
+	yaca_free(expected);
+}
+
+BOOST_FIXTURE_TEST_CASE(T953__positive__cpp_output_length, InitDebugFixture)
+{
+	check_output_length<YACA_ENCRYPT_AES, YACA_BCM_ECB>(YACA_KEY_TYPE_SYMMETRIC, 128);
+	check_output_length<YACA_ENCRYPT_AES, YACA_BCM_CBC>(YACA_KEY_TYPE_SYMMETRIC, 256);
+	check_output_length<YACA_ENCRYPT_AES, YACA_BCM_CTR>(YACA_KEY_TYPE_SYMMETRIC, 192);
+	check_output_length<YACA_ENCRYPT_AES, YACA_BCM_GCM>(YACA_KEY_TYPE_SYMMETRIC, 256);
+	check_output_length<YACA_ENCRYPT_AES, YACA_BCM_CFB1>(YACA_KEY_TYPE_SYMMETRIC, 128);
+	check_output_length<YACA_ENCRYPT_AES, YACA_BCM_WRAP>(YACA_KEY_TYPE_SYMMETRIC, 256);
+	check_output_length<YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_ECB>(YACA_KEY_TYPE_DES, 64);
+	check_output_length<YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CBC>(YACA_KEY_TYPE_DES, 192);
+	check_output_length<YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_WRAP>(YACA_KEY_TYPE_DES, 192);
+	check_output_length<YACA_ENCRYPT_CAST5, YACA_BCM_OFB>(YACA_KEY_TYPE_SYMMETRIC, 128);
+	check_output_length<YACA_ENCRYPT_UNSAFE_RC4, YACA_BCM_NONE>(YACA_KEY_TYPE_SYMMETRIC, 128);
+}
+
+BOOST_FIXTURE_TEST_CASE(T954__positive__cpp_encrypt_decrypt, InitDebugFixture)
+{
+	int ret;
+	char *expected = NULL;
+	size_t expected_len;
+
+	yaca::key key = yaca::key::generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT);
+	yaca::key iv = generate_iv(YACA_ENCRYPT_AES, YACA_BCM_CBC, YACA_KEY_LENGTH_256BIT);
+
+	ret = yaca_simple_encrypt(YACA_ENCRYPT_AES, YACA_BCM_CBC, key.get(), iv.get(),
+	                          INPUT_DATA, INPUT_DATA_SIZE, &expected, &expected_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	/* in place, CBC encryption doesn't hold back whole blocks */
+	std::vector<char> buffer(INPUT_DATA, INPUT_DATA + INPUT_DATA_SIZE);
+	buffer.resize(INPUT_DATA_SIZE + AesCbc::finalize_length);
+	size_t written = 0;
+	{
+		AesCbc ctx(key, iv);
+		yaca::span<char> data(buffer);
+
+		written += ctx.update(data.first(1024), data);
+		BOOST_REQUIRE(written == 1024);
+		written += ctx.update(data.subspan(1024, INPUT_DATA_SIZE - 1024), data.subspan(1024));
+		BOOST_REQUIRE(written == INPUT_DATA_SIZE);
+		written += ctx.finalize(data.subspan(written));
+	}
+	BOOST_REQUIRE(written == expected_len);
+	BOOST_REQUIRE(memcmp(buffer.data(), expected, expected_len) == 0);
+
+	yaca::decryptor<YACA_ENCRYPT_AES, YACA_BCM_CBC> dec(key, iv);
+	std::vector<char> plain(decltype(dec)::output_length(expected_len));
+	written = dec.update(yaca::span<const char>(expected, expected_len), plain);
+	written += dec.finalize(yaca::span<char>(plain).subspan(written));
+	BOOST_REQUIRE(written == INPUT_DATA_SIZE);
+	BOOST_REQUIRE(memcmp(plain.data(), INPUT_DATA, INPUT_DATA_SIZE) == 0);
+
+	yaca_free(expected);
+
+	/* properties */
+	const char aad[] = "additional data";
+	char tag[16];
+	std::vector<char> cipher(INPUT_DATA_SIZE);
+	iv = generate_iv(YACA_ENCRYPT_AES, YACA_BCM_GCM, YACA_KEY_LENGTH_256BIT);
+
+	yaca::encryptor<YACA_ENCRYPT_AES, YACA_BCM_GCM> gcm(key, iv);
+	gcm.set_property(YACA_PROPERTY_GCM_AAD, aad);
+	written = gcm.update(yaca::span<const char>(INPUT_DATA, INPUT_DATA_SIZE), cipher);
+	char final[decltype(gcm)::finalize_length];
+	written += gcm.finalize(final);
+	BOOST_REQUIRE(written == INPUT_DATA_SIZE);
+	gcm.set_property(YACA_PROPERTY_GCM_TAG_LEN, sizeof(tag));
+	BOOST_REQUIRE(gcm.get_property(YACA_PROPERTY_GCM_TAG, tag) == sizeof(tag));
+
+	yaca::decryptor<YACA_ENCRYPT_AES, YACA_BCM_GCM> ungcm(key, iv);
+	ungcm.set_property(YACA_PROPERTY_GCM_AAD, aad);
+	written = ungcm.update(cipher, plain);
+	ungcm.set_property(YACA_PROPERTY_GCM_TAG, tag);
+	written += ungcm.finalize(final);
+	BOOST_REQUIRE(written == INPUT_DATA_SIZE);
+	BOOST_REQUIRE(memcmp(plain.data(), INPUT_DATA, INPUT_DATA_SIZE) == 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(T955__negative__cpp, InitDebugFixture)
+{
+	auto invalid = [](const yaca::error &e) {
+		return e.code() == YACA_ERROR_INVALID_PARAMETER;
+	};
+
+	BOOST_CHECK_EXCEPTION(yaca::key::generate(YACA_KEY_TYPE_SYMMETRIC, 7),
+	                      yaca::error, invalid);
+
+	yaca::key key = yaca::key::generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT);
+	yaca::key iv = generate_iv(YACA_ENCRYPT_AES, YACA_BCM_CBC, YACA_KEY_LENGTH_256BIT);
+
+	/* no IV */
+	BOOST_CHECK_EXCEPTION(AesCbc(key, yaca::key()), yaca::error, invalid);
+
+	/* the output has to fit the compile time length */
+	AesCbc ctx(key, iv);
+	char output[AesCbc::output_length(32)];
+	BOOST_CHECK_EXCEPTION(ctx.update(yaca::span<const char>(INPUT_DATA, 32),
+	                                 yaca::span<char>(output, sizeof(output) - 1)),
+	                      yaca::error, invalid);
+	BOOST_CHECK_EXCEPTION(ctx.finalize(yaca::span<char>(output, AesCbc::finalize_length - 1)),
+	                      yaca::error, invalid);
+	BOOST_CHECK_EXCEPTION(ctx.update(yaca::span<const char>(), output),
+	                      yaca::error, invalid);
+
+	yaca::digest<YACA_DIGEST_SHA256> digest;
+	char small[yaca::digest<YACA_DIGEST_SHA256>::length - 1];
+	BOOST_CHECK_EXCEPTION(digest.finalize(small), yaca::error, invalid);
+
+	/* no key */
+	BOOST_CHECK_EXCEPTION(yaca::hmac<YACA_DIGEST_SHA256>{yaca::key()}, yaca::error, invalid);
+}
+
+BOOST_FIXTURE_TEST_CASE(T956__positive__cpp_hmac, InitDebugFixture)
+{
+	int ret;
+	char *expected = NULL;
+	size_t expected_len;
+
+	yaca::key key = yaca::key::generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT);
+
+	ret = yaca_simple_calculate_hmac(YACA_DIGEST_SHA224, key.get(), INPUT_DATA,
+	                                 INPUT_DATA_SIZE, &expected, &expected_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(expected_len == yaca::hmac<YACA_DIGEST_SHA224>::length);
+
+	yaca::hmac<YACA_DIGEST_SHA224> ctx(key);
+	ctx.update(yaca::span<const char>(INPUT_DATA, INPUT_DATA_SIZE));
+	auto mac = ctx.finalize();
+	BOOST_REQUIRE(memcmp(mac.data(), expected, expected_len) == 0);
+
+	yaca_free(expected);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
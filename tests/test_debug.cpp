@@ -25,6 +25,8 @@
 #include <boost/test/unit_test.hpp>
 #include <string>
 #include <vector>
+#include <thread>
+#include <algorithm>
 #include <iostream>
 
 #include <openssl/err.h>
@@ -215,4 +217,131 @@ BOOST_FIXTURE_TEST_CASE(T004__positive__error_handle, CallbackCleanup)
 
 }
 
+BOOST_FIXTURE_TEST_CASE(T005__positive__error_records, CallbackCleanup)
+{
+	int ret;
+	yaca_error_record_s records[YACA_ERROR_RECORDS_MAX + 1];
+	size_t count;
+	char buf[BUF_SIZE];
+	std::string str;
+
+	yaca_error_clear_records();
+
+	ret = yaca_error_get_records(records, YACA_ERROR_RECORDS_MAX, &count);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(count == 0);
+
+	/* Recorded without the callback */
+	PEMerr(PEM_F_LOAD_IV, PEM_R_READ_KEY);
+	RSAerr(RSA_F_RSA_VERIFY, RSA_R_DATA_TOO_LARGE);
+	ERROR_DUMP(YACA_ERROR_INTERNAL);
+	ERROR_DUMP(YACA_ERROR_INVALID_PARAMETER);
+	BOOST_REQUIRE(ERR_peek_error() == 0);
+
+	ret = yaca_error_get_records(records, YACA_ERROR_RECORDS_MAX, &count);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(count == 2);
+
+	BOOST_REQUIRE(records[0].code == YACA_ERROR_INVALID_PARAMETER);
+	BOOST_REQUIRE(records[0].openssl_errors_count == 0);
+
+	BOOST_REQUIRE(records[1].code == YACA_ERROR_INTERNAL);
+	BOOST_REQUIRE(std::string(records[1].file) == __FILE__);
+	BOOST_REQUIRE(std::string(records[1].function) == "test_method");
+	BOOST_REQUIRE(records[1].line == records[0].line - 1);
+	BOOST_REQUIRE(records[1].openssl_errors_count == 2);
+	BOOST_REQUIRE(ERR_GET_REASON(records[1].openssl_errors[0]) == PEM_R_READ_KEY);
+	BOOST_REQUIRE(ERR_GET_REASON(records[1].openssl_errors[1]) == RSA_R_DATA_TOO_LARGE);
+
+	/* The same text the callback gets */
+	yaca_debug_set_error_cb(&debug_error_cb);
+	PEMerr(PEM_F_LOAD_IV, PEM_R_READ_KEY);
+	ERROR_DUMP(YACA_ERROR_INTERNAL);
+	BOOST_REQUIRE(error_cb_called == 1);
+
+	ret = yaca_error_get_records(records, 1, &count);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(count == 1);
+
+	ret = yaca_error_format_record(&records[0], buf, sizeof(buf));
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(std::string(buf) == std::string(last_buf));
+	BOOST_REQUIRE(std::string(buf).find("YACA_ERROR_INTERNAL") != std::string::npos);
+	BOOST_REQUIRE(std::count(buf, buf + strlen(buf), '\n') == 2);
+
+	/* Too short */
+	ret = yaca_error_format_record(&records[0], buf, 40);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	str = buf;
+	BOOST_REQUIRE(str.size() == 39);
+	BOOST_REQUIRE(str.substr(str.size() - strlen(ELLIPSIS)) == ELLIPSIS);
+
+	ret = yaca_error_format_record(&records[0], buf, sizeof(ELLIPSIS));
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(std::string(buf) == ELLIPSIS);
+
+	/* Only the latest ones are kept */
+	yaca_debug_set_error_cb(NULL);
+	for (int i = 0; i < YACA_ERROR_RECORDS_MAX + 3; ++i)
+		error_dump("file", i, "function", YACA_ERROR_INTERNAL);
+
+	ret = yaca_error_get_records(records, YACA_ERROR_RECORDS_MAX + 1, &count);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(count == YACA_ERROR_RECORDS_MAX);
+	for (size_t i = 0; i < count; ++i)
+		BOOST_REQUIRE(records[i].line == (int)(YACA_ERROR_RECORDS_MAX + 2 - i));
+
+	/* Other threads have their own */
+	std::thread([&count]{
+		yaca_error_record_s record;
+
+		error_dump("thread", 0, "function", YACA_ERROR_INTERNAL);
+		yaca_error_get_records(&record, 1, &count);
+	}).join();
+	BOOST_REQUIRE(count == 1);
+
+	ret = yaca_error_get_records(records, 1, &count);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(std::string(records[0].file) == "file");
+
+	yaca_error_clear_records();
+
+	ret = yaca_error_get_records(records, YACA_ERROR_RECORDS_MAX, &count);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(count == 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(T006__negative__error_records, CallbackCleanup)
+{
+	int ret;
+	yaca_error_record_s record;
+	size_t count;
+	char buf[BUF_SIZE];
+
+	ERROR_DUMP(YACA_ERROR_INTERNAL);
+
+	ret = yaca_error_get_records(NULL, 1, &count);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_error_get_records(&record, 0, &count);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_error_get_records(&record, 1, NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_error_get_records(&record, 1, &count);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_error_format_record(NULL, buf, sizeof(buf));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_error_format_record(&record, NULL, sizeof(buf));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_error_format_record(&record, buf, sizeof(ELLIPSIS) - 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	yaca_error_clear_records();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
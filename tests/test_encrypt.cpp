@@ -24,13 +24,18 @@
 
 #include <boost/test/unit_test.hpp>
 #include <vector>
+#include <algorithm>
 #include <cstring>
 #include <iostream>
+#include <string>
 
 #include <yaca_crypto.h>
 #include <yaca_encrypt.h>
 #include <yaca_key.h>
 #include <yaca_digest.h>
+#include <yaca_simple.h>
+#include <yaca_seal.h>
+#include <yaca_sign.h>
 #include <yaca_error.h>
 
 #include "common.h"
@@ -57,6 +62,34 @@ yaca_key_h generate_iv(yaca_encrypt_algorithm_e algo, yaca_block_cipher_mode_e b
 	return iv;
 }
 
+/* Feeds the input in records of at most split bytes, each one in its own
+ * buffer sized by yaca_context_get_output_length(). With in_place the output
+ * overwrites the record, otherwise it goes to a separate buffer.
+ */
+void update_records(yaca_context_h ctx, const char *input, size_t input_len, size_t split,
+                    update_fun_5_t *fun, bool in_place, std::vector<char> &output)
+{
+	for (size_t pos = 0; pos < input_len; pos += split) {
+		int ret;
+		size_t len = std::min(split, input_len - pos);
+		size_t capacity, written;
+
+		ret = yaca_context_get_output_length(ctx, len, &capacity);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		std::vector<char> record(input + pos, input + pos + len);
+		std::vector<char> separate(capacity);
+		record.resize(std::max(len, capacity));
+		char *out = in_place ? record.data() : separate.data();
+
+		ret = fun(ctx, record.data(), len, out, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(written <= capacity);
+
+		output.insert(output.end(), out, out + written);
+	}
+}
+
 } // namespace
 
 
@@ -2396,4 +2429,2345 @@ BOOST_FIXTURE_TEST_CASE(T612__negative__encrypt_decrypt_gcm, InitDebugFixture)
 	yaca_free(aad);
 }
 
+BOOST_FIXTURE_TEST_CASE(T613__positive__get_property_into, InitDebugFixture)
+{
+	static const struct {
+		yaca_block_cipher_mode_e bcm;
+		yaca_property_e tag_property;
+		size_t tag_len;
+	} tparams[] = {
+		{YACA_BCM_GCM, YACA_PROPERTY_GCM_TAG, 16},
+		{YACA_BCM_CCM, YACA_PROPERTY_CCM_TAG, 12},
+	};
+
+	for (const auto &tp: tparams) {
+		int ret;
+		yaca_context_h ctx = YACA_CONTEXT_NULL;
+		yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+		char *encrypted = NULL, *decrypted = NULL, *tag = NULL;
+		size_t encrypted_len, decrypted_len, tag_len, written;
+		char tag_into[16];
+		size_t tag_into_len;
+
+		ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		iv = generate_iv(YACA_ENCRYPT_AES, tp.bcm, YACA_KEY_LENGTH_256BIT);
+
+		ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, tp.bcm, key, iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		allocate_output(ctx, INPUT_DATA_SIZE, 1, encrypted);
+
+		ret = yaca_encrypt_update(ctx, INPUT_DATA, INPUT_DATA_SIZE, encrypted, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		encrypted_len = written;
+
+		ret = yaca_encrypt_finalize(ctx, encrypted + encrypted_len, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		encrypted_len += written;
+
+		/* exact capacity is enough */
+		ret = yaca_context_get_property_into(ctx, tp.tag_property,
+		                                     tag_into, tp.tag_len, &tag_into_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(tag_into_len == tp.tag_len);
+
+		/* same value as the allocating variant, CCM tag can only be read once */
+		if (tp.bcm == YACA_BCM_GCM) {
+			ret = yaca_context_get_property(ctx, tp.tag_property, (void**)&tag, &tag_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			BOOST_REQUIRE(tag_len == tag_into_len);
+			BOOST_REQUIRE(memcmp(tag, tag_into, tag_len) == 0);
+		}
+
+		yaca_context_destroy(ctx);
+		ctx = YACA_CONTEXT_NULL;
+
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, tp.bcm, key, iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		if (tp.bcm == YACA_BCM_CCM) {
+			ret = yaca_context_set_property(ctx, tp.tag_property, tag_into, tag_into_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		}
+
+		allocate_output(ctx, encrypted_len, 1, decrypted);
+
+		ret = yaca_decrypt_update(ctx, encrypted, encrypted_len, decrypted, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		decrypted_len = written;
+
+		if (tp.bcm == YACA_BCM_GCM) {
+			ret = yaca_context_set_property(ctx, tp.tag_property, tag_into, tag_into_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		}
+
+		ret = yaca_decrypt_finalize(ctx, decrypted + decrypted_len, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		decrypted_len += written;
+
+		BOOST_REQUIRE(decrypted_len == INPUT_DATA_SIZE);
+		BOOST_REQUIRE(memcmp(decrypted, INPUT_DATA, INPUT_DATA_SIZE) == 0);
+
+		yaca_context_destroy(ctx);
+		yaca_key_destroy(key);
+		yaca_key_destroy(iv);
+		yaca_free(encrypted);
+		yaca_free(decrypted);
+		yaca_free(tag);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T614__negative__get_property_into, InitDebugFixture)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL, ctx_digest = YACA_CONTEXT_NULL;
+	yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+	char *encrypted = NULL;
+	size_t written;
+	char tag[16];
+	size_t tag_len = 0;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	iv = generate_iv(YACA_ENCRYPT_AES, YACA_BCM_GCM, YACA_KEY_LENGTH_256BIT);
+
+	ret = yaca_digest_initialize(&ctx_digest, YACA_DIGEST_SHA256);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_GCM, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	allocate_output(ctx, INPUT_DATA_SIZE, 1, encrypted);
+
+	ret = yaca_encrypt_update(ctx, INPUT_DATA, INPUT_DATA_SIZE, encrypted, &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	/* not finalized yet */
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_GCM_TAG, tag, sizeof(tag), &tag_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_finalize(ctx, encrypted + written, &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_context_get_property_into(YACA_CONTEXT_NULL, YACA_PROPERTY_GCM_TAG,
+	                                     tag, sizeof(tag), &tag_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_context_get_property_into(ctx_digest, YACA_PROPERTY_GCM_TAG,
+	                                     tag, sizeof(tag), &tag_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_context_get_property_into(ctx, YACA_INVALID_PROPERTY, tag, sizeof(tag), &tag_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_CCM_TAG, tag, sizeof(tag), &tag_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_PADDING, tag, sizeof(tag), &tag_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_GCM_TAG, NULL, sizeof(tag), &tag_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_GCM_TAG, tag, 0, &tag_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_GCM_TAG, tag, sizeof(tag), NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	/* the required length is reported back */
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_GCM_TAG, tag, 8, &tag_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	BOOST_REQUIRE(tag_len == 16);
+
+	yaca_context_destroy(ctx);
+	yaca_context_destroy(ctx_digest);
+	yaca_key_destroy(key);
+	yaca_key_destroy(iv);
+	yaca_free(encrypted);
+}
+
+BOOST_FIXTURE_TEST_CASE(T615__positive__encrypt_decrypt_in_place, InitDebugFixture)
+{
+	struct encrypt_args {
+		yaca_encrypt_algorithm_e algo;
+		yaca_block_cipher_mode_e bcm;
+		size_t key_bit_len;
+		yaca_padding_e padding;
+	};
+
+	/* Every ENCRYPTION_CIPHERS entry, the padding decides how much ECB
+	 * and CBC hold back between the records
+	 */
+	const std::vector<encrypt_args> eargs = {
+		{YACA_ENCRYPT_AES, YACA_BCM_CBC,  128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CBC,  128, YACA_PADDING_NONE},
+		{YACA_ENCRYPT_AES, YACA_BCM_CCM,  128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CFB,  128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CFB1, 128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CFB8, 128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CTR,  128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_ECB,  128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_ECB,  128, YACA_PADDING_NONE},
+		{YACA_ENCRYPT_AES, YACA_BCM_GCM,  128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_OFB,  128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_WRAP, 128, YACA_INVALID_PADDING},
+
+		{YACA_ENCRYPT_AES, YACA_BCM_CBC,  192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CCM,  192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CFB,  192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CFB1, 192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CFB8, 192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CTR,  192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_ECB,  192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_GCM,  192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_OFB,  192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_WRAP, 192, YACA_INVALID_PADDING},
+
+		{YACA_ENCRYPT_AES, YACA_BCM_CBC,  256, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CCM,  256, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CFB,  256, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CFB1, 256, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CFB8, 256, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_CTR,  256, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_ECB,  256, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_GCM,  256, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_OFB,  256, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_AES, YACA_BCM_WRAP, 256, YACA_INVALID_PADDING},
+
+		{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CBC,  64, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CFB,  64, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CFB1, 64, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_CFB8, 64, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_ECB,  64, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_UNSAFE_DES, YACA_BCM_OFB,  64, YACA_INVALID_PADDING},
+
+		{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_CBC, 128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_CFB, 128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_ECB, 128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_UNSAFE_3DES_2TDEA, YACA_BCM_OFB, 128, YACA_INVALID_PADDING},
+
+		{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CBC,  192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CFB,  192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CFB1, 192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CFB8, 192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_ECB,  192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_OFB,  192, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_WRAP, 192, YACA_INVALID_PADDING},
+
+		{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_CBC, 128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_CFB, 128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_ECB, 128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_UNSAFE_RC2, YACA_BCM_OFB, 128, YACA_INVALID_PADDING},
+
+		{YACA_ENCRYPT_UNSAFE_RC4, YACA_BCM_NONE, 128, YACA_INVALID_PADDING},
+
+		{YACA_ENCRYPT_CAST5, YACA_BCM_CBC, 128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_CAST5, YACA_BCM_CFB, 128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_CAST5, YACA_BCM_ECB, 128, YACA_INVALID_PADDING},
+		{YACA_ENCRYPT_CAST5, YACA_BCM_OFB, 128, YACA_INVALID_PADDING},
+	};
+
+	/* Longer than what the library bounces through its stack at once */
+	std::vector<char> input;
+	for (int i = 0; i < 3; ++i)
+		input.insert(input.end(), INPUT_DATA, INPUT_DATA + INPUT_DATA_SIZE);
+
+	for (const auto &ea: eargs) {
+		int ret;
+		yaca_context_h ctx = YACA_CONTEXT_NULL;
+		yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+		size_t tag_len;
+
+		/* CCM and WRAP take a single update, WRAP only of a key size */
+		size_t input_len = input.size();
+		size_t split = 1001;
+		if (ea.bcm == YACA_BCM_WRAP)
+			input_len = split = ea.key_bit_len / 8;
+		else if (ea.bcm == YACA_BCM_CCM)
+			split = input_len;
+
+		yaca_property_e tag_prop = ea.bcm == YACA_BCM_GCM ? YACA_PROPERTY_GCM_TAG :
+		                                                    YACA_PROPERTY_CCM_TAG;
+		bool aead = ea.bcm == YACA_BCM_GCM || ea.bcm == YACA_BCM_CCM;
+
+		ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, ea.key_bit_len, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		iv = generate_iv(ea.algo, ea.bcm, ea.key_bit_len);
+
+		/* ENCRYPT, out of place for the reference and then in place */
+		std::vector<char> encrypted[2];
+		char tag[2][16];
+
+		for (int in_place = 0; in_place < 2; ++in_place) {
+			size_t written;
+
+			ret = yaca_encrypt_initialize(&ctx, ea.algo, ea.bcm, key, iv);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			if (ea.padding != YACA_INVALID_PADDING) {
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_PADDING, &ea.padding,
+				                                sizeof(yaca_padding_e));
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			}
+
+			update_records(ctx, input.data(), input_len, split, &yaca_encrypt_update,
+			               in_place, encrypted[in_place]);
+
+			/* at most one block */
+			char last[32];
+			ret = yaca_encrypt_finalize(ctx, last, &written);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			encrypted[in_place].insert(encrypted[in_place].end(), last, last + written);
+
+			if (aead) {
+				ret = yaca_context_get_property_into(ctx, tag_prop, tag[in_place],
+				                                     sizeof(tag[in_place]), &tag_len);
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			}
+
+			yaca_context_destroy(ctx);
+			ctx = YACA_CONTEXT_NULL;
+		}
+
+		/* 3DES key wrap uses a random IV of its own */
+		if (ea.algo != YACA_ENCRYPT_3DES_3TDEA || ea.bcm != YACA_BCM_WRAP)
+			BOOST_REQUIRE(encrypted[0] == encrypted[1]);
+		if (aead)
+			BOOST_REQUIRE(memcmp(tag[0], tag[1], tag_len) == 0);
+
+		/* DECRYPT in place */
+		{
+			std::vector<char> decrypted;
+			size_t written;
+
+			ret = yaca_decrypt_initialize(&ctx, ea.algo, ea.bcm, key, iv);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			if (ea.padding != YACA_INVALID_PADDING) {
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_PADDING, &ea.padding,
+				                                sizeof(yaca_padding_e));
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			}
+
+			if (ea.bcm == YACA_BCM_CCM) {
+				ret = yaca_context_set_property(ctx, tag_prop, tag[1], tag_len);
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			}
+
+			if (ea.bcm == YACA_BCM_WRAP || ea.bcm == YACA_BCM_CCM)
+				split = encrypted[1].size();
+
+			update_records(ctx, encrypted[1].data(), encrypted[1].size(), split,
+			               &yaca_decrypt_update, true, decrypted);
+
+			if (ea.bcm == YACA_BCM_GCM) {
+				ret = yaca_context_set_property(ctx, tag_prop, tag[1], tag_len);
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			}
+
+			/* at most one block */
+			char last[32];
+			ret = yaca_decrypt_finalize(ctx, last, &written);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			decrypted.insert(decrypted.end(), last, last + written);
+
+			BOOST_REQUIRE(decrypted.size() == input_len);
+			BOOST_REQUIRE(memcmp(decrypted.data(), input.data(), input_len) == 0);
+
+			yaca_context_destroy(ctx);
+			ctx = YACA_CONTEXT_NULL;
+		}
+
+		yaca_key_destroy(key);
+		yaca_key_destroy(iv);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T616__negative__encrypt_decrypt_in_place, InitDebugFixture)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+	char buffer[256];
+	size_t written;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	memcpy(buffer, INPUT_DATA, sizeof(buffer));
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CTR, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_encrypt_update(ctx, buffer, 64, buffer + 1, &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_update(ctx, buffer + 63, 64, buffer, &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	/* adjacent buffers don't overlap */
+	ret = yaca_encrypt_update(ctx, buffer, 64, buffer + 64, &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	yaca_context_destroy(ctx);
+	ctx = YACA_CONTEXT_NULL;
+
+	ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_decrypt_update(ctx, buffer + 16, 128, buffer, &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	yaca_context_destroy(ctx);
+	yaca_key_destroy(iv);
+	yaca_key_destroy(key);
+}
+
+BOOST_FIXTURE_TEST_CASE(T617__positive__wrap_unwrap_batch, InitDebugFixture)
+{
+	struct wrap_args {
+		yaca_encrypt_algorithm_e algo;
+		size_t kek_bit_len;
+		yaca_key_type_e key_type;
+		size_t key_bit_len;
+		size_t threads;
+	};
+
+	const std::vector<wrap_args> wargs = {
+		{YACA_ENCRYPT_AES,        128, YACA_KEY_TYPE_SYMMETRIC, 256, 0},
+		{YACA_ENCRYPT_AES,        192, YACA_KEY_TYPE_SYMMETRIC, 128, 1},
+		{YACA_ENCRYPT_AES,        256, YACA_KEY_TYPE_SYMMETRIC, 192, 4},
+		{YACA_ENCRYPT_AES,        256, YACA_KEY_TYPE_DES,       192, 64},
+		{YACA_ENCRYPT_3DES_3TDEA, 192, YACA_KEY_TYPE_DES,       128, 1},
+		{YACA_ENCRYPT_3DES_3TDEA, 192, YACA_KEY_TYPE_SYMMETRIC, 192, 3},
+	};
+
+	const size_t COUNT = 37;
+
+	for (const auto &wa: wargs) {
+		int ret;
+		yaca_key_h kek = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+		std::vector<yaca_key_h> keys(COUNT, YACA_KEY_NULL), unwrapped(COUNT, YACA_KEY_NULL);
+		std::vector<char *> wrapped(COUNT, nullptr);
+		std::vector<size_t> wrapped_lens(COUNT);
+
+		ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, wa.kek_bit_len, &kek);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		iv = generate_iv(wa.algo, YACA_BCM_WRAP, wa.kek_bit_len);
+
+		for (auto &key: keys) {
+			ret = yaca_key_generate(wa.key_type, wa.key_bit_len, &key);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		}
+
+		ret = yaca_encrypt_wrap_keys(wa.algo, kek, iv, keys.data(), COUNT,
+		                             wrapped.data(), wrapped_lens.data(), wa.threads);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		/* AES key wrap is deterministic, 3DES uses a random IV every time */
+		if (wa.algo == YACA_ENCRYPT_AES) {
+			char *key_data = NULL, *single = NULL;
+			size_t key_data_len, single_len;
+
+			ret = yaca_key_export(keys[COUNT - 1], YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW,
+			                      NULL, &key_data, &key_data_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_simple_encrypt(wa.algo, YACA_BCM_WRAP, kek, iv, key_data, key_data_len,
+			                          &single, &single_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			BOOST_REQUIRE(single_len == wrapped_lens[COUNT - 1]);
+			BOOST_REQUIRE(memcmp(single, wrapped[COUNT - 1], single_len) == 0);
+
+			yaca_free(single);
+			yaca_free(key_data);
+		}
+
+		ret = yaca_decrypt_unwrap_keys(wa.algo, kek, iv, wa.key_type,
+		                               wrapped.data(), wrapped_lens.data(), COUNT,
+		                               unwrapped.data(), wa.threads);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		/* The raw buffer variant on the same data */
+		std::vector<std::vector<char>> raw(COUNT, std::vector<char>(wa.key_bit_len / 8 + 16));
+		std::vector<char *> raw_ptrs(COUNT);
+		std::vector<size_t> raw_lens(COUNT);
+		for (size_t i = 0; i < COUNT; ++i)
+			raw_ptrs[i] = raw[i].data();
+
+		ret = yaca_decrypt_unwrap_batch(wa.algo, kek, iv, wrapped.data(), wrapped_lens.data(),
+		                                COUNT, raw_ptrs.data(), raw_lens.data(), wa.threads);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			yaca_key_type_e type;
+			size_t bit_len;
+			char *key_data = NULL, *unwrapped_data = NULL;
+			size_t key_data_len, unwrapped_data_len;
+
+			ret = yaca_key_get_type(unwrapped[i], &type);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			BOOST_REQUIRE(type == wa.key_type);
+			ret = yaca_key_get_bit_length(unwrapped[i], &bit_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			BOOST_REQUIRE(bit_len == wa.key_bit_len);
+
+			ret = yaca_key_export(keys[i], YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW,
+			                      NULL, &key_data, &key_data_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			ret = yaca_key_export(unwrapped[i], YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW,
+			                      NULL, &unwrapped_data, &unwrapped_data_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			BOOST_REQUIRE(key_data_len == unwrapped_data_len);
+			BOOST_REQUIRE(memcmp(key_data, unwrapped_data, key_data_len) == 0);
+			BOOST_REQUIRE(raw_lens[i] == key_data_len);
+			BOOST_REQUIRE(memcmp(key_data, raw_ptrs[i], key_data_len) == 0);
+
+			yaca_free(key_data);
+			yaca_free(unwrapped_data);
+		}
+
+		/* and back with yaca_encrypt_wrap_batch() */
+		std::vector<std::vector<char>> rewrapped(COUNT, std::vector<char>(wa.key_bit_len / 8 + 16));
+		std::vector<char *> rewrapped_ptrs(COUNT);
+		std::vector<size_t> rewrapped_lens(COUNT);
+		for (size_t i = 0; i < COUNT; ++i)
+			rewrapped_ptrs[i] = rewrapped[i].data();
+
+		ret = yaca_encrypt_wrap_batch(wa.algo, kek, iv, raw_ptrs.data(), raw_lens.data(), COUNT,
+		                              rewrapped_ptrs.data(), rewrapped_lens.data(), wa.threads);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			BOOST_REQUIRE(rewrapped_lens[i] == wrapped_lens[i]);
+			if (wa.algo == YACA_ENCRYPT_AES)
+				BOOST_REQUIRE(memcmp(rewrapped_ptrs[i], wrapped[i], wrapped_lens[i]) == 0);
+		}
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			yaca_key_destroy(keys[i]);
+			yaca_key_destroy(unwrapped[i]);
+			yaca_free(wrapped[i]);
+		}
+		yaca_key_destroy(iv);
+		yaca_key_destroy(kek);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T618__negative__wrap_unwrap_batch, InitDebugFixture)
+{
+	int ret;
+	yaca_key_h kek = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+	yaca_key_h key_rsa = YACA_KEY_NULL;
+	yaca_key_h keys[3] = {YACA_KEY_NULL, YACA_KEY_NULL, YACA_KEY_NULL};
+	yaca_key_h unwrapped[3] = {YACA_KEY_NULL, YACA_KEY_NULL, YACA_KEY_NULL};
+	char *wrapped[3] = {NULL, NULL, NULL};
+	size_t wrapped_lens[3];
+	char buffers[3][48];
+	char *outputs[3] = {buffers[0], buffers[1], buffers[2]};
+	size_t output_lens[3];
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &kek);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	iv = generate_iv(YACA_ENCRYPT_AES, YACA_BCM_WRAP, YACA_KEY_LENGTH_256BIT);
+	ret = yaca_key_generate(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_1024BIT, &key_rsa);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	for (auto &key: keys) {
+		ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	ret = yaca_encrypt_wrap_keys(YACA_ENCRYPT_AES, kek, iv, NULL, 3,
+	                             wrapped, wrapped_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_wrap_keys(YACA_ENCRYPT_AES, kek, iv, keys, 0,
+	                             wrapped, wrapped_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_wrap_keys(YACA_ENCRYPT_AES, YACA_KEY_NULL, iv, keys, 3,
+	                             wrapped, wrapped_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_wrap_keys(YACA_ENCRYPT_UNSAFE_RC4, kek, iv, keys, 3,
+	                             wrapped, wrapped_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_wrap_keys(YACA_ENCRYPT_AES, kek, iv, keys, 3,
+	                             NULL, wrapped_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_wrap_keys(YACA_ENCRYPT_AES, kek, iv, keys, 3,
+	                             wrapped, wrapped_lens, 65);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	/* every key has to be wrappable */
+	yaca_key_h mixed[3] = {keys[0], key_rsa, keys[2]};
+	ret = yaca_encrypt_wrap_keys(YACA_ENCRYPT_AES, kek, iv, mixed, 3,
+	                             wrapped, wrapped_lens, 2);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	BOOST_REQUIRE(wrapped[0] == NULL);
+
+	ret = yaca_encrypt_wrap_keys(YACA_ENCRYPT_AES, kek, iv, keys, 3,
+	                             wrapped, wrapped_lens, 2);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_decrypt_unwrap_keys(YACA_ENCRYPT_AES, kek, iv, YACA_KEY_TYPE_RSA_PRIV,
+	                               wrapped, wrapped_lens, 3, unwrapped, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_decrypt_unwrap_keys(YACA_ENCRYPT_AES, kek, iv, YACA_KEY_TYPE_SYMMETRIC,
+	                               wrapped, NULL, 3, unwrapped, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	/* a 256 bit key is not a valid DES key */
+	ret = yaca_decrypt_unwrap_keys(YACA_ENCRYPT_AES, kek, iv, YACA_KEY_TYPE_DES,
+	                               wrapped, wrapped_lens, 3, unwrapped, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	BOOST_REQUIRE(unwrapped[0] == YACA_KEY_NULL);
+
+	wrapped_lens[2] -= 1;
+	ret = yaca_decrypt_unwrap_batch(YACA_ENCRYPT_AES, kek, iv, wrapped, wrapped_lens, 3,
+	                                outputs, output_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	wrapped_lens[2] += 1;
+
+	outputs[1] = NULL;
+	ret = yaca_decrypt_unwrap_batch(YACA_ENCRYPT_AES, kek, iv, wrapped, wrapped_lens, 3,
+	                                outputs, output_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	outputs[1] = buffers[1];
+
+	ret = yaca_decrypt_unwrap_batch(YACA_ENCRYPT_AES, kek, iv, wrapped, wrapped_lens, 3,
+	                                outputs, output_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	/* AES key wrap needs at least 128 bits, in multiples of 64 */
+	output_lens[0] = 12;
+	ret = yaca_encrypt_wrap_batch(YACA_ENCRYPT_AES, kek, iv, outputs, output_lens, 3,
+	                              wrapped, wrapped_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_wrap_batch(YACA_ENCRYPT_AES, kek, iv, NULL, output_lens, 3,
+	                              wrapped, wrapped_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	for (size_t i = 0; i < 3; ++i) {
+		yaca_key_destroy(keys[i]);
+		yaca_free(wrapped[i]);
+	}
+	yaca_key_destroy(key_rsa);
+	yaca_key_destroy(iv);
+	yaca_key_destroy(kek);
+}
+
+/* One record through the context API, the reference for the AEAD batches */
+void aead_seal_single(yaca_block_cipher_mode_e bcm, yaca_key_h key, const yaca_aead_record_s &r,
+                      size_t iv_len, size_t tag_len, std::vector<char> &output,
+                      std::vector<char> &tag)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_key_h iv = YACA_KEY_NULL;
+	size_t written, final_len, len;
+	bool ccm = bcm == YACA_BCM_CCM;
+
+	ret = yaca_key_import(YACA_KEY_TYPE_IV, NULL, r.iv, iv_len, &iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, bcm, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	if (ccm) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CCM_TAG_LEN,
+		                                &tag_len, sizeof(tag_len));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	/* CCM needs the total length before the AAD */
+	if (ccm && r.aad_len > 0) {
+		ret = yaca_encrypt_update(ctx, NULL, r.input_len, NULL, &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	if (r.aad_len > 0) {
+		ret = yaca_context_set_property(ctx, ccm ? YACA_PROPERTY_CCM_AAD :
+		                                           YACA_PROPERTY_GCM_AAD,
+		                                r.aad, r.aad_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	output.resize(r.input_len + 16);
+	ret = yaca_encrypt_update(ctx, r.input, r.input_len, output.data(), &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_encrypt_finalize(ctx, output.data() + written, &final_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	output.resize(written + final_len);
+
+	if (!ccm) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_GCM_TAG_LEN,
+		                                &tag_len, sizeof(tag_len));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	tag.resize(tag_len);
+	ret = yaca_context_get_property_into(ctx, ccm ? YACA_PROPERTY_CCM_TAG :
+	                                                YACA_PROPERTY_GCM_TAG,
+	                                     tag.data(), tag.size(), &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(len == tag_len);
+
+	yaca_context_destroy(ctx);
+	yaca_key_destroy(iv);
+}
+
+BOOST_FIXTURE_TEST_CASE(T619__positive__encrypt_decrypt_aead_batch, InitDebugFixture)
+{
+	struct aead_args {
+		yaca_block_cipher_mode_e bcm;
+		size_t key_bit_len;
+		size_t iv_len;
+		size_t tag_len;
+		size_t threads;
+	};
+
+	const std::vector<aead_args> aargs = {
+		{YACA_BCM_GCM, 128, 12, 16, 0},
+		{YACA_BCM_GCM, 192, 16,  4, 1},
+		{YACA_BCM_GCM, 256, 12, 13, 3},
+		{YACA_BCM_GCM, 256,  8, 16, 64},
+		{YACA_BCM_CCM, 128,  7,  4, 1},
+		{YACA_BCM_CCM, 192, 12, 12, 2},
+		{YACA_BCM_CCM, 256, 13, 16, 5},
+	};
+
+	const size_t COUNT = 29;
+
+	for (const auto &aa: aargs) {
+		int ret;
+		yaca_key_h key = YACA_KEY_NULL;
+		std::vector<std::vector<char>> ivs(COUNT, std::vector<char>(aa.iv_len));
+		std::vector<std::vector<char>> sealed(COUNT), tags(COUNT), opened(COUNT);
+		std::vector<yaca_aead_record_s> records(COUNT);
+
+		ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, aa.key_bit_len, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		/* Every third record without AAD, the last one in place */
+		for (size_t i = 0; i < COUNT; ++i) {
+			yaca_aead_record_s &r = records[i];
+
+			ret = yaca_randomize_bytes(ivs[i].data(), aa.iv_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			sealed[i].assign(INPUT_DATA + i, INPUT_DATA + i + 1 + 37 * i);
+			tags[i].assign(aa.tag_len, 0);
+
+			r.iv = ivs[i].data();
+			r.aad = i % 3 == 0 ? NULL : INPUT_DATA + 100 * i;
+			r.aad_len = i % 3 == 0 ? 0 : i + 1;
+			r.input = i == COUNT - 1 ? sealed[i].data() : INPUT_DATA + i;
+			r.input_len = sealed[i].size();
+			r.output = sealed[i].data();
+			r.tag = tags[i].data();
+			r.result = -1;
+		}
+
+		ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, aa.bcm, key, aa.iv_len, aa.tag_len,
+		                              records.data(), COUNT, aa.threads);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			std::vector<char> output, tag;
+			yaca_aead_record_s r = records[i];
+
+			BOOST_REQUIRE(r.result == YACA_ERROR_NONE);
+
+			r.input = INPUT_DATA + i;
+			aead_seal_single(aa.bcm, key, r, aa.iv_len, aa.tag_len, output, tag);
+			BOOST_REQUIRE(output == sealed[i]);
+			BOOST_REQUIRE(tag == tags[i]);
+		}
+
+		/* and back */
+		for (size_t i = 0; i < COUNT; ++i) {
+			yaca_aead_record_s &r = records[i];
+
+			opened[i].assign(sealed[i].size(), 0);
+			r.input = sealed[i].data();
+			r.output = i == COUNT - 1 ? sealed[i].data() : opened[i].data();
+			r.result = -1;
+		}
+
+		ret = yaca_decrypt_aead_batch(YACA_ENCRYPT_AES, aa.bcm, key, aa.iv_len, aa.tag_len,
+		                              records.data(), COUNT, aa.threads);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			BOOST_REQUIRE(records[i].result == YACA_ERROR_NONE);
+			BOOST_REQUIRE(memcmp(records[i].output, INPUT_DATA + i, records[i].input_len) == 0);
+		}
+
+		yaca_key_destroy(key);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T620__negative__encrypt_decrypt_aead_batch, InitDebugFixture)
+{
+	const size_t COUNT = 4;
+	const size_t LEN = 64;
+	int ret;
+	yaca_key_h key = YACA_KEY_NULL, key2 = YACA_KEY_NULL, key_des = YACA_KEY_NULL;
+	yaca_key_h key_rsa = YACA_KEY_NULL;
+	char ivs[COUNT][12] = {};
+	char tags[COUNT][16];
+	char sealed[COUNT][LEN];
+	char opened[COUNT][LEN];
+	yaca_aead_record_s records[COUNT];
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key2);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_DES, YACA_KEY_LENGTH_192BIT, &key_des);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_1024BIT, &key_rsa);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	for (size_t i = 0; i < COUNT; ++i) {
+		ivs[i][0] = i;
+		records[i] = {ivs[i], INPUT_DATA, 10, INPUT_DATA + i, LEN, sealed[i], tags[i], -1};
+	}
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, YACA_KEY_NULL, 12, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key_rsa, 12, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key_des, 12, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_GCM, key, 12, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_CBC, key, 12, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key, 0, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_CCM, key, 14, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key, 12, 6,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_CCM, key, 12, 13,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key, 12, 16,
+	                              NULL, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key, 12, 16,
+	                              records, 0, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key, 12, 16,
+	                              records, COUNT, 65);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	/* every record is checked before any of them is processed */
+	records[2].iv = NULL;
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key, 12, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	BOOST_REQUIRE(records[0].result == -1);
+	records[2].iv = ivs[2];
+
+	records[1].input_len = 0;
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key, 12, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	records[1].input_len = LEN;
+
+	records[3].tag = NULL;
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key, 12, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	records[3].tag = tags[3];
+
+	records[0].aad = NULL;
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key, 12, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	records[0].aad = INPUT_DATA;
+
+	/* partially overlapping buffers */
+	records[1].input = sealed[1] + 1;
+	ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key, 12, 16,
+	                              records, COUNT, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	records[1].input = INPUT_DATA + 1;
+
+	for (yaca_block_cipher_mode_e bcm: {YACA_BCM_GCM, YACA_BCM_CCM}) {
+		ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, bcm, key, 12, 16,
+		                              records, COUNT, 2);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			records[i].input = sealed[i];
+			records[i].output = opened[i];
+		}
+
+		/* a forged tag, a forged ciphertext and modified AAD fail alone */
+		tags[0][5] ^= 1;
+		sealed[2][LEN - 1] ^= 1;
+		records[3].aad_len = 9;
+		ret = yaca_decrypt_aead_batch(YACA_ENCRYPT_AES, bcm, key, 12, 16,
+		                              records, COUNT, 2);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		BOOST_REQUIRE(records[0].result == YACA_ERROR_INVALID_PARAMETER);
+		BOOST_REQUIRE(records[1].result == YACA_ERROR_NONE);
+		BOOST_REQUIRE(records[2].result == YACA_ERROR_INVALID_PARAMETER);
+		BOOST_REQUIRE(records[3].result == YACA_ERROR_INVALID_PARAMETER);
+		BOOST_REQUIRE(memcmp(opened[1], INPUT_DATA + 1, LEN) == 0);
+		for (size_t i: {0, 2, 3})
+			BOOST_REQUIRE(std::all_of(opened[i], opened[i] + LEN,
+			                          [](char c) { return c == 0; }));
+		tags[0][5] ^= 1;
+		sealed[2][LEN - 1] ^= 1;
+		records[3].aad_len = 10;
+
+		/* a wrong key */
+		ret = yaca_decrypt_aead_batch(YACA_ENCRYPT_AES, bcm, key2, 12, 16,
+		                              records, COUNT, 1);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		for (size_t i = 0; i < COUNT; ++i)
+			BOOST_REQUIRE(records[i].result == YACA_ERROR_INVALID_PARAMETER);
+
+		/* a GCM tag may be truncated, CCM authenticates its length as well */
+		ret = yaca_decrypt_aead_batch(YACA_ENCRYPT_AES, bcm, key, 12, 12,
+		                              records, COUNT, 1);
+		BOOST_REQUIRE(ret == (bcm == YACA_BCM_GCM ? YACA_ERROR_NONE :
+		                                            YACA_ERROR_INVALID_PARAMETER));
+
+		ret = yaca_decrypt_aead_batch(YACA_ENCRYPT_AES, bcm, key, 12, 16,
+		                              records, COUNT, 1);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			records[i].input = INPUT_DATA + i;
+			records[i].output = sealed[i];
+		}
+	}
+
+	yaca_key_destroy(key_rsa);
+	yaca_key_destroy(key_des);
+	yaca_key_destroy(key2);
+	yaca_key_destroy(key);
+}
+
+/* CBC and a separate HMAC(IV || AAD || ciphertext || AL), the reference for
+ * the CBC-HMAC modes
+ */
+void cbc_hmac_seal_reference(yaca_digest_algorithm_e digest, yaca_key_h key, yaca_key_h iv,
+                             const std::vector<char> &mac_key, const std::vector<char> &aad,
+                             const std::vector<char> &input, bool padding,
+                             std::vector<char> &output, std::vector<char> &tag)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_key_h hkey = YACA_KEY_NULL;
+	size_t written, final_len, len;
+	char *iv_data = NULL;
+	size_t iv_len;
+	char al[8];
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	if (!padding) {
+		yaca_padding_e none = YACA_PADDING_NONE;
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_PADDING, &none, sizeof(none));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	output.resize(input.size() + 16);
+	ret = yaca_encrypt_update(ctx, input.data(), input.size(), output.data(), &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_encrypt_finalize(ctx, output.data() + written, &final_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	output.resize(written + final_len);
+	yaca_context_destroy(ctx);
+
+	ret = yaca_key_import(YACA_KEY_TYPE_SYMMETRIC, NULL, mac_key.data(), mac_key.size(), &hkey);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_sign_initialize_hmac(&ctx, digest, hkey);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_key_export(iv, YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW, NULL,
+	                      &iv_data, &iv_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_sign_update(ctx, iv_data, iv_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	if (!aad.empty()) {
+		ret = yaca_sign_update(ctx, aad.data(), aad.size());
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+	ret = yaca_sign_update(ctx, output.data(), output.size());
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	for (size_t i = 0; i < sizeof(al); ++i)
+		al[i] = (char)((uint64_t)aad.size() * 8 >> (56 - 8 * i));
+	ret = yaca_sign_update(ctx, al, sizeof(al));
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	tag.resize(64);
+	ret = yaca_sign_finalize(ctx, tag.data(), &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	tag.resize(len);
+
+	yaca_free(iv_data);
+	yaca_context_destroy(ctx);
+	yaca_key_destroy(hkey);
+}
+
+BOOST_FIXTURE_TEST_CASE(T621__positive__encrypt_decrypt_cbc_hmac, InitDebugFixture)
+{
+	struct cbc_hmac_args {
+		yaca_block_cipher_mode_e bcm;
+		yaca_digest_algorithm_e digest;
+		size_t key_bit_len;
+		size_t mac_key_len;
+		size_t aad_len;
+		size_t input_len;
+		bool padding;
+		bool in_place;
+	};
+
+	/* lengths above 4096 span several chunks of the single pass */
+	const std::vector<cbc_hmac_args> cargs = {
+		{YACA_BCM_CBC_HMAC_SHA1,   YACA_DIGEST_SHA1,   128, 20,  0,     1, true,  false},
+		{YACA_BCM_CBC_HMAC_SHA1,   YACA_DIGEST_SHA1,   192, 64, 16,  4096, true,  true},
+		{YACA_BCM_CBC_HMAC_SHA1,   YACA_DIGEST_SHA1,   256, 99, 13, 10003, true,  false},
+		{YACA_BCM_CBC_HMAC_SHA256, YACA_DIGEST_SHA256, 128, 32, 16,    33, true,  true},
+		{YACA_BCM_CBC_HMAC_SHA256, YACA_DIGEST_SHA256, 192,  1,  0,  8192, false, false},
+		{YACA_BCM_CBC_HMAC_SHA256, YACA_DIGEST_SHA256, 256, 32,  7, 12345, true,  true},
+		{YACA_BCM_CBC_HMAC_SHA256, YACA_DIGEST_SHA256, 256, 32, 16,  4112, false, true},
+	};
+
+	for (const auto &ca: cargs) {
+		int ret;
+		yaca_context_h ctx = YACA_CONTEXT_NULL;
+		yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+		yaca_padding_e none = YACA_PADDING_NONE;
+		std::vector<char> mac_key(ca.mac_key_len), aad(ca.aad_len), input(ca.input_len);
+		std::vector<char> ref_output, ref_tag, output, tag(64), decrypted;
+		size_t written, len, half = ca.input_len / 2;
+
+		for (size_t i = 0; i < ca.input_len; ++i)
+			input[i] = INPUT_DATA[i % INPUT_DATA_SIZE];
+
+		ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, ca.key_bit_len, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_randomize_bytes(mac_key.data(), mac_key.size());
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		if (ca.aad_len > 0) {
+			ret = yaca_randomize_bytes(aad.data(), aad.size());
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		}
+
+		cbc_hmac_seal_reference(ca.digest, key, iv, mac_key, aad, input, ca.padding,
+		                        ref_output, ref_tag);
+
+		/* ENCRYPT, in two updates unless in place */
+		{
+			ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, ca.bcm, key, iv);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY,
+			                                mac_key.data(), mac_key.size());
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			/* the AAD may come in parts */
+			if (ca.aad_len > 0) {
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_AAD,
+				                                aad.data(), 1);
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			}
+			if (ca.aad_len > 1) {
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_AAD,
+				                                aad.data() + 1, aad.size() - 1);
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			}
+
+			if (!ca.padding) {
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_PADDING,
+				                                &none, sizeof(none));
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			}
+
+			output.assign(input.size() + 32, 0);
+			size_t total = 0;
+
+			if (ca.in_place) {
+				std::copy(input.begin(), input.end(), output.begin());
+				ret = yaca_encrypt_update(ctx, output.data(), input.size(),
+				                          output.data(), &written);
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+				total += written;
+			} else {
+				if (half > 0) {
+					ret = yaca_encrypt_update(ctx, input.data(), half,
+					                          output.data(), &written);
+					BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+					total += written;
+				}
+
+				ret = yaca_encrypt_update(ctx, input.data() + half, input.size() - half,
+				                          output.data() + total, &written);
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+				total += written;
+			}
+
+			ret = yaca_encrypt_finalize(ctx, output.data() + total, &written);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			total += written;
+			output.resize(total);
+
+			ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_CBC_HMAC_TAG,
+			                                     tag.data(), tag.size(), &len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			tag.resize(len);
+
+			BOOST_REQUIRE(output == ref_output);
+			BOOST_REQUIRE(tag == ref_tag);
+
+			yaca_context_destroy(ctx);
+			ctx = YACA_CONTEXT_NULL;
+		}
+
+		/* DECRYPT with the full and a truncated tag */
+		for (size_t tag_len: {tag.size(), tag.size() / 2}) {
+			ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, ca.bcm, key, iv);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY,
+			                                mac_key.data(), mac_key.size());
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			if (ca.aad_len > 0) {
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_AAD,
+				                                aad.data(), aad.size());
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			}
+
+			if (!ca.padding) {
+				ret = yaca_context_set_property(ctx, YACA_PROPERTY_PADDING,
+				                                &none, sizeof(none));
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			}
+
+			decrypted.assign(output.size() + 16, 0);
+			if (ca.in_place)
+				std::copy(output.begin(), output.end(), decrypted.begin());
+
+			ret = yaca_decrypt_update(ctx, ca.in_place ? decrypted.data() : output.data(),
+			                          output.size(), decrypted.data(), &written);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			size_t total = written;
+
+			ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_TAG,
+			                                tag.data(), tag_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_decrypt_finalize(ctx, decrypted.data() + total, &written);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			total += written;
+			decrypted.resize(total);
+
+			BOOST_REQUIRE(decrypted == input);
+
+			yaca_context_destroy(ctx);
+			ctx = YACA_CONTEXT_NULL;
+		}
+
+		yaca_key_destroy(iv);
+		yaca_key_destroy(key);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T622__negative__encrypt_decrypt_cbc_hmac, InitDebugFixture)
+{
+	const size_t LEN = 100;
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_key_h key = YACA_KEY_NULL, key_des = YACA_KEY_NULL;
+	yaca_key_h iv = YACA_KEY_NULL, iv64 = YACA_KEY_NULL, iv_forged = YACA_KEY_NULL;
+	char mac_key[32] = {1, 2, 3};
+	char aad[16] = {4, 5, 6};
+	char sealed[LEN + 16], opened[LEN + 16];
+	char tag[32], small[16];
+	char *iv_data = NULL;
+	size_t sealed_len, written, len, iv_len;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_DES, YACA_KEY_LENGTH_192BIT, &key_des);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_64BIT, &iv64);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_export(iv, YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW, NULL,
+	                      &iv_data, &iv_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	/* AES only, with a 128-bit IV */
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_CBC_HMAC_SHA1,
+	                              key_des, iv64);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC_HMAC_SHA1, key, iv64);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC_HMAC_SHA256, key,
+	                              YACA_KEY_NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	/* the HMAC properties belong to the CBC-HMAC modes */
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY, mac_key, sizeof(mac_key));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_AAD, aad, sizeof(aad));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	yaca_context_destroy(ctx);
+	ctx = YACA_CONTEXT_NULL;
+
+	/* ENCRYPT */
+	{
+		ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC_HMAC_SHA256, key, iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		/* nothing before the HMAC key */
+		ret = yaca_encrypt_update(ctx, INPUT_DATA, LEN, sealed, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_AAD, aad, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_encrypt_finalize(ctx, sealed, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY, NULL, 10);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY, mac_key, 0);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		/* a key set again replaces the previous one */
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY, aad, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY,
+		                                mac_key, sizeof(mac_key));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_AAD, aad, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		/* not after the AAD */
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY,
+		                                mac_key, sizeof(mac_key));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_GCM_AAD, aad, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_TAG, tag, sizeof(tag));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_encrypt_update(ctx, INPUT_DATA, LEN, sealed, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		sealed_len = written;
+
+		/* no AAD after the data */
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_AAD, aad, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_CBC_HMAC_TAG,
+		                                     tag, sizeof(tag), &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_encrypt_finalize(ctx, sealed + sealed_len, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		sealed_len += written;
+
+		ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_GCM_TAG,
+		                                     tag, sizeof(tag), &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_CBC_HMAC_TAG,
+		                                     small, sizeof(small), &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		BOOST_REQUIRE(len == sizeof(tag));
+
+		ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_CBC_HMAC_TAG,
+		                                     tag, sizeof(tag), &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(len == sizeof(tag));
+
+		yaca_context_destroy(ctx);
+		ctx = YACA_CONTEXT_NULL;
+	}
+
+	struct forgery {
+		size_t iv_byte;
+		size_t mac_key_byte;
+		size_t aad_byte;
+		size_t sealed_byte;
+		size_t tag_byte;
+	};
+
+	/* one of the IV, the HMAC key, the AAD, the ciphertext or the tag is
+	 * modified, the last ciphertext byte breaks the padding as well. A
+	 * modified IV only changes the first plaintext block.
+	 */
+	const size_t NONE = (size_t)-1;
+	const std::vector<forgery> forgeries = {
+		{0,    NONE, NONE, NONE,           NONE},
+		{15,   NONE, NONE, NONE,           NONE},
+		{NONE, 0,    NONE, NONE,           NONE},
+		{NONE, NONE, 15,   NONE,           NONE},
+		{NONE, NONE, NONE, 0,              NONE},
+		{NONE, NONE, NONE, sealed_len - 1, NONE},
+		{NONE, NONE, NONE, NONE,           31},
+		{NONE, NONE, NONE, NONE,           0},
+	};
+
+	/* DECRYPT */
+	for (const auto &f: forgeries) {
+		auto flip = [](char *buf, size_t byte) {
+			if (byte != (size_t)-1)
+				buf[byte] ^= 0x01;
+		};
+
+		flip(iv_data, f.iv_byte);
+		ret = yaca_key_import(YACA_KEY_TYPE_IV, NULL, iv_data, iv_len, &iv_forged);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		flip(iv_data, f.iv_byte);
+
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC_HMAC_SHA256, key,
+		                              iv_forged);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		flip(mac_key, f.mac_key_byte);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY,
+		                                mac_key, sizeof(mac_key));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		flip(mac_key, f.mac_key_byte);
+
+		flip(aad, f.aad_byte);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_AAD, aad, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		flip(aad, f.aad_byte);
+
+		flip(sealed, f.sealed_byte);
+		ret = yaca_decrypt_update(ctx, sealed, sealed_len, opened, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		flip(sealed, f.sealed_byte);
+
+		/* no finalization without the tag, which is checked */
+		ret = yaca_decrypt_finalize(ctx, opened + written, &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_CBC_HMAC_TAG,
+		                                     tag, sizeof(tag), &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_TAG, tag, 15);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_TAG, tag, 33);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		flip(tag, f.tag_byte);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_TAG, tag, sizeof(tag));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		flip(tag, f.tag_byte);
+
+		ret = yaca_decrypt_finalize(ctx, opened + written, &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		yaca_context_destroy(ctx);
+		ctx = YACA_CONTEXT_NULL;
+		yaca_key_destroy(iv_forged);
+		iv_forged = YACA_KEY_NULL;
+	}
+
+	/* the first ciphertext block moved to the end of the AAD, the same bytes
+	 * are MACed but with another AAD length
+	 */
+	{
+		char longer_aad[sizeof(aad) + 16];
+
+		memcpy(longer_aad, aad, sizeof(aad));
+		memcpy(longer_aad + sizeof(aad), sealed, 16);
+
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC_HMAC_SHA256, key, iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY,
+		                                mac_key, sizeof(mac_key));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_AAD,
+		                                longer_aad, sizeof(longer_aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_decrypt_update(ctx, sealed + 16, sealed_len - 16, opened, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_TAG, tag, sizeof(tag));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_decrypt_finalize(ctx, opened + written, &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		yaca_context_destroy(ctx);
+		ctx = YACA_CONTEXT_NULL;
+	}
+
+	/* the HMAC-SHA1 tag is shorter */
+	ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC_HMAC_SHA1, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_KEY, mac_key, sizeof(mac_key));
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_TAG, tag, 9);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_TAG, tag, 21);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_CBC_HMAC_TAG, tag, 10);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	yaca_context_destroy(ctx);
+
+	yaca_free(iv_data);
+	yaca_key_destroy(iv64);
+	yaca_key_destroy(iv);
+	yaca_key_destroy(key_des);
+	yaca_key_destroy(key);
+}
+
+std::vector<char> siv_hex(const char *hex)
+{
+	std::vector<char> out;
+
+	for (size_t i = 0; hex[i] != '\0' && hex[i + 1] != '\0'; i += 2)
+		out.push_back(static_cast<char>(std::stoi(std::string(hex + i, 2), nullptr, 16)));
+
+	return out;
+}
+
+/* SIV through the context API, the AADs as separate components */
+void siv_seal(yaca_key_h key, const std::vector<std::vector<char>> &aads,
+              const std::vector<char> &input, bool in_place,
+              std::vector<char> &output, std::vector<char> &tag)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t written = 0, len;
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, key, YACA_KEY_NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	for (const auto &aad: aads) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad.data(), aad.size());
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	output.assign(input.size() + 16, 0);
+	if (in_place) {
+		std::copy(input.begin(), input.end(), output.begin());
+		ret = yaca_encrypt_update(ctx, output.data(), input.size(), output.data(), &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	} else if (!input.empty()) {
+		ret = yaca_encrypt_update(ctx, input.data(), input.size(), output.data(), &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+	BOOST_REQUIRE(written == input.size());
+
+	ret = yaca_encrypt_finalize(ctx, output.data() + written, &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(len == 0);
+	output.resize(written);
+
+	tag.assign(16, 0);
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_SIV_TAG, tag.data(), tag.size(),
+	                                     &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(len == 16);
+
+	yaca_context_destroy(ctx);
+}
+
+int siv_open(yaca_key_h key, const std::vector<std::vector<char>> &aads,
+             const std::vector<char> &input, const std::vector<char> &tag,
+             std::vector<char> &output)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t written = 0, len;
+
+	ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, key, YACA_KEY_NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_TAG, tag.data(), tag.size());
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	for (const auto &aad: aads) {
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad.data(), aad.size());
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	output.assign(input.size() + 16, 0);
+	if (!input.empty()) {
+		ret = yaca_decrypt_update(ctx, input.data(), input.size(), output.data(), &written);
+		if (ret != YACA_ERROR_NONE)
+			goto exit;
+	}
+
+	ret = yaca_decrypt_finalize(ctx, output.data() + written, &len);
+	if (ret != YACA_ERROR_NONE)
+		goto exit;
+	output.resize(written + len);
+
+exit:
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
+BOOST_FIXTURE_TEST_CASE(T623__positive__encrypt_decrypt_siv, InitDebugFixture)
+{
+	struct siv_kat {
+		const char *key;
+		std::vector<const char *> aads;
+		const char *plaintext;
+		const char *tag;
+		const char *ciphertext;
+	};
+
+	/* RFC 5297 A.1 and A.2, the nonce of A.2 is its last AAD component */
+	const std::vector<siv_kat> kats = {
+		{
+			"fffefdfcfbfaf9f8f7f6f5f4f3f2f1f0f0f1f2f3f4f5f6f7f8f9fafbfcfdfeff",
+			{"101112131415161718191a1b1c1d1e1f2021222324252627"},
+			"112233445566778899aabbccddee",
+			"85632d07c6e8f37f950acd320a2ecc93",
+			"40c02b9690c4dc04daef7f6afe5c",
+		},
+		{
+			"7f7e7d7c7b7a79787776757473727170404142434445464748494a4b4c4d4e4f",
+			{"00112233445566778899aabbccddeeffdeaddadadeaddadaffeeddccbbaa99887766554433221100",
+			 "102030405060708090a0",
+			 "09f911029d74e35bd84156c5635688c0"},
+			"7468697320697320736f6d6520706c61696e7465787420746f20656e6372797074207573696e67205349562d414553",
+			"7bdb6e3b432667eb06f4d14bff2fbd0f",
+			"cb900f2fddbe404326601965c889bf17dba77ceb094fa663b7a3f748ba8af829ea64ad544a272e9c485b62a3fd5c0d",
+		},
+	};
+
+	for (const auto &kat: kats) {
+		int ret;
+		yaca_key_h key = YACA_KEY_NULL;
+		std::vector<char> raw = siv_hex(kat.key);
+		std::vector<std::vector<char>> aads;
+		std::vector<char> plaintext = siv_hex(kat.plaintext);
+		std::vector<char> output, tag, opened;
+
+		for (const char *aad: kat.aads)
+			aads.push_back(siv_hex(aad));
+
+		ret = yaca_key_import(YACA_KEY_TYPE_SYMMETRIC, NULL, raw.data(), raw.size(), &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (bool in_place: {false, true}) {
+			siv_seal(key, aads, plaintext, in_place, output, tag);
+			BOOST_REQUIRE(tag == siv_hex(kat.tag));
+			BOOST_REQUIRE(output == siv_hex(kat.ciphertext));
+		}
+
+		ret = siv_open(key, aads, output, tag, opened);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(opened == plaintext);
+
+		yaca_key_destroy(key);
+	}
+
+	/* No IV, the tag is the synthetic one */
+	for (size_t key_bit_len: {256, 384, 512}) {
+		int ret;
+		size_t iv_bit_len = 1;
+
+		ret = yaca_encrypt_get_iv_bit_length(YACA_ENCRYPT_AES, YACA_BCM_SIV, key_bit_len,
+		                                      &iv_bit_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(iv_bit_len == 0);
+	}
+
+	/* Deterministic: the same input gives the same output, any change gives another one */
+	for (size_t key_bit_len: {256, 384, 512}) {
+		for (size_t len: {0, 1, 15, 16, 17, 32, 1000}) {
+			int ret;
+			yaca_key_h key = YACA_KEY_NULL;
+			std::vector<char> input(INPUT_DATA, INPUT_DATA + len);
+			std::vector<std::vector<char>> aads = {{'a', 'b'}, {'c'}};
+			std::vector<std::vector<char>> swapped = {{'c'}, {'a', 'b'}};
+			std::vector<char> output, tag, output2, tag2, opened;
+			char *simple = NULL, *simple_opened = NULL;
+			size_t simple_len, simple_opened_len;
+
+			ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, key_bit_len, &key);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			siv_seal(key, aads, input, false, output, tag);
+			siv_seal(key, aads, input, false, output2, tag2);
+			BOOST_REQUIRE(output == output2);
+			BOOST_REQUIRE(tag == tag2);
+
+			/* the order of the components matters */
+			siv_seal(key, swapped, input, false, output2, tag2);
+			BOOST_REQUIRE(tag != tag2);
+
+			ret = siv_open(key, aads, output, tag, opened);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			BOOST_REQUIRE(opened == input);
+
+			/* the simple API with a single AAD is the tag and the ciphertext */
+			siv_seal(key, {{'a', 'b'}}, input, false, output, tag);
+			ret = yaca_simple_encrypt_siv(key, "ab", 2, len > 0 ? input.data() : NULL, len,
+			                              &simple, &simple_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			BOOST_REQUIRE(simple_len == len + 16);
+			BOOST_REQUIRE(std::equal(tag.begin(), tag.end(), simple));
+			BOOST_REQUIRE(std::equal(output.begin(), output.end(), simple + 16));
+
+			ret = yaca_simple_decrypt_siv(key, "ab", 2, simple, simple_len,
+			                              &simple_opened, &simple_opened_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			BOOST_REQUIRE(simple_opened_len == len);
+			BOOST_REQUIRE((simple_opened == NULL) == (len == 0));
+			BOOST_REQUIRE(len == 0 || memcmp(simple_opened, input.data(), len) == 0);
+
+			yaca_free(simple_opened);
+			yaca_free(simple);
+			yaca_key_destroy(key);
+		}
+	}
+
+	/* The batch gives what the contexts give */
+	for (size_t threads: {0, 1, 3}) {
+		int ret;
+		const size_t COUNT = 17;
+		yaca_key_h key = YACA_KEY_NULL;
+		std::vector<std::vector<char>> sealed(COUNT), tags(COUNT), opened(COUNT);
+		std::vector<yaca_aead_record_s> records(COUNT);
+
+		ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_512BIT, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		/* Every third record without AAD, the last one in place */
+		for (size_t i = 0; i < COUNT; ++i) {
+			yaca_aead_record_s &r = records[i];
+
+			sealed[i].assign(INPUT_DATA + i, INPUT_DATA + i + 1 + 37 * i);
+			tags[i].assign(16, 0);
+
+			r.iv = NULL;
+			r.aad = i % 3 == 0 ? NULL : INPUT_DATA + 100 * i;
+			r.aad_len = i % 3 == 0 ? 0 : i + 1;
+			r.input = i == COUNT - 1 ? sealed[i].data() : INPUT_DATA + i;
+			r.input_len = sealed[i].size();
+			r.output = sealed[i].data();
+			r.tag = tags[i].data();
+			r.result = -1;
+		}
+
+		ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_SIV, key, 0, 16,
+		                              records.data(), COUNT, threads);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			std::vector<std::vector<char>> aads;
+			std::vector<char> input(INPUT_DATA + i, INPUT_DATA + i + records[i].input_len);
+			std::vector<char> output, tag;
+
+			BOOST_REQUIRE(records[i].result == YACA_ERROR_NONE);
+
+			if (records[i].aad_len > 0)
+				aads.emplace_back(records[i].aad, records[i].aad + records[i].aad_len);
+			siv_seal(key, aads, input, false, output, tag);
+			BOOST_REQUIRE(output == sealed[i]);
+			BOOST_REQUIRE(tag == tags[i]);
+		}
+
+		/* and back */
+		for (size_t i = 0; i < COUNT; ++i) {
+			yaca_aead_record_s &r = records[i];
+
+			opened[i].assign(sealed[i].size(), 0);
+			r.input = sealed[i].data();
+			r.output = i == COUNT - 1 ? sealed[i].data() : opened[i].data();
+			r.result = -1;
+		}
+
+		ret = yaca_decrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_SIV, key, 0, 16,
+		                              records.data(), COUNT, threads);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			BOOST_REQUIRE(records[i].result == YACA_ERROR_NONE);
+			BOOST_REQUIRE(memcmp(records[i].output, INPUT_DATA + i, records[i].input_len) == 0);
+		}
+
+		yaca_key_destroy(key);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T624__negative__encrypt_decrypt_siv, InitDebugFixture)
+{
+	const size_t LEN = 100;
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_key_h key = YACA_KEY_NULL, key128 = YACA_KEY_NULL, key_des = YACA_KEY_NULL;
+	yaca_key_h iv = YACA_KEY_NULL, key_pub = YACA_KEY_NULL, key_sym = YACA_KEY_NULL;
+	yaca_key_h key_prv = YACA_KEY_NULL;
+	char aad[16] = {4, 5, 6};
+	char sealed[LEN], opened[LEN], empty[1];
+	char tag[16], small[8];
+	size_t written, len, iv_bit_len;
+	char *simple = NULL, *simple_opened = NULL;
+	size_t simple_len, simple_opened_len;
+	std::vector<yaca_aead_record_s> records(2);
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_UNSAFE_128BIT, &key128);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_DES, YACA_KEY_LENGTH_192BIT, &key_des);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_2048BIT, &key_prv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_extract_public(key_prv, &key_pub);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	/* AES only, a double length key and no IV */
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_3DES_3TDEA, YACA_BCM_SIV, key_des,
+	                              YACA_KEY_NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, key_des, YACA_KEY_NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, key128, YACA_KEY_NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_get_iv_bit_length(YACA_ENCRYPT_AES, YACA_BCM_SIV, 128, &iv_bit_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_encrypt_get_iv_bit_length(YACA_ENCRYPT_AES, YACA_BCM_SIV, 264, &iv_bit_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	/* neither the seal nor the other simple functions */
+	ret = yaca_seal_initialize(&ctx, key_pub, YACA_ENCRYPT_AES, YACA_BCM_SIV,
+	                           YACA_KEY_LENGTH_256BIT, &key_sym, &iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_simple_encrypt(YACA_ENCRYPT_AES, YACA_BCM_SIV, key, YACA_KEY_NULL,
+	                          INPUT_DATA, LEN, &simple, &simple_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_simple_decrypt(YACA_ENCRYPT_AES, YACA_BCM_SIV, key, YACA_KEY_NULL,
+	                          INPUT_DATA, LEN, &simple, &simple_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	/* the SIV properties belong to SIV */
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CTR, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad, sizeof(aad));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	yaca_context_destroy(ctx);
+	ctx = YACA_CONTEXT_NULL;
+
+	/* ENCRYPT */
+	{
+		ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, key, YACA_KEY_NULL);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_TAG, tag, sizeof(tag));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_GCM_AAD, aad, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, NULL, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad, 1);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_SIV_TAG, tag, sizeof(tag), &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_encrypt_update(ctx, INPUT_DATA, LEN, sealed, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		/* a single update, no AAD after it */
+		ret = yaca_encrypt_update(ctx, INPUT_DATA, LEN, sealed, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_encrypt_finalize(ctx, sealed + written, &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_SIV_TAG, small, sizeof(small),
+		                                     &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		BOOST_REQUIRE(len == sizeof(tag));
+		ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_SIV_TAG, tag, sizeof(tag), &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		yaca_context_destroy(ctx);
+		ctx = YACA_CONTEXT_NULL;
+	}
+
+	/* DECRYPT */
+	{
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, key, YACA_KEY_NULL);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		/* the tag comes first */
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_decrypt_update(ctx, sealed, LEN, opened, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_decrypt_finalize(ctx, opened, &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_TAG, tag, 15);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_TAG, tag, sizeof(tag));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_TAG, tag, sizeof(tag));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		/* the components are in the wrong order */
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad, 1);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_AAD, aad, sizeof(aad));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		/* nothing of a forged message is released */
+		ret = yaca_decrypt_update(ctx, sealed, LEN, opened, &written);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		for (size_t i = 0; i < LEN; ++i)
+			BOOST_REQUIRE(opened[i] == 0);
+
+		ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_SIV_TAG, tag, sizeof(tag), &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		yaca_context_destroy(ctx);
+		ctx = YACA_CONTEXT_NULL;
+	}
+
+	/* A forged tag of an empty message is caught in the finalization */
+	{
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_SIV, key, YACA_KEY_NULL);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_SIV_TAG, tag, sizeof(tag));
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_decrypt_finalize(ctx, empty, &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		yaca_context_destroy(ctx);
+		ctx = YACA_CONTEXT_NULL;
+	}
+
+	/* SIMPLE */
+	{
+		ret = yaca_simple_encrypt_siv(YACA_KEY_NULL, aad, sizeof(aad), INPUT_DATA, LEN,
+		                              &simple, &simple_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_simple_encrypt_siv(key128, aad, sizeof(aad), INPUT_DATA, LEN,
+		                              &simple, &simple_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_simple_encrypt_siv(key, NULL, sizeof(aad), INPUT_DATA, LEN,
+		                              &simple, &simple_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_simple_encrypt_siv(key, aad, 0, INPUT_DATA, LEN, &simple, &simple_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_simple_encrypt_siv(key, aad, sizeof(aad), NULL, LEN, &simple, &simple_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_simple_encrypt_siv(key, aad, sizeof(aad), INPUT_DATA, LEN, NULL, &simple_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_simple_encrypt_siv(key, aad, sizeof(aad), INPUT_DATA, LEN, &simple, NULL);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_simple_encrypt_siv(key, aad, sizeof(aad), INPUT_DATA, LEN,
+		                              &simple, &simple_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_simple_decrypt_siv(key, aad, sizeof(aad), simple, 15,
+		                              &simple_opened, &simple_opened_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_simple_decrypt_siv(key, aad, sizeof(aad), NULL, simple_len,
+		                              &simple_opened, &simple_opened_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_simple_decrypt_siv(key, aad, sizeof(aad), simple, simple_len,
+		                              NULL, &simple_opened_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		/* another AAD, a truncated message and a forged tag */
+		ret = yaca_simple_decrypt_siv(key, aad, sizeof(aad) - 1, simple, simple_len,
+		                              &simple_opened, &simple_opened_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_simple_decrypt_siv(key, aad, sizeof(aad), simple, simple_len - 1,
+		                              &simple_opened, &simple_opened_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		simple[0] ^= 1;
+		ret = yaca_simple_decrypt_siv(key, aad, sizeof(aad), simple, simple_len,
+		                              &simple_opened, &simple_opened_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		BOOST_REQUIRE(simple_opened == NULL);
+	}
+
+	/* BATCH */
+	{
+		char forged[16], opened2[LEN];
+
+		records[0].iv = NULL;
+		records[0].aad = aad;
+		records[0].aad_len = sizeof(aad);
+		records[0].input = INPUT_DATA;
+		records[0].input_len = LEN;
+		records[0].output = sealed;
+		records[0].tag = tag;
+		records[0].result = -1;
+
+		ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_SIV, key, 12, 16,
+		                              records.data(), 1, 1);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_SIV, key, 0, 12,
+		                              records.data(), 1, 1);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_SIV, key128, 0, 16,
+		                              records.data(), 1, 1);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_GCM, key, 0, 16,
+		                              records.data(), 1, 1);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_encrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_SIV, key, 0, 16,
+		                              records.data(), 1, 1);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		/* the same record twice, the second one with a forged tag */
+		std::copy(tag, tag + sizeof(tag), forged);
+		forged[15] ^= 1;
+		records[0].input = sealed;
+		records[0].output = opened;
+		records[1] = records[0];
+		records[1].output = opened2;
+		records[1].tag = forged;
+
+		ret = yaca_decrypt_aead_batch(YACA_ENCRYPT_AES, YACA_BCM_SIV, key, 0, 16,
+		                              records.data(), 2, 2);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+		BOOST_REQUIRE(records[0].result == YACA_ERROR_NONE);
+		BOOST_REQUIRE(memcmp(opened, INPUT_DATA, LEN) == 0);
+		BOOST_REQUIRE(records[1].result == YACA_ERROR_INVALID_PARAMETER);
+		for (size_t i = 0; i < LEN; ++i)
+			BOOST_REQUIRE(opened2[i] == 0);
+	}
+
+	yaca_free(simple);
+	yaca_key_destroy(key_sym);
+	yaca_key_destroy(key_pub);
+	yaca_key_destroy(key_prv);
+	yaca_key_destroy(iv);
+	yaca_key_destroy(key_des);
+	yaca_key_destroy(key128);
+	yaca_key_destroy(key);
+}
+
+std::vector<char> plaintext_digest_reference(yaca_digest_algorithm_e algo,
+                                             const std::vector<char> &input)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t len;
+
+	ret = yaca_digest_initialize(&ctx, algo);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	if (!input.empty()) {
+		ret = yaca_digest_update(ctx, input.data(), input.size());
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	ret = yaca_context_get_output_length(ctx, 0, &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	std::vector<char> digest(len);
+	ret = yaca_digest_finalize(ctx, digest.data(), &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	digest.resize(len);
+
+	yaca_context_destroy(ctx);
+	return digest;
+}
+
+/* Encryption or decryption in updates of split bytes with the plaintext hashed along,
+ * the tag of GCM and CCM is read when encrypting and set when decrypting
+ */
+void plaintext_digest_crypt(bool encrypt, yaca_block_cipher_mode_e bcm, yaca_key_h key,
+                            yaca_key_h iv, yaca_digest_algorithm_e algo,
+                            const std::vector<char> &input, size_t split, bool in_place,
+                            std::vector<char> &tag, std::vector<char> &output,
+                            std::vector<char> &digest)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	size_t written = 0, len;
+	auto update = encrypt ? yaca_encrypt_update : yaca_decrypt_update;
+	yaca_property_e tag_property = bcm == YACA_BCM_GCM ? YACA_PROPERTY_GCM_TAG :
+	                                                     YACA_PROPERTY_CCM_TAG;
+
+	if (encrypt)
+		ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, bcm, key, iv);
+	else
+		ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, bcm, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO, &algo, sizeof(algo));
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	if (!encrypt && bcm == YACA_BCM_CCM) {
+		ret = yaca_context_set_property(ctx, tag_property, tag.data(), tag.size());
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	/* in place with a single update, CBC may keep the last block back */
+	BOOST_REQUIRE(!in_place || split >= input.size());
+	output.assign(input.size() + 16, 0);
+	if (in_place)
+		std::copy(input.begin(), input.end(), output.begin());
+
+	for (size_t pos = 0; pos < input.size(); pos += split) {
+		size_t chunk = std::min(split, input.size() - pos);
+		const char *in = in_place ? output.data() + pos : input.data() + pos;
+
+		ret = update(ctx, in, chunk, output.data() + written, &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		written += len;
+	}
+
+	if (!encrypt && bcm == YACA_BCM_GCM) {
+		ret = yaca_context_set_property(ctx, tag_property, tag.data(), tag.size());
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	if (encrypt)
+		ret = yaca_encrypt_finalize(ctx, output.data() + written, &len);
+	else
+		ret = yaca_decrypt_finalize(ctx, output.data() + written, &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	output.resize(written + len);
+
+	if (encrypt && (bcm == YACA_BCM_GCM || bcm == YACA_BCM_CCM)) {
+		tag.assign(16, 0);
+		ret = yaca_context_get_property_into(ctx, tag_property, tag.data(), tag.size(), &len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		tag.resize(len);
+	}
+
+	digest.assign(64, 0);
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST, digest.data(),
+	                                     digest.size(), &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	digest.resize(len);
+
+	yaca_context_destroy(ctx);
+}
+
+BOOST_FIXTURE_TEST_CASE(T625__positive__encrypt_decrypt_plaintext_digest, InitDebugFixture)
+{
+	struct digest_args {
+		yaca_block_cipher_mode_e bcm;
+		yaca_digest_algorithm_e algo;
+		size_t len;
+		size_t split;
+		bool in_place;
+	};
+
+	/* longer than a chunk hashed at once, in updates spanning chunks, in place in one update */
+	const size_t LONG_LEN = 3 * INPUT_DATA_SIZE + 100;
+
+	const std::vector<digest_args> dargs = {
+		{YACA_BCM_CBC, YACA_DIGEST_SHA256, LONG_LEN, LONG_LEN, false},
+		{YACA_BCM_CBC, YACA_DIGEST_SHA256, LONG_LEN, 5000,     false},
+		{YACA_BCM_CBC, YACA_DIGEST_SHA256, 0,        1,        false},
+		{YACA_BCM_CBC, YACA_DIGEST_SHA1,   1000,     7,        false},
+		{YACA_BCM_CBC, YACA_DIGEST_SHA512, LONG_LEN, LONG_LEN, true},
+		{YACA_BCM_CTR, YACA_DIGEST_MD5,    LONG_LEN, 4097,     false},
+		{YACA_BCM_CTR, YACA_DIGEST_SHA384, LONG_LEN, LONG_LEN, true},
+		{YACA_BCM_GCM, YACA_DIGEST_SHA224, LONG_LEN, 10000,    false},
+		{YACA_BCM_GCM, YACA_DIGEST_SHA256, 1000,     1000,     true},
+		{YACA_BCM_CCM, YACA_DIGEST_SHA256, LONG_LEN, LONG_LEN, false},
+		{YACA_BCM_CCM, YACA_DIGEST_SHA256, 1000,     1000,     true},
+	};
+
+	std::vector<char> input;
+	while (input.size() < LONG_LEN)
+		input.insert(input.end(), INPUT_DATA, INPUT_DATA + INPUT_DATA_SIZE);
+
+	for (const auto &da: dargs) {
+		int ret;
+		yaca_key_h key = YACA_KEY_NULL, iv;
+		std::vector<char> plaintext(input.begin(), input.begin() + da.len);
+		std::vector<char> tag, encrypted, decrypted, enc_digest, dec_digest;
+		std::vector<char> expected = plaintext_digest_reference(da.algo, plaintext);
+
+		ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		iv = generate_iv(YACA_ENCRYPT_AES, da.bcm, YACA_KEY_LENGTH_256BIT);
+
+		plaintext_digest_crypt(true, da.bcm, key, iv, da.algo, plaintext, da.split,
+		                       da.in_place, tag, encrypted, enc_digest);
+		BOOST_REQUIRE(enc_digest == expected);
+
+		/* in place the padded ciphertext in one update as well */
+		plaintext_digest_crypt(false, da.bcm, key, iv, da.algo, encrypted,
+		                       da.in_place ? encrypted.size() : da.split, da.in_place, tag,
+		                       decrypted, dec_digest);
+		BOOST_REQUIRE(decrypted == plaintext);
+		BOOST_REQUIRE(dec_digest == expected);
+
+		/* the same ciphertext as without the digest */
+		if (!da.in_place && da.bcm != YACA_BCM_GCM && da.bcm != YACA_BCM_CCM && da.len > 0) {
+			char *simple = NULL;
+			size_t simple_len;
+
+			ret = yaca_simple_encrypt(YACA_ENCRYPT_AES, da.bcm, key, iv, plaintext.data(),
+			                          plaintext.size(), &simple, &simple_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			BOOST_REQUIRE(simple_len == encrypted.size());
+			BOOST_REQUIRE(memcmp(simple, encrypted.data(), simple_len) == 0);
+			yaca_free(simple);
+		}
+
+		yaca_key_destroy(iv);
+		yaca_key_destroy(key);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T626__negative__encrypt_decrypt_plaintext_digest, InitDebugFixture)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL, ctx_digest = YACA_CONTEXT_NULL;
+	yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+	yaca_digest_algorithm_e algo = YACA_DIGEST_SHA256;
+	yaca_digest_algorithm_e bad_algo = static_cast<yaca_digest_algorithm_e>(-1);
+	char encrypted[INPUT_DATA_SIZE + 16], digest[64], small[16];
+	char *allocated = NULL;
+	size_t written, len;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	/* encrypt contexts only */
+	ret = yaca_digest_initialize(&ctx_digest, YACA_DIGEST_SHA256);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_set_property(ctx_digest, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO,
+	                                &algo, sizeof(algo));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO, &algo, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO, NULL, sizeof(algo));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO,
+	                                &bad_algo, sizeof(bad_algo));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST, digest, 32);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	/* not set */
+	ret = yaca_encrypt_update(ctx, INPUT_DATA, INPUT_DATA_SIZE, encrypted, &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_encrypt_finalize(ctx, encrypted + written, &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST,
+	                                     digest, sizeof(digest), &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	yaca_context_destroy(ctx);
+	ctx = YACA_CONTEXT_NULL;
+
+	/* only once and before the first update */
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO, &algo, sizeof(algo));
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO, &algo, sizeof(algo));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	yaca_context_destroy(ctx);
+	ctx = YACA_CONTEXT_NULL;
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_encrypt_update(ctx, INPUT_DATA, 16, encrypted, &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO, &algo, sizeof(algo));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	yaca_context_destroy(ctx);
+	ctx = YACA_CONTEXT_NULL;
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_GCM, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_GCM_AAD, INPUT_DATA, 16);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO, &algo, sizeof(algo));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	yaca_context_destroy(ctx);
+	ctx = YACA_CONTEXT_NULL;
+
+	/* readable after the finalization only, into a buffer large enough */
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_CBC, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST_ALGO, &algo, sizeof(algo));
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST,
+	                                     digest, sizeof(digest), &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_encrypt_update(ctx, INPUT_DATA, INPUT_DATA_SIZE, encrypted, &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST,
+	                                     digest, sizeof(digest), &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	ret = yaca_encrypt_finalize(ctx, encrypted + written, &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST,
+	                                     small, sizeof(small), &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	BOOST_REQUIRE(len == 32);
+	ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST,
+	                                     digest, sizeof(digest), &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(len == 32);
+
+	ret = yaca_context_get_property(ctx, YACA_PROPERTY_PLAINTEXT_DIGEST,
+	                                (void**)&allocated, &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(len == 32);
+	BOOST_REQUIRE(memcmp(allocated, digest, len) == 0);
+
+	/* the digest of the plaintext, not of the ciphertext */
+	std::vector<char> expected = plaintext_digest_reference(
+		algo, std::vector<char>(INPUT_DATA, INPUT_DATA + INPUT_DATA_SIZE));
+	BOOST_REQUIRE(memcmp(expected.data(), digest, expected.size()) == 0);
+
+	yaca_free(allocated);
+	yaca_context_destroy(ctx);
+	yaca_context_destroy(ctx_digest);
+	yaca_key_destroy(iv);
+	yaca_key_destroy(key);
+}
+
+/* Not a DebugFixture, the failed integrity check is dumped */
+BOOST_FIXTURE_TEST_CASE(T627__negative__unwrap_batch_integrity, InitFixture)
+{
+	int ret;
+	yaca_key_h kek = YACA_KEY_NULL, kek2 = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+	yaca_key_h keys[3] = {YACA_KEY_NULL, YACA_KEY_NULL, YACA_KEY_NULL};
+	yaca_key_h unwrapped[3] = {YACA_KEY_NULL, YACA_KEY_NULL, YACA_KEY_NULL};
+	char *wrapped[3] = {NULL, NULL, NULL};
+	size_t wrapped_lens[3];
+	char buffers[3][48];
+	char *outputs[3] = {buffers[0], buffers[1], buffers[2]};
+	size_t output_lens[3];
+	yaca_error_record_s records[YACA_ERROR_RECORDS_MAX];
+	size_t records_count;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &kek);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &kek2);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	iv = generate_iv(YACA_ENCRYPT_AES, YACA_BCM_WRAP, YACA_KEY_LENGTH_256BIT);
+	for (auto &key: keys) {
+		ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	ret = yaca_encrypt_wrap_keys(YACA_ENCRYPT_AES, kek, iv, keys, 3,
+	                             wrapped, wrapped_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	/* the same as yaca_decrypt_update() of a single key */
+	ret = yaca_decrypt_unwrap_keys(YACA_ENCRYPT_AES, kek2, iv, YACA_KEY_TYPE_SYMMETRIC,
+	                               wrapped, wrapped_lens, 3, unwrapped, 3);
+	BOOST_REQUIRE(ret == YACA_ERROR_INTERNAL);
+	BOOST_REQUIRE(unwrapped[2] == YACA_KEY_NULL);
+
+	wrapped[1][3] ^= 1;
+	ret = yaca_decrypt_unwrap_batch(YACA_ENCRYPT_AES, kek, iv, wrapped, wrapped_lens, 3,
+	                                outputs, output_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INTERNAL);
+	wrapped[1][3] ^= 1;
+
+	/* the last key is unwrapped on a thread of its own, its record is
+	 * moved to the calling thread
+	 */
+	yaca_error_clear_records();
+	wrapped[2][3] ^= 1;
+	ret = yaca_decrypt_unwrap_batch(YACA_ENCRYPT_AES, kek, iv, wrapped, wrapped_lens, 3,
+	                                outputs, output_lens, 3);
+	BOOST_REQUIRE(ret == YACA_ERROR_INTERNAL);
+	wrapped[2][3] ^= 1;
+
+	ret = yaca_error_get_records(records, YACA_ERROR_RECORDS_MAX, &records_count);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(records_count == 1);
+	BOOST_REQUIRE(records[0].code == YACA_ERROR_INTERNAL);
+	yaca_error_clear_records();
+
+	ret = yaca_decrypt_unwrap_batch(YACA_ENCRYPT_AES, kek, iv, wrapped, wrapped_lens, 3,
+	                                outputs, output_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	for (size_t i = 0; i < 3; ++i) {
+		yaca_key_destroy(keys[i]);
+		yaca_free(wrapped[i]);
+	}
+	yaca_key_destroy(iv);
+	yaca_key_destroy(kek2);
+	yaca_key_destroy(kek);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -24,8 +24,10 @@
 
 #include <boost/test/unit_test.hpp>
 #include <vector>
+#include <string>
 
 #include <yaca_crypto.h>
+#include <yaca_digest.h>
 #include <yaca_encrypt.h>
 #include <yaca_key.h>
 #include <yaca_simple.h>
@@ -1330,6 +1332,14 @@ BOOST_FIXTURE_TEST_CASE(T218__negative__key_derive_pbkdf2, InitDebugFixture)
 	ret = yaca_key_derive_pbkdf2(PASSWORD, salt, SALT_LEN, 10,
 	                             YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, NULL);
 	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_parallel(PASSWORD, salt, SALT_LEN, 10, YACA_DIGEST_SHA1,
+	                                      YACA_KEY_LENGTH_256BIT, &key, 65);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_parallel(NULL, salt, SALT_LEN, 10, YACA_DIGEST_SHA1,
+	                                      YACA_KEY_LENGTH_256BIT, &key, 2);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
 }
 
 BOOST_FIXTURE_TEST_CASE(T219__positive__import_x509_cert, InitDebugFixture)
@@ -1465,4 +1475,608 @@ BOOST_FIXTURE_TEST_CASE(T220__negative__key_get, InitDebugFixture)
 	yaca_key_destroy(key);
 }
 
+BOOST_FIXTURE_TEST_CASE(T221__positive__key_derive_pbkdf2_vectors, InitDebugFixture)
+{
+	struct pbkdf2_vector {
+		yaca_digest_algorithm_e digest;
+		std::string password;
+		std::string salt;
+		size_t iter;
+		std::string key;
+	};
+
+	/* RFC 6070 and a few multi-block ones, the long keys are derived in parallel */
+	const std::vector<struct pbkdf2_vector> vectors = {
+		{YACA_DIGEST_SHA1, "password", "salt", 1,
+		 "0c60c80f961f0e71f3a9b524af6012062fe037a6"},
+		{YACA_DIGEST_SHA1, "passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096,
+		 "3d2eec4fe41c849b80c8d83662c0e44a8b291a964cf2f07038"},
+		{YACA_DIGEST_SHA256, "password", "salt", 4096,
+		 "c5e478d59288c841aa530db6845c4c8d962893a001ce4e11a4963873aa98134a"},
+		{YACA_DIGEST_SHA256, "passwordPASSWORDpassword", "saltSALTsaltSALTsaltSALTsaltSALTsalt", 4096,
+		 "348c89dbcbd32b2f32d814b8116e84cf2b17347ebc1800181c4e2a1fb8dd53e1c635518c7dac47e9"},
+		{YACA_DIGEST_SHA512, "password", "", 1000,
+		 "037e94baa9506c5ba26bd3bbaa3684b933192040620ebce309ff1e8442d5463ce406cee23465ca5f"
+		 "93c3210754b7ad6005cafd3fcf1a75fdd6f654586767d1f5097b05df388b7ffdab46ff02e3b03832"
+		 "f111fa795a5f6de152c3151cce2fc1718cd9351353ef84639971040c2cc162d06a1b8290966b8459"
+		 "2c0609cf43cd4471499c4a738b10276ddf36db64b718e6af832056ef642b9430ca02a3ec80aeaa8e"},
+		/* a password longer than the digest block */
+		{YACA_DIGEST_MD5, std::string(100, 'x'), "salt", 1200,
+		 "7733791d7deebe746eeb30e774f76f35220df94ea4cf02050497b0481ae12644"
+		 "a8d4fabb6f4de1f013e1d43ba2204cda"},
+	};
+
+	for (const auto &v: vectors) {
+		int ret;
+		yaca_key_h key = YACA_KEY_NULL;
+		char *data = NULL;
+		size_t data_len;
+		std::string hex;
+
+		ret = yaca_key_derive_pbkdf2(v.password.c_str(), v.salt.empty() ? NULL : v.salt.c_str(),
+		                             v.salt.size(), v.iter, v.digest, v.key.size() * 4, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_key_export(key, YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW,
+		                      NULL, &data, &data_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(data_len == v.key.size() / 2);
+
+		for (size_t i = 0; i < data_len; ++i) {
+			static const char DIGITS[] = "0123456789abcdef";
+			hex += DIGITS[(unsigned char)data[i] >> 4];
+			hex += DIGITS[(unsigned char)data[i] & 0xf];
+		}
+		BOOST_REQUIRE(hex == v.key);
+
+		yaca_free(data);
+		yaca_key_destroy(key);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T222__positive__key_derive_pbkdf2_batch, InitDebugFixture)
+{
+	static const size_t COUNT = 9;
+
+	struct pbkdf2_args {
+		yaca_digest_algorithm_e digest;
+		size_t iter;
+		size_t bit_len;
+		size_t threads;
+	};
+
+	const std::vector<struct pbkdf2_args> pargs = {
+		{YACA_DIGEST_MD5,     1,    128, 0},
+		{YACA_DIGEST_SHA1,    15,   512, 1},
+		{YACA_DIGEST_SHA256,  1000, 256, 4},
+		{YACA_DIGEST_SHA512,  50,   768, 64},
+	};
+
+	std::vector<std::string> passwords;
+	std::vector<std::string> salts;
+	std::vector<const char*> password_ptrs;
+	std::vector<const char*> salt_ptrs;
+	std::vector<size_t> salt_lens;
+
+	for (size_t i = 0; i < COUNT; ++i) {
+		passwords.push_back("Password_ExamplE_" + std::to_string(i));
+		salts.push_back(std::string(i, 's'));
+	}
+
+	for (size_t i = 0; i < COUNT; ++i) {
+		password_ptrs.push_back(passwords[i].c_str());
+		/* the first one without a salt */
+		salt_ptrs.push_back(i == 0 ? NULL : salts[i].c_str());
+		salt_lens.push_back(salts[i].size());
+	}
+
+	for (const auto &pa: pargs) {
+		int ret;
+		yaca_key_h keys[COUNT];
+
+		ret = yaca_key_derive_pbkdf2_batch(password_ptrs.data(), salt_ptrs.data(),
+		                                   salt_lens.data(), COUNT, pa.iter, pa.digest,
+		                                   pa.bit_len, keys, pa.threads);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			yaca_key_h key = YACA_KEY_NULL;
+
+			ret = yaca_key_derive_pbkdf2(password_ptrs[i], salt_ptrs[i], salt_lens[i],
+			                             pa.iter, pa.digest, pa.bit_len, &key);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			assert_keys_identical(keys[i], key);
+
+			yaca_key_destroy(key);
+			yaca_key_destroy(keys[i]);
+		}
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T223__negative__key_derive_pbkdf2_batch, InitDebugFixture)
+{
+	static const size_t COUNT = 3;
+
+	int ret;
+	const char *passwords[COUNT] = {"a", "b", "c"};
+	const char *salts[COUNT] = {"salt", "salt", "salt"};
+	size_t salt_lens[COUNT] = {4, 4, 4};
+	yaca_key_h keys[COUNT];
+
+	ret = yaca_key_derive_pbkdf2_batch(NULL, salts, salt_lens, COUNT, 10,
+	                                   YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_batch(passwords, NULL, salt_lens, COUNT, 10,
+	                                   YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, NULL, COUNT, 10,
+	                                   YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, 0, 10,
+	                                   YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, COUNT, 0,
+	                                   YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, COUNT, INT_MAX + 1UL,
+	                                   YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, COUNT, 10,
+	                                   YACA_INVALID_DIGEST_ALGORITHM, YACA_KEY_LENGTH_256BIT,
+	                                   keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, COUNT, 10,
+	                                   YACA_DIGEST_SHA1, 0, keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, COUNT, 10,
+	                                   YACA_DIGEST_SHA1, 127, keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, COUNT, 10,
+	                                   YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, NULL, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, COUNT, 10,
+	                                   YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, keys, 65);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	passwords[1] = NULL;
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, COUNT, 10,
+	                                   YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	passwords[1] = "b";
+
+	salts[2] = NULL;
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, COUNT, 10,
+	                                   YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	salts[2] = "salt";
+
+	salt_lens[0] = 0;
+	ret = yaca_key_derive_pbkdf2_batch(passwords, salts, salt_lens, COUNT, 10,
+	                                   YACA_DIGEST_SHA1, YACA_KEY_LENGTH_256BIT, keys, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+}
+
+BOOST_FIXTURE_TEST_CASE(T224__positive__key_derive_dh_batch, InitDebugFixture)
+{
+	static const size_t COUNT = 7;
+
+	struct key_args {
+		yaca_key_type_e type;
+		yaca_key_bit_length_e len;
+		size_t threads;
+	};
+
+	const std::vector<struct key_args> kargs = {
+		{YACA_KEY_TYPE_DH_PRIV,
+		 (yaca_key_bit_length_e)YACA_KEY_LENGTH_DH_RFC_1024_160, 0},
+		{YACA_KEY_TYPE_EC_PRIV,
+		 (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_PRIME256V1, 1},
+		{YACA_KEY_TYPE_EC_PRIV,
+		 (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_SECT163R2, 3},
+		{YACA_KEY_TYPE_EC_PRIV,
+		 (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_SECP384R1, 64}
+	};
+
+	for (const auto &ka: kargs) {
+		int ret;
+		yaca_key_h priv = YACA_KEY_NULL, pub = YACA_KEY_NULL, params = YACA_KEY_NULL;
+		yaca_key_h peer_privs[COUNT], peer_pubs[COUNT];
+		yaca_context_h ctx = YACA_CONTEXT_NULL;
+		size_t secret_len;
+		std::vector<std::vector<char>> buffers;
+		char *secrets[COUNT];
+		size_t secret_lens[COUNT];
+
+		generate_asymmetric_keys(ka.type, ka.len, &priv, &pub);
+		ret = yaca_key_extract_parameters(priv, &params);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			ret = yaca_key_generate_from_parameters(params, &peer_privs[i]);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			ret = yaca_key_extract_public(peer_privs[i], &peer_pubs[i]);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		}
+
+		ret = yaca_key_derive_dh_initialize(&ctx, priv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_context_get_output_length(ctx, 0, &secret_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		for (size_t i = 0; i < COUNT; ++i) {
+			buffers.emplace_back(secret_len);
+			secrets[i] = buffers.back().data();
+		}
+
+		/* the second batch reuses the copies of the context */
+		for (int batch = 0; batch < 2; ++batch) {
+			ret = yaca_key_derive_dh_batch(ctx, peer_pubs, COUNT, secrets, secret_lens,
+			                               ka.threads);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			for (size_t i = 0; i < COUNT; ++i) {
+				char *secret = NULL;
+				size_t len;
+
+				ret = yaca_key_derive_dh(peer_privs[i], pub, &secret, &len);
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+				BOOST_REQUIRE(secret_lens[i] <= secret_len);
+				BOOST_REQUIRE(secret_lens[i] == len);
+				ret = yaca_memcmp(secrets[i], secret, len);
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+				yaca_free(secret);
+			}
+		}
+
+		yaca_context_destroy(ctx);
+		for (size_t i = 0; i < COUNT; ++i) {
+			yaca_key_destroy(peer_privs[i]);
+			yaca_key_destroy(peer_pubs[i]);
+		}
+		yaca_key_destroy(params);
+		yaca_key_destroy(priv);
+		yaca_key_destroy(pub);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T225__negative__key_derive_dh_batch, InitDebugFixture)
+{
+	static const size_t COUNT = 2;
+
+	int ret;
+	yaca_key_h priv = YACA_KEY_NULL, pub = YACA_KEY_NULL;
+	yaca_key_h rsa_priv = YACA_KEY_NULL, rsa_pub = YACA_KEY_NULL;
+	yaca_key_h dh_priv = YACA_KEY_NULL, dh_pub = YACA_KEY_NULL;
+	yaca_context_h ctx = YACA_CONTEXT_NULL, digest_ctx = YACA_CONTEXT_NULL;
+	char buffer1[128], buffer2[128];
+	char *secrets[COUNT] = {buffer1, buffer2};
+	size_t secret_lens[COUNT];
+	size_t len;
+
+	generate_asymmetric_keys(YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_PRIME256V1, &priv, &pub);
+	generate_asymmetric_keys(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_1024BIT,
+	                         &rsa_priv, &rsa_pub);
+	generate_asymmetric_keys(YACA_KEY_TYPE_DH_PRIV,
+	                         (yaca_key_bit_length_e)YACA_KEY_LENGTH_DH_RFC_1024_160,
+	                         &dh_priv, &dh_pub);
+
+	yaca_key_h pub_keys[COUNT] = {pub, pub};
+
+	ret = yaca_key_derive_dh_initialize(NULL, priv);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_dh_initialize(&ctx, YACA_KEY_NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_dh_initialize(&ctx, pub);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_dh_initialize(&ctx, rsa_priv);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_dh_initialize(&ctx, priv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_context_get_output_length(ctx, 1, &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_digest_initialize(&digest_ctx, YACA_DIGEST_SHA256);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_key_derive_dh_batch(YACA_CONTEXT_NULL, pub_keys, COUNT, secrets, secret_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_dh_batch(digest_ctx, pub_keys, COUNT, secrets, secret_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_dh_batch(ctx, NULL, COUNT, secrets, secret_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_dh_batch(ctx, pub_keys, 0, secrets, secret_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_dh_batch(ctx, pub_keys, COUNT, NULL, secret_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_dh_batch(ctx, pub_keys, COUNT, secrets, NULL, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_derive_dh_batch(ctx, pub_keys, COUNT, secrets, secret_lens, 65);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	pub_keys[1] = YACA_KEY_NULL;
+	ret = yaca_key_derive_dh_batch(ctx, pub_keys, COUNT, secrets, secret_lens, 2);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	pub_keys[1] = priv;
+	ret = yaca_key_derive_dh_batch(ctx, pub_keys, COUNT, secrets, secret_lens, 2);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	pub_keys[1] = rsa_pub;
+	ret = yaca_key_derive_dh_batch(ctx, pub_keys, COUNT, secrets, secret_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	pub_keys[1] = dh_pub;
+	ret = yaca_key_derive_dh_batch(ctx, pub_keys, COUNT, secrets, secret_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	pub_keys[1] = pub;
+	secrets[0] = NULL;
+	ret = yaca_key_derive_dh_batch(ctx, pub_keys, COUNT, secrets, secret_lens, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	yaca_context_destroy(digest_ctx);
+	yaca_context_destroy(ctx);
+	yaca_key_destroy(dh_priv);
+	yaca_key_destroy(dh_pub);
+	yaca_key_destroy(rsa_priv);
+	yaca_key_destroy(rsa_pub);
+	yaca_key_destroy(priv);
+	yaca_key_destroy(pub);
+}
+
+BOOST_FIXTURE_TEST_CASE(T226__positive__key_import_export_raw, InitDebugFixture)
+{
+	struct curve_args {
+		yaca_key_bit_length_ec_e curve;
+		size_t prv_len;
+		size_t point_len;
+	};
+
+	const std::vector<struct curve_args> cargs = {
+		{YACA_KEY_LENGTH_EC_PRIME256V1,      32, 32},
+		{YACA_KEY_LENGTH_EC_SECP384R1,       48, 48},
+		{YACA_KEY_LENGTH_EC_SECP521R1,       66, 66},
+		{YACA_KEY_LENGTH_EC_SECP256K1,       32, 32},
+		{YACA_KEY_LENGTH_EC_BRAINPOOLP256R1, 32, 32},
+		{YACA_KEY_LENGTH_EC_SECT163R2,       21, 21}
+	};
+
+	for (const auto &ca: cargs) {
+		int ret;
+		yaca_key_h prv = YACA_KEY_NULL, pub = YACA_KEY_NULL;
+		yaca_key_h prv_imp = YACA_KEY_NULL, pub_imp = YACA_KEY_NULL;
+		yaca_key_h pub_imp_c = YACA_KEY_NULL, pub_extracted = YACA_KEY_NULL;
+		char *prv_raw = NULL, *pub_raw = NULL, *pub_raw_c = NULL;
+		size_t prv_raw_len, pub_raw_len, pub_raw_c_len;
+		size_t bit_len;
+		yaca_key_type_e type;
+
+		generate_asymmetric_keys(YACA_KEY_TYPE_EC_PRIV, ca.curve, &prv, &pub);
+
+		ret = yaca_key_export(prv, YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW, NULL,
+		                      &prv_raw, &prv_raw_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(prv_raw_len == ca.prv_len);
+
+		ret = yaca_key_export(pub, YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW, NULL,
+		                      &pub_raw, &pub_raw_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(pub_raw_len == 1 + 2 * ca.point_len);
+		BOOST_REQUIRE(pub_raw[0] == 0x04);
+
+		ret = yaca_key_export(pub, YACA_KEY_FORMAT_EC_COMPRESSED, YACA_KEY_FILE_FORMAT_RAW,
+		                      NULL, &pub_raw_c, &pub_raw_c_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(pub_raw_c_len == 1 + ca.point_len);
+		BOOST_REQUIRE(pub_raw_c[0] == 0x02 || pub_raw_c[0] == 0x03);
+
+		ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PRIV, ca.curve, prv_raw, prv_raw_len,
+		                          &prv_imp);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, ca.curve, pub_raw, pub_raw_len,
+		                          &pub_imp);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, ca.curve, pub_raw_c, pub_raw_c_len,
+		                          &pub_imp_c);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_key_get_type(prv_imp, &type);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(type == YACA_KEY_TYPE_EC_PRIV);
+		ret = yaca_key_get_bit_length(pub_imp_c, &bit_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(bit_len == ca.curve);
+
+		/* the public key is computed from the imported scalar */
+		ret = yaca_key_extract_public(prv_imp, &pub_extracted);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		assert_keys_identical(prv, prv_imp);
+		assert_keys_identical(pub, pub_imp);
+		assert_keys_identical(pub, pub_imp_c);
+		assert_keys_identical(pub, pub_extracted);
+
+		yaca_key_destroy(prv);
+		yaca_key_destroy(pub);
+		yaca_key_destroy(prv_imp);
+		yaca_key_destroy(pub_imp);
+		yaca_key_destroy(pub_imp_c);
+		yaca_key_destroy(pub_extracted);
+		yaca_free(prv_raw);
+		yaca_free(pub_raw);
+		yaca_free(pub_raw_c);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T227__negative__key_import_export_raw, InitDebugFixture)
+{
+	int ret;
+	yaca_key_h prv = YACA_KEY_NULL, pub = YACA_KEY_NULL, key = YACA_KEY_NULL;
+	yaca_key_h rsa = YACA_KEY_NULL;
+	char *prv_raw = NULL, *pub_raw = NULL, *data = NULL;
+	size_t prv_raw_len, pub_raw_len, data_len;
+	/* n of P-256, the order itself */
+	const unsigned char order[] = {
+		0xFF, 0xFF, 0xFF, 0xFF, 0x00, 0x00, 0x00, 0x00,
+		0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+		0xBC, 0xE6, 0xFA, 0xAD, 0xA7, 0x17, 0x9E, 0x84,
+		0xF3, 0xB9, 0xCA, 0xC2, 0xFC, 0x63, 0x25, 0x51
+	};
+	const char zero[32] = {};
+
+	generate_asymmetric_keys(YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_PRIME256V1, &prv, &pub);
+	generate_asymmetric_keys(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_1024BIT, &rsa);
+
+	ret = yaca_key_export(prv, YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW, NULL,
+	                      &prv_raw, &prv_raw_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_export(pub, YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW, NULL,
+	                      &pub_raw, &pub_raw_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_key_export(prv, YACA_KEY_FORMAT_EC_COMPRESSED, YACA_KEY_FILE_FORMAT_RAW, NULL,
+	                      &data, &data_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_export(pub, YACA_KEY_FORMAT_EC_COMPRESSED, YACA_KEY_FILE_FORMAT_DER, NULL,
+	                      &data, &data_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_export(pub, YACA_KEY_FORMAT_PKCS8, YACA_KEY_FILE_FORMAT_RAW, NULL,
+	                      &data, &data_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_export(prv, YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW, "password",
+	                      &data, &data_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_export(rsa, YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_RAW, NULL,
+	                      &data, &data_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, YACA_KEY_LENGTH_EC_PRIME256V1,
+	                          NULL, pub_raw_len, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, YACA_KEY_LENGTH_EC_PRIME256V1,
+	                          pub_raw, 0, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, YACA_KEY_LENGTH_EC_PRIME256V1,
+	                          pub_raw, pub_raw_len, NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_RSA_PUB, YACA_KEY_LENGTH_EC_PRIME256V1,
+	                          pub_raw, pub_raw_len, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PARAMS, YACA_KEY_LENGTH_EC_PRIME256V1,
+	                          pub_raw, pub_raw_len, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, YACA_KEY_LENGTH_256BIT,
+	                          pub_raw, pub_raw_len, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, YACA_INVALID_KEY_BIT_LENGTH_EC,
+	                          pub_raw, pub_raw_len, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	/* a point of another curve */
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, YACA_KEY_LENGTH_EC_SECP384R1,
+	                          pub_raw, pub_raw_len, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, YACA_KEY_LENGTH_EC_PRIME256V1,
+	                          pub_raw, pub_raw_len - 1, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	/* not on the curve */
+	pub_raw[pub_raw_len - 1] ^= 0x01;
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, YACA_KEY_LENGTH_EC_PRIME256V1,
+	                          pub_raw, pub_raw_len, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+	pub_raw[pub_raw_len - 1] ^= 0x01;
+
+	/* the point at infinity */
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PUB, YACA_KEY_LENGTH_EC_PRIME256V1,
+	                          zero, 1, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_PRIME256V1,
+	                          prv_raw, prv_raw_len - 1, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_SECP384R1,
+	                          prv_raw, prv_raw_len, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_PRIME256V1,
+	                          zero, sizeof(zero), &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_key_import_raw(YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_PRIME256V1,
+	                          (const char*)order, sizeof(order), &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	yaca_key_destroy(prv);
+	yaca_key_destroy(pub);
+	yaca_key_destroy(rsa);
+	yaca_free(prv_raw);
+	yaca_free(pub_raw);
+}
+
+BOOST_FIXTURE_TEST_CASE(T228__positive__key_derive_pbkdf2_split, InitDebugFixture)
+{
+	static const char *PASSWORD = "Password_ExamplE";
+	static const char *SALT = "salt";
+
+	/* Also thread counts that don't divide the blocks, and a partial last block */
+	for (size_t threads: {1, 2, 3, 4, 6}) {
+		for (size_t blocks = 1; blocks <= 2 * threads + 1; ++blocks) {
+			int ret;
+			yaca_key_h key = YACA_KEY_NULL, reference = YACA_KEY_NULL;
+			size_t salt_len = strlen(SALT);
+			size_t bit_len = blocks * 256 - (blocks % 2) * 64;
+
+			ret = yaca_key_derive_pbkdf2_parallel(PASSWORD, SALT, salt_len, 1000,
+			                                      YACA_DIGEST_SHA256, bit_len, &key, threads);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_key_derive_pbkdf2(PASSWORD, SALT, salt_len, 1000, YACA_DIGEST_SHA256,
+			                             bit_len, &reference);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			assert_keys_identical(key, reference);
+
+			yaca_key_destroy(reference);
+			yaca_key_destroy(key);
+		}
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -24,11 +24,21 @@
 
 #include <boost/test/unit_test.hpp>
 #include <vector>
+#include <thread>
+
+#include <openssl/bn.h>
+#include <openssl/ec.h>
+#include <openssl/err.h>
+#include <openssl/evp.h>
+#include <openssl/x509.h>
 
 #include <yaca_crypto.h>
 #include <yaca_sign.h>
+#include <yaca_encrypt.h>
 #include <yaca_key.h>
 #include <yaca_digest.h>
+#include <yaca_simple.h>
+#include <yaca_rsa.h>
 #include <yaca_error.h>
 
 #include "common.h"
@@ -64,6 +74,76 @@ void call_update_loop(yaca_context_h &ctx, const char *input, size_t input_len,
 	}
 }
 
+using bytes_t = std::vector<unsigned char>;
+
+/* DER INTEGER of a non-negative number, pad extra zeros make it non-minimal */
+bytes_t der_integer(const BIGNUM *bn, size_t pad)
+{
+	bytes_t out(BN_num_bytes(bn));
+
+	BN_bn2bin(bn, out.data());
+	if (out.empty() || (out[0] & 0x80) != 0)
+		++pad;
+	out.insert(out.begin(), pad, 0x00);
+
+	BOOST_REQUIRE_MESSAGE(out.size() < 0x80, "Fix your test");
+	out.insert(out.begin(), {0x02, (unsigned char)out.size()});
+	return out;
+}
+
+/* DER ECDSA-Sig-Value, the long form of a short length is non-minimal */
+bytes_t der_ecdsa_sig(const BIGNUM *r, const BIGNUM *s,
+                      size_t r_pad = 0, bool long_length = false)
+{
+	bytes_t out = der_integer(r, r_pad);
+	bytes_t s_der = der_integer(s, 0);
+
+	out.insert(out.end(), s_der.begin(), s_der.end());
+	BOOST_REQUIRE_MESSAGE(out.size() < 0x80, "Fix your test");
+	if (long_length)
+		out.insert(out.begin(), {0x30, 0x81, (unsigned char)out.size()});
+	else
+		out.insert(out.begin(), {0x30, (unsigned char)out.size()});
+	return out;
+}
+
+/* EVP_DigestVerifyFinal() mapped the way yaca_verify_finalize() does it */
+int openssl_verify(EVP_PKEY *pkey, const EVP_MD *md, const bytes_t &signature)
+{
+	int ret;
+	EVP_MD_CTX *md_ctx = EVP_MD_CTX_new();
+
+	BOOST_REQUIRE(md_ctx != NULL);
+	BOOST_REQUIRE(EVP_DigestVerifyInit(md_ctx, NULL, md, NULL, pkey) == 1);
+	BOOST_REQUIRE(EVP_DigestVerifyUpdate(md_ctx, INPUT_DATA, INPUT_DATA_SIZE) == 1);
+
+	ret = EVP_DigestVerifyFinal(md_ctx, signature.data(), signature.size());
+	EVP_MD_CTX_free(md_ctx);
+	ERR_clear_error();
+
+	if (ret == 1)
+		return YACA_ERROR_NONE;
+	if (ret == 0)
+		return YACA_ERROR_DATA_MISMATCH;
+	return YACA_ERROR_INTERNAL;
+}
+
+int yaca_verify(yaca_key_h key, yaca_digest_algorithm_e digest, const bytes_t &signature)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+
+	ret = yaca_verify_initialize(&ctx, digest, key);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_verify_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_verify_finalize(ctx, (const char *)signature.data(), signature.size());
+	yaca_context_destroy(ctx);
+	return ret;
+}
+
 } //namespace
 
 
@@ -962,4 +1042,763 @@ BOOST_FIXTURE_TEST_CASE(T806__negative__sign_hmac, InitDebugFixture)
 	yaca_free(signature);
 }
 
+BOOST_FIXTURE_TEST_CASE(T807__positive__verify_prepare_key, InitDebugFixture)
+{
+	struct prepare_args {
+		yaca_key_type_e type_prv;
+		yaca_key_bit_length_e key_bit_len;
+		yaca_digest_algorithm_e digest;
+	};
+
+	const std::vector<prepare_args> pargs = {
+		{YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_1024BIT, YACA_DIGEST_SHA256},
+		{YACA_KEY_TYPE_DSA_PRIV, YACA_KEY_LENGTH_1024BIT, YACA_DIGEST_SHA1},
+		{YACA_KEY_TYPE_EC_PRIV,
+		 (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_PRIME256V1, YACA_DIGEST_SHA256},
+		{YACA_KEY_TYPE_EC_PRIV,
+		 (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_PRIME256V1, YACA_DIGEST_SHA1},
+		{YACA_KEY_TYPE_EC_PRIV,
+		 (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_PRIME256V1, YACA_DIGEST_SHA512},
+		{YACA_KEY_TYPE_EC_PRIV,
+		 (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_SECP384R1, YACA_DIGEST_SHA384},
+		{YACA_KEY_TYPE_EC_PRIV,
+		 (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_SECP256K1, YACA_DIGEST_SHA256}
+	};
+
+	for (const auto &pa: pargs) {
+		int ret;
+		yaca_context_h ctx = YACA_CONTEXT_NULL;
+		yaca_key_h key_prv = YACA_KEY_NULL, key_pub = YACA_KEY_NULL;
+
+		char *signature = NULL;
+		size_t signature_len;
+
+		generate_asymmetric_keys(pa.type_prv, pa.key_bit_len, &key_prv, &key_pub);
+
+		ret = yaca_sign_initialize(&ctx, pa.digest, key_prv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_sign_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_context_get_output_length(ctx, 0, &signature_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_malloc(signature_len, (void **)&signature);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_sign_finalize(ctx, signature, &signature_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		yaca_context_destroy(ctx);
+		ctx = YACA_CONTEXT_NULL;
+
+		/* Unprepared, prepared, prepared again */
+		for (int i = 0; i < 3; ++i) {
+			if (i > 0) {
+				ret = yaca_verify_prepare_key(key_pub);
+				BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			}
+
+			ret = yaca_verify_initialize(&ctx, pa.digest, key_pub);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			call_update_loop(ctx, INPUT_DATA, INPUT_DATA_SIZE, 7, &yaca_verify_update);
+
+			ret = yaca_verify_finalize(ctx, signature, signature_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			yaca_context_destroy(ctx);
+			ctx = YACA_CONTEXT_NULL;
+
+			/* wrong message */
+			ret = yaca_verify_initialize(&ctx, pa.digest, key_pub);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_verify_update(ctx, INPUT_DATA, INPUT_DATA_SIZE - 1);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_verify_finalize(ctx, signature, signature_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_DATA_MISMATCH);
+
+			yaca_context_destroy(ctx);
+			ctx = YACA_CONTEXT_NULL;
+
+			/* tampered signature, last byte of s or of the RSA signature */
+			signature[signature_len - 1] ^= 0x01;
+
+			ret = yaca_verify_initialize(&ctx, pa.digest, key_pub);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_verify_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_verify_finalize(ctx, signature, signature_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_DATA_MISMATCH);
+
+			yaca_context_destroy(ctx);
+			ctx = YACA_CONTEXT_NULL;
+
+			signature[signature_len - 1] ^= 0x01;
+		}
+
+		/* The context outlives the prepared key */
+		ret = yaca_verify_initialize(&ctx, pa.digest, key_pub);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		yaca_key_destroy(key_pub);
+
+		ret = yaca_verify_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_verify_finalize(ctx, signature, signature_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		yaca_context_destroy(ctx);
+		yaca_key_destroy(key_prv);
+		yaca_free(signature);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T808__negative__verify_prepare_key, InitDebugFixture)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_key_h key_sym = YACA_KEY_NULL, key_dh = YACA_KEY_NULL;
+	yaca_key_h key_prv = YACA_KEY_NULL, key_pub = YACA_KEY_NULL;
+	yaca_padding_e pad = YACA_PADDING_PKCS1;
+	/* a DER ECDSA signature with r = s = 1 */
+	const char SIG_ONE[] = {0x30, 0x06, 0x02, 0x01, 0x01, 0x02, 0x01, 0x01};
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key_sym);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	generate_asymmetric_keys(YACA_KEY_TYPE_DH_PRIV,
+	                         (yaca_key_bit_length_e)YACA_KEY_LENGTH_DH_RFC_1024_160,
+	                         &key_dh);
+	generate_asymmetric_keys(YACA_KEY_TYPE_EC_PRIV,
+	                         (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_PRIME256V1,
+	                         &key_prv, &key_pub);
+
+	ret = yaca_verify_prepare_key(YACA_KEY_NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_verify_prepare_key(key_sym);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_verify_prepare_key(key_dh);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_verify_prepare_key(key_prv);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_verify_prepare_key(key_pub);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_verify_initialize(&ctx, YACA_DIGEST_MD5, key_pub);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_verify_initialize(&ctx, YACA_DIGEST_SHA256, key_pub);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_PADDING, &pad, sizeof(pad));
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_verify_update(ctx, NULL, INPUT_DATA_SIZE);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_verify_finalize(ctx, NULL, 0);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_verify_finalize(ctx, SIG_ONE, sizeof(SIG_ONE));
+	BOOST_REQUIRE(ret == YACA_ERROR_DATA_MISMATCH);
+
+	yaca_context_destroy(ctx);
+	yaca_key_destroy(key_sym);
+	yaca_key_destroy(key_dh);
+	yaca_key_destroy(key_prv);
+	yaca_key_destroy(key_pub);
+}
+
+namespace {
+
+int sign_and_verify(const yaca_key_h key_prv, const yaca_key_h key_pub)
+{
+	int ret;
+	char *signature = NULL;
+	size_t signature_len;
+
+	ret = yaca_simple_calculate_signature(YACA_DIGEST_SHA256, key_prv,
+	                                      INPUT_DATA, INPUT_DATA_SIZE,
+	                                      &signature, &signature_len);
+	if (ret != YACA_ERROR_NONE)
+		return ret;
+
+	ret = yaca_simple_verify_signature(YACA_DIGEST_SHA256, key_pub,
+	                                   INPUT_DATA, INPUT_DATA_SIZE,
+	                                   signature, signature_len);
+	yaca_free(signature);
+	return ret;
+}
+
+} //namespace
+
+BOOST_FIXTURE_TEST_CASE(T809__positive__sign_prepare_key, InitDebugFixture)
+{
+	const size_t THREADS = 4;
+	const size_t ITERATIONS = 8;
+
+	int ret;
+	yaca_key_h key_prv = YACA_KEY_NULL, key_pub = YACA_KEY_NULL;
+	yaca_context_h ctxs[THREADS + 2];
+	char *signature = NULL, *encrypted = NULL, *decrypted = NULL;
+	size_t signature_len, encrypted_len, decrypted_len;
+
+	generate_asymmetric_keys(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_1024BIT,
+	                         &key_prv, &key_pub);
+
+	/* Only the warm up, then the copies, then nothing */
+	ret = yaca_sign_prepare_key(key_prv, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = sign_and_verify(key_prv, key_pub);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_sign_prepare_key(key_prv, THREADS);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_sign_prepare_key(key_prv, 1000);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	/* More contexts than copies, the last ones share the key */
+	for (auto &ctx: ctxs) {
+		ret = yaca_sign_initialize(&ctx, YACA_DIGEST_SHA256, key_prv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_sign_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	}
+
+	for (auto &ctx: ctxs) {
+		ret = yaca_context_get_output_length(ctx, 0, &signature_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_malloc(signature_len, (void **)&signature);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_sign_finalize(ctx, signature, &signature_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_simple_verify_signature(YACA_DIGEST_SHA256, key_pub,
+		                                   INPUT_DATA, INPUT_DATA_SIZE,
+		                                   signature, signature_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		yaca_context_destroy(ctx);
+		yaca_free(signature);
+		signature = NULL;
+	}
+
+	/* The low level RSA takes the copies too */
+	ret = yaca_rsa_private_encrypt(YACA_PADDING_PKCS1, key_prv, INPUT_DATA, 64,
+	                               &encrypted, &encrypted_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_rsa_public_decrypt(YACA_PADDING_PKCS1, key_pub, encrypted, encrypted_len,
+	                              &decrypted, &decrypted_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(decrypted_len == 64);
+	BOOST_REQUIRE(yaca_memcmp(decrypted, INPUT_DATA, 64) == YACA_ERROR_NONE);
+
+	yaca_free(encrypted);
+	yaca_free(decrypted);
+	encrypted = decrypted = NULL;
+
+	ret = yaca_rsa_public_encrypt(YACA_PADDING_PKCS1_OAEP, key_pub, INPUT_DATA, 64,
+	                              &encrypted, &encrypted_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_rsa_private_decrypt(YACA_PADDING_PKCS1_OAEP, key_prv, encrypted, encrypted_len,
+	                               &decrypted, &decrypted_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	BOOST_REQUIRE(decrypted_len == 64);
+	BOOST_REQUIRE(yaca_memcmp(decrypted, INPUT_DATA, 64) == YACA_ERROR_NONE);
+
+	/* One key, more threads than copies */
+	{
+		std::thread threads[THREADS + 2];
+		int results[THREADS + 2];
+
+		for (size_t i = 0; i < THREADS + 2; ++i)
+			threads[i] = std::thread([&, i]{
+				results[i] = yaca_initialize();
+				for (size_t j = 0; j < ITERATIONS && results[i] == YACA_ERROR_NONE; ++j)
+					results[i] = sign_and_verify(key_prv, key_pub);
+				yaca_cleanup();
+			});
+
+		for (size_t i = 0; i < THREADS + 2; ++i) {
+			threads[i].join();
+			BOOST_REQUIRE(results[i] == YACA_ERROR_NONE);
+		}
+	}
+
+	/* A context outlives the key and its copies */
+	ret = yaca_sign_initialize(&ctxs[0], YACA_DIGEST_SHA256, key_prv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	yaca_key_destroy(key_prv);
+
+	ret = yaca_sign_update(ctxs[0], INPUT_DATA, INPUT_DATA_SIZE);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_context_get_output_length(ctxs[0], 0, &signature_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_malloc(signature_len, (void **)&signature);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_sign_finalize(ctxs[0], signature, &signature_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_simple_verify_signature(YACA_DIGEST_SHA256, key_pub,
+	                                   INPUT_DATA, INPUT_DATA_SIZE,
+	                                   signature, signature_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	yaca_context_destroy(ctxs[0]);
+	yaca_key_destroy(key_pub);
+	yaca_free(signature);
+	yaca_free(encrypted);
+	yaca_free(decrypted);
+}
+
+BOOST_FIXTURE_TEST_CASE(T810__negative__sign_prepare_key, InitDebugFixture)
+{
+	int ret;
+	yaca_key_h key_sym = YACA_KEY_NULL, key_dsa = YACA_KEY_NULL, key_ec = YACA_KEY_NULL;
+	yaca_key_h key_prv = YACA_KEY_NULL, key_pub = YACA_KEY_NULL;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key_sym);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	generate_asymmetric_keys(YACA_KEY_TYPE_DSA_PRIV, YACA_KEY_LENGTH_512BIT, &key_dsa);
+	generate_asymmetric_keys(YACA_KEY_TYPE_EC_PRIV,
+	                         (yaca_key_bit_length_e)YACA_KEY_LENGTH_EC_PRIME256V1,
+	                         &key_ec);
+	generate_asymmetric_keys(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_512BIT,
+	                         &key_prv, &key_pub);
+
+	ret = yaca_sign_prepare_key(YACA_KEY_NULL, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_sign_prepare_key(key_sym, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_sign_prepare_key(key_dsa, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_sign_prepare_key(key_ec, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_sign_prepare_key(key_pub, 1);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_sign_prepare_key(key_prv, 0);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	yaca_key_destroy(key_sym);
+	yaca_key_destroy(key_dsa);
+	yaca_key_destroy(key_ec);
+	yaca_key_destroy(key_prv);
+	yaca_key_destroy(key_pub);
+}
+
+BOOST_FIXTURE_TEST_CASE(T811__positive__sign_gmac, InitDebugFixture)
+{
+	struct gmac_args {
+		yaca_key_bit_length_e key_len;
+		size_t iv_bit_len;
+		size_t split;
+	};
+
+	const std::vector<gmac_args> gargs = {
+		{YACA_KEY_LENGTH_UNSAFE_128BIT, 96,  11},
+		{YACA_KEY_LENGTH_192BIT,        96,  22},
+		{YACA_KEY_LENGTH_256BIT,        96,  33},
+		{YACA_KEY_LENGTH_256BIT,        128, 7},
+		{YACA_KEY_LENGTH_256BIT,        64,  1},
+	};
+
+	/* The GCM spec test case 1, all zero key and IV, no AAD, no plaintext */
+	{
+		int ret;
+		yaca_context_h ctx = YACA_CONTEXT_NULL;
+		yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+		const char zeros[16] = {};
+		const char expected[] = "\x58\xe2\xfc\xce\xfa\x7e\x30\x61"
+		                        "\x36\x7f\x1d\x57\xa4\xe7\x45\x5a";
+		char mac[16];
+		size_t mac_len;
+
+		ret = yaca_key_import(YACA_KEY_TYPE_SYMMETRIC, NULL, zeros, 16, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_key_import(YACA_KEY_TYPE_IV, NULL, zeros, 12, &iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_sign_initialize_gmac(&ctx, key, iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_context_get_output_length(ctx, 0, &mac_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(mac_len == sizeof(mac));
+
+		ret = yaca_sign_finalize(ctx, mac, &mac_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		BOOST_REQUIRE(mac_len == sizeof(mac));
+		BOOST_REQUIRE(yaca_memcmp(mac, expected, sizeof(mac)) == YACA_ERROR_NONE);
+
+		yaca_context_destroy(ctx);
+		yaca_key_destroy(key);
+		yaca_key_destroy(iv);
+	}
+
+	for (const auto &ga: gargs) {
+		int ret;
+		yaca_context_h ctx = YACA_CONTEXT_NULL;
+		yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+
+		char *signature = NULL, *simple = NULL;
+		size_t signature_len, simple_len, written;
+		char tag[16];
+		size_t tag_len;
+
+		ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, ga.key_len, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_key_generate(YACA_KEY_TYPE_IV, ga.iv_bit_len, &iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		/* SIGN */
+		{
+			ret = yaca_sign_initialize_gmac(&ctx, key, iv);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			call_update_loop(ctx, INPUT_DATA, INPUT_DATA_SIZE,
+			                 ga.split, yaca_sign_update);
+
+			ret = yaca_context_get_output_length(ctx, 0, &signature_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_malloc(signature_len, (void **)&signature);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_sign_finalize(ctx, signature, &signature_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			BOOST_REQUIRE(signature_len == 16);
+
+			yaca_context_destroy(ctx);
+			ctx = YACA_CONTEXT_NULL;
+		}
+
+		/* VERIFY, the simple API */
+		{
+			ret = yaca_simple_calculate_gmac(key, iv, INPUT_DATA, INPUT_DATA_SIZE,
+			                                 &simple, &simple_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			BOOST_REQUIRE(signature_len == simple_len);
+			ret = yaca_memcmp(signature, simple, signature_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		}
+
+		/* VERIFY, GCM with the message as the AAD */
+		{
+			ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_GCM, key, iv);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_context_set_property(ctx, YACA_PROPERTY_GCM_AAD,
+			                                INPUT_DATA, INPUT_DATA_SIZE);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_encrypt_finalize(ctx, tag, &written);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+			BOOST_REQUIRE(written == 0);
+
+			ret = yaca_context_get_property_into(ctx, YACA_PROPERTY_GCM_TAG,
+			                                     tag, sizeof(tag), &tag_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			BOOST_REQUIRE(signature_len == tag_len);
+			ret = yaca_memcmp(signature, tag, signature_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			yaca_context_destroy(ctx);
+			ctx = YACA_CONTEXT_NULL;
+		}
+
+		yaca_key_destroy(key);
+		yaca_key_destroy(iv);
+		yaca_free(signature);
+		yaca_free(simple);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T812__negative__sign_gmac, InitDebugFixture)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_key_h key = YACA_KEY_NULL, key2 = YACA_KEY_NULL, key_64 = YACA_KEY_NULL;
+	yaca_key_h key_des = YACA_KEY_NULL, key_rsa = YACA_KEY_NULL;
+	yaca_key_h iv = YACA_KEY_NULL, iv2 = YACA_KEY_NULL;
+	yaca_padding_e padding = YACA_PADDING_PKCS1;
+
+	char signature[16], signature2[16];
+	size_t signature_len, signature2_len;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key2);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_UNSAFE_64BIT, &key_64);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_DES, YACA_KEY_LENGTH_192BIT, &key_des);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv2);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	generate_asymmetric_keys(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_512BIT, &key_rsa);
+
+	/* SIGN */
+	{
+		ret = yaca_sign_initialize_gmac(NULL, key, iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_initialize_gmac(&ctx, YACA_KEY_NULL, iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_initialize_gmac(&ctx, key_64, iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_initialize_gmac(&ctx, key_des, iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_initialize_gmac(&ctx, key_rsa, iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_initialize_gmac(&ctx, key, YACA_KEY_NULL);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_initialize_gmac(&ctx, key, key2);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_initialize_gmac(&ctx, key, iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_context_set_property(ctx, YACA_PROPERTY_PADDING,
+		                                &padding, sizeof(padding));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_context_get_output_length(ctx, 1, &signature_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_update(ctx, NULL, INPUT_DATA_SIZE);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_update(ctx, INPUT_DATA, 0);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_verify_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_sign_finalize(ctx, NULL, &signature_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_verify_finalize(ctx, signature, sizeof(signature));
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_finalize(ctx, signature, &signature_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_sign_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		ret = yaca_sign_finalize(ctx, signature2, &signature2_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+		yaca_context_destroy(ctx);
+		ctx = YACA_CONTEXT_NULL;
+	}
+
+	/* VERIFY, wrong key, wrong IV */
+	for (const auto &k: {std::make_pair(key2, iv), std::make_pair(key, iv2)}) {
+		ret = yaca_sign_initialize_gmac(&ctx, k.first, k.second);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_sign_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_sign_finalize(ctx, signature2, &signature2_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		BOOST_REQUIRE(signature_len == signature2_len);
+		ret = yaca_memcmp(signature, signature2, signature_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_DATA_MISMATCH);
+
+		yaca_context_destroy(ctx);
+		ctx = YACA_CONTEXT_NULL;
+	}
+
+	yaca_key_destroy(key);
+	yaca_key_destroy(key2);
+	yaca_key_destroy(key_64);
+	yaca_key_destroy(key_des);
+	yaca_key_destroy(key_rsa);
+	yaca_key_destroy(iv);
+	yaca_key_destroy(iv2);
+}
+
+/* The prepared EC keys don't verify with the EVP, the answers have to be the same */
+BOOST_FIXTURE_TEST_CASE(T813__positive__verify_prepare_key_openssl, InitFixture)
+{
+	struct curve_args {
+		yaca_key_bit_length_ec_e curve;
+		int nid;
+	};
+
+	const std::vector<curve_args> cargs = {
+		{YACA_KEY_LENGTH_EC_PRIME256V1, NID_X9_62_prime256v1},
+		{YACA_KEY_LENGTH_EC_SECP384R1, NID_secp384r1},
+		{YACA_KEY_LENGTH_EC_SECP256K1, NID_secp256k1}
+	};
+
+	const std::vector<std::pair<yaca_digest_algorithm_e, const EVP_MD *>> digests = {
+		{YACA_DIGEST_SHA1, EVP_sha1()},
+		{YACA_DIGEST_SHA256, EVP_sha256()},
+		{YACA_DIGEST_SHA512, EVP_sha512()}
+	};
+
+	for (const auto &ca: cargs) {
+		int ret;
+		yaca_key_h key_prv = YACA_KEY_NULL, key_pub = YACA_KEY_NULL;
+		yaca_key_h key_prepared = YACA_KEY_NULL;
+		char *pub = NULL;
+		size_t pub_len;
+		const unsigned char *p;
+		EVP_PKEY *pkey;
+		EC_GROUP *group;
+		const BIGNUM *order;
+
+		generate_asymmetric_keys(YACA_KEY_TYPE_EC_PRIV, ca.curve, &key_prv, &key_pub);
+
+		ret = yaca_key_export(key_pub, YACA_KEY_FORMAT_DEFAULT, YACA_KEY_FILE_FORMAT_DER,
+		                      NULL, &pub, &pub_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_key_import(YACA_KEY_TYPE_EC_PUB, NULL, pub, pub_len, &key_prepared);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_verify_prepare_key(key_prepared);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		p = (const unsigned char *)pub;
+		pkey = d2i_PUBKEY(NULL, &p, pub_len);
+		BOOST_REQUIRE(pkey != NULL);
+
+		group = EC_GROUP_new_by_curve_name(ca.nid);
+		BOOST_REQUIRE(group != NULL);
+		order = EC_GROUP_get0_order(group);
+
+		for (const auto &d: digests) {
+			yaca_context_h ctx = YACA_CONTEXT_NULL;
+			char *signature = NULL;
+			size_t signature_len;
+			ECDSA_SIG *sig;
+			const BIGNUM *r, *s;
+			BIGNUM *zero = BN_new(), *r_big = BN_new(), *s_big = BN_new();
+			BIGNUM *s_high = BN_new(), *r_wrong = BN_dup(BN_value_one());
+
+			BOOST_REQUIRE(zero != NULL && r_big != NULL && s_big != NULL &&
+			              s_high != NULL && r_wrong != NULL);
+
+			ret = yaca_sign_initialize(&ctx, d.first, key_prv);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_sign_update(ctx, INPUT_DATA, INPUT_DATA_SIZE);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_context_get_output_length(ctx, 0, &signature_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_malloc(signature_len, (void **)&signature);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			ret = yaca_sign_finalize(ctx, signature, &signature_len);
+			BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+			p = (const unsigned char *)signature;
+			sig = d2i_ECDSA_SIG(NULL, &p, signature_len);
+			BOOST_REQUIRE(sig != NULL);
+			ECDSA_SIG_get0(sig, &r, &s);
+
+			BN_zero(zero);
+			BOOST_REQUIRE(BN_add(r_big, r, order) == 1);
+			BOOST_REQUIRE(BN_add(s_big, s, order) == 1);
+			BOOST_REQUIRE(BN_sub(s_high, order, s) == 1);
+
+			bytes_t valid = der_ecdsa_sig(r, s);
+			bytes_t trailing = valid;
+			trailing.push_back(0x00);
+			bytes_t truncated(valid.begin(), valid.end() - 1);
+
+			const std::vector<bytes_t> signatures = {
+				valid,
+				der_ecdsa_sig(zero, s),
+				der_ecdsa_sig(r, zero),
+				der_ecdsa_sig(order, s),
+				der_ecdsa_sig(r_big, s),
+				der_ecdsa_sig(r, order),
+				der_ecdsa_sig(r, s_big),
+				der_ecdsa_sig(r, s_high),
+				der_ecdsa_sig(r_wrong, s),
+				der_ecdsa_sig(r, s, 1),
+				der_ecdsa_sig(r, s, 0, true),
+				trailing,
+				truncated
+			};
+
+			for (size_t i = 0; i < signatures.size(); ++i) {
+				int expected = openssl_verify(pkey, d.second, signatures[i]);
+
+				BOOST_REQUIRE_MESSAGE(i != 0 || expected == YACA_ERROR_NONE,
+				                      "Fix your test");
+				BOOST_REQUIRE_MESSAGE(yaca_verify(key_pub, d.first, signatures[i]) == expected,
+				                      "signature " << i << " unprepared");
+				BOOST_REQUIRE_MESSAGE(yaca_verify(key_prepared, d.first, signatures[i]) == expected,
+				                      "signature " << i << " prepared");
+			}
+
+			BN_free(zero);
+			BN_free(r_big);
+			BN_free(s_big);
+			BN_free(s_high);
+			BN_free(r_wrong);
+			ECDSA_SIG_free(sig);
+			yaca_context_destroy(ctx);
+			yaca_free(signature);
+		}
+
+		EC_GROUP_free(group);
+		EVP_PKEY_free(pkey);
+		yaca_free(pub);
+		yaca_key_destroy(key_prepared);
+		yaca_key_destroy(key_pub);
+		yaca_key_destroy(key_prv);
+	}
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -779,4 +779,114 @@ BOOST_FIXTURE_TEST_CASE(T3011__negative__simple_calculate_cmac, InitDebugFixture
 	yaca_key_destroy(key_prv);
 }
 
+BOOST_FIXTURE_TEST_CASE(T312__positive__simple_calculate_gmac, InitDebugFixture)
+{
+	const std::vector<yaca_key_bit_length_e> lens = {
+		YACA_KEY_LENGTH_UNSAFE_128BIT,
+		YACA_KEY_LENGTH_192BIT,
+		YACA_KEY_LENGTH_256BIT};
+
+	for (const auto &len: lens) {
+		int ret;
+		yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+		char *mac1 = NULL, *mac2 = NULL;
+		size_t mac1_len, mac2_len;
+
+		ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, len, &key);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+		ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_simple_calculate_gmac(key, iv,
+		                                 INPUT_DATA, INPUT_DATA_SIZE,
+		                                 &mac1, &mac1_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		ret = yaca_simple_calculate_gmac(key, iv,
+		                                 INPUT_DATA, INPUT_DATA_SIZE,
+		                                 &mac2, &mac2_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		BOOST_REQUIRE(mac1_len == 16);
+		BOOST_REQUIRE(mac1_len == mac2_len);
+		ret = yaca_memcmp(mac1, mac2, mac1_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		yaca_free(mac2);
+		mac2 = NULL;
+
+		/* an empty message */
+		ret = yaca_simple_calculate_gmac(key, iv, NULL, 0, &mac2, &mac2_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+		BOOST_REQUIRE(mac1_len == mac2_len);
+		ret = yaca_memcmp(mac1, mac2, mac1_len);
+		BOOST_REQUIRE(ret == YACA_ERROR_DATA_MISMATCH);
+
+		yaca_key_destroy(key);
+		yaca_key_destroy(iv);
+		yaca_free(mac1);
+		yaca_free(mac2);
+	}
+}
+
+BOOST_FIXTURE_TEST_CASE(T313__negative__simple_calculate_gmac, InitDebugFixture)
+{
+	int ret;
+	yaca_key_h key = YACA_KEY_NULL, key_prv = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+	char *mac = NULL;
+	size_t mac_len;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_RSA_PRIV, YACA_KEY_LENGTH_512BIT, &key_prv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_simple_calculate_gmac(YACA_KEY_NULL, iv,
+	                                 INPUT_DATA, INPUT_DATA_SIZE,
+	                                 &mac, &mac_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_simple_calculate_gmac(key_prv, iv,
+	                                 INPUT_DATA, INPUT_DATA_SIZE,
+	                                 &mac, &mac_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_simple_calculate_gmac(key, YACA_KEY_NULL,
+	                                 INPUT_DATA, INPUT_DATA_SIZE,
+	                                 &mac, &mac_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_simple_calculate_gmac(key, key,
+	                                 INPUT_DATA, INPUT_DATA_SIZE,
+	                                 &mac, &mac_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_simple_calculate_gmac(key, iv,
+	                                 NULL, INPUT_DATA_SIZE,
+	                                 &mac, &mac_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_simple_calculate_gmac(key, iv,
+	                                 INPUT_DATA, 0,
+	                                 &mac, &mac_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_simple_calculate_gmac(key, iv,
+	                                 INPUT_DATA, INPUT_DATA_SIZE,
+	                                 NULL, &mac_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	ret = yaca_simple_calculate_gmac(key, iv,
+	                                 INPUT_DATA, INPUT_DATA_SIZE,
+	                                 &mac, 0);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	yaca_key_destroy(key);
+	yaca_key_destroy(key_prv);
+	yaca_key_destroy(iv);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,282 @@
+/*
+ *  Copyright (c) 2020 Samsung Electronics Co., Ltd All Rights Reserved
+ *
+ *  Contact: Lukasz Pawelczyk <l.pawelczyk@samsung.com>
+ *
+ *  Licensed under the Apache License, Version 2.0 (the "License");
+ *  you may not use this file except in compliance with the License.
+ *  You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *  Unless required by applicable law or agreed to in writing, software
+ *  distributed under the License is distributed on an "AS IS" BASIS,
+ *  WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *  See the License for the specific language governing permissions and
+ *  limitations under the License
+ */
+
+/**
+ * @file    test_stats.cpp
+ * @brief   Statistics API unit tests.
+ */
+
+#include <boost/test/unit_test.hpp>
+#include <thread>
+
+#include <yaca_crypto.h>
+#include <yaca_digest.h>
+#include <yaca_encrypt.h>
+#include <yaca_sign.h>
+#include <yaca_simple.h>
+#include <yaca_key.h>
+#include <yaca_stats.h>
+#include <yaca_error.h>
+
+#include "common.h"
+
+
+namespace {
+
+struct StatsFixture : public InitDebugFixture {
+	StatsFixture()
+	{
+		yaca_stats_reset();
+		yaca_stats_set_enabled(true);
+	}
+
+	~StatsFixture()
+	{
+		yaca_stats_set_enabled(false);
+	}
+};
+
+yaca_stats_s snapshot()
+{
+	yaca_stats_s stats;
+
+	int ret = yaca_stats_snapshot(&stats);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	return stats;
+}
+
+} // namespace
+
+
+BOOST_AUTO_TEST_SUITE(TESTS_STATS)
+
+BOOST_FIXTURE_TEST_CASE(T901__positive__stats_digest, StatsFixture)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	char digest[64];
+	size_t digest_len;
+
+	ret = yaca_digest_initialize(&ctx, YACA_DIGEST_SHA256);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_digest_update(ctx, INPUT_DATA, 100);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_digest_update(ctx, INPUT_DATA, 23);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_digest_finalize(ctx, digest, &digest_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	yaca_context_destroy(ctx);
+
+	yaca_stats_s stats = snapshot();
+	BOOST_REQUIRE(stats.initialized[YACA_STATS_CONTEXT_DIGEST] == 1);
+	BOOST_REQUIRE(stats.updated[YACA_STATS_CONTEXT_DIGEST] == 2);
+	BOOST_REQUIRE(stats.finalized[YACA_STATS_CONTEXT_DIGEST] == 1);
+	BOOST_REQUIRE(stats.digest_bytes[YACA_DIGEST_SHA256] == 123);
+	BOOST_REQUIRE(stats.digest_bytes[YACA_DIGEST_SHA1] == 0);
+	BOOST_REQUIRE(stats.initialized[YACA_STATS_CONTEXT_ENCRYPT] == 0);
+	BOOST_REQUIRE(stats.allocations > 0);
+}
+
+BOOST_FIXTURE_TEST_CASE(T902__positive__stats_encrypt_rng, StatsFixture)
+{
+	int ret;
+	yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+	char *ciphertext = NULL;
+	size_t ciphertext_len;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	yaca_stats_s stats = snapshot();
+	BOOST_REQUIRE(stats.rng_bytes == (YACA_KEY_LENGTH_256BIT + YACA_KEY_LENGTH_IV_128BIT) / 8);
+	BOOST_REQUIRE(stats.rng_syscalls >= 2);
+
+	ret = yaca_simple_encrypt(YACA_ENCRYPT_AES, YACA_BCM_CBC, key, iv,
+	                          INPUT_DATA, INPUT_DATA_SIZE, &ciphertext, &ciphertext_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	stats = snapshot();
+	BOOST_REQUIRE(stats.initialized[YACA_STATS_CONTEXT_ENCRYPT] == 1);
+	BOOST_REQUIRE(stats.updated[YACA_STATS_CONTEXT_ENCRYPT] == 1);
+	BOOST_REQUIRE(stats.finalized[YACA_STATS_CONTEXT_ENCRYPT] == 1);
+	BOOST_REQUIRE(stats.cipher_bytes[YACA_ENCRYPT_AES] == INPUT_DATA_SIZE);
+
+	yaca_free(ciphertext);
+	yaca_key_destroy(iv);
+	yaca_key_destroy(key);
+}
+
+BOOST_FIXTURE_TEST_CASE(T903__positive__stats_failures_reset, StatsFixture)
+{
+	int ret;
+	yaca_key_h prv = YACA_KEY_NULL, pub = YACA_KEY_NULL;
+	char *signature = NULL;
+	size_t signature_len;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_EC_PRIV, YACA_KEY_LENGTH_EC_PRIME256V1, &prv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_extract_public(prv, &pub);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_simple_calculate_signature(YACA_DIGEST_SHA512, prv, INPUT_DATA, INPUT_DATA_SIZE,
+	                                      &signature, &signature_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_simple_verify_signature(YACA_DIGEST_SHA512, pub, INPUT_DATA, INPUT_DATA_SIZE - 1,
+	                                   signature, signature_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_DATA_MISMATCH);
+
+	yaca_stats_s stats = snapshot();
+	BOOST_REQUIRE(stats.initialized[YACA_STATS_CONTEXT_SIGN] == 2);
+	BOOST_REQUIRE(stats.finalized[YACA_STATS_CONTEXT_SIGN] == 1);
+	BOOST_REQUIRE(stats.digest_bytes[YACA_DIGEST_SHA512] == 2 * INPUT_DATA_SIZE - 1);
+	BOOST_REQUIRE(stats.failures[YACA_STATS_FAILURE_VERIFICATION] == 1);
+
+	/* A rejected argument isn't a failure */
+	ret = yaca_simple_verify_signature(YACA_DIGEST_SHA512, pub, INPUT_DATA, INPUT_DATA_SIZE,
+	                                   NULL, signature_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	stats = snapshot();
+	BOOST_REQUIRE(stats.failures[YACA_STATS_FAILURE_VERIFICATION] == 1);
+	BOOST_REQUIRE(stats.failures[YACA_STATS_FAILURE_OPENSSL_INVALID_PARAMETER] == 0);
+	BOOST_REQUIRE(stats.failures[YACA_STATS_FAILURE_AUTHENTICATION] == 0);
+
+	yaca_stats_reset();
+	stats = snapshot();
+	BOOST_REQUIRE(stats.initialized[YACA_STATS_CONTEXT_SIGN] == 0);
+	BOOST_REQUIRE(stats.failures[YACA_STATS_FAILURE_VERIFICATION] == 0);
+
+	yaca_free(signature);
+	yaca_key_destroy(pub);
+	yaca_key_destroy(prv);
+}
+
+BOOST_FIXTURE_TEST_CASE(T904__positive__stats_threads_disabled, StatsFixture)
+{
+	const size_t THREADS = 4;
+	std::thread threads[THREADS];
+
+	for (auto &t: threads)
+		t = std::thread([]{
+			char buf[16];
+
+			yaca_initialize();
+			yaca_randomize_bytes(buf, sizeof(buf));
+			yaca_cleanup();
+		});
+
+	for (auto &t: threads)
+		t.join();
+
+	/* exited threads are still accounted for */
+	yaca_stats_s stats = snapshot();
+	BOOST_REQUIRE(stats.rng_bytes == THREADS * 16);
+
+	yaca_stats_set_enabled(false);
+
+	char buf[16];
+	int ret = yaca_randomize_bytes(buf, sizeof(buf));
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	stats = snapshot();
+	BOOST_REQUIRE(stats.rng_bytes == THREADS * 16);
+}
+
+BOOST_FIXTURE_TEST_CASE(T905__negative__stats_snapshot, InitDebugFixture)
+{
+	int ret = yaca_stats_snapshot(NULL);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+}
+
+BOOST_FIXTURE_TEST_CASE(T906__positive__stats_authentication, StatsFixture)
+{
+	int ret;
+	yaca_context_h ctx = YACA_CONTEXT_NULL;
+	yaca_key_h key = YACA_KEY_NULL, iv = YACA_KEY_NULL;
+	char *ciphertext = NULL, *plaintext = NULL, *tag = NULL;
+	size_t ciphertext_len, plaintext_len, tag_len = 16, written, len;
+
+	ret = yaca_key_generate(YACA_KEY_TYPE_SYMMETRIC, YACA_KEY_LENGTH_256BIT, &key);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_key_generate(YACA_KEY_TYPE_IV, YACA_KEY_LENGTH_IV_128BIT, &iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_encrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_GCM, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_context_get_output_length(ctx, INPUT_DATA_SIZE, &ciphertext_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_get_output_length(ctx, 0, &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ciphertext_len += len;
+
+	ret = yaca_malloc(ciphertext_len, (void **)&ciphertext);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_encrypt_update(ctx, INPUT_DATA, INPUT_DATA_SIZE, ciphertext, &written);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_encrypt_finalize(ctx, ciphertext + written, &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ciphertext_len = written + len;
+
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_GCM_TAG_LEN, &tag_len, sizeof(tag_len));
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+	ret = yaca_context_get_property(ctx, YACA_PROPERTY_GCM_TAG, (void **)&tag, &tag_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	yaca_context_destroy(ctx);
+	ctx = YACA_CONTEXT_NULL;
+
+	tag[0] ^= 0x01;
+
+	ret = yaca_decrypt_initialize(&ctx, YACA_ENCRYPT_AES, YACA_BCM_GCM, key, iv);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_malloc(ciphertext_len, (void **)&plaintext);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_decrypt_update(ctx, ciphertext, ciphertext_len, plaintext, &plaintext_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_context_set_property(ctx, YACA_PROPERTY_GCM_TAG, tag, tag_len);
+	BOOST_REQUIRE(ret == YACA_ERROR_NONE);
+
+	ret = yaca_decrypt_finalize(ctx, plaintext + plaintext_len, &len);
+	BOOST_REQUIRE(ret == YACA_ERROR_INVALID_PARAMETER);
+
+	yaca_stats_s stats = snapshot();
+	BOOST_REQUIRE(stats.failures[YACA_STATS_FAILURE_AUTHENTICATION] == 1);
+	BOOST_REQUIRE(stats.failures[YACA_STATS_FAILURE_OPENSSL_INVALID_PARAMETER] == 0);
+	BOOST_REQUIRE(stats.failures[YACA_STATS_FAILURE_INTERNAL] == 0);
+
+	yaca_context_destroy(ctx);
+	yaca_free(plaintext);
+	yaca_free(tag);
+	yaca_free(ciphertext);
+	yaca_key_destroy(iv);
+	yaca_key_destroy(key);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -79,6 +79,18 @@ The package provides Yet Another Crypto API unit tests.
 %files tests
 %{_bindir}/yaca-unit-tests*
 
+## Benchmarks Package #######################################################
+%package bench
+Summary:        Yet Another Crypto API benchmarks
+Group:          Security/Other
+Requires:       yaca = %{version}-%{release}
+
+%description bench
+The package provides Yet Another Crypto API benchmarks.
+
+%files bench
+%{_bindir}/yaca-bench
+
 ## Python3 Package ############################################################
 %package -n python3-yaca
 Summary:        Yet Another Crypto API Python3 bindings